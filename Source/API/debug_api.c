@@ -1,121 +1,539 @@
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdlib.h>
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdbool.h>
-#include "cmsis_os2.h"
-#include "uart_driver.h"
-#include "uart_api.h"
-#include "debug_api.h"
-#include "string_util.h"
-/**********************************************************************************************************************
-* Private definitions and macros
-*********************************************************************************************************************/
-#define DEBUG_MUTEX_ACQUIRE_TIMEOUT 100
-#define DEBUG_UART_SPEED 115200
-#define DEBUG_BUFFER_SIZE 1024
-#define CFG_DEBUG_API_SEND_MUTEX_NAME "DebugApiMutex"
-#define UART_DEBUGGING eUartApiDevice_Debug
-/**********************************************************************************************************************
-* Private typedef
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Private constants
-*********************************************************************************************************************/
-static const osMutexAttr_t g_send_mutex_attr = {.name = CFG_DEBUG_API_SEND_MUTEX_NAME};
-/**********************************************************************************************************************
-* Private variables
-*********************************************************************************************************************/
-static char g_debug_message_buffer[DEBUG_BUFFER_SIZE] = {0};
-static osMutexId_t g_print_mutex = NULL;
-/**********************************************************************************************************************
-* Exported variables and references
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of private functions
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Definitions of private functions
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Definitions of exported functions
-*********************************************************************************************************************/
-bool Debug_API_Init(void) {
-    sString_t delimiter = (sString_t)DEFINE_STRING("\r\n");
-
-    if (UART_API_Init(UART_DEBUGGING, DEBUG_UART_SPEED, delimiter) == false) {
-        return false;        
-    }  
-
-    g_print_mutex = osMutexNew(&g_send_mutex_attr);
-
-    if (g_print_mutex == NULL) {
-        return false;       
-    }
-
-    return true;
-}
-
-bool Debug_API_PrintMessage(const char *module_tag, const char *file, int line, eDebugLevel_t debug_level, const char *format, ...) {
-    
-    if (g_print_mutex == NULL) {
-        return false;
-    }
-
-    if ((format == NULL) || (module_tag == NULL)) {
-         return false;
-    }
-
-    if (osMutexAcquire(g_print_mutex, DEBUG_MUTEX_ACQUIRE_TIMEOUT) != osOK) {
-        return false;
-    }
-
-    bool return_val = true;
-
-    int bytes_written = 0;
-    switch (debug_level) {
-        case eDebugLevel_Info: {
-            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.INF]: \t", module_tag);
-        } break;
-        case eDebugLevel_Warning: {
-            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.WRN] (%s @%u line): \t", module_tag, file, line);
-        } break;
-        case eDebugLevel_Error: {
-            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.ERR] (%s @%u line): \t", module_tag, file, line);
-        } break;
-        default: {
-            break;
-        }
-    }
-
-    if ((bytes_written < DEBUG_BUFFER_SIZE) && (bytes_written > 0)) {
-        va_list args;
-        va_start(args, format);
-        bytes_written += vsnprintf(&g_debug_message_buffer[bytes_written], DEBUG_BUFFER_SIZE, format, args);   
-        va_end(args);
-
-        if (bytes_written >= DEBUG_BUFFER_SIZE) {
-            return_val = false;
-        }  
-        
-        sString_t full_message;
-        full_message.str = g_debug_message_buffer;
-        full_message.size = bytes_written;
-
-        if (UART_API_SendMessage(UART_DEBUGGING, full_message) == false) {    
-            return_val = false; 
-        }
-    }
-
-    if (osMutexRelease(g_print_mutex) != osOK) {
-        return_val = false;
-    }
-
-    return return_val;
-}
\ No newline at end of file
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "stm32f4xx.h"
+#include "cmsis_os2.h"
+#include "uart_driver.h"
+#include "uart_api.h"
+#include "debug_api.h"
+#include "string_util.h"
+#include "log_ring.h"
+/**********************************************************************************************************************
+* Private definitions and macros
+*********************************************************************************************************************/
+#define DEBUG_UART_SPEED 115200
+#define DEBUG_BUFFER_SIZE 1024
+#define UART_DEBUGGING eUartApiDevice_Debug
+/* Messages are formatted on the stack of the caller, longer ones are cut short */
+#define DEBUG_MESSAGE_SIZE 128
+#define DEBUG_RING_SIZE 4096
+#define DEBUG_DRAIN_TASK_NAME "DebugDrainTask"
+#define DEBUG_DRAIN_TASK_STACK_SIZE 1024
+/* Below every worker task, the log is only written out when nothing else has to run */
+#define DEBUG_DRAIN_TASK_PRIORITY 8
+#define DEBUG_DRAIN_FLAG 0x01U
+/* A record claimed but not yet committed, the writer was preempted and is looked at again shortly */
+#define DEBUG_DRAIN_RETRY_MS 10
+/* Frames are COBS encoded and end with a zero byte, the decoder finds them in a raw capture */
+#define DEBUG_FRAME_DELIMITER 0x00
+#define DEBUG_COBS_BLOCK_SIZE 0xFF
+#define DEBUG_FLAG_CHARACTERS "-+ #0"
+#define DEBUG_DIGIT_CHARACTERS "0123456789"
+#define DEBUG_LENGTH_CHARACTERS "hlzjtL"
+#define DEBUG_ALL_MODULES "*"
+/**********************************************************************************************************************
+* Private typedef
+*********************************************************************************************************************/
+/* Fixed part of every record, the prefix is only formatted by the drain task */
+typedef struct sDebugRecord {
+    uint32_t timestamp;
+    const char *module_tag;
+    const char *file;
+    int line;
+    eDebugLevel_t debug_level;
+} sDebugRecord_t;
+
+/* Fixed part of a binary record, the packed arguments follow it */
+typedef struct sDebugBinaryRecord {
+    uint32_t timestamp;
+    const sDebugFormat_t *debug_format;
+    const char *module_tag;
+} sDebugBinaryRecord_t;
+/**********************************************************************************************************************
+* Private constants
+*********************************************************************************************************************/
+static const osThreadAttr_t g_drain_task_attr = {
+    .name = DEBUG_DRAIN_TASK_NAME,
+    .stack_size = DEBUG_DRAIN_TASK_STACK_SIZE,
+    .priority = DEBUG_DRAIN_TASK_PRIORITY
+};
+/* eDebugLevel_Last is a silenced module */
+static const char *g_level_names[eDebugLevel_Last + 1] = {
+    [eDebugLevel_Info] = "INF",
+    [eDebugLevel_Warning] = "WRN",
+    [eDebugLevel_Error] = "ERR",
+    [eDebugLevel_Last] = "OFF"
+};
+#if (DEBUG_API_BINARY_LOG == 1)
+/* Calls that bypass the macros are formatted on the target and sent as a single string argument */
+static const sDebugFormat_t g_text_formats[eDebugLevel_Last] DEBUG_FORMAT_SECTION = {
+    [eDebugLevel_Info] = {.format = "%s", .file = NULL, .line = 0, .debug_level = eDebugLevel_Info},
+    [eDebugLevel_Warning] = {.format = "%s", .file = NULL, .line = 0, .debug_level = eDebugLevel_Warning},
+    [eDebugLevel_Error] = {.format = "%s", .file = NULL, .line = 0, .debug_level = eDebugLevel_Error}
+};
+#endif
+/**********************************************************************************************************************
+* Private variables
+*********************************************************************************************************************/
+static char g_debug_message_buffer[DEBUG_BUFFER_SIZE] = {0};
+/* Kept as 64 bit words so the records are aligned */
+static uint64_t g_debug_ring_storage[DEBUG_RING_SIZE / sizeof(uint64_t)] = {0};
+static sLogRing_t g_debug_ring = {0};
+static osThreadId_t g_drain_task_id = NULL;
+static volatile debug_mirror_callback_t g_mirror = NULL;
+/**********************************************************************************************************************
+* Exported variables and references
+*********************************************************************************************************************/
+/* Placed by the linker scripts around the .log_modules entries */
+extern sDebugModule_t _slog_modules[];
+extern sDebugModule_t _elog_modules[];
+
+/**********************************************************************************************************************
+* Prototypes of private functions
+*********************************************************************************************************************/
+static void Debug_API_DrainTask (void *argument);
+#if (DEBUG_API_BINARY_LOG == 1)
+static bool Debug_API_SendFrame (const uint8_t *record, size_t size);
+static bool Debug_API_PackValue (uint8_t *buffer, size_t size, size_t *length, const void *value, size_t value_size);
+static size_t Debug_API_PackArguments (const char *format, va_list args, uint8_t *buffer, size_t size);
+#else
+static bool Debug_API_SendRecord (const uint8_t *record, size_t size);
+#endif
+static bool Debug_API_WriteRecord (const void *meta, size_t meta_size, const void *message, size_t message_size);
+static bool Debug_API_Output (uint32_t timestamp, size_t size);
+/**********************************************************************************************************************
+* Definitions of private functions
+*********************************************************************************************************************/
+static void Debug_API_DrainTask (void *argument) {
+    while (1) {
+        size_t size = 0;
+        const uint8_t *record = LogRing_Peek(&g_debug_ring, &size);
+
+        if (record == NULL) {
+            uint32_t timeout = (LogRing_IsEmpty(&g_debug_ring) == true) ? osWaitForever : DEBUG_DRAIN_RETRY_MS;
+
+            osThreadFlagsWait(DEBUG_DRAIN_FLAG, osFlagsWaitAny, timeout);
+            continue;
+        }
+
+#if (DEBUG_API_BINARY_LOG == 1)
+        Debug_API_SendFrame(record, size);
+#else
+        Debug_API_SendRecord(record, size);
+#endif
+        LogRing_Release(&g_debug_ring);
+    }
+}
+
+#if (DEBUG_API_BINARY_LOG == 1)
+static bool Debug_API_SendFrame (const uint8_t *record, size_t size) {
+    /* One code byte per started block and the delimiter */
+    if ((size + (size / (DEBUG_COBS_BLOCK_SIZE - 1)) + 2) > DEBUG_BUFFER_SIZE) {
+        return false;
+    }
+
+    uint8_t *frame = (uint8_t *) g_debug_message_buffer;
+    size_t code_index = 0;
+    size_t frame_size = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < size; i++) {
+        if (record[i] != DEBUG_FRAME_DELIMITER) {
+            frame[frame_size++] = record[i];
+            code++;
+        }
+
+        if ((record[i] == DEBUG_FRAME_DELIMITER) || (code == DEBUG_COBS_BLOCK_SIZE)) {
+            frame[code_index] = code;
+            code_index = frame_size++;
+            code = 1;
+        }
+    }
+
+    frame[code_index] = code;
+    frame[frame_size++] = DEBUG_FRAME_DELIMITER;
+
+    uint32_t timestamp;
+    memcpy(&timestamp, record, sizeof(timestamp));
+
+    return Debug_API_Output(timestamp, frame_size);
+}
+
+static bool Debug_API_PackValue (uint8_t *buffer, size_t size, size_t *length, const void *value, size_t value_size) {
+    if ((*length + value_size) > size) {
+        return false;
+    }
+
+    memcpy(&buffer[*length], value, value_size);
+    *length += value_size;
+
+    return true;
+}
+
+/* Walks the conversions the way printf would and stores each argument in its own size, little endian as it sits in
+ * memory. A string is stored as its length in one byte and the characters. Packing stops at the first argument that
+ * does not fit, the decoder marks the line as cut short. */
+static size_t Debug_API_PackArguments (const char *format, va_list args, uint8_t *buffer, size_t size) {
+    size_t length = 0;
+
+    while (*format != '\0') {
+        if (*format++ != '%') {
+            continue;
+        }
+
+        while ((*format != '\0') && (strchr(DEBUG_FLAG_CHARACTERS, *format) != NULL)) {
+            format++;
+        }
+
+        if (*format == '*') {
+            int width = va_arg(args, int);
+
+            if (Debug_API_PackValue(buffer, size, &length, &width, sizeof(width)) == false) {
+                return length;
+            }
+
+            format++;
+        }
+
+        while ((*format != '\0') && (strchr(DEBUG_DIGIT_CHARACTERS, *format) != NULL)) {
+            format++;
+        }
+
+        size_t precision = SIZE_MAX;
+
+        if (*format == '.') {
+            format++;
+
+            if (*format == '*') {
+                int star_precision = va_arg(args, int);
+
+                if (Debug_API_PackValue(buffer, size, &length, &star_precision, sizeof(star_precision)) == false) {
+                    return length;
+                }
+
+                precision = (star_precision < 0) ? SIZE_MAX : (size_t) star_precision;
+                format++;
+            } else {
+                precision = strtoul(format, (char **) &format, 10);
+            }
+        }
+
+        size_t long_count = 0;
+
+        while ((*format != '\0') && (strchr(DEBUG_LENGTH_CHARACTERS, *format) != NULL)) {
+            long_count += (*format == 'l') ? 1 : 0;
+            format++;
+        }
+
+        bool is_packed = true;
+
+        switch (*format) {
+            case '%': {
+            } break;
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c': {
+                if (long_count >= 2) {
+                    long long value = va_arg(args, long long);
+                    is_packed = Debug_API_PackValue(buffer, size, &length, &value, sizeof(value));
+                } else if (long_count == 1) {
+                    long value = va_arg(args, long);
+                    is_packed = Debug_API_PackValue(buffer, size, &length, &value, sizeof(value));
+                } else {
+                    int value = va_arg(args, int);
+                    is_packed = Debug_API_PackValue(buffer, size, &length, &value, sizeof(value));
+                }
+            } break;
+            case 'p': {
+                void *value = va_arg(args, void *);
+                is_packed = Debug_API_PackValue(buffer, size, &length, &value, sizeof(value));
+            } break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G': {
+                double value = va_arg(args, double);
+                is_packed = Debug_API_PackValue(buffer, size, &length, &value, sizeof(value));
+            } break;
+            case 's': {
+                const char *value = va_arg(args, const char *);
+
+                if (value == NULL) {
+                    value = "(null)";
+                }
+
+                if (length >= size) {
+                    return length;
+                }
+
+                size_t limit = size - length - 1;
+                limit = (limit > UINT8_MAX) ? UINT8_MAX : limit;
+                limit = (limit > precision) ? precision : limit;
+
+                uint8_t string_length = (uint8_t) strnlen(value, limit);
+
+                buffer[length++] = string_length;
+                is_packed = Debug_API_PackValue(buffer, size, &length, value, string_length);
+            } break;
+            default: {
+                /* Unknown conversion, nothing after it can be told apart */
+                return length;
+            }
+        }
+
+        if ((is_packed == false) || (*format == '\0')) {
+            return length;
+        }
+
+        format++;
+    }
+
+    return length;
+}
+#else
+static bool Debug_API_SendRecord (const uint8_t *record, size_t size) {
+    if (size < sizeof(sDebugRecord_t)) {
+        return false;
+    }
+
+    sDebugRecord_t meta;
+    memcpy(&meta, record, sizeof(meta));
+
+    int bytes_written = 0;
+    switch (meta.debug_level) {
+        case eDebugLevel_Info: {
+            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.INF]: \t", meta.module_tag);
+        } break;
+        case eDebugLevel_Warning: {
+            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.WRN] (%s @%u line): \t", meta.module_tag, meta.file, meta.line);
+        } break;
+        case eDebugLevel_Error: {
+            bytes_written = snprintf(g_debug_message_buffer, DEBUG_BUFFER_SIZE, "[%s.ERR] (%s @%u line): \t", meta.module_tag, meta.file, meta.line);
+        } break;
+        default: {
+            break;
+        }
+    }
+
+    size_t message_size = size - sizeof(sDebugRecord_t);
+
+    if ((bytes_written <= 0) || ((bytes_written + message_size) > DEBUG_BUFFER_SIZE)) {
+        return false;
+    }
+
+    memcpy(&g_debug_message_buffer[bytes_written], &record[sizeof(sDebugRecord_t)], message_size);
+
+    return Debug_API_Output(meta.timestamp, bytes_written + message_size);
+}
+#endif
+
+/* The line or frame in the message buffer goes to the UART and to the mirror, if there is one */
+static bool Debug_API_Output (uint32_t timestamp, size_t size) {
+    debug_mirror_callback_t mirror = g_mirror;
+
+    if (mirror != NULL) {
+        mirror(timestamp, g_debug_message_buffer, size);
+    }
+
+    sString_t full_message;
+    full_message.str = g_debug_message_buffer;
+    full_message.size = size;
+
+    return UART_API_SendMessage(UART_DEBUGGING, full_message);
+}
+
+static bool Debug_API_WriteRecord (const void *meta, size_t meta_size, const void *message, size_t message_size) {
+    bool was_empty = false;
+
+    if (LogRing_Write(&g_debug_ring, meta, meta_size, message, message_size, &was_empty) == false) {
+        return false;
+    }
+
+    if (was_empty == true) {
+        osThreadFlagsSet(g_drain_task_id, DEBUG_DRAIN_FLAG);
+    }
+
+    return true;
+}
+/**********************************************************************************************************************
+* Definitions of exported functions
+*********************************************************************************************************************/
+bool Debug_API_Init(void) {
+    sString_t delimiter = (sString_t)DEFINE_STRING("\r\n");
+
+    if (UART_API_Init(UART_DEBUGGING, DEBUG_UART_SPEED, delimiter) == false) {
+        return false;        
+    }  
+
+    if (LogRing_Init(&g_debug_ring, g_debug_ring_storage, sizeof(g_debug_ring_storage)) == false) {
+        return false;
+    }
+
+    g_drain_task_id = osThreadNew(Debug_API_DrainTask, NULL, &g_drain_task_attr);
+
+    if (g_drain_task_id == NULL) {
+        return false;       
+    }
+
+    return true;
+}
+
+/* Never blocks, the message goes into the ring and is counted as dropped when there is no room for it. */
+bool Debug_API_PrintMessage(const char *module_tag, const char *file, int line, eDebugLevel_t debug_level, const char *format, ...) {
+    
+    if (g_drain_task_id == NULL) {
+        return false;
+    }
+
+    if ((format == NULL) || (module_tag == NULL)) {
+         return false;
+    }
+
+    if ((debug_level < eDebugLevel_First) || (debug_level >= eDebugLevel_Last)) {
+        return false;
+    }
+
+    char message[DEBUG_MESSAGE_SIZE];
+    int bytes_written = 0;
+
+    /* vsnprintf is not reentrant and may allocate, an interrupt logs the format text with its conversions unexpanded */
+    if (__get_IPSR() != 0U) {
+        size_t format_size = strlen(format);
+        size_t copy_size = (format_size < DEBUG_MESSAGE_SIZE) ? format_size : (DEBUG_MESSAGE_SIZE - 1);
+
+        memcpy(message, format, copy_size);
+        message[copy_size] = '\0';
+        bytes_written = (int) format_size;
+    } else {
+        va_list args;
+        va_start(args, format);
+        bytes_written = vsnprintf(message, DEBUG_MESSAGE_SIZE, format, args);
+        va_end(args);
+    }
+
+    if (bytes_written < 0) {
+        return false;
+    }
+
+    /* A message cut short still ends the line */
+    if (bytes_written >= DEBUG_MESSAGE_SIZE) {
+        bytes_written = DEBUG_MESSAGE_SIZE - 1;
+        message[bytes_written - 2] = '\r';
+        message[bytes_written - 1] = '\n';
+    }
+
+#if (DEBUG_API_BINARY_LOG == 1)
+    return Debug_API_PrintBinary(module_tag, &g_text_formats[debug_level], message);
+#else
+    sDebugRecord_t meta = {
+        .timestamp = osKernelGetTickCount(),
+        .module_tag = module_tag,
+        .file = file,
+        .line = line,
+        .debug_level = debug_level
+    };
+
+    return Debug_API_WriteRecord(&meta, sizeof(meta), message, bytes_written);
+#endif
+}
+
+#if (DEBUG_API_BINARY_LOG == 1)
+bool Debug_API_PrintBinary(const char *module_tag, const sDebugFormat_t *debug_format, ...) {
+    if (g_drain_task_id == NULL) {
+        return false;
+    }
+
+    if ((debug_format == NULL) || (debug_format->format == NULL) || (module_tag == NULL)) {
+        return false;
+    }
+
+    sDebugBinaryRecord_t meta = {
+        .timestamp = osKernelGetTickCount(),
+        .debug_format = debug_format,
+        .module_tag = module_tag
+    };
+    uint8_t arguments[DEBUG_MESSAGE_SIZE];
+
+    va_list args;
+    va_start(args, debug_format);
+    size_t arguments_size = Debug_API_PackArguments(debug_format->format, args, arguments, sizeof(arguments));
+    va_end(args);
+
+    return Debug_API_WriteRecord(&meta, sizeof(meta), arguments, arguments_size);
+}
+#endif
+
+bool Debug_API_GetStats(sLogRingStats_t *stats) {
+    return LogRing_GetStats(&g_debug_ring, stats);
+}
+
+bool Debug_API_SetModuleLevel(const char *tag, eDebugLevel_t level) {
+    if ((level < eDebugLevel_First) || (level > eDebugLevel_Last)) {
+        return false;
+    }
+
+    bool is_all = (tag == NULL) || (strcmp(tag, DEBUG_ALL_MODULES) == 0);
+    bool is_found = false;
+
+    for (sDebugModule_t *module = _slog_modules; module < _elog_modules; module++) {
+        if ((is_all == true) || (strcmp(module->tag, tag) == 0)) {
+            module->level = (uint8_t) level;
+            is_found = true;
+        }
+    }
+
+    return is_found;
+}
+
+bool Debug_API_GetModuleLevel(const char *tag, eDebugLevel_t *level) {
+    if ((tag == NULL) || (level == NULL)) {
+        return false;
+    }
+
+    for (sDebugModule_t *module = _slog_modules; module < _elog_modules; module++) {
+        if (strcmp(module->tag, tag) == 0) {
+            *level = (eDebugLevel_t) module->level;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t Debug_API_GetModuleCount(void) {
+    return (size_t) (_elog_modules - _slog_modules);
+}
+
+bool Debug_API_GetModule(size_t index, const char **tag, eDebugLevel_t *level) {
+    if ((index >= Debug_API_GetModuleCount()) || (tag == NULL) || (level == NULL)) {
+        return false;
+    }
+
+    *tag = _slog_modules[index].tag;
+    *level = (eDebugLevel_t) _slog_modules[index].level;
+
+    return true;
+}
+
+const char *Debug_API_GetLevelName(eDebugLevel_t level) {
+    if ((level < eDebugLevel_First) || (level > eDebugLevel_Last)) {
+        return NULL;
+    }
+
+    return g_level_names[level];
+}
+
+void Debug_API_SetMirror(debug_mirror_callback_t mirror) {
+    g_mirror = mirror;
+}
@@ -1,37 +1,122 @@
-#ifndef SOURCE_API_DEBUG_API_H_
-#define SOURCE_API_DEBUG_API_H_
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdbool.h>
-/**********************************************************************************************************************
-* Exported definitions and macros
-*********************************************************************************************************************/
-#define CREATE_MODULE_TAG(tag) static const char *module_tag = #tag
-#define STRINGIZE(TAG) #TAG
-#define DEBUG_INFO(format, ...) \
-   Debug_API_PrintMessage(module_tag, NULL, 0, eDebugLevel_Info, format, ##__VA_ARGS__)
-#define DEBUG_WARN(format, ...) \
-   Debug_API_PrintMessage(module_tag, __FILE__, __LINE__, eDebugLevel_Warning, format, ##__VA_ARGS__)
-#define DEBUG_ERROR(format, ...) \
-   Debug_API_PrintMessage(module_tag, __FILE__, __LINE__, eDebugLevel_Error, format, ##__VA_ARGS__)
-/**********************************************************************************************************************
-* Exported types
-*********************************************************************************************************************/
-typedef enum {
-   eDebugLevel_First = 0,
-   eDebugLevel_Info = eDebugLevel_First,
-   eDebugLevel_Warning,
-   eDebugLevel_Error,
-   eDebugLevel_Last
-} eDebugLevel_t;
-/**********************************************************************************************************************
-* Exported variables
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of exported functions
-*********************************************************************************************************************/
-bool Debug_API_Init(void);
-bool Debug_API_PrintMessage(const char *module_tag, const char *file, int line, eDebugLevel_t debug_level, const char *format, ...);
+#ifndef SOURCE_API_DEBUG_API_H_
+#define SOURCE_API_DEBUG_API_H_
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "log_ring.h"
+/**********************************************************************************************************************
+* Exported definitions and macros
+*********************************************************************************************************************/
+/* 1 keeps the formatting off the target. A call only stores its format descriptor and the raw arguments, the
+ * records are turned back into text on the host by Tools/log_decode.py with the firmware ELF. */
+#ifndef DEBUG_API_BINARY_LOG
+#define DEBUG_API_BINARY_LOG 0
+#endif
+
+/* Calls below this level are compiled out and their arguments never evaluated: 0 info, 1 warning, 2 error, 3 none */
+#ifndef DEBUG_API_MIN_LEVEL
+#define DEBUG_API_MIN_LEVEL 0
+#endif
+
+/* Every module also gets its entry in the runtime level table, the entries are gathered by the linker */
+#define DEBUG_MODULE_SECTION __attribute__((section(".log_modules"), used))
+#define CREATE_MODULE_TAG(module) \
+   static const char *module_tag = #module; \
+   static sDebugModule_t debug_module DEBUG_MODULE_SECTION = {.tag = #module, .level = eDebugLevel_First}
+#define STRINGIZE(TAG) #TAG
+#if (DEBUG_API_BINARY_LOG == 1)
+/* The descriptors have a flash section of their own, the decoder looks them up by address */
+#define DEBUG_FORMAT_SECTION __attribute__((section(".log_formats"), used))
+#define DEBUG_EMIT(debug_level, file, line, format, ...) \
+   ({ \
+      static const sDebugFormat_t debug_format DEBUG_FORMAT_SECTION = {format, file, line, debug_level}; \
+      Debug_API_PrintBinary(module_tag, &debug_format, ##__VA_ARGS__); \
+   })
+#else
+#define DEBUG_EMIT(debug_level, file, line, format, ...) \
+   Debug_API_PrintMessage(module_tag, file, line, debug_level, format, ##__VA_ARGS__)
+#endif
+/* The level of the module is checked before any of the arguments is evaluated */
+#define DEBUG_LOG(debug_level, file, line, format, ...) \
+   ((debug_module.level <= (debug_level)) ? DEBUG_EMIT(debug_level, file, line, format, ##__VA_ARGS__) : false)
+/* Keeps the arguments referenced without generating any code */
+#define DEBUG_DISABLED(debug_level, format, ...) \
+   ((void) sizeof(Debug_API_PrintMessage(module_tag, NULL, 0, debug_level, format, ##__VA_ARGS__)))
+#if (DEBUG_API_MIN_LEVEL <= 0)
+#define DEBUG_INFO(format, ...) \
+   DEBUG_LOG(eDebugLevel_Info, NULL, 0, format, ##__VA_ARGS__)
+#else
+#define DEBUG_INFO(format, ...) \
+   DEBUG_DISABLED(eDebugLevel_Info, format, ##__VA_ARGS__)
+#endif
+#if (DEBUG_API_MIN_LEVEL <= 1)
+#define DEBUG_WARN(format, ...) \
+   DEBUG_LOG(eDebugLevel_Warning, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#else
+#define DEBUG_WARN(format, ...) \
+   DEBUG_DISABLED(eDebugLevel_Warning, format, ##__VA_ARGS__)
+#endif
+#if (DEBUG_API_MIN_LEVEL <= 2)
+#define DEBUG_ERROR(format, ...) \
+   DEBUG_LOG(eDebugLevel_Error, __FILE__, __LINE__, format, ##__VA_ARGS__)
+#else
+#define DEBUG_ERROR(format, ...) \
+   DEBUG_DISABLED(eDebugLevel_Error, format, ##__VA_ARGS__)
+#endif
+/**********************************************************************************************************************
+* Exported types
+*********************************************************************************************************************/
+typedef enum {
+   eDebugLevel_First = 0,
+   eDebugLevel_Info = eDebugLevel_First,
+   eDebugLevel_Warning,
+   eDebugLevel_Error,
+   eDebugLevel_Last
+} eDebugLevel_t;
+
+/* Everything about a call that is known at build time, the layout is read by the host decoder */
+typedef struct sDebugFormat {
+   const char *format;
+   const char *file;
+   uint16_t line;
+   uint8_t debug_level;
+} sDebugFormat_t;
+
+/* One entry per CREATE_MODULE_TAG, a level of eDebugLevel_Last silences the module */
+typedef struct sDebugModule {
+   const char *tag;
+   uint8_t level;
+} sDebugModule_t;
+
+/* Called by the drain task with every line, or every frame in the binary mode, right before it goes to the UART */
+typedef void (*debug_mirror_callback_t) (uint32_t timestamp, const char *data, size_t size);
+/**********************************************************************************************************************
+* Exported variables
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Prototypes of exported functions
+*********************************************************************************************************************/
+bool Debug_API_Init(void);
+/* Safe from tasks and interrupts, the message is written out later by a low priority task. In an interrupt the format
+ * is logged as plain text with its arguments left out, formatting is only done in task context. */
+bool Debug_API_PrintMessage(const char *module_tag, const char *file, int line, eDebugLevel_t debug_level, const char *format, ...)
+    __attribute__((format(printf, 5, 6)));
+#if (DEBUG_API_BINARY_LOG == 1)
+/* Arguments are packed as they are passed, strings are copied. The text is only built by the decoder. */
+bool Debug_API_PrintBinary(const char *module_tag, const sDebugFormat_t *debug_format, ...);
+#endif
+/* A NULL tag or "*" sets every module, false when no module has the tag */
+bool Debug_API_SetModuleLevel(const char *tag, eDebugLevel_t level);
+bool Debug_API_GetModuleLevel(const char *tag, eDebugLevel_t *level);
+size_t Debug_API_GetModuleCount(void);
+bool Debug_API_GetModule(size_t index, const char **tag, eDebugLevel_t *level);
+const char *Debug_API_GetLevelName(eDebugLevel_t level);
+/* A single mirror, NULL removes it. It must not block, the whole log waits for it. */
+void Debug_API_SetMirror(debug_mirror_callback_t mirror);
+/* Records taken, records dropped on a full ring and the fill level */
+bool Debug_API_GetStats(sLogRingStats_t *stats);
 #endif /* SOURCE_API_DEBUG_API_H_ */
\ No newline at end of file
@@ -0,0 +1,330 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "modem_api.h"
+#include "nmea_parser.h"
+#include "gnss_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define FIX_MUTEX_ATTR_NAME "GnssFixMutex"
+#define FIX_MUTEX_TIMEOUT_MS 20
+#define MODEM_LOCK_TIMEOUT_MS 450
+#define GNSS_ON_PARAMETERS "1"
+#define GNSS_OFF_PARAMETERS ""
+/* <UTC>,<lat>,<lon>,<HDOP>,<altitude>,<fix>,<COG>,<spkm>,<spkn>,<date>,<nsat> with signed decimal degrees */
+#define LOCATION_MODE_PARAMETERS "2"
+#define LOCATION_LINE_SIZE 100
+#define LOCATION_FIELD_COUNT 11
+#define LOCATION_FIELD_SEPARATOR ','
+#define DEGREE_DECIMALS 7
+#define VALUE_DECIMALS 2
+#define SPEED_DECIMALS 3
+/* km/h * 1000 -> 0.01 m/s */
+#define KMH_E3_TO_SPEED(value) ((value) / 36)
+#define CME_ERROR_NONE 0
+#define CME_ERROR_SESSION_ONGOING 504
+#define CME_ERROR_SESSION_NOT_ACTIVE 505
+#define CME_ERROR_NOT_FIXED 516
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eLocationField {
+    eLocationField_First = 0,
+    eLocationField_Time = eLocationField_First,
+    eLocationField_Latitude,
+    eLocationField_Longitude,
+    eLocationField_Hdop,
+    eLocationField_Altitude,
+    eLocationField_FixType,
+    eLocationField_Course,
+    eLocationField_SpeedKmh,
+    eLocationField_SpeedKnots,
+    eLocationField_Date,
+    eLocationField_Satellites,
+    eLocationField_Last
+} eLocationField_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(GNSS_API);
+static const osMutexAttr_t g_fix_mutex_attr = {
+    .name = FIX_MUTEX_ATTR_NAME
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osMutexId_t g_fix_mutex_id = NULL;
+static sNmeaFix_t g_fix = {0};
+static sGnssStats_t g_stats = {0};
+static bool g_is_running = false;
+static char g_location_line[LOCATION_LINE_SIZE];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool GNSS_API_ParseLocation (char *line, sNmeaFix_t *fix);
+static void GNSS_API_OnLocation (sString_t location);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool GNSS_API_ParseLocation (char *line, sNmeaFix_t *fix) {
+    char *fields[eLocationField_Last] = {0};
+    size_t field_count = 0;
+
+    while (*line == ' ') {
+        line++;
+    }
+
+    fields[field_count++] = line;
+
+    for (char *cursor = line; *cursor != '\0'; cursor++) {
+        if ((*cursor == '\r') || (*cursor == '\n')) {
+            *cursor = '\0';
+            break;
+        }
+
+        if (*cursor == LOCATION_FIELD_SEPARATOR) {
+            *cursor = '\0';
+
+            if (field_count == eLocationField_Last) {
+                return false;
+            }
+
+            fields[field_count++] = cursor + 1;
+        }
+    }
+
+    if (field_count != LOCATION_FIELD_COUNT) {
+        return false;
+    }
+
+    int32_t value = 0;
+
+    if ((NmeaParser_ParseTime(fields[eLocationField_Time], &fix->time_ms) == false) ||
+        (NmeaParser_ParseFixed(fields[eLocationField_Latitude], DEGREE_DECIMALS, &fix->latitude) == false) ||
+        (NmeaParser_ParseFixed(fields[eLocationField_Longitude], DEGREE_DECIMALS, &fix->longitude) == false)) {
+        return false;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_Hdop], VALUE_DECIMALS, &value) && (value >= 0)) {
+        fix->hdop = (uint16_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_Altitude], VALUE_DECIMALS, &value)) {
+        fix->altitude = value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_FixType], 0, &value) && (value >= 0)) {
+        fix->fix_type = (uint8_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_Course], VALUE_DECIMALS, &value) && (value >= 0)) {
+        fix->course = (uint16_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_SpeedKmh], SPEED_DECIMALS, &value) && (value >= 0)) {
+        fix->speed = (uint16_t) KMH_E3_TO_SPEED(value);
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_Date], 0, &value) && (value >= 0)) {
+        fix->date = (uint32_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[eLocationField_Satellites], 0, &value) && (value >= 0)) {
+        fix->satellites_used = (uint8_t) value;
+    }
+
+    /* The engine only answers +QGPSLOC once it has a position, there is no separate quality field. */
+    fix->quality = 1;
+    fix->is_valid = true;
+
+    return true;
+}
+
+/* Runs in the modem receive task, so it only parses and copies. */
+static void GNSS_API_OnLocation (sString_t location) {
+    size_t line_size = (location.size < (LOCATION_LINE_SIZE - 1)) ? location.size : (LOCATION_LINE_SIZE - 1);
+
+    memcpy(g_location_line, location.str, line_size);
+    g_location_line[line_size] = '\0';
+
+    sNmeaFix_t fix = {0};
+    if (GNSS_API_ParseLocation(g_location_line, &fix) == false) {
+        g_stats.parse_errors++;
+        return;
+    }
+
+    if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) != osOK) {
+        return;
+    }
+
+    g_fix = fix;
+    g_stats.fixes++;
+
+    osMutexRelease(g_fix_mutex_id);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool GNSS_API_Init (void) {
+    if (g_fix_mutex_id == NULL) {
+        g_fix_mutex_id = osMutexNew(&g_fix_mutex_attr);
+        if (g_fix_mutex_id == NULL) {
+            DEBUG_ERROR("Failed to create the GNSS fix mutex!\r\n");
+            return false;
+        }
+    }
+
+    if (Modem_API_SetLocationCallback(&GNSS_API_OnLocation) == false) {
+        DEBUG_ERROR("Failed to register the location callback!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+eModemError_t GNSS_API_Start (void) {
+    if (Modem_API_GetState() != eModemState_Initialized) {
+        return eModemError_InvalidState;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    Modem_API_ReportCmeError(CME_ERROR_NONE);
+
+    eModemError_t error_type = Modem_API_SendChannelCommand(eModemChannel_Gnss, eModemCommands_QGPS, eModemFlags_ResponseOK,
+                                                            GNSS_ON_PARAMETERS, sizeof(GNSS_ON_PARAMETERS));
+
+    /* An engine left running by an earlier session is as good as a fresh start. */
+    if ((error_type != eModemError_ATSuccess) && (Modem_API_GetLastCmeError() == CME_ERROR_SESSION_ONGOING)) {
+        error_type = eModemError_ATSuccess;
+    }
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to start the GNSS engine!\r\n");
+        return error_type;
+    }
+
+    g_is_running = true;
+    DEBUG_INFO("GNSS engine started\r\n");
+
+    return eModemError_ATSuccess;
+}
+
+eModemError_t GNSS_API_Stop (void) {
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    Modem_API_ReportCmeError(CME_ERROR_NONE);
+
+    eModemError_t error_type = Modem_API_SendChannelCommand(eModemChannel_Gnss, eModemCommands_QGPSEND, eModemFlags_ResponseOK,
+                                                            GNSS_OFF_PARAMETERS, sizeof(GNSS_OFF_PARAMETERS));
+
+    if ((error_type != eModemError_ATSuccess) && (Modem_API_GetLastCmeError() == CME_ERROR_SESSION_NOT_ACTIVE)) {
+        error_type = eModemError_ATSuccess;
+    }
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to stop the GNSS engine!\r\n");
+        return error_type;
+    }
+
+    g_is_running = false;
+
+    if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) == osOK) {
+        g_fix.is_valid = false;
+        osMutexRelease(g_fix_mutex_id);
+    }
+
+    return eModemError_ATSuccess;
+}
+
+bool GNSS_API_IsRunning (void) {
+    return g_is_running;
+}
+
+eModemError_t GNSS_API_PollLocation (void) {
+    if ((g_is_running == false) || (Modem_API_GetState() != eModemState_Initialized)) {
+        return eModemError_InvalidState;
+    }
+
+    /* Sockets own the modem, a poll never queues up behind or in front of a send. */
+    if (Modem_API_TryLockModem() == false) {
+        g_stats.busy++;
+        return eModemError_ResourceBusy;
+    }
+
+    g_stats.polls++;
+    Modem_API_ReportCmeError(CME_ERROR_NONE);
+
+    eModemError_t error_type = Modem_API_SendChannelCommand(eModemChannel_Gnss, eModemCommands_QGPSLOC, eModemFlags_Location,
+                                                            LOCATION_MODE_PARAMETERS, sizeof(LOCATION_MODE_PARAMETERS));
+    int cme_error = Modem_API_GetLastCmeError();
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type == eModemError_ATSuccess) {
+        return eModemError_ATSuccess;
+    }
+
+    if (cme_error == CME_ERROR_NOT_FIXED) {
+        g_stats.no_fix++;
+
+        if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) == osOK) {
+            g_fix.is_valid = false;
+            osMutexRelease(g_fix_mutex_id);
+        }
+    } else if (cme_error == CME_ERROR_SESSION_NOT_ACTIVE) {
+        /* The modem was power cycled under us, the engine has to be started again. */
+        g_is_running = false;
+    }
+
+    return error_type;
+}
+
+bool GNSS_API_GetFix (sNmeaFix_t *fix) {
+    if (fix == NULL) {
+        return false;
+    }
+
+    if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) != osOK) {
+        return false;
+    }
+
+    *fix = g_fix;
+
+    osMutexRelease(g_fix_mutex_id);
+
+    return fix->is_valid;
+}
+
+bool GNSS_API_GetStats (sGnssStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    *stats = g_stats;
+
+    return true;
+}
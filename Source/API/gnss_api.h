@@ -0,0 +1,39 @@
+#ifndef SOURCE_API_GNSS_API_H_
+#define SOURCE_API_GNSS_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "error_codes.h"
+#include "nmea_parser.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sGnssStats {
+    uint32_t polls;
+    uint32_t fixes;
+    uint32_t no_fix;
+    uint32_t busy;
+    uint32_t parse_errors;
+} sGnssStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool GNSS_API_Init (void);
+eModemError_t GNSS_API_Start (void);
+eModemError_t GNSS_API_Stop (void);
+bool GNSS_API_IsRunning (void);
+/* Never waits for the modem, returns eModemError_ResourceBusy when someone else holds it */
+eModemError_t GNSS_API_PollLocation (void);
+bool GNSS_API_GetFix (sNmeaFix_t *fix);
+bool GNSS_API_GetStats (sGnssStats_t *stats);
+#endif /* SOURCE_API_GNSS_API_H_ */
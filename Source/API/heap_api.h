@@ -1,28 +1,34 @@
-#ifndef SOURCE_API_HEAP_API_H_
-#define SOURCE_API_HEAP_API_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdint.h>
-#include <stdlib.h>
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-bool Heap_API_Init (void);
-void *Heap_API_Malloc (size_t element_size);
-void *Heap_API_Calloc (size_t num_elements, size_t element_size);
-void Heap_API_Free (void *mem_ptr);
-#endif /* SOURCE_API_HEAP_API_H_ */
+#ifndef SOURCE_API_HEAP_API_H_
+#define SOURCE_API_HEAP_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sHeapApiStats {
+    size_t arena;
+    size_t used;
+    size_t free;
+} sHeapApiStats_t;
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool Heap_API_Init (void);
+void *Heap_API_Malloc (size_t element_size);
+void *Heap_API_Calloc (size_t num_elements, size_t element_size);
+void Heap_API_Free (void *mem_ptr);
+bool Heap_API_GetStats (sHeapApiStats_t *stats);
+#endif /* SOURCE_API_HEAP_API_H_ */
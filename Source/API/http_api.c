@@ -0,0 +1,181 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "debug_api.h"
+#include "modem_api.h"
+#include "tcp_api.h"
+#include "flash_driver.h"
+#include "http_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define RECV_TIMEOUT_MS 5000
+#define CHUNK_SIZE 512
+#define HTTP_HEADER_SIZE 512
+#define HTTP_REQUEST_FORMAT "GET %s HTTP/1.0\r\nHost: %s\r\nConnection: close\r\n\r\n"
+#define HTTP_HEADER_END "\r\n\r\n"
+#define HTTP_LINE_END "\r\n"
+#define HTTP_STATUS_PREFIX "HTTP/1."
+#define HTTP_STATUS_OK " 200"
+#define HTTP_CONTENT_LENGTH "Content-Length:"
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(HTTP_API);
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static char g_chunk[CHUNK_SIZE];
+static char g_http_header[HTTP_HEADER_SIZE];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool HTTP_API_ParseHeader (const char *header, uint32_t *content_length);
+static bool HTTP_API_ReceiveBody (eServerId_t connect_id, eFlashDriverSector_t sector, size_t offset, uint32_t *file_size);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool HTTP_API_ParseHeader (const char *header, uint32_t *content_length) {
+    if ((strncmp(header, HTTP_STATUS_PREFIX, sizeof(HTTP_STATUS_PREFIX) - 1) != 0) ||
+        (strncmp(&header[sizeof(HTTP_STATUS_PREFIX)], HTTP_STATUS_OK, sizeof(HTTP_STATUS_OK) - 1) != 0)) {
+        DEBUG_WARN("Server refused the request: %.20s\r\n", header);
+        return false;
+    }
+
+    for (const char *line = strstr(header, HTTP_LINE_END); line != NULL; line = strstr(line, HTTP_LINE_END)) {
+        line += sizeof(HTTP_LINE_END) - 1;
+
+        if (strncasecmp(line, HTTP_CONTENT_LENGTH, sizeof(HTTP_CONTENT_LENGTH) - 1) != 0) {
+            continue;
+        }
+
+        const char *value = line + sizeof(HTTP_CONTENT_LENGTH) - 1;
+        uint32_t length = 0;
+
+        while (*value == ' ') {
+            value++;
+        }
+
+        while ((*value >= '0') && (*value <= '9')) {
+            length = (length * 10) + (*value - '0');
+            value++;
+        }
+
+        *content_length = length;
+
+        return (length > 0);
+    }
+
+    DEBUG_WARN("Server did not send the file size!\r\n");
+
+    return false;
+}
+
+/* Splits the HTTP header off and streams the body straight into flash. */
+static bool HTTP_API_ReceiveBody (eServerId_t connect_id, eFlashDriverSector_t sector, size_t offset, uint32_t *file_size) {
+    size_t max_size = Flash_Driver_GetSectorSize(sector) - offset;
+    size_t header_size = 0;
+    bool is_header_done = false;
+    uint32_t content_length = 0;
+    uint32_t received = 0;
+
+    while ((is_header_done == false) || (received < content_length)) {
+        size_t chunk_size = TCP_API_Recv(connect_id, g_chunk, CHUNK_SIZE, RECV_TIMEOUT_MS);
+        if (chunk_size == 0) {
+            DEBUG_WARN("Download stalled after %lu bytes!\r\n", received);
+            return false;
+        }
+
+        const char *body = g_chunk;
+        size_t body_size = chunk_size;
+
+        if (is_header_done == false) {
+            size_t copy_size = HTTP_HEADER_SIZE - 1 - header_size;
+            copy_size = (chunk_size < copy_size) ? chunk_size : copy_size;
+
+            memcpy(&g_http_header[header_size], g_chunk, copy_size);
+            header_size += copy_size;
+            g_http_header[header_size] = '\0';
+
+            char *header_end = strstr(g_http_header, HTTP_HEADER_END);
+            if (header_end == NULL) {
+                if (header_size == (HTTP_HEADER_SIZE - 1)) {
+                    DEBUG_WARN("Server header is too long!\r\n");
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (HTTP_API_ParseHeader(g_http_header, &content_length) == false) {
+                return false;
+            }
+
+            if (content_length > max_size) {
+                DEBUG_WARN("File of %lu bytes does not fit into flash!\r\n", content_length);
+                return false;
+            }
+
+            size_t header_in_chunk = (size_t) (header_end - g_http_header) + sizeof(HTTP_HEADER_END) - 1 -
+                                     (header_size - copy_size);
+            body = &g_chunk[header_in_chunk];
+            body_size = chunk_size - header_in_chunk;
+            is_header_done = true;
+        }
+
+        if (body_size > (content_length - received)) {
+            body_size = content_length - received;
+        }
+
+        if ((body_size > 0) && (Flash_Driver_Program(sector, offset + received, body, body_size) == false)) {
+            DEBUG_ERROR("Failed to store the downloaded data!\r\n");
+            return false;
+        }
+
+        received += body_size;
+    }
+
+    *file_size = received;
+
+    return true;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+eModemError_t HTTP_API_Download (eServerId_t connect_id, char *host, size_t port, const char *path,
+                                 eFlashDriverSector_t sector, size_t offset, uint32_t *file_size) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || (host == NULL) || (path == NULL) ||
+        (file_size == NULL) || (offset >= Flash_Driver_GetSectorSize(sector))) {
+        return eModemError_InvalidParameters;
+    }
+
+    eModemError_t error_type = TCP_API_OpenStream(connect_id, host, port);
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to reach %s!\r\n", host);
+        return error_type;
+    }
+
+    TCP_API_FlushRecv(connect_id);
+
+    size_t request_size = snprintf(g_chunk, CHUNK_SIZE, HTTP_REQUEST_FORMAT, path, host);
+
+    bool is_received = (request_size < CHUNK_SIZE) &&
+                       (TCP_API_StreamWrite(g_chunk, request_size) == eModemError_ATSuccess) &&
+                       HTTP_API_ReceiveBody(connect_id, sector, offset, file_size);
+
+    TCP_API_CloseStream(Modem_API_IsMultiplexed() ? eStreamExit_EscapeSequence : eStreamExit_Dtr);
+    TCP_API_Disconnect(connect_id);
+
+    return is_received ? eModemError_ATSuccess : eModemError_ReceptionFail;
+}
@@ -0,0 +1,31 @@
+#ifndef SOURCE_API_HTTP_API_H_
+#define SOURCE_API_HTTP_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "error_codes.h"
+#include "tcp_app.h"
+#include "flash_driver.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* HTTP/1.0 GET over a transparent stream, the body goes straight into the sector from offset on. The sector has to be
+ * erased by the caller and the socket has to be free, it is closed again before returning. */
+eModemError_t HTTP_API_Download (eServerId_t connect_id, char *host, size_t port, const char *path,
+                                 eFlashDriverSector_t sector, size_t offset, uint32_t *file_size);
+#endif /* SOURCE_API_HTTP_API_H_ */
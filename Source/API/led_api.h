@@ -1,35 +1,35 @@
-#ifndef __SOMETHING__H__
-#define __SOMETHING__H__
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdlib.h>
-//#include <cli_commands.h>
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-typedef enum eLed {
-    eLed_First = 1,
-    eLed_Status = eLed_First,
-    eLed_GpsFix,
-    eLed_Last
-} eLed_t;
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-bool LED_API_LedInit (void);
-bool LED_API_LedOn (eLed_t led);
-bool LED_API_LedOff (eLed_t led);
-bool LED_API_LedToggle (eLed_t led);
-bool LED_API_LedBlink (eLed_t led, size_t blink_freq, size_t num_blinks, void (*callback_func)(eLed_t led));
-uint32_t LED_API_GetTimerValue (eLed_t led);
-#endif /* __SOMETHING__H__ */
+#ifndef __SOMETHING__H__
+#define __SOMETHING__H__
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdlib.h>
+//#include <cli_commands.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eLed {
+    eLed_First = 1,
+    eLed_Status = eLed_First,
+    eLed_GpsFix,
+    eLed_Last
+} eLed_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool LED_API_LedInit (void);
+bool LED_API_LedOn (eLed_t led);
+bool LED_API_LedOff (eLed_t led);
+bool LED_API_LedToggle (eLed_t led);
+bool LED_API_LedBlink (eLed_t led, size_t blink_freq, size_t num_blinks, void (*callback_func)(eLed_t led));
+uint32_t LED_API_GetTimerValue (eLed_t led);
+#endif /* __SOMETHING__H__ */
@@ -0,0 +1,261 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_api.h"
+#include "power_api.h"
+#include "metrics_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define METRICS_MUTEX_ATTR_NAME "MetricsMutex"
+#define METRICS_TIMER_ATTR_NAME "MetricsTimer"
+#define METRICS_MUTEX_TIMEOUT 100
+#define SAMPLE_PERIOD_MS 1000U
+/* The window is the span between the oldest and the newest sample */
+#define WINDOW_SAMPLES 10U
+#define SAMPLE_RING_SIZE (WINDOW_SAMPLES + 1U)
+#define PERMILLE 1000U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sMetricsSample {
+    uint32_t total;
+    uint32_t stop_time;
+    size_t count;
+    uint32_t number[METRICS_API_MAX_TASKS];
+    uint32_t run_time[METRICS_API_MAX_TASKS];
+} sMetricsSample_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const osMutexAttr_t g_metrics_mutex_attr = {
+    .name = METRICS_MUTEX_ATTR_NAME
+};
+static const osTimerAttr_t g_metrics_timer_attr = {
+    .name = METRICS_TIMER_ATTR_NAME
+};
+/* Indexed by eTaskState */
+static const char g_task_state_lut[] = {'X', 'R', 'B', 'S', 'D', '?'};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osMutexId_t g_metrics_mutex_id = NULL;
+static osTimerId_t g_metrics_timer_id = NULL;
+/* Only the timer task touches the raw status and the samples */
+static TaskStatus_t g_task_status[METRICS_API_MAX_TASKS];
+static sMetricsSample_t g_samples[SAMPLE_RING_SIZE];
+static size_t g_sample_newest = 0;
+static size_t g_sample_count = 0;
+/* The result of the last sample, guarded by the mutex */
+static sMetricsTask_t g_tasks[METRICS_API_MAX_TASKS];
+static size_t g_task_count = 0;
+static uint32_t g_window_us = 0;
+static uint16_t g_cpu_load = 0;
+static uint16_t g_sleep = 0;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Metrics_API_OnTimer (void *arg);
+static uint32_t Metrics_API_GetBaseRunTime (const sMetricsSample_t *base, uint32_t number);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* A task missing from the base sample was created within the window, its counter started at zero. */
+static uint32_t Metrics_API_GetBaseRunTime (const sMetricsSample_t *base, uint32_t number) {
+    if (base == NULL) {
+        return 0;
+    }
+
+    for (size_t index = 0; index < base->count; index++) {
+        if (base->number[index] == number) {
+            return base->run_time[index];
+        }
+    }
+
+    return 0;
+}
+
+/* Runs in the timer task, which is never kept waiting on a reader. */
+static void Metrics_API_OnTimer (void *arg) {
+    uint32_t total = 0;
+    UBaseType_t count = uxTaskGetSystemState(g_task_status, METRICS_API_MAX_TASKS, &total);
+
+    if (count == 0) {
+        return;
+    }
+
+    size_t newest = (g_sample_newest + 1U) % SAMPLE_RING_SIZE;
+    sMetricsSample_t *sample = &g_samples[newest];
+
+    sample->total = total;
+    sample->stop_time = Power_API_GetStopTime();
+    sample->count = count;
+
+    for (size_t index = 0; index < count; index++) {
+        sample->number[index] = g_task_status[index].xTaskNumber;
+        sample->run_time[index] = g_task_status[index].ulRunTimeCounter;
+    }
+
+    g_sample_newest = newest;
+
+    if (g_sample_count < SAMPLE_RING_SIZE) {
+        g_sample_count++;
+    }
+
+    /* Until there is a second sample the share is taken since boot */
+    const sMetricsSample_t *base = NULL;
+    uint32_t base_total = 0;
+    uint32_t base_stop_time = 0;
+
+    if (g_sample_count > 1U) {
+        base = &g_samples[(newest + SAMPLE_RING_SIZE - (g_sample_count - 1U)) % SAMPLE_RING_SIZE];
+        base_total = base->total;
+        base_stop_time = base->stop_time;
+    }
+
+    uint32_t window = total - base_total;
+    /* The run time counter carries on through a Stop, so the time in it is part of the window */
+    uint64_t sleep = (window == 0) ? 0 : (((uint64_t) (sample->stop_time - base_stop_time) * PERMILLE) / window);
+
+    if (osMutexAcquire(g_metrics_mutex_id, 0) != osOK) {
+        return;
+    }
+
+    uint16_t idle_permille = 0;
+
+    for (size_t index = 0; index < count; index++) {
+        TaskStatus_t *status = &g_task_status[index];
+        sMetricsTask_t *task = &g_tasks[index];
+        uint32_t run_time = status->ulRunTimeCounter - Metrics_API_GetBaseRunTime(base, status->xTaskNumber);
+        uint64_t permille = (window == 0) ? 0 : (((uint64_t) run_time * PERMILLE) / window);
+
+        strncpy(task->name, status->pcTaskName, sizeof(task->name) - 1U);
+        task->name[sizeof(task->name) - 1U] = '\0';
+        task->number = status->xTaskNumber;
+        task->priority = status->uxCurrentPriority;
+        task->state = g_task_state_lut[(status->eCurrentState < eInvalid) ? status->eCurrentState : eInvalid];
+        task->cpu_permille = (uint16_t) ((permille > PERMILLE) ? PERMILLE : permille);
+        task->stack_free = status->usStackHighWaterMark * sizeof(StackType_t);
+
+        if (strcmp(status->pcTaskName, configIDLE_TASK_NAME) == 0) {
+            idle_permille = task->cpu_permille;
+        }
+    }
+
+    g_task_count = count;
+    g_window_us = window;
+    g_cpu_load = (uint16_t) (PERMILLE - idle_permille);
+    g_sleep = (uint16_t) ((sleep > PERMILLE) ? PERMILLE : sleep);
+
+    osMutexRelease(g_metrics_mutex_id);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Metrics_API_Init (void) {
+    if (g_metrics_mutex_id == NULL) {
+        g_metrics_mutex_id = osMutexNew(&g_metrics_mutex_attr);
+        if (g_metrics_mutex_id == NULL) {
+            return false;
+        }
+    }
+
+    if (g_metrics_timer_id == NULL) {
+        g_metrics_timer_id = osTimerNew(&Metrics_API_OnTimer, osTimerPeriodic, NULL, &g_metrics_timer_attr);
+        if (g_metrics_timer_id == NULL) {
+            return false;
+        }
+    }
+
+    return (osTimerStart(g_metrics_timer_id, SAMPLE_PERIOD_MS) == osOK);
+}
+
+bool Metrics_API_GetTasks (sMetricsTask_t *tasks, size_t max_tasks, size_t *count, uint32_t *window_us) {
+    if ((tasks == NULL) || (count == NULL) || (g_metrics_mutex_id == NULL)) {
+        return false;
+    }
+
+    if (osMutexAcquire(g_metrics_mutex_id, METRICS_MUTEX_TIMEOUT) != osOK) {
+        return false;
+    }
+
+    *count = (g_task_count < max_tasks) ? g_task_count : max_tasks;
+    memcpy(tasks, g_tasks, *count * sizeof(sMetricsTask_t));
+
+    if (window_us != NULL) {
+        *window_us = g_window_us;
+    }
+
+    osMutexRelease(g_metrics_mutex_id);
+
+    return true;
+}
+
+bool Metrics_API_GetCpuLoad (uint16_t *load_permille) {
+    if ((load_permille == NULL) || (g_metrics_mutex_id == NULL)) {
+        return false;
+    }
+
+    if (osMutexAcquire(g_metrics_mutex_id, METRICS_MUTEX_TIMEOUT) != osOK) {
+        return false;
+    }
+
+    *load_permille = g_cpu_load;
+
+    osMutexRelease(g_metrics_mutex_id);
+
+    return true;
+}
+
+bool Metrics_API_GetSleep (uint16_t *sleep_permille) {
+    if ((sleep_permille == NULL) || (g_metrics_mutex_id == NULL)) {
+        return false;
+    }
+
+    if (osMutexAcquire(g_metrics_mutex_id, METRICS_MUTEX_TIMEOUT) != osOK) {
+        return false;
+    }
+
+    *sleep_permille = g_sleep;
+
+    osMutexRelease(g_metrics_mutex_id);
+
+    return true;
+}
+
+bool Metrics_API_GetHeap (sMetricsHeap_t *heap) {
+    if (heap == NULL) {
+        return false;
+    }
+
+    HeapStats_t rtos_stats;
+    sHeapApiStats_t libc_stats = {0};
+
+    vPortGetHeapStats(&rtos_stats);
+
+    heap->rtos_free = rtos_stats.xAvailableHeapSpaceInBytes;
+    heap->rtos_min_free = rtos_stats.xMinimumEverFreeBytesRemaining;
+    heap->rtos_largest_block = rtos_stats.xSizeOfLargestFreeBlockInBytes;
+    heap->rtos_free_blocks = rtos_stats.xNumberOfFreeBlocks;
+    heap->rtos_allocations = rtos_stats.xNumberOfSuccessfulAllocations;
+    heap->rtos_frees = rtos_stats.xNumberOfSuccessfulFrees;
+
+    /* Left at zero until the first UART brings the libc heap lock up */
+    Heap_API_GetStats(&libc_stats);
+
+    heap->libc_arena = libc_stats.arena;
+    heap->libc_used = libc_stats.used;
+    heap->libc_free = libc_stats.free;
+
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef SOURCE_API_METRICS_API_H_
+#define SOURCE_API_METRICS_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define METRICS_API_MAX_TASKS 20
+#define METRICS_API_TASK_NAME_SIZE 16
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sMetricsTask {
+    char name[METRICS_API_TASK_NAME_SIZE];
+    uint32_t number;
+    uint32_t priority;
+    char state;
+    /* Share of the CPU over the window, in tenths of a percent */
+    uint16_t cpu_permille;
+    /* Least free stack the task ever had, in bytes */
+    uint32_t stack_free;
+} sMetricsTask_t;
+
+typedef struct sMetricsHeap {
+    size_t rtos_free;
+    size_t rtos_min_free;
+    size_t rtos_largest_block;
+    size_t rtos_free_blocks;
+    size_t rtos_allocations;
+    size_t rtos_frees;
+    size_t libc_arena;
+    size_t libc_used;
+    size_t libc_free;
+} sMetricsHeap_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool Metrics_API_Init (void);
+/* The tasks as of the last sample, window_us is the span their CPU share was measured over. */
+bool Metrics_API_GetTasks (sMetricsTask_t *tasks, size_t max_tasks, size_t *count, uint32_t *window_us);
+/* Everything but the idle task over the same window, in tenths of a percent */
+bool Metrics_API_GetCpuLoad (uint16_t *load_permille);
+/* Time spent in Stop over the same window, in tenths of a percent, part of what the idle task is charged with */
+bool Metrics_API_GetSleep (uint16_t *sleep_permille);
+bool Metrics_API_GetHeap (sMetricsHeap_t *heap);
+#endif /* SOURCE_API_METRICS_API_H_ */
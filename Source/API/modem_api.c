@@ -1,516 +1,924 @@
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdint.h>
-#include <stddef.h>
-#include <string.h>
-#include "cmsis_os2.h"
-#include "gpio_driver.h"
-#include "uart_driver.h"
-#include "message.h"
-#include "string_util.h"
-#include "uart_api.h"
-#include "debug_api.h"
-#include "heap_api.h"
-#include "cmd_api.h"
-#include "modem_api.h"
-#include "modem_api_commands.h"
-/**********************************************************************************************************************
-* Private definitions and macros
-*********************************************************************************************************************/
-#define APN_NAME "internet.tele2.lt"
-#define MODEM_BAUDRATE 115200
-#define MODEM_UART eUartApiDevice_Modem
-#define CMD_RECEPTION_TIMEOUT_MS 400
-#define SOCKET_CLOSE_TIMEOUT_MS 10000
-#define MODEM_API_SET_UP_MODEM_TASK_ATTR_NAME "SetUpModem"
-#define MODEM_API_RECEIVE_TASK_ATTR_NAME "ReceiveTask"
-#define MODEM_API_SET_UP_MODEM_TASK_STACK_SIZE 1024U
-#define MODEM_API_RECEIVE_TASK_STACK_SIZE 1024U
-#define NONE_THREAD_ARGUMENTS NULL
-#define UART_MODEM_COMMAND_HANDLE_MUTEX_ATTR_NAME "ComamndHandleMutex"
-#define MODEM_CONTROL_EVENT_FLAG_NAME "ModemControlFlag"
-#define FAILED_TO_CLEAR_FLAG "Failed to clear flag!\r\n"
-#define CMD(COMMAND) .command_name = #COMMAND, .command_name_size = sizeof(#COMMAND) - 1
-#define MODEM_SETUP_COMMAND(COMMAND) .str = #COMMAND, .size = sizeof(#COMMAND) - 1
-#define MODEM_AT_TABLE_SIZE 10
-#define NUMBER_OF_MODEM_SET_UP_COMMANDS (sizeof(g_modem_setup_commands) / sizeof(g_modem_setup_commands[0]))
-#define AT_COMMAND_BUFFER_SIZE 80
-#define AT_COMMAND_PARAMETERS_BUFFER_SIZE 60
-#define CLI_RESPONSE_BUFFER_SIZE 200
-#define MODEM_LOCK_TIMEOUT_MS 450
-/**********************************************************************************************************************
-* Private typedef
-*********************************************************************************************************************/
-typedef struct eModemResponseSpecs {
-    sString_t AT_command;
-    eModemCommands_t command_id; 
-} eATCommandsSpecs_t;
-/**********************************************************************************************************************
-* Private constants
-*********************************************************************************************************************/
-CREATE_MODULE_TAG (MODEM_API);
-static const osThreadAttr_t g_modem_api_setup_task_attr = {
-    .name = MODEM_API_SET_UP_MODEM_TASK_ATTR_NAME,
-    .stack_size = MODEM_API_SET_UP_MODEM_TASK_STACK_SIZE,
-    .priority = 25
-};
-static const osThreadAttr_t g_modem_api_receive_task_attr = {
-    .name = MODEM_API_RECEIVE_TASK_ATTR_NAME,
-    .stack_size = MODEM_API_RECEIVE_TASK_STACK_SIZE,
-    .priority = 25
-};
-static const osMutexAttr_t g_uart_modem_command_handle_attr = {
-    .name = UART_MODEM_COMMAND_HANDLE_MUTEX_ATTR_NAME
-};
-static const osEventFlagsAttr_t g_state_flag_attr = {
-    .name = MODEM_CONTROL_EVENT_FLAG_NAME
-};
-
-static const sCommandDescription_t g_modem_callback_function_lut[] = {
-    {.command_function = &Modem_API_CMD_OK, CMD(OK)},
-    {.command_function = &Modem_API_CMD_DisableEcho, CMD(ATE0)},
-    {.command_function = &Modem_API_CMD_Error, CMD(ERROR)},
-    {.command_function = &Modem_API_CMD_GetError, CMD(+QIGETERROR:)},
-    {.command_function = &Modem_API_CMD_NetworkRegStatus, CMD(+CEREG:)},
-    {.command_function = &Modem_API_CMD_AddressPDP, CMD(+CGPADDR:)},
-    {.command_function = &Modem_API_CMD_QIOPEN, CMD(+QIOPEN:)},
-    {.command_function = &Modem_API_CMD_ReadyToSend, CMD(>)},
-    {.command_function = &Modem_CMD_SendOk, CMD(SEND OK)},
-    {.command_function = &Modem_API_CMD_SendFail, CMD(SEND FAIL)},
-    {.command_function = &Modem_API_CMD_QIURC, CMD(+QIURC:)}
-};
-
-static char g_command_reply_buffer[CLI_RESPONSE_BUFFER_SIZE] = {0};
-
-static sBuffer_t g_response_buffer = {.str = g_command_reply_buffer, .size = CLI_RESPONSE_BUFFER_SIZE, .count = 0};
-
-static const sCommandLauncherArgs_t g_modem_cmd_launcher_params = {
-    .commands_table = g_modem_callback_function_lut,
-    .commands_table_size = sizeof(g_modem_callback_function_lut) / sizeof(g_modem_callback_function_lut[0]),
-    .response_buffer = &g_response_buffer
-};
-static const sString_t g_modem_setup_commands[] = {
-    {MODEM_SETUP_COMMAND(RDY)},
-    {MODEM_SETUP_COMMAND(+CFUN: 1)},
-    {MODEM_SETUP_COMMAND(+CPIN: READY)},
-    {MODEM_SETUP_COMMAND(+QUSIM: 1)},
-    {MODEM_SETUP_COMMAND(+QIND: SMS DONE)},
-    {MODEM_SETUP_COMMAND(+QIND: PB DONE)}
-};
-static const sString_t g_modem_AT_commands[eModemCommands_Last] = {
-    [eModemCommands_ATE0]       = {MODEM_SETUP_COMMAND(E)},
-    [eModemCommands_QICSGP]     = {MODEM_SETUP_COMMAND(+QICSGP=)},
-    [eModemCommands_QIACT]      = {MODEM_SETUP_COMMAND(+QIACT=)},
-    [eModemCommands_CEREG]      = {MODEM_SETUP_COMMAND(+CEREG)},
-    [eModemCommands_CGPADDR]    = {MODEM_SETUP_COMMAND(+CGPADDR=)},
-    [eModemCommands_QIGETERROR] = {MODEM_SETUP_COMMAND(+QIGET)}, 
-    [eModemCommands_QIOPEN]     = {MODEM_SETUP_COMMAND(+QIOPEN=)},
-    [eModemCommands_QISEND]     = {MODEM_SETUP_COMMAND(+QISEND=)},
-    [eModemCommands_QIURC]      = {MODEM_SETUP_COMMAND(+QIRD=)},
-    [eModemCommands_QICLOSE]    = {MODEM_SETUP_COMMAND(+QICLOSE=)}
-};
-static uint32_t g_modem_flags[eModemFlag_Last] = {
-    [eModemFlags_Ready]           = 0x01,          
-    [eModemFlags_ResponseOK]      = 0x02,     
-    [eModemFlags_EchoDisabled]    = 0x04,   
-    [eModemFlags_Error]           = 0x08,          
-    [eModemFlags_Registered]      = 0x10,     
-    [eModemFlags_ValidPDPAddress] = 0x20,
-    [eModemFlags_ServerOpen]      = 0x40,   
-    [eModemFlags_SendOK]          = 0x80,        
-    [eModemFlags_SendFail]        = 0x100,      
-    [eModemFlags_DataReceived]    = 0x200,  
-};
-/**********************************************************************************************************************
-* Private variables
-*********************************************************************************************************************/
-static osThreadId_t g_modem_api_setup_task_id = NULL;
-static osThreadId_t g_modem_api_receive_task_id = NULL;
-static osMutexId_t g_uart_modem_command_handle_id = NULL;
-static osEventFlagsId_t g_status_flag_id = NULL;
-static sString_t modem_command;
-static eModemState_t g_modem_state;
-static sString_t g_modem_message;
-static bool set_up_cmd_received = false;
-static uint32_t flag = 0;
-/**********************************************************************************************************************
-* Exported variables and references
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of private functions
-*********************************************************************************************************************/
-static void Modem_API_SetUpModem (void *args);
-static void Modem_API_ReceiveTask (void *args);
-static bool Modem_API_ClearFlagByCommand (eModemFlags_t command_flag);
-/**********************************************************************************************************************
-* Definitions of private functions
-*********************************************************************************************************************/
-static void Modem_API_SetUpModem (void *args) {
-    uint8_t cmd_count = 0;
-    char cmd_params_str[AT_COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
-    size_t cmd_params_size = 0;
-
-    while (1) {
-        switch (g_modem_state) {
-            case eModemState_TurnedOff: {
-                if (((GPIO_Driver_Write(eGPIODriver_ModemPowerOffPin, eGPIO_PinState_Low)) ||
-                    (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_High)) ||
-                    (GPIO_Driver_Write(eGPIODriver_Reset_NPin, eGPIO_PinState_High))) == false) {
-                    DEBUG_WARN("Failed to set the write pins in the second boot cycle!\r\n");
-                    break;
-                }
-
-                osDelay(10);
-
-                if (((GPIO_Driver_Write(eGPIODriver_ModemPowerOffPin, eGPIO_PinState_High)) ||
-                    (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_Low)) ||
-                    (GPIO_Driver_Write(eGPIODriver_Reset_NPin, eGPIO_PinState_Low))) == false) {
-                    DEBUG_WARN("Failed to set the write pins in the third boot cycle!\r\n");
-                    break;
-                }
-
-                osDelay(10);
-
-                if (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_High) == false) {
-                    DEBUG_WARN("Failed to set the write pin!\r\n");
-                    break;
-                }
-
-                osDelay(510);
-
-                if (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_Low) == false) {
-                    DEBUG_WARN("Failed to set the write pin!\r\n");
-                    break;
-                }
-
-                osDelay(13000);
-
-                if (((GPIO_Driver_Write(eGPIODriver_ModemUartDtrPin, eGPIO_PinState_Low)) || 
-                    (GPIO_Driver_Write(eGPIODriver_GnssOnPin, eGPIO_PinState_High))) == false) {
-                    DEBUG_WARN("Failed to set the write pins!\r\n");
-                    break;
-                }
-
-                g_modem_state = eModemState_TurnedOn;
-            }
-            case eModemState_TurnedOn: {
-                while (1) {
-                    if (UART_API_GetMessage(MODEM_UART, &modem_command, CMD_RECEPTION_TIMEOUT_MS) == false) {
-                        DEBUG_ERROR("Failed to receive commands after modem start up!\r\n");
-                        continue;
-                    }
-
-                    if (modem_command.size < 2) {
-                        Heap_API_Free(modem_command.str);
-                        continue;
-                    }
-                    
-                    for (uint8_t i = 0; i < NUMBER_OF_MODEM_SET_UP_COMMANDS; i++) {
-                        if (strncmp(modem_command.str, g_modem_setup_commands[i].str, g_modem_setup_commands[i].size) == 0) {
-                            set_up_cmd_received = true;
-                            cmd_count++;
-                            Heap_API_Free(modem_command.str);
-                            break;
-                        }
-                    }
-
-                    if ((set_up_cmd_received == true) && (cmd_count != NUMBER_OF_MODEM_SET_UP_COMMANDS)) {
-                        set_up_cmd_received = false;
-                        continue;
-                    }
-                    else if (cmd_count == NUMBER_OF_MODEM_SET_UP_COMMANDS) {
-                        flag = osEventFlagsSet(g_status_flag_id, g_modem_flags[eModemFlags_Ready]);
-                        if (flag >= osFlagsError) {
-                            DEBUG_ERROR("Failed to set the flag, error occured!\r\n");
-                        }
-                        g_modem_state = eModemState_Ready;
-                        break;
-                    }
-                    else {
-                        DEBUG_ERROR("Received incorrect command: %s, modem is not ready for a connection!\r\n", modem_command.str);
-                        g_modem_state = eModemState_TurnedOn;
-                        Heap_API_Free(modem_command.str);
-                        break;
-                    }
-                }
-            }    
-            case eModemState_Ready: {
-
-                if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
-                    DEBUG_ERROR("Failed to lock the modem!\r\n");
-                    break;
-                }
-                //ATE0: ECHO Disable
-                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "0") + 1;
-                while (Modem_API_SendCommand(eModemCommands_ATE0, eModemFlags_EchoDisabled, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-                    osDelay(1000);
-                    DEBUG_ERROR("Failed to disable ECHO mode, retrying!...\r\n");
-                }
-
-                //QICSGP: Define PDP context
-                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE,
-                                           "1,1,\"%s\",\"\",\"\",0", APN_NAME) + 1;
-                while (Modem_API_SendCommand(eModemCommands_QICSGP, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-                    osDelay(1000);
-                    DEBUG_INFO("Defining PDP context... !!!\r\n");
-                }
-
-                //QIACT: Activate PDP context
-                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "1") + 1;
-                while (Modem_API_SendCommand(eModemCommands_QIACT, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-                    osDelay(1000);
-                    DEBUG_INFO("Retrying PDP activation...!!\r\n");
-                }
-
-                osDelay(100);
-
-                //CEREG: Check Network registration status
-                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "?") + 1;
-                while (Modem_API_SendCommand(eModemCommands_CEREG, eModemFlags_Registered, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-                    osDelay(1000);
-                    DEBUG_INFO("Retrying network registration status identification procedure...!!\r\n");
-                }
-
-                //CGPADDR: Check PDP address
-                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "1") + 1;
-                while (Modem_API_SendCommand(eModemCommands_CGPADDR, eModemFlags_ValidPDPAddress, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-                    osDelay(1000);
-                    DEBUG_INFO("Retrying PDP address checking procedure...!!\r\n");
-                }
-
-                if (Modem_API_UnlockModem() == false) {
-                    DEBUG_ERROR("Failed to Unlock the modem!\r\n");
-                    break;
-                }
-
-                g_modem_state = eModemState_Initialized;
-                break;
-            }
-            default: {
-                DEBUG_ERROR("Unexpected modem state!\r\n");
-                g_modem_state = eModemState_TurnedOff;
-                break;
-            }
-        }
-
-        if (g_modem_state == eModemState_Initialized) {
-            DEBUG_INFO("Modem is ready for connection!\r\n");
-            break;
-        }
-        else {
-            DEBUG_INFO("Modem is not setup correctly, retrying the process! ...\r\n");
-            osDelay(5000);
-            continue;
-        }
-    }
-
-    osThreadExit();
-}
-
-static void Modem_API_ReceiveTask (void *args) {
-
-    flag = osEventFlagsWait(g_status_flag_id, g_modem_flags[eModemFlags_Ready], osFlagsNoClear, osWaitForever);
-    if (flag >= osFlagsError) {
-        DEBUG_ERROR("Error occured while waiting for modem entering the ready state!\r\n");
-        osThreadExit();
-    }
-
-    while (1) {
-        if (UART_API_GetMessage(MODEM_UART, &g_modem_message, CMD_RECEPTION_TIMEOUT_MS) == false) {
-            continue;
-        }
-
-        if (g_modem_message.size < 2) {
-            Heap_API_Free(g_modem_message.str);
-            continue;
-        }
-
-        if (CMD_API_Launcher(g_modem_message, &g_modem_cmd_launcher_params) == false) {
-            DEBUG_WARN("%s", g_response_buffer);
-        } else {
-            DEBUG_INFO("%s", g_response_buffer);
-        }
-
-        Heap_API_Free(g_modem_message.str);
-    }
-}
-
-static bool Modem_API_ClearFlagByCommand (eModemFlags_t command_flag) {
-    bool is_flag_cleared = true;
-    is_flag_cleared = Modem_API_ClearFlag(command_flag) && Modem_API_ClearFlag(eModemFlags_Error) &&
-                      Modem_API_ClearFlag(eModemFlags_ResponseOK);
-
-    return is_flag_cleared;
-}
-/**********************************************************************************************************************
-* Definitions of exported functions
-*********************************************************************************************************************/
-bool Modem_API_Init (void) {
-    g_modem_state = eModemState_TurnedOff;
-
-    sString_t delimiter = (sString_t)DEFINE_STRING("\r\n");
-    if (UART_API_Init(MODEM_UART, MODEM_BAUDRATE, delimiter) == false) {
-        DEBUG_ERROR("Failed to initialize modem uart api function!\r\n");
-        return false;
-    }
-
-    if (g_uart_modem_command_handle_id == NULL) {
-        g_uart_modem_command_handle_id = osMutexNew(&g_uart_modem_command_handle_attr);
-        if (g_uart_modem_command_handle_id == NULL) {
-            DEBUG_ERROR("Failed to create mutex for modem command handling!\r\n");
-            return false;
-        }
-    }
-
-    if (g_status_flag_id == NULL) {
-        g_status_flag_id = osEventFlagsNew(&g_state_flag_attr);
-        if (g_status_flag_id == NULL) {
-            DEBUG_ERROR("Failed to create an event flag for modem state indication!\r\n");
-            return false;
-        }
-    }
-
-    if (g_modem_api_setup_task_id == NULL) {
-        g_modem_api_setup_task_id = osThreadNew(&Modem_API_SetUpModem, 
-                                                NONE_THREAD_ARGUMENTS,
-                                                &g_modem_api_setup_task_attr);
-        if (g_modem_api_setup_task_id == NULL) {
-            DEBUG_ERROR("Failed to create thread for setting up the modem!\r\n");
-            return false;
-        }
-    }
-
-    if (g_modem_api_receive_task_id == NULL) {
-        g_modem_api_receive_task_id = osThreadNew(&Modem_API_ReceiveTask,
-                                                  NONE_THREAD_ARGUMENTS,
-                                                  &g_modem_api_receive_task_attr);
-        if (g_modem_api_receive_task_id == NULL) {
-            DEBUG_ERROR("Failed to create thread for AT command processing!\r\n");
-            return false;
-        }
-    }
-
-    return true;
-}
-
-eModemError_t Modem_API_SendCommand (eModemCommands_t AT_command, eModemFlags_t command_flag, char *cmd_params_string, size_t cmd_params_size) {
-    eModemError_t error_type = eModemError_ATSuccess;
-
-    if ((AT_command < eModemCommands_First) || (AT_command >= eModemCommands_Last) || 
-        (cmd_params_string == NULL) || (cmd_params_size == 0)) {
-        DEBUG_ERROR("Invalid AT command or its parameters!\r\n");
-        return eModemError_InvalidParameters;
-    }
-
-    if (Modem_API_ClearFlagByCommand(command_flag) == false) {
-        return eModemError_ClearFlagFail;
-    }
-
-    sString_t formatted_AT_command;
-    formatted_AT_command.str = (char *) Heap_API_Calloc(AT_COMMAND_BUFFER_SIZE, sizeof(char));
-
-    if (formatted_AT_command.str == NULL) {
-        DEBUG_ERROR("Failed to allocate space for AT command!\r\n");
-        return eModemError_MemoryAllocationFail;
-    }
-
-    formatted_AT_command.size = snprintf(formatted_AT_command.str, AT_COMMAND_BUFFER_SIZE, "AT%s%s\r\n", 
-                                         g_modem_AT_commands[AT_command].str, cmd_params_string) + 1;
-
-    if ((formatted_AT_command.size == 0) || (formatted_AT_command.str == NULL)) {
-        error_type = eModemError_InvalidParameters;
-    }
-
-    if (UART_API_SendMessage(MODEM_UART, formatted_AT_command) == false) {
-        DEBUG_ERROR("Failed to send %s command!\r\n", formatted_AT_command.str);
-        error_type = eModemError_SendFail;
-    }
-
-    if (AT_command != eModemCommands_QISEND) {
-        uint32_t timeout_ms = ((AT_command == eModemCommands_QICLOSE) || (AT_command == eModemCommands_QIGETERROR)) ? 
-                               SOCKET_CLOSE_TIMEOUT_MS : CMD_RECEPTION_TIMEOUT_MS;
-        uint32_t flags = osEventFlagsWait(g_status_flag_id, g_modem_flags[eModemFlags_Error] | g_modem_flags[command_flag], 
-                                          osFlagsWaitAny, timeout_ms);
-        if (flags >= osFlagsError) {
-            DEBUG_INFO("Wait flag event failed!\r\n");
-            error_type = eModemError_WaitFlagFail;
-        }
-    }
-
-    Heap_API_Free(formatted_AT_command.str);
-
-    return error_type;
-}
-
-bool Modem_API_SetFlag (eModemFlags_t flag_to_set) {
-    if ((flag_to_set < eModemFlags_First) || (flag_to_set >= eModemFlag_Last)) {
-        DEBUG_ERROR("Invalid flag is passed!\r\n");
-        return false;
-    }
-
-    uint32_t flag_check = osEventFlagsSet(g_status_flag_id, g_modem_flags[flag_to_set]);
-    if (flag_check >= osFlagsError) {
-        DEBUG_ERROR("Fail occured in setting the flag!\r\n");
-        return false;
-    }
-
-    return true;
-}
-
-bool Modem_API_IsFlagSet (eModemFlags_t flag_to_check) {
-    if ((flag_to_check < eModemFlags_First) || (flag_to_check >= eModemFlag_Last)) {
-        DEBUG_ERROR("Invalid flag is passed!\r\n");
-        return false;
-    }
-
-    if ((osEventFlagsGet(g_status_flag_id) & g_modem_flags[flag_to_check]) > 0) {
-        return true;
-    }
-    else {
-        return false;
-    }
-}
-
-bool Modem_API_ClearFlag (eModemFlags_t flag_to_clear) {
-    if ((flag_to_clear < eModemFlags_First) || (flag_to_clear >= eModemFlag_Last)) {
-        DEBUG_ERROR("Invalid flag is passed!\r\n");
-        return false;
-    }
-
-    if (osEventFlagsClear(g_status_flag_id, g_modem_flags[flag_to_clear]) >= osFlagsError) {
-        DEBUG_ERROR("Failed to clear the flag!\r\n");
-        return false;
-    }
-
-    return true;
-}
-
-bool Modem_API_LockModem (uint32_t timeout) {
-    if (timeout < 0) {
-        DEBUG_ERROR("Invalid timeout value!\r\n");
-        return false;
-    }
-
-    if (osMutexAcquire(g_uart_modem_command_handle_id, timeout) != osOK) {
-        DEBUG_ERROR("Failed to acquire command handling mutex!\r\n");
-        return false;
-    }
-
-    return true;
-}
-
-bool Modem_API_UnlockModem (void) {
-    if (osMutexRelease(g_uart_modem_command_handle_id) != osOK) {
-        DEBUG_ERROR("Failed to release command handling mutex!\r\n");
-        return false;
-    }
-
-    return true;
-}
-
-eModemState_t Modem_API_GetState (void) {
-    return g_modem_state;
-}
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "gpio_driver.h"
+#include "uart_driver.h"
+#include "cmux_driver.h"
+#include "cmux_frame.h"
+#include "message.h"
+#include "string_util.h"
+#include "uart_api.h"
+#include "debug_api.h"
+#include "heap_api.h"
+#include "power_api.h"
+#include "cmd_api.h"
+#include "modem_api.h"
+#include "modem_api_commands.h"
+/**********************************************************************************************************************
+* Private definitions and macros
+*********************************************************************************************************************/
+#define APN_NAME "internet.tele2.lt"
+#define MODEM_BAUDRATE 115200
+#define MODEM_UART_DRIVER eUartDriver_2
+#define CMUX_PORT_SPEED_115200 5
+#define CMUX_OPEN_TIMEOUT_MS 1000
+#define MODEM_UART eUartApiDevice_Modem
+#define MODEM_DATA_UART eUartApiDevice_ModemData
+#define MODEM_GNSS_UART eUartApiDevice_ModemGnss
+#define CMD_RECEPTION_TIMEOUT_MS 400
+#define SOCKET_CLOSE_TIMEOUT_MS 10000
+#define PDP_CONTEXT_TIMEOUT_MS 40000
+#define FILE_OPERATION_TIMEOUT_MS 5000
+#define MODEM_API_SET_UP_MODEM_TASK_ATTR_NAME "SetUpModem"
+#define MODEM_API_RECEIVE_TASK_ATTR_NAME "ReceiveTask"
+#define MODEM_API_RECEIVE_DATA_TASK_ATTR_NAME "ReceiveDataTask"
+#define MODEM_API_RECEIVE_GNSS_TASK_ATTR_NAME "ReceiveGnssTask"
+#define MODEM_API_SET_UP_MODEM_TASK_STACK_SIZE 1024U
+#define MODEM_API_RECEIVE_TASK_STACK_SIZE 1024U
+#define NONE_THREAD_ARGUMENTS NULL
+#define UART_MODEM_COMMAND_HANDLE_MUTEX_ATTR_NAME "ComamndHandleMutex"
+#define MODEM_CONTROL_EVENT_FLAG_NAME "ModemControlFlag"
+#define FAILED_TO_CLEAR_FLAG "Failed to clear flag!\r\n"
+#define CMD(COMMAND) .command_name = #COMMAND, .command_name_size = sizeof(#COMMAND) - 1
+#define MODEM_SETUP_COMMAND(COMMAND) .str = #COMMAND, .size = sizeof(#COMMAND) - 1
+#define MODEM_RECEIVE_TASK(NAME) {.name = NAME, .stack_size = MODEM_API_RECEIVE_TASK_STACK_SIZE, .priority = 25}
+#define MODEM_RESPONSE_BUFFER(CHANNEL) {.str = g_command_reply_buffer[CHANNEL], .size = CLI_RESPONSE_BUFFER_SIZE, .count = 0}
+#define MODEM_LAUNCHER_PARAMS(CHANNEL) {.commands_table = g_modem_callback_function_lut, \
+    .commands_table_size = sizeof(g_modem_callback_function_lut) / sizeof(g_modem_callback_function_lut[0]), \
+    .response_buffer = &g_response_buffer[CHANNEL]}
+#define MODEM_AT_TABLE_SIZE 13
+#define NUMBER_OF_MODEM_SET_UP_COMMANDS (sizeof(g_modem_setup_commands) / sizeof(g_modem_setup_commands[0]))
+#define AT_COMMAND_BUFFER_SIZE 80
+#define AT_COMMAND_PARAMETERS_BUFFER_SIZE 60
+#define CLI_RESPONSE_BUFFER_SIZE 200
+#define MODEM_LOCK_TIMEOUT_MS 450
+#define SIGNAL_QUALITY_PARAMETERS "Q"
+#define MODEM_SEND_PROMPT "> "
+#define MODEM_READ_RESPONSE "+QIRD: "
+#define MODEM_STREAM_RESPONSE "CONNECT"
+/**********************************************************************************************************************
+* Private typedef
+*********************************************************************************************************************/
+typedef struct eModemResponseSpecs {
+    sString_t AT_command;
+    eModemCommands_t command_id; 
+} eATCommandsSpecs_t;
+/**********************************************************************************************************************
+* Private constants
+*********************************************************************************************************************/
+CREATE_MODULE_TAG (MODEM_API);
+static const osThreadAttr_t g_modem_api_setup_task_attr = {
+    .name = MODEM_API_SET_UP_MODEM_TASK_ATTR_NAME,
+    .stack_size = MODEM_API_SET_UP_MODEM_TASK_STACK_SIZE,
+    .priority = 25
+};
+/* Every channel has a receive task, the data and GNSS ones only hear anything while the UART is multiplexed */
+static const osThreadAttr_t g_modem_api_receive_task_attr[eModemChannel_Last] = {
+    [eModemChannel_At]   = MODEM_RECEIVE_TASK(MODEM_API_RECEIVE_TASK_ATTR_NAME),
+    [eModemChannel_Data] = MODEM_RECEIVE_TASK(MODEM_API_RECEIVE_DATA_TASK_ATTR_NAME),
+    [eModemChannel_Gnss] = MODEM_RECEIVE_TASK(MODEM_API_RECEIVE_GNSS_TASK_ATTR_NAME)
+};
+static const eUartApiDevice_t g_modem_channel_uart[eModemChannel_Last] = {
+    [eModemChannel_At]   = MODEM_UART,
+    [eModemChannel_Data] = MODEM_DATA_UART,
+    [eModemChannel_Gnss] = MODEM_GNSS_UART
+};
+static const osMutexAttr_t g_uart_modem_command_handle_attr = {
+    .name = UART_MODEM_COMMAND_HANDLE_MUTEX_ATTR_NAME
+};
+static const osEventFlagsAttr_t g_state_flag_attr = {
+    .name = MODEM_CONTROL_EVENT_FLAG_NAME
+};
+
+static const sCommandDescription_t g_modem_callback_function_lut[] = {
+    {.command_function = &Modem_API_CMD_OK, CMD(OK)},
+    {.command_function = &Modem_API_CMD_DisableEcho, CMD(ATE0)},
+    {.command_function = &Modem_API_CMD_Error, CMD(ERROR)},
+    {.command_function = &Modem_API_CMD_GetError, CMD(+QIGETERROR:)},
+    {.command_function = &Modem_API_CMD_NetworkRegStatus, CMD(+CEREG:)},
+    {.command_function = &Modem_API_CMD_AddressPDP, CMD(+CGPADDR:)},
+    {.command_function = &Modem_API_CMD_QIOPEN, CMD(+QIOPEN:)},
+    {.command_function = &Modem_API_CMD_ReadyToSend, CMD(>)},
+    {.command_function = &Modem_CMD_SendOk, CMD(SEND OK)},
+    {.command_function = &Modem_API_CMD_SendFail, CMD(SEND FAIL)},
+    {.command_function = &Modem_API_CMD_QIURC, CMD(+QIURC:)},
+    {.command_function = &Modem_API_CMD_QIRD, CMD(+QIRD:)},
+    {.command_function = &Modem_API_CMD_Connect, CMD(CONNECT)},
+    {.command_function = &Modem_API_CMD_QGPSLOC, CMD(+QGPSLOC:)},
+    {.command_function = &Modem_API_CMD_CmeError, CMD(+CME ERROR:)},
+    {.command_function = &Modem_API_CMD_Clock, CMD(+CCLK:)},
+    {.command_function = &Modem_API_CMD_QFUPL, CMD(+QFUPL:)},
+    {.command_function = &Modem_API_CMD_SignalQuality, CMD(+CSQ:)}
+};
+
+static char g_command_reply_buffer[eModemChannel_Last][CLI_RESPONSE_BUFFER_SIZE] = {0};
+
+static sBuffer_t g_response_buffer[eModemChannel_Last] = {
+    [eModemChannel_At]   = MODEM_RESPONSE_BUFFER(eModemChannel_At),
+    [eModemChannel_Data] = MODEM_RESPONSE_BUFFER(eModemChannel_Data),
+    [eModemChannel_Gnss] = MODEM_RESPONSE_BUFFER(eModemChannel_Gnss)
+};
+
+static const sCommandLauncherArgs_t g_modem_cmd_launcher_params[eModemChannel_Last] = {
+    [eModemChannel_At]   = MODEM_LAUNCHER_PARAMS(eModemChannel_At),
+    [eModemChannel_Data] = MODEM_LAUNCHER_PARAMS(eModemChannel_Data),
+    [eModemChannel_Gnss] = MODEM_LAUNCHER_PARAMS(eModemChannel_Gnss)
+};
+static const sString_t g_modem_setup_commands[] = {
+    {MODEM_SETUP_COMMAND(RDY)},
+    {MODEM_SETUP_COMMAND(+CFUN: 1)},
+    {MODEM_SETUP_COMMAND(+CPIN: READY)},
+    {MODEM_SETUP_COMMAND(+QUSIM: 1)},
+    {MODEM_SETUP_COMMAND(+QIND: SMS DONE)},
+    {MODEM_SETUP_COMMAND(+QIND: PB DONE)}
+};
+static const sString_t g_modem_AT_commands[eModemCommands_Last] = {
+    [eModemCommands_ATE0]       = {MODEM_SETUP_COMMAND(E)},
+    [eModemCommands_QICSGP]     = {MODEM_SETUP_COMMAND(+QICSGP=)},
+    [eModemCommands_QIACT]      = {MODEM_SETUP_COMMAND(+QIACT=)},
+    [eModemCommands_CEREG]      = {MODEM_SETUP_COMMAND(+CEREG)},
+    [eModemCommands_CGPADDR]    = {MODEM_SETUP_COMMAND(+CGPADDR=)},
+    [eModemCommands_QIGETERROR] = {MODEM_SETUP_COMMAND(+QIGET)}, 
+    [eModemCommands_QIOPEN]     = {MODEM_SETUP_COMMAND(+QIOPEN=)},
+    [eModemCommands_QISEND]     = {MODEM_SETUP_COMMAND(+QISEND=)},
+    [eModemCommands_QIRD]       = {MODEM_SETUP_COMMAND(+QIRD=)},
+    [eModemCommands_QICLOSE]    = {MODEM_SETUP_COMMAND(+QICLOSE=)},
+    [eModemCommands_QICFG]      = {MODEM_SETUP_COMMAND(+QICFG=)},
+    [eModemCommands_QIDEACT]    = {MODEM_SETUP_COMMAND(+QIDEACT=)},
+    [eModemCommands_DTRMode]    = {MODEM_SETUP_COMMAND(&D)},
+    [eModemCommands_CMUX]       = {MODEM_SETUP_COMMAND(+CMUX=)},
+    [eModemCommands_IFC]        = {MODEM_SETUP_COMMAND(+IFC=)},
+    [eModemCommands_QGPS]       = {MODEM_SETUP_COMMAND(+QGPS=)},
+    [eModemCommands_QGPSEND]    = {MODEM_SETUP_COMMAND(+QGPSEND)},
+    [eModemCommands_QGPSLOC]    = {MODEM_SETUP_COMMAND(+QGPSLOC=)},
+    [eModemCommands_QGPSXTRA]   = {MODEM_SETUP_COMMAND(+QGPSXTRA=)},
+    [eModemCommands_QGPSXTRATIME] = {MODEM_SETUP_COMMAND(+QGPSXTRATIME=)},
+    [eModemCommands_QGPSXTRADATA] = {MODEM_SETUP_COMMAND(+QGPSXTRADATA=)},
+    [eModemCommands_QFUPL]      = {MODEM_SETUP_COMMAND(+QFUPL=)},
+    [eModemCommands_QFDEL]      = {MODEM_SETUP_COMMAND(+QFDEL=)},
+    [eModemCommands_CCLK]       = {MODEM_SETUP_COMMAND(+CCLK)},
+    [eModemCommands_CSQ]        = {MODEM_SETUP_COMMAND(+CS)}
+};
+static uint32_t g_modem_flags[eModemFlag_Last] = {
+    [eModemFlags_Ready]           = 0x01,          
+    [eModemFlags_ResponseOK]      = 0x02,     
+    [eModemFlags_EchoDisabled]    = 0x04,   
+    [eModemFlags_Error]           = 0x08,          
+    [eModemFlags_Registered]      = 0x10,     
+    [eModemFlags_ValidPDPAddress] = 0x20,
+    [eModemFlags_ServerOpen]      = 0x40,   
+    [eModemFlags_SendOK]          = 0x80,        
+    [eModemFlags_SendFail]        = 0x100,      
+    [eModemFlags_DataReceived]    = 0x200,  
+    [eModemFlags_ReadyToSend]     = 0x400,
+    [eModemFlags_Connect]         = 0x800,
+    [eModemFlags_Location]        = 0x1000,
+    [eModemFlags_Clock]           = 0x2000,
+    [eModemFlags_FileUploaded]    = 0x4000,
+    [eModemFlags_SignalQuality]   = 0x8000,
+};
+/**********************************************************************************************************************
+* Private variables
+*********************************************************************************************************************/
+static osThreadId_t g_modem_api_setup_task_id = NULL;
+static osThreadId_t g_modem_api_receive_task_id[eModemChannel_Last] = {0};
+static osMutexId_t g_uart_modem_command_handle_id = NULL;
+static osEventFlagsId_t g_status_flag_id = NULL;
+static sString_t modem_command;
+static eModemState_t g_modem_state;
+static bool set_up_cmd_received = false;
+static uint32_t flag = 0;
+static modem_socket_event_callback_t g_socket_event_callback = NULL;
+static modem_data_callback_t g_data_callback = NULL;
+static modem_location_callback_t g_location_callback = NULL;
+static modem_clock_callback_t g_clock_callback = NULL;
+static volatile int g_last_cme_error = 0;
+static volatile int g_signal_quality = MODEM_API_SIGNAL_UNKNOWN;
+static volatile bool g_is_stream_requested = false;
+static bool g_is_streaming[eModemChannel_Last] = {0};
+/* Only taken when the modem refuses the flow control */
+static bool g_is_power_locked = false;
+/**********************************************************************************************************************
+* Exported variables and references
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Prototypes of private functions
+*********************************************************************************************************************/
+static void Modem_API_SetUpModem (void *args);
+static void Modem_API_ReceiveTask (void *args);
+static bool Modem_API_ClearFlagByCommand (eModemFlags_t command_flag);
+static uint32_t Modem_API_GetCommandTimeout (eModemCommands_t AT_command);
+static size_t Modem_API_GetRawLength (sString_t line);
+static bool Modem_API_SetUpMultiplexer (void);
+static void Modem_API_SetUpFlowControl (void);
+static void Modem_API_ReleasePowerLock (void);
+/**********************************************************************************************************************
+* Definitions of private functions
+*********************************************************************************************************************/
+static void Modem_API_SetUpModem (void *args) {
+    uint8_t cmd_count = 0;
+    char cmd_params_str[AT_COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
+    size_t cmd_params_size = 0;
+
+    while (1) {
+        switch (g_modem_state) {
+            case eModemState_TurnedOff: {
+                CMUX_Driver_Close();
+                Modem_API_ReleasePowerLock();
+
+                if (((GPIO_Driver_Write(eGPIODriver_ModemPowerOffPin, eGPIO_PinState_Low)) ||
+                    (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_High)) ||
+                    (GPIO_Driver_Write(eGPIODriver_Reset_NPin, eGPIO_PinState_High))) == false) {
+                    DEBUG_WARN("Failed to set the write pins in the second boot cycle!\r\n");
+                    break;
+                }
+
+                osDelay(10);
+
+                if (((GPIO_Driver_Write(eGPIODriver_ModemPowerOffPin, eGPIO_PinState_High)) ||
+                    (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_Low)) ||
+                    (GPIO_Driver_Write(eGPIODriver_Reset_NPin, eGPIO_PinState_Low))) == false) {
+                    DEBUG_WARN("Failed to set the write pins in the third boot cycle!\r\n");
+                    break;
+                }
+
+                osDelay(10);
+
+                if (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_High) == false) {
+                    DEBUG_WARN("Failed to set the write pin!\r\n");
+                    break;
+                }
+
+                osDelay(510);
+
+                if (GPIO_Driver_Write(eGPIODriver_ModemOnPin, eGPIO_PinState_Low) == false) {
+                    DEBUG_WARN("Failed to set the write pin!\r\n");
+                    break;
+                }
+
+                osDelay(13000);
+
+                if (((GPIO_Driver_Write(eGPIODriver_ModemUartDtrPin, eGPIO_PinState_Low)) || 
+                    (GPIO_Driver_Write(eGPIODriver_GnssOnPin, eGPIO_PinState_High))) == false) {
+                    DEBUG_WARN("Failed to set the write pins!\r\n");
+                    break;
+                }
+
+                g_modem_state = eModemState_TurnedOn;
+            }
+            case eModemState_TurnedOn: {
+                while (1) {
+                    if (UART_API_GetMessage(MODEM_UART, &modem_command, CMD_RECEPTION_TIMEOUT_MS) == false) {
+                        DEBUG_ERROR("Failed to receive commands after modem start up!\r\n");
+                        continue;
+                    }
+
+                    if (modem_command.size < 2) {
+                        Heap_API_Free(modem_command.str);
+                        continue;
+                    }
+                    
+                    for (uint8_t i = 0; i < NUMBER_OF_MODEM_SET_UP_COMMANDS; i++) {
+                        if (strncmp(modem_command.str, g_modem_setup_commands[i].str, g_modem_setup_commands[i].size) == 0) {
+                            set_up_cmd_received = true;
+                            cmd_count++;
+                            Heap_API_Free(modem_command.str);
+                            break;
+                        }
+                    }
+
+                    if ((set_up_cmd_received == true) && (cmd_count != NUMBER_OF_MODEM_SET_UP_COMMANDS)) {
+                        set_up_cmd_received = false;
+                        continue;
+                    }
+                    else if (cmd_count == NUMBER_OF_MODEM_SET_UP_COMMANDS) {
+                        flag = osEventFlagsSet(g_status_flag_id, g_modem_flags[eModemFlags_Ready]);
+                        if (flag >= osFlagsError) {
+                            DEBUG_ERROR("Failed to set the flag, error occured!\r\n");
+                        }
+                        g_modem_state = eModemState_Ready;
+                        break;
+                    }
+                    else {
+                        DEBUG_ERROR("Received incorrect command: %s, modem is not ready for a connection!\r\n", modem_command.str);
+                        g_modem_state = eModemState_TurnedOn;
+                        Heap_API_Free(modem_command.str);
+                        break;
+                    }
+                }
+            }    
+            case eModemState_Ready: {
+
+                if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+                    DEBUG_ERROR("Failed to lock the modem!\r\n");
+                    break;
+                }
+                //ATE0: ECHO Disable
+                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "0") + 1;
+                while (Modem_API_SendCommand(eModemCommands_ATE0, eModemFlags_EchoDisabled, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+                    osDelay(1000);
+                    DEBUG_ERROR("Failed to disable ECHO mode, retrying!...\r\n");
+                }
+
+                /* The OK behind the echo belongs to ATE0, left alone it would answer AT+CMUX */
+                Modem_API_WaitForResult(eModemFlags_ResponseOK, eModemFlags_Error, CMD_RECEPTION_TIMEOUT_MS);
+
+                //IFC: RTS/CTS flow control, the modem holds its bytes while the core is in Stop
+                Modem_API_SetUpFlowControl();
+
+                //CMUX: Split the UART into AT, socket data and GNSS channels
+                if (Modem_API_SetUpMultiplexer() == false) {
+                    DEBUG_ERROR("Modem stopped answering after the multiplexer setup, restarting the modem!\r\n");
+                    Modem_API_UnlockModem();
+                    g_modem_state = eModemState_TurnedOff;
+                    break;
+                }
+
+                //QICSGP: Define PDP context
+                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE,
+                                           "1,1,\"%s\",\"\",\"\",0", APN_NAME) + 1;
+                while (Modem_API_SendCommand(eModemCommands_QICSGP, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+                    osDelay(1000);
+                    DEBUG_INFO("Defining PDP context... !!!\r\n");
+                }
+
+                //QIACT: Activate PDP context
+                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "1") + 1;
+                while (Modem_API_SendCommand(eModemCommands_QIACT, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+                    osDelay(1000);
+                    DEBUG_INFO("Retrying PDP activation...!!\r\n");
+                }
+
+                osDelay(100);
+
+                //CEREG: Check Network registration status
+                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "?") + 1;
+                while (Modem_API_SendCommand(eModemCommands_CEREG, eModemFlags_Registered, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+                    osDelay(1000);
+                    DEBUG_INFO("Retrying network registration status identification procedure...!!\r\n");
+                }
+
+                //CGPADDR: Check PDP address
+                cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "1") + 1;
+                while (Modem_API_SendCommand(eModemCommands_CGPADDR, eModemFlags_ValidPDPAddress, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+                    osDelay(1000);
+                    DEBUG_INFO("Retrying PDP address checking procedure...!!\r\n");
+                }
+
+                if (Modem_API_UnlockModem() == false) {
+                    DEBUG_ERROR("Failed to Unlock the modem!\r\n");
+                    break;
+                }
+
+                g_modem_state = eModemState_Initialized;
+                break;
+            }
+            default: {
+                DEBUG_ERROR("Unexpected modem state!\r\n");
+                g_modem_state = eModemState_TurnedOff;
+                break;
+            }
+        }
+
+        if (g_modem_state == eModemState_Initialized) {
+            DEBUG_INFO("Modem is ready for connection!\r\n");
+            break;
+        }
+        else {
+            DEBUG_INFO("Modem is not setup correctly, retrying the process! ...\r\n");
+            osDelay(5000);
+            continue;
+        }
+    }
+
+    osThreadExit();
+}
+
+static void Modem_API_ReceiveTask (void *args) {
+    eModemChannel_t channel = (eModemChannel_t) (uintptr_t) args;
+    sString_t modem_message;
+
+    flag = osEventFlagsWait(g_status_flag_id, g_modem_flags[eModemFlags_Ready], osFlagsNoClear, osWaitForever);
+    if (flag >= osFlagsError) {
+        DEBUG_ERROR("Error occured while waiting for modem entering the ready state!\r\n");
+        osThreadExit();
+    }
+
+    bool is_raw_data_next = false;
+
+    while (1) {
+        if (UART_API_GetMessage(g_modem_channel_uart[channel], &modem_message, CMD_RECEPTION_TIMEOUT_MS) == false) {
+            continue;
+        }
+
+        if ((is_raw_data_next == true) || (g_is_streaming[channel] == true)) {
+            if (g_data_callback != NULL) {
+                g_data_callback(modem_message, (is_raw_data_next == false));
+            }
+
+            is_raw_data_next = false;
+            Heap_API_Free(modem_message.str);
+            continue;
+        }
+
+        if (modem_message.size < 2) {
+            Heap_API_Free(modem_message.str);
+            continue;
+        }
+
+        size_t raw_length = Modem_API_GetRawLength(modem_message);
+
+        if (raw_length == UART_API_RAW_STREAM) {
+            g_is_stream_requested = false;
+            g_is_streaming[channel] = true;
+        } else {
+            is_raw_data_next = (raw_length > 0);
+        }
+
+        if (CMD_API_Launcher(modem_message, &g_modem_cmd_launcher_params[channel]) == false) {
+            DEBUG_WARN("%s", g_response_buffer[channel].str);
+        } else {
+            DEBUG_INFO("%s", g_response_buffer[channel].str);
+        }
+
+        Heap_API_Free(modem_message.str);
+    }
+}
+
+static bool Modem_API_ClearFlagByCommand (eModemFlags_t command_flag) {
+    bool is_flag_cleared = true;
+    is_flag_cleared = Modem_API_ClearFlag(command_flag) && Modem_API_ClearFlag(eModemFlags_Error) &&
+                      Modem_API_ClearFlag(eModemFlags_ResponseOK);
+
+    return is_flag_cleared;
+}
+
+static size_t Modem_API_GetRawLength (sString_t line) {
+    size_t prefix_size = sizeof(MODEM_READ_RESPONSE) - 1;
+
+    if ((g_is_stream_requested == true) && (line.str != NULL) && (line.size == (sizeof(MODEM_STREAM_RESPONSE) - 1)) && 
+        (strncmp(line.str, MODEM_STREAM_RESPONSE, line.size) == 0)) {
+        return UART_API_RAW_STREAM;
+    }
+
+    if ((line.str == NULL) || (line.size <= prefix_size) || (strncmp(line.str, MODEM_READ_RESPONSE, prefix_size) != 0)) {
+        return 0;
+    }
+
+    int raw_length = atoi(&line.str[prefix_size]);
+
+    return (raw_length > 0) ? (size_t) raw_length : 0;
+}
+
+/* Without the multiplexer everything runs on the plain UART as before, only a modem that answers neither way is
+ * restarted */
+static bool Modem_API_SetUpMultiplexer (void) {
+    char cmd_params_str[AT_COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
+    size_t cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "0,0,%d,%d",
+                                      CMUX_PORT_SPEED_115200, CMUX_FRAME_MAX_INFO_SIZE) + 1;
+
+    if (Modem_API_SendCommand(eModemCommands_CMUX, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+        DEBUG_WARN("Modem refused the multiplexer, staying on the plain UART!\r\n");
+        return true;
+    }
+
+    if (CMUX_Driver_Open(CMUX_OPEN_TIMEOUT_MS) == true) {
+        return true;
+    }
+
+    DEBUG_WARN("Multiplexer channels did not open, staying on the plain UART!\r\n");
+
+    /* Echo is off already, the probe only waits for the OK */
+    cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "0") + 1;
+
+    return (Modem_API_SendCommand(eModemCommands_ATE0, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) == eModemError_ATSuccess);
+}
+
+/* The power API raises RTS around every Stop. A modem that ignores it may start a frame or an URC while the core is
+ * waking up and lose its first bytes, so the core stays out of Stop until that modem is turned off. */
+static void Modem_API_SetUpFlowControl (void) {
+    char cmd_params_str[AT_COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
+    size_t cmd_params_size = snprintf(cmd_params_str, AT_COMMAND_PARAMETERS_BUFFER_SIZE, "2,2") + 1;
+
+    if (Modem_API_SendCommand(eModemCommands_IFC, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) == eModemError_ATSuccess) {
+        return;
+    }
+
+    DEBUG_WARN("Modem refused the flow control, keeping the core out of Stop while it is on!\r\n");
+
+    if (g_is_power_locked == false) {
+        g_is_power_locked = true;
+        Power_API_Lock();
+    }
+}
+
+static void Modem_API_ReleasePowerLock (void) {
+    if (g_is_power_locked == true) {
+        g_is_power_locked = false;
+        Power_API_Unlock();
+    }
+}
+
+static uint32_t Modem_API_GetCommandTimeout (eModemCommands_t AT_command) {
+    switch (AT_command) {
+        case eModemCommands_QICLOSE:
+        case eModemCommands_QIGETERROR: {
+            return SOCKET_CLOSE_TIMEOUT_MS;
+        }
+        case eModemCommands_QIACT:
+        case eModemCommands_QIDEACT: {
+            return PDP_CONTEXT_TIMEOUT_MS;
+        }
+        case eModemCommands_QFUPL:
+        case eModemCommands_QFDEL:
+        case eModemCommands_QGPSXTRADATA: {
+            return FILE_OPERATION_TIMEOUT_MS;
+        }
+        default: {
+            return CMD_RECEPTION_TIMEOUT_MS;
+        }
+    }
+}
+/**********************************************************************************************************************
+* Definitions of exported functions
+*********************************************************************************************************************/
+bool Modem_API_Init (void) {
+    g_modem_state = eModemState_TurnedOff;
+
+    sString_t delimiter = (sString_t)DEFINE_STRING("\r\n");
+    if (UART_API_Init(MODEM_UART, MODEM_BAUDRATE, delimiter) == false) {
+        DEBUG_ERROR("Failed to initialize modem uart api function!\r\n");
+        return false;
+    }
+
+    if (CMUX_Driver_Init(MODEM_UART_DRIVER) == false) {
+        DEBUG_ERROR("Failed to initialize the modem multiplexer!\r\n");
+        return false;
+    }
+
+    sString_t send_prompt = (sString_t)DEFINE_STRING(MODEM_SEND_PROMPT);
+    if (UART_API_SetPrompt(MODEM_UART, send_prompt) == false) {
+        DEBUG_ERROR("Failed to set the modem data prompt!\r\n");
+        return false;
+    }
+
+    if (UART_API_SetLengthParser(MODEM_UART, &Modem_API_GetRawLength) == false) {
+        DEBUG_ERROR("Failed to set the modem read length parser!\r\n");
+        return false;
+    }
+
+    if ((UART_API_Init(MODEM_DATA_UART, MODEM_BAUDRATE, delimiter) == false) ||
+        (UART_API_Init(MODEM_GNSS_UART, MODEM_BAUDRATE, delimiter) == false)) {
+        DEBUG_ERROR("Failed to initialize the multiplexed modem channels!\r\n");
+        return false;
+    }
+
+    if (UART_API_SetLengthParser(MODEM_DATA_UART, &Modem_API_GetRawLength) == false) {
+        DEBUG_ERROR("Failed to set the modem data channel length parser!\r\n");
+        return false;
+    }
+
+    if (g_uart_modem_command_handle_id == NULL) {
+        g_uart_modem_command_handle_id = osMutexNew(&g_uart_modem_command_handle_attr);
+        if (g_uart_modem_command_handle_id == NULL) {
+            DEBUG_ERROR("Failed to create mutex for modem command handling!\r\n");
+            return false;
+        }
+    }
+
+    if (g_status_flag_id == NULL) {
+        g_status_flag_id = osEventFlagsNew(&g_state_flag_attr);
+        if (g_status_flag_id == NULL) {
+            DEBUG_ERROR("Failed to create an event flag for modem state indication!\r\n");
+            return false;
+        }
+    }
+
+    if (g_modem_api_setup_task_id == NULL) {
+        g_modem_api_setup_task_id = osThreadNew(&Modem_API_SetUpModem, 
+                                                NONE_THREAD_ARGUMENTS,
+                                                &g_modem_api_setup_task_attr);
+        if (g_modem_api_setup_task_id == NULL) {
+            DEBUG_ERROR("Failed to create thread for setting up the modem!\r\n");
+            return false;
+        }
+    }
+
+    for (eModemChannel_t channel = eModemChannel_First; channel < eModemChannel_Last; channel++) {
+        if (g_modem_api_receive_task_id[channel] != NULL) {
+            continue;
+        }
+
+        g_modem_api_receive_task_id[channel] = osThreadNew(&Modem_API_ReceiveTask,
+                                                           (void *) (uintptr_t) channel,
+                                                           &g_modem_api_receive_task_attr[channel]);
+        if (g_modem_api_receive_task_id[channel] == NULL) {
+            DEBUG_ERROR("Failed to create thread for AT command processing!\r\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+eModemError_t Modem_API_SendCommand (eModemCommands_t AT_command, eModemFlags_t command_flag, char *cmd_params_string, size_t cmd_params_size) {
+    return Modem_API_SendChannelCommand(eModemChannel_At, AT_command, command_flag, cmd_params_string, cmd_params_size);
+}
+
+eModemError_t Modem_API_SendChannelCommand (eModemChannel_t channel, eModemCommands_t AT_command, eModemFlags_t command_flag,
+                                            char *cmd_params_string, size_t cmd_params_size) {
+    eModemError_t error_type = eModemError_ATSuccess;
+
+    if ((channel < eModemChannel_First) || (channel >= eModemChannel_Last) ||
+        (AT_command < eModemCommands_First) || (AT_command >= eModemCommands_Last) || 
+        (cmd_params_string == NULL) || (cmd_params_size == 0)) {
+        DEBUG_ERROR("Invalid AT command or its parameters!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_ClearFlagByCommand(command_flag) == false) {
+        return eModemError_ClearFlagFail;
+    }
+
+    sString_t formatted_AT_command;
+    formatted_AT_command.str = (char *) Heap_API_Calloc(AT_COMMAND_BUFFER_SIZE, sizeof(char));
+
+    if (formatted_AT_command.str == NULL) {
+        DEBUG_ERROR("Failed to allocate space for AT command!\r\n");
+        return eModemError_MemoryAllocationFail;
+    }
+
+    formatted_AT_command.size = snprintf(formatted_AT_command.str, AT_COMMAND_BUFFER_SIZE, "AT%s%s\r\n", 
+                                         g_modem_AT_commands[AT_command].str, cmd_params_string) + 1;
+
+    if ((formatted_AT_command.size == 0) || (formatted_AT_command.str == NULL)) {
+        error_type = eModemError_InvalidParameters;
+    }
+
+    if (UART_API_SendMessage(Modem_API_GetChannelUart(channel), formatted_AT_command) == false) {
+        DEBUG_ERROR("Failed to send %s command!\r\n", formatted_AT_command.str);
+        error_type = eModemError_SendFail;
+    }
+
+    uint32_t timeout_ms = Modem_API_GetCommandTimeout(AT_command);
+    uint32_t flags = osEventFlagsWait(g_status_flag_id, g_modem_flags[eModemFlags_Error] | g_modem_flags[command_flag], 
+                                      osFlagsWaitAny, timeout_ms);
+    if (flags >= osFlagsError) {
+        DEBUG_INFO("Wait flag event failed!\r\n");
+        error_type = eModemError_WaitFlagFail;
+    } else if ((flags & g_modem_flags[command_flag]) == 0) {
+        error_type = eModemError_InvalidResponse;
+    }
+
+    Heap_API_Free(formatted_AT_command.str);
+
+    return error_type;
+}
+
+eModemError_t Modem_API_WaitForResult (eModemFlags_t success_flag, eModemFlags_t fail_flag, uint32_t timeout) {
+    if ((success_flag < eModemFlags_First) || (success_flag >= eModemFlag_Last) || 
+        (fail_flag < eModemFlags_First) || (fail_flag >= eModemFlag_Last)) {
+        DEBUG_ERROR("Invalid flag is passed!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    uint32_t flags = osEventFlagsWait(g_status_flag_id, g_modem_flags[success_flag] | g_modem_flags[fail_flag] | 
+                                      g_modem_flags[eModemFlags_Error], osFlagsWaitAny, timeout);
+    if (flags >= osFlagsError) {
+        DEBUG_INFO("Wait flag event failed!\r\n");
+        return eModemError_WaitFlagFail;
+    }
+
+    if ((flags & g_modem_flags[success_flag]) == 0) {
+        return eModemError_InvalidResponse;
+    }
+
+    return eModemError_ATSuccess;
+}
+
+bool Modem_API_SetFlag (eModemFlags_t flag_to_set) {
+    if ((flag_to_set < eModemFlags_First) || (flag_to_set >= eModemFlag_Last)) {
+        DEBUG_ERROR("Invalid flag is passed!\r\n");
+        return false;
+    }
+
+    uint32_t flag_check = osEventFlagsSet(g_status_flag_id, g_modem_flags[flag_to_set]);
+    if (flag_check >= osFlagsError) {
+        DEBUG_ERROR("Fail occured in setting the flag!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool Modem_API_IsFlagSet (eModemFlags_t flag_to_check) {
+    if ((flag_to_check < eModemFlags_First) || (flag_to_check >= eModemFlag_Last)) {
+        DEBUG_ERROR("Invalid flag is passed!\r\n");
+        return false;
+    }
+
+    if ((osEventFlagsGet(g_status_flag_id) & g_modem_flags[flag_to_check]) > 0) {
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+bool Modem_API_ClearFlag (eModemFlags_t flag_to_clear) {
+    if ((flag_to_clear < eModemFlags_First) || (flag_to_clear >= eModemFlag_Last)) {
+        DEBUG_ERROR("Invalid flag is passed!\r\n");
+        return false;
+    }
+
+    if (osEventFlagsClear(g_status_flag_id, g_modem_flags[flag_to_clear]) >= osFlagsError) {
+        DEBUG_ERROR("Failed to clear the flag!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool Modem_API_LockModem (uint32_t timeout) {
+    if (timeout < 0) {
+        DEBUG_ERROR("Invalid timeout value!\r\n");
+        return false;
+    }
+
+    if (osMutexAcquire(g_uart_modem_command_handle_id, timeout) != osOK) {
+        DEBUG_ERROR("Failed to acquire command handling mutex!\r\n");
+        return false;
+    }
+
+    /* A response must not lose its first bytes to a wakeup, so the core stays out of Stop while a command runs */
+    Power_API_Lock();
+
+    return true;
+}
+
+/* Background users take the modem only when it is free, a busy modem is not an error for them. */
+bool Modem_API_TryLockModem (void) {
+    if (osMutexAcquire(g_uart_modem_command_handle_id, 0) != osOK) {
+        return false;
+    }
+
+    Power_API_Lock();
+
+    return true;
+}
+
+bool Modem_API_UnlockModem (void) {
+    if (osMutexRelease(g_uart_modem_command_handle_id) != osOK) {
+        DEBUG_ERROR("Failed to release command handling mutex!\r\n");
+        return false;
+    }
+
+    Power_API_Unlock();
+
+    return true;
+}
+
+eModemState_t Modem_API_GetState (void) {
+    return g_modem_state;
+}
+
+bool Modem_API_IsMultiplexed (void) {
+    return CMUX_Driver_IsActive();
+}
+
+eUartApiDevice_t Modem_API_GetChannelUart (eModemChannel_t channel) {
+    if ((channel < eModemChannel_First) || (channel >= eModemChannel_Last) || (CMUX_Driver_IsActive() == false)) {
+        return MODEM_UART;
+    }
+
+    return g_modem_channel_uart[channel];
+}
+
+bool Modem_API_SetSocketEventCallback (modem_socket_event_callback_t callback) {
+    if (callback == NULL) {
+        DEBUG_ERROR("Invalid socket event callback!\r\n");
+        return false;
+    }
+
+    g_socket_event_callback = callback;
+
+    return true;
+}
+
+void Modem_API_ReportSocketEvent (int socket_id, eModemSocketEvent_t event) {
+    if ((event < eModemSocketEvent_First) || (event >= eModemSocketEvent_Last) || (g_socket_event_callback == NULL)) {
+        return;
+    }
+
+    g_socket_event_callback(socket_id, event);
+}
+
+bool Modem_API_SetDataCallback (modem_data_callback_t callback) {
+    if (callback == NULL) {
+        DEBUG_ERROR("Invalid data callback!\r\n");
+        return false;
+    }
+
+    g_data_callback = callback;
+
+    return true;
+}
+
+void Modem_API_RequestStream (void) {
+    g_is_stream_requested = true;
+}
+
+void Modem_API_StopStream (void) {
+    g_is_stream_requested = false;
+
+    for (eModemChannel_t channel = eModemChannel_First; channel < eModemChannel_Last; channel++) {
+        UART_API_StopRawStream(g_modem_channel_uart[channel]);
+        g_is_streaming[channel] = false;
+    }
+}
+
+bool Modem_API_SetLocationCallback (modem_location_callback_t callback) {
+    if (callback == NULL) {
+        DEBUG_ERROR("Invalid location callback!\r\n");
+        return false;
+    }
+
+    g_location_callback = callback;
+
+    return true;
+}
+
+void Modem_API_ReportLocation (sString_t location) {
+    if ((location.str == NULL) || (g_location_callback == NULL)) {
+        return;
+    }
+
+    g_location_callback(location);
+}
+
+void Modem_API_ReportCmeError (int error_code) {
+    g_last_cme_error = error_code;
+}
+
+int Modem_API_GetLastCmeError (void) {
+    return g_last_cme_error;
+}
+
+bool Modem_API_SetClockCallback (modem_clock_callback_t callback) {
+    if (callback == NULL) {
+        DEBUG_ERROR("Invalid clock callback!\r\n");
+        return false;
+    }
+
+    g_clock_callback = callback;
+
+    return true;
+}
+
+void Modem_API_ReportClock (sString_t clock) {
+    if ((clock.str == NULL) || (g_clock_callback == NULL)) {
+        return;
+    }
+
+    g_clock_callback(clock);
+}
+
+void Modem_API_ReportSignalQuality (int rssi) {
+    g_signal_quality = rssi;
+}
+
+/* Skipped while someone else holds the modem, the caller keeps its last reading. */
+eModemError_t Modem_API_QuerySignalQuality (int *rssi) {
+    if (rssi == NULL) {
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_TryLockModem() == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    /* Sent as "+CS" with "Q" as its parameter, the send path needs a non empty parameter string. */
+    char cmd_params[] = SIGNAL_QUALITY_PARAMETERS;
+    g_signal_quality = MODEM_API_SIGNAL_UNKNOWN;
+
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_CSQ, eModemFlags_SignalQuality, cmd_params, sizeof(cmd_params));
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        return error_type;
+    }
+
+    *rssi = g_signal_quality;
+
+    return eModemError_ATSuccess;
+}
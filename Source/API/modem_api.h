@@ -1,71 +1,142 @@
-#ifndef SOURCE_API_MODEM_API_H_
-#define SOURCE_API_MODEM_API_H_
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdint.h>
-#include <stdbool.h>
-#include "error_codes.h"
-/**********************************************************************************************************************
-* Exported definitions and macros
-*********************************************************************************************************************/
-typedef enum eModemCommands {
-   eModemCommands_First = 0,
-   eModemCommands_ATE0 = eModemCommands_First,
-   eModemCommands_QICSGP,
-   eModemCommands_QIACT,
-   eModemCommands_CEREG,
-   eModemCommands_CGPADDR,
-   eModemCommands_QIGETERROR, 
-   eModemCommands_QIOPEN,
-   eModemCommands_QISEND,
-   eModemCommands_QIURC,
-   eModemCommands_QICLOSE,
-   eModemCommands_Last
-} eModemCommands_t;
-
-typedef enum eModemState {
-   eModemState_First = 0,
-   eModemState_TurnedOff = eModemState_First,
-   eModemState_TurnedOn,
-   eModemState_Ready,
-   eModemState_Uninitialized,
-   eModemState_Initialized,
-   eModemState_Last
-} eModemState_t;
-
-typedef enum eModemFlags {
-   eModemFlags_First = 0,
-   eModemFlags_Ready = eModemFlags_First,
-   eModemFlags_ResponseOK,
-   eModemFlags_EchoDisabled,
-   eModemFlags_Error,
-   eModemFlags_Registered,
-   eModemFlags_ValidPDPAddress,
-   eModemFlags_ServerOpen,
-   // eModemFlags_ReadyToSend,
-   eModemFlags_SendOK,
-   eModemFlags_SendFail,
-   eModemFlags_DataReceived,
-   eModemFlag_Last
-} eModemFlags_t;
-/**********************************************************************************************************************
-* Exported types
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Exported variables
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of exported functions
-*********************************************************************************************************************/
-bool Modem_API_Init (void);
-bool Modem_API_SetFlag (eModemFlags_t flag_to_set);
-bool Modem_API_IsFlagSet (eModemFlags_t flag_to_check);
-bool Modem_API_ClearFlag (eModemFlags_t flag_to_clear);
-eModemError_t Modem_API_SendCommand (eModemCommands_t g_modem_AT_commands, eModemFlags_t flag, char *cmd_params_string, size_t cmd_params_size);
-eModemState_t Modem_API_GetState(void);
-bool Modem_API_LockModem (uint32_t timeout);
-bool Modem_API_UnlockModem (void);
-#endif /* SOURCE_API_MODEM_API_H_ */
+#ifndef SOURCE_API_MODEM_API_H_
+#define SOURCE_API_MODEM_API_H_
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "error_codes.h"
+#include "message.h"
+#include "uart_api.h"
+/**********************************************************************************************************************
+* Exported definitions and macros
+*********************************************************************************************************************/
+/* +CSQ rssi when the modem does not know the signal level */
+#define MODEM_API_SIGNAL_UNKNOWN 99
+
+typedef enum eModemCommands {
+   eModemCommands_First = 0,
+   eModemCommands_ATE0 = eModemCommands_First,
+   eModemCommands_QICSGP,
+   eModemCommands_QIACT,
+   eModemCommands_CEREG,
+   eModemCommands_CGPADDR,
+   eModemCommands_QIGETERROR, 
+   eModemCommands_QIOPEN,
+   eModemCommands_QISEND,
+   eModemCommands_QIRD,
+   eModemCommands_QICLOSE,
+   eModemCommands_QICFG,
+   eModemCommands_QIDEACT,
+   eModemCommands_DTRMode,
+   eModemCommands_CMUX,
+   eModemCommands_IFC,
+   eModemCommands_QGPS,
+   eModemCommands_QGPSEND,
+   eModemCommands_QGPSLOC,
+   eModemCommands_QGPSXTRA,
+   eModemCommands_QGPSXTRATIME,
+   eModemCommands_QGPSXTRADATA,
+   eModemCommands_QFUPL,
+   eModemCommands_QFDEL,
+   eModemCommands_CCLK,
+   eModemCommands_CSQ,
+   eModemCommands_Last
+} eModemCommands_t;
+
+typedef enum eModemState {
+   eModemState_First = 0,
+   eModemState_TurnedOff = eModemState_First,
+   eModemState_TurnedOn,
+   eModemState_Ready,
+   eModemState_Uninitialized,
+   eModemState_Initialized,
+   eModemState_Last
+} eModemState_t;
+
+typedef enum eModemFlags {
+   eModemFlags_First = 0,
+   eModemFlags_Ready = eModemFlags_First,
+   eModemFlags_ResponseOK,
+   eModemFlags_EchoDisabled,
+   eModemFlags_Error,
+   eModemFlags_Registered,
+   eModemFlags_ValidPDPAddress,
+   eModemFlags_ServerOpen,
+   eModemFlags_ReadyToSend,
+   eModemFlags_SendOK,
+   eModemFlags_SendFail,
+   eModemFlags_DataReceived,
+   eModemFlags_Connect,
+   eModemFlags_Location,
+   eModemFlags_Clock,
+   eModemFlags_FileUploaded,
+   eModemFlags_SignalQuality,
+   eModemFlag_Last
+} eModemFlags_t;
+
+/* Multiplexer channels, without the multiplexer they all share the plain UART */
+typedef enum eModemChannel {
+   eModemChannel_First = 0,
+   eModemChannel_At = eModemChannel_First,
+   eModemChannel_Data,
+   eModemChannel_Gnss,
+   eModemChannel_Last
+} eModemChannel_t;
+
+typedef enum eModemSocketEvent {
+   eModemSocketEvent_First = 0,
+   eModemSocketEvent_Opened = eModemSocketEvent_First,
+   eModemSocketEvent_OpenFailed,
+   eModemSocketEvent_Closed,
+   eModemSocketEvent_DataReceived,
+   eModemSocketEvent_ContextDeactivated,
+   eModemSocketEvent_Last
+} eModemSocketEvent_t;
+/**********************************************************************************************************************
+* Exported types
+*********************************************************************************************************************/
+typedef void (*modem_socket_event_callback_t) (int socket_id, eModemSocketEvent_t event);
+/* is_stream tells transparent mode bytes apart from the payload of an AT+QIRD reply */
+typedef void (*modem_data_callback_t) (sString_t data, bool is_stream);
+typedef void (*modem_location_callback_t) (sString_t location);
+typedef void (*modem_clock_callback_t) (sString_t clock);
+
+/**********************************************************************************************************************
+* Exported variables
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Prototypes of exported functions
+*********************************************************************************************************************/
+bool Modem_API_Init (void);
+bool Modem_API_SetFlag (eModemFlags_t flag_to_set);
+bool Modem_API_IsFlagSet (eModemFlags_t flag_to_check);
+bool Modem_API_ClearFlag (eModemFlags_t flag_to_clear);
+eModemError_t Modem_API_SendCommand (eModemCommands_t g_modem_AT_commands, eModemFlags_t flag, char *cmd_params_string, size_t cmd_params_size);
+eModemError_t Modem_API_SendChannelCommand (eModemChannel_t channel, eModemCommands_t AT_command, eModemFlags_t flag,
+                                            char *cmd_params_string, size_t cmd_params_size);
+eModemError_t Modem_API_WaitForResult (eModemFlags_t success_flag, eModemFlags_t fail_flag, uint32_t timeout);
+eModemState_t Modem_API_GetState(void);
+/* False when the modem refused the multiplexer and everything runs on the plain UART */
+bool Modem_API_IsMultiplexed (void);
+/* The UART device a channel is on right now, the plain modem UART while not multiplexed */
+eUartApiDevice_t Modem_API_GetChannelUart (eModemChannel_t channel);
+bool Modem_API_LockModem (uint32_t timeout);
+bool Modem_API_TryLockModem (void);
+bool Modem_API_UnlockModem (void);
+bool Modem_API_SetSocketEventCallback (modem_socket_event_callback_t callback);
+void Modem_API_ReportSocketEvent (int socket_id, eModemSocketEvent_t event);
+bool Modem_API_SetDataCallback (modem_data_callback_t callback);
+void Modem_API_RequestStream (void);
+void Modem_API_StopStream (void);
+bool Modem_API_SetLocationCallback (modem_location_callback_t callback);
+void Modem_API_ReportLocation (sString_t location);
+void Modem_API_ReportCmeError (int error_code);
+int Modem_API_GetLastCmeError (void);
+bool Modem_API_SetClockCallback (modem_clock_callback_t callback);
+void Modem_API_ReportClock (sString_t clock);
+void Modem_API_ReportSignalQuality (int rssi);
+/* +CSQ rssi, 0 to 31 or MODEM_API_SIGNAL_UNKNOWN */
+eModemError_t Modem_API_QuerySignalQuality (int *rssi);
+#endif /* SOURCE_API_MODEM_API_H_ */
@@ -0,0 +1,234 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uart_driver.h"
+#include "tim_driver.h"
+#include "power_driver.h"
+#include "power_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define US_IN_S 1000000U
+#define US_PER_TICK (US_IN_S / configTICK_RATE_HZ)
+/* A modem that sees RTS go up finishes at most the byte it is on, two of them at 115200 */
+#define RX_HOLD_SETTLE_US 200U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static bool g_is_initialized = false;
+static TickType_t g_max_stop_ticks = 0;
+static volatile uint32_t g_lock_count = 0;
+static volatile TickType_t g_activity_tick = 0;
+static TickType_t g_resume_tick = 0;
+/* The part of a tick that passed during sleeps but was not stepped yet, never more than one tick */
+static uint32_t g_carry_us = 0;
+/* Written by the idle task with interrupts disabled */
+static sPowerStats_t g_stats = {0};
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Power_API_CanStop (TickType_t expected_idle_ticks);
+static bool Power_API_HoldRx (void);
+static void Power_API_ReleaseRx (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Runs with interrupts disabled */
+static bool Power_API_CanStop (TickType_t expected_idle_ticks) {
+    if ((g_is_initialized == false) || (g_lock_count > 0) || (expected_idle_ticks < POWER_API_MIN_STOP_TICKS)) {
+        return false;
+    }
+
+    if ((xTaskGetTickCount() - g_activity_tick) < pdMS_TO_TICKS(POWER_API_ACTIVITY_HOLD_MS)) {
+        return false;
+    }
+
+    /* The modem gets to send what it held back during the last Stop */
+    if ((xTaskGetTickCount() - g_resume_tick) < pdMS_TO_TICKS(POWER_API_RX_RELEASE_MS)) {
+        return false;
+    }
+
+    /* Stop freezes the UARTs, a byte still in the shift register would go out broken */
+    for (eUartDriver_t uart = eUartDriver_First; uart < eUartDriver_Last; uart++) {
+        if (UART_Driver_IsTxIdle(uart) == false) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Runs with interrupts disabled. RTS goes up so the modem keeps its bytes until the clock is back, false when a byte
+ * got in before it took effect. */
+static bool Power_API_HoldRx (void) {
+    for (eUartDriver_t uart = eUartDriver_First; uart < eUartDriver_Last; uart++) {
+        UART_Driver_SetRxReady(uart, false);
+    }
+
+    uint32_t start = DWT->CYCCNT;
+
+    while ((DWT->CYCCNT - start) < ((SystemCoreClock / US_IN_S) * RX_HOLD_SETTLE_US)) {
+    }
+
+    for (eUartDriver_t uart = eUartDriver_First; uart < eUartDriver_Last; uart++) {
+        if (UART_Driver_IsRxPending(uart) == true) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void Power_API_ReleaseRx (void) {
+    for (eUartDriver_t uart = eUartDriver_First; uart < eUartDriver_Last; uart++) {
+        UART_Driver_SetRxReady(uart, true);
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Power_API_Init (void) {
+    if (Power_Driver_Init() == false) {
+        return false;
+    }
+
+    g_max_stop_ticks = (TickType_t) (((uint64_t) POWER_DRIVER_MAX_STOP_COUNTS * configTICK_RATE_HZ) /
+                                     Power_Driver_GetWakeTimerHz());
+    g_stats.wake_timer_hz = Power_Driver_GetWakeTimerHz();
+    g_is_initialized = true;
+
+    return true;
+}
+
+void Power_API_Lock (void) {
+    taskENTER_CRITICAL();
+    g_lock_count++;
+    taskEXIT_CRITICAL();
+}
+
+void Power_API_Unlock (void) {
+    taskENTER_CRITICAL();
+
+    if (g_lock_count > 0) {
+        g_lock_count--;
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+void Power_API_MarkActivity (void) {
+    g_activity_tick = xTaskGetTickCountFromISR();
+}
+
+uint32_t Power_API_GetStopTime (void) {
+    return g_stats.stop_us;
+}
+
+bool Power_API_GetStats (sPowerStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *stats = g_stats;
+    stats->locks = g_lock_count;
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/* The kernel calls this from the idle task with the scheduler suspended when nothing is due for at least two ticks
+ * (configUSE_TICKLESS_IDLE 2). The tick is stopped, LPTIM1 wakes the core when the next task is due and the ticks
+ * slept are stepped in one go. The last tick is left to the tick interrupt, which is what wakes the task. */
+void vPortSuppressTicksAndSleep (TickType_t expected_idle_ticks) {
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+        __enable_irq();
+        return;
+    }
+
+    if (Power_API_CanStop(expected_idle_ticks) == false) {
+        /* Plain sleep, the next tick or any interrupt wakes the core */
+        __DSB();
+        __WFI();
+        __ISB();
+        __enable_irq();
+        return;
+    }
+
+    if (Power_API_HoldRx() == false) {
+        Power_API_ReleaseRx();
+        __enable_irq();
+        return;
+    }
+
+    if (expected_idle_ticks > g_max_stop_ticks) {
+        expected_idle_ticks = g_max_stop_ticks;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    uint32_t wake_timer_hz = Power_Driver_GetWakeTimerHz();
+    uint32_t tick_elapsed_us = (SysTick->LOAD - SysTick->VAL) / (SystemCoreClock / US_IN_S);
+    uint32_t sleep_us = (expected_idle_ticks * US_PER_TICK) - tick_elapsed_us;
+    /* Rounded up, so a full sleep always reaches the tick the next task is due on */
+    uint32_t requested = (uint32_t) ((((uint64_t) sleep_us * wake_timer_hz) + US_IN_S - 1U) / US_IN_S);
+    uint32_t counts = Power_Driver_Stop(requested);
+    uint32_t stop_us = (uint32_t) (((uint64_t) counts * US_IN_S) / wake_timer_hz);
+    uint32_t total_us = g_carry_us + tick_elapsed_us + stop_us;
+    TickType_t ticks = total_us / US_PER_TICK;
+
+    g_carry_us = total_us % US_PER_TICK;
+
+    if (ticks >= expected_idle_ticks) {
+        /* The kernel cannot step past the task that is due, more than a tick over is dropped */
+        if (ticks > expected_idle_ticks) {
+            g_carry_us = US_PER_TICK - 1U;
+        }
+
+        ticks = expected_idle_ticks - 1U;
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    }
+
+    if (counts < requested) {
+        g_stats.early_wakeups++;
+    }
+
+    if (ticks > 0) {
+        vTaskStepTick(ticks);
+    }
+
+    /* TIM13 was stopped as well, the time goes to the idle task like any other idle time */
+    TIM13_AddRunTime(stop_us);
+
+    g_stats.stops++;
+    g_stats.stop_us += stop_us;
+
+    Power_API_ReleaseRx();
+    g_resume_tick = xTaskGetTickCount();
+
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __enable_irq();
+}
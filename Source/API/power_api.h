@@ -0,0 +1,45 @@
+#ifndef SOURCE_API_POWER_API_H_
+#define SOURCE_API_POWER_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Shorter idle stretches are slept through with the tick running, a Stop costs a PLL relock on the way out */
+#define POWER_API_MIN_STOP_TICKS 4U
+/* Bytes are lost when a UART wakes the core, so Stop waits until the lines have been quiet for this long */
+#define POWER_API_ACTIVITY_HOLD_MS 2000U
+/* The modem UART is held with RTS during a Stop, after one RTS stays down at least this long */
+#define POWER_API_RX_RELEASE_MS 20U
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sPowerStats {
+    uint32_t wake_timer_hz;
+    uint32_t stops;
+    /* Stops cut short by something else than the wake timer, a UART line in practice */
+    uint32_t early_wakeups;
+    /* Time spent in Stop, in microseconds, wraps like the run time counter */
+    uint32_t stop_us;
+    uint32_t locks;
+} sPowerStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Until this succeeds the idle task only sleeps with the tick running */
+bool Power_API_Init (void);
+/* Keeps the core out of Stop while held, for anything that cannot lose a byte or needs the fast clocks running */
+void Power_API_Lock (void);
+void Power_API_Unlock (void);
+/* Called by the UART receive interrupts, restarts the quiet period */
+void Power_API_MarkActivity (void);
+uint32_t Power_API_GetStopTime (void);
+bool Power_API_GetStats (sPowerStats_t *stats);
+#endif /* SOURCE_API_POWER_API_H_ */
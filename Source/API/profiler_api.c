@@ -0,0 +1,221 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tim_driver.h"
+#include "metrics_api.h"
+#include "power_api.h"
+#include "profiler_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define PROFILE_FORMAT_VERSION 1U
+#define PROFILE_LINE_SIZE 96U
+#define SLOTS_PER_LINE 3U
+/* A full neighbourhood drops the sample rather than keep the interrupt busy */
+#define MAX_PROBES 8U
+#define SLOT_MASK (PROFILER_API_SLOTS - 1U)
+#define HASH_MULTIPLIER 2654435761U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* A slot with a zero count is free */
+typedef struct sProfilerSlot {
+    uint32_t pc;
+    uint32_t count;
+    uint16_t task;
+} sProfilerSlot_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+/* Written by the sampling interrupt only, everything else stops it first */
+static sProfilerSlot_t g_slots[PROFILER_API_SLOTS];
+static volatile uint32_t g_samples = 0;
+static volatile uint32_t g_dropped = 0;
+static volatile uint32_t g_slots_used = 0;
+static bool g_is_running = false;
+static uint32_t g_rate_hz = PROFILER_API_DEFAULT_RATE_HZ;
+/* Too big for the stack of the task that asks for the dump */
+static sMetricsTask_t g_dump_tasks[METRICS_API_MAX_TASKS];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Profiler_API_OnSample (uint32_t pc, uint32_t exception);
+static bool Profiler_API_WriteLine (profiler_write_callback_t write, void *context, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Runs above the kernel interrupts. Reading the current task handle and its number is a plain load, nothing else of the
+ * kernel is touched. */
+static void Profiler_API_OnSample (uint32_t pc, uint32_t exception) {
+    uint16_t task = PROFILER_API_TASK_ISR;
+
+    if (exception == 0) {
+        task = (uint16_t) uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+    }
+
+    uint32_t hash = (((pc >> 1) ^ ((uint32_t) task << 24)) * HASH_MULTIPLIER) >> 16;
+
+    for (uint32_t probe = 0; probe < MAX_PROBES; probe++) {
+        sProfilerSlot_t *slot = &g_slots[(hash + probe) & SLOT_MASK];
+
+        if (slot->count == 0) {
+            slot->pc = pc;
+            slot->task = task;
+            slot->count = 1;
+            g_slots_used++;
+            g_samples++;
+            return;
+        }
+
+        if ((slot->pc == pc) && (slot->task == task)) {
+            slot->count++;
+            g_samples++;
+            return;
+        }
+    }
+
+    g_dropped++;
+}
+
+static bool Profiler_API_WriteLine (profiler_write_callback_t write, void *context, const char *format, ...) {
+    char line[PROFILE_LINE_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    int size = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if ((size < 0) || ((size_t) size >= sizeof(line))) {
+        return false;
+    }
+
+    return write(line, (size_t) size, context);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Profiler_API_Start (uint32_t rate_hz) {
+    if (TIM14_StartSampling(rate_hz, &Profiler_API_OnSample) == false) {
+        return false;
+    }
+
+    /* TIM14 stops in Stop, the idle time would go unsampled */
+    if (g_is_running == false) {
+        Power_API_Lock();
+    }
+
+    g_rate_hz = rate_hz;
+    g_is_running = true;
+
+    return true;
+}
+
+void Profiler_API_Stop (void) {
+    TIM14_StopSampling();
+
+    if (g_is_running == true) {
+        Power_API_Unlock();
+    }
+
+    g_is_running = false;
+}
+
+void Profiler_API_Reset (void) {
+    bool was_running = g_is_running;
+
+    Profiler_API_Stop();
+
+    memset(g_slots, 0, sizeof(g_slots));
+    g_samples = 0;
+    g_dropped = 0;
+    g_slots_used = 0;
+
+    if (was_running == true) {
+        Profiler_API_Start(g_rate_hz);
+    }
+}
+
+bool Profiler_API_GetStats (sProfilerStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    stats->is_running = g_is_running;
+    stats->rate_hz = g_rate_hz;
+    stats->samples = g_samples;
+    stats->dropped = g_dropped;
+    stats->slots_used = g_slots_used;
+
+    return true;
+}
+
+/* A header, the tasks by number, the slots as pc:task:count, three to a line, and an end marker. Every line starts with
+ * PROFILE so the host can pick them out of a console log, Tools/profile_report.py resolves the addresses. */
+bool Profiler_API_Dump (profiler_write_callback_t write, void *context) {
+    if (write == NULL) {
+        return false;
+    }
+
+    bool was_running = g_is_running;
+
+    Profiler_API_Stop();
+
+    size_t task_count = 0;
+    bool is_written = Profiler_API_WriteLine(write, context, "PROFILE BEGIN %u %lu %lu %lu %lu", PROFILE_FORMAT_VERSION,
+                                             g_rate_hz, g_samples, g_dropped, g_slots_used);
+
+    if (Metrics_API_GetTasks(g_dump_tasks, METRICS_API_MAX_TASKS, &task_count, NULL) == false) {
+        task_count = 0;
+    }
+
+    for (size_t index = 0; (is_written == true) && (index < task_count); index++) {
+        is_written = Profiler_API_WriteLine(write, context, "PROFILE TASK %lu %s", g_dump_tasks[index].number,
+                                            g_dump_tasks[index].name);
+    }
+
+    for (size_t index = 0; (is_written == true) && (index < PROFILER_API_SLOTS); ) {
+        char line[PROFILE_LINE_SIZE];
+        int size = snprintf(line, sizeof(line), "PROFILE SAMPLES");
+        size_t in_line = 0;
+
+        for (; (index < PROFILER_API_SLOTS) && (in_line < SLOTS_PER_LINE); index++) {
+            if (g_slots[index].count == 0) {
+                continue;
+            }
+
+            size += snprintf(&line[size], sizeof(line) - size, " %08lx:%u:%lu", g_slots[index].pc, g_slots[index].task,
+                             g_slots[index].count);
+            in_line++;
+        }
+
+        if (in_line > 0) {
+            is_written = write(line, (size_t) size, context);
+        }
+    }
+
+    if (is_written == true) {
+        is_written = Profiler_API_WriteLine(write, context, "PROFILE END");
+    }
+
+    if (was_running == true) {
+        Profiler_API_Start(g_rate_hz);
+    }
+
+    return is_written;
+}
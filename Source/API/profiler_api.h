@@ -0,0 +1,45 @@
+#ifndef SOURCE_API_PROFILER_API_H_
+#define SOURCE_API_PROFILER_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Just off the 1 kHz tick, so the samples do not lock onto it */
+#define PROFILER_API_DEFAULT_RATE_HZ 997U
+/* Power of two, every distinct program counter and task pair takes a slot of 12 bytes */
+#define PROFILER_API_SLOTS 512U
+/* The task number of samples taken while an interrupt was running, tasks are numbered from 1 by trace_api.h */
+#define PROFILER_API_TASK_ISR 0U
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sProfilerStats {
+    bool is_running;
+    uint32_t rate_hz;
+    uint32_t samples;
+    uint32_t dropped;
+    uint32_t slots_used;
+} sProfilerStats_t;
+
+/* Takes one line of the dump without the line ending, false stops the dump */
+typedef bool (*profiler_write_callback_t) (const char *line, size_t size, void *context);
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Samples are added to what is already there, Profiler_API_Reset starts over */
+bool Profiler_API_Start (uint32_t rate_hz);
+void Profiler_API_Stop (void);
+void Profiler_API_Reset (void);
+bool Profiler_API_GetStats (sProfilerStats_t *stats);
+/* Sampling is paused while the histogram is written out and picks up again afterwards */
+bool Profiler_API_Dump (profiler_write_callback_t write, void *context);
+#endif /* SOURCE_API_PROFILER_API_H_ */
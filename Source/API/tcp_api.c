@@ -1,152 +1,682 @@
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdio.h>
-#include <string.h>
-#include "cmsis_os2.h"
-#include "message.h"
-#include "uart_api.h"
-#include "debug_api.h"
-#include "modem_api.h"
-#include "heap_api.h"
-#include "tcp_api.h"
-#include "tcp_app.h"
-/**********************************************************************************************************************
- * Private definitions and macros
- *********************************************************************************************************************/
-#define COMMAND_PARAMETERS_BUFFER_SIZE 50
-#define MODEM_LOCK_TIMEOUT_MS 450
-#define MAX_PORT 65536
-#define MIN_PORT 0
-#define MODEM_UART eUartApiDevice_Modem
-#define FAILED_TO_LOCK_MODEM "Failed to lock the modem!\r\n"
-#define FAILED_TO_UNLOCK_MODEM "Failed to unlock the modem!\r\n"
-/**********************************************************************************************************************
- * Private typedef
- *********************************************************************************************************************/
- 
-/**********************************************************************************************************************
- * Private constants
- *********************************************************************************************************************/
-CREATE_MODULE_TAG(TCP_API);
-/**********************************************************************************************************************
- * Private variables
- *********************************************************************************************************************/
-size_t cmd_params_size = 0;
-static char cmd_params_str[COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
-/**********************************************************************************************************************
- * Exported variables and references
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of private functions
- *********************************************************************************************************************/
- 
-/**********************************************************************************************************************
- * Definitions of private functions
- *********************************************************************************************************************/
- 
-/**********************************************************************************************************************
- * Definitions of exported functions
- *********************************************************************************************************************/
-eModemError_t TCP_API_Connect (eServerId_t connect_id, char *ip_address, size_t port) {
-    if ((ip_address == NULL) || (port < MIN_PORT) || (port > MAX_PORT) ||
-        (connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
-        DEBUG_INFO("Invalid IP address, port or socket ID!\r\n");
-        return eModemError_InvalidParameters;
-    }
-
-    if (Modem_API_GetState() != eModemState_Initialized) {
-        DEBUG_ERROR("Modem is not initialized yet, wait for modem to be initialized!\r\n");
-        return eModemError_InvalidState;
-    }
-
-    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
-        return eModemError_ResourceBusy;
-    }
-
-    size_t cmd_params_size = 0;
-    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, 
-                               "1,%d,\"TCP\",\"%s\",%u,0,1", connect_id, ip_address, port);
-    if (Modem_API_SendCommand(eModemCommands_QIOPEN, eModemFlags_ServerOpen, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-        if (Modem_API_UnlockModem() == false) {
-            return eModemError_Unknown;
-        }
-        return eModemError_SendFail;
-    }
-
-    if (Modem_API_UnlockModem() == false) {
-        return eModemError_Unknown;
-    }
-
-    return eModemError_ATSuccess;
-}
-
-eModemError_t TCP_API_Send (eServerId_t connect_id, char *server_data_str, size_t server_data_size) {
-    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || 
-        (server_data_str == NULL) || (server_data_size == 0)) {
-        DEBUG_INFO("Incorrect socket ID or data!\r\n");
-        Heap_API_Free(server_data_str);
-        return eModemError_InvalidParameters;
-    }
-
-    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
-        Heap_API_Free(server_data_str);
-        return eModemError_ResourceBusy;
-    }
-
-    sString_t data_to_server = {.size = server_data_size, .str = server_data_str};
-
-    size_t cmd_params_size = 0;
-    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d", connect_id);
-    if (Modem_API_SendCommand(eModemCommands_QISEND, eModemFlags_SendOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-        if (Modem_API_UnlockModem() == false) {
-            Heap_API_Free(server_data_str);
-            return eModemError_Unknown;
-        }
-        Heap_API_Free(server_data_str);
-        return eModemError_SendFail;
-    }
-
-    osDelay(10);
-
-    if (UART_API_SendMessage(MODEM_UART, data_to_server) == false) {
-        DEBUG_ERROR("Failed to send %s command!\r\n", data_to_server);
-        Heap_API_Free(server_data_str);
-        return eModemError_SendFail;
-    }
-
-    Heap_API_Free(data_to_server.str);
-
-    if (Modem_API_UnlockModem() == false) {
-        return eModemError_Unknown;
-    }
-    
-    return eModemError_ATSuccess;
-}
-
-eModemError_t TCP_API_Disconnect (eServerId_t connect_id) {
-    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
-        DEBUG_INFO("Incorrect socket ID!\r\n");
-        return eModemError_InvalidParameters;
-    }
-
-    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
-        return eModemError_ResourceBusy;
-    }
-
-    size_t cmd_params_size = 0;
-    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d", connect_id);
-    if (Modem_API_SendCommand(eModemCommands_QICLOSE, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
-        if (Modem_API_UnlockModem() == false) {
-            return eModemError_Unknown;
-        }
-        return eModemError_SendFail;
-    }
-
-    if (Modem_API_UnlockModem() == false) {
-        return eModemError_Unknown;
-    }
-
-	return eModemError_ATSuccess;
-}
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "message.h"
+#include "ring_buffer.h"
+#include "gpio_driver.h"
+#include "string_util.h"
+#include "uart_api.h"
+#include "debug_api.h"
+#include "modem_api.h"
+#include "heap_api.h"
+#include "power_api.h"
+#include "tcp_api.h"
+#include "tcp_app.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define COMMAND_PARAMETERS_BUFFER_SIZE 50
+#define MODEM_LOCK_TIMEOUT_MS 450
+#define SEND_RESULT_TIMEOUT_MS 3000
+/* How much longer a slow > prompt is waited for before the data phase is padded out */
+#define SEND_PROMPT_LATE_TIMEOUT_MS 2000
+#define SEND_PAD_CHUNK_SIZE 64
+#define MAX_PORT 65536
+#define MIN_PORT 0
+#define PDP_CONTEXT_ID 1
+#define UDP_SERVICE_LOCAL_ADDRESS "127.0.0.1"
+#define SOCKET_ACCESS_MODE_BUFFER 1
+#define READ_CHUNK_SIZE 512
+#define RX_MUTEX_ATTR_NAME "TcpRxMutex"
+#define RX_EVENT_FLAG_ATTR_NAME "TcpRxFlag"
+#define RX_MUTEX_TIMEOUT_MS 50
+#define RX_FLAG(connect_id) (1U << (connect_id))
+#define SOCKET_ACCESS_MODE_TRANSPARENT 2
+#define STREAM_CONNECT_TIMEOUT_MS 30000
+#define STREAM_PACKET_SIZE 1460
+#define STREAM_WAIT_TIME_100MS 2
+#define STREAM_ESCAPE_SEQUENCE "+++"
+#define STREAM_ESCAPE_GUARD_TIME_MS 1000
+#define STREAM_DTR_PULSE_MS 100
+#define STREAM_EXIT_TIMEOUT_MS 2000
+/* Any other command can be running on the AT channel when a multiplexed stream closes */
+#define STREAM_CLOSE_LOCK_TIMEOUT_MS 10000
+#define NO_STREAM_SOCKET eServerId_Last
+#define MODEM_UART eUartApiDevice_Modem
+#define FAILED_TO_LOCK_MODEM "Failed to lock the modem!\r\n"
+#define FAILED_TO_UNLOCK_MODEM "Failed to unlock the modem!\r\n"
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+ 
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(TCP_API);
+static const osMutexAttr_t g_rx_mutex_attr = {
+    .name = RX_MUTEX_ATTR_NAME
+};
+static const osEventFlagsAttr_t g_rx_flag_attr = {
+    .name = RX_EVENT_FLAG_ATTR_NAME
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+size_t cmd_params_size = 0;
+static char cmd_params_str[COMMAND_PARAMETERS_BUFFER_SIZE] = {0};
+static osMutexId_t g_rx_mutex_id = NULL;
+static osEventFlagsId_t g_rx_flag_id = NULL;
+static RingBufferHandle_t g_rx_ring [eServerId_Last] = {NULL};
+static tcp_api_recv_callback_t g_recv_callback [eServerId_Last] = {NULL};
+static char g_read_chunk[READ_CHUNK_SIZE];
+static size_t g_read_chunk_size = 0;
+static volatile eServerId_t g_stream_connect_id = NO_STREAM_SOCKET;
+static uint32_t g_stream_start_tick = 0;
+/* Set while a stream runs on the data channel, the modem lock is free and only the power lock is held */
+static bool g_is_stream_multiplexed = false;
+static sTcpStreamStats_t g_stream_stats = {0};
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static eModemError_t TCP_API_SendPayload (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size);
+static eModemError_t TCP_API_SendLocked (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size);
+static eModemError_t TCP_API_PadOutSend (eServerId_t connect_id, size_t server_data_size);
+static void TCP_API_OnModemData (sString_t data, bool is_stream);
+static void TCP_API_Deliver (eServerId_t connect_id, const char *data, size_t data_size, tcp_api_recv_callback_t filter);
+static size_t TCP_API_PopReceived (eServerId_t connect_id, char *buffer, size_t buffer_size);
+static eModemError_t TCP_API_ConfigureStream (void);
+static void TCP_API_EndStream (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static eModemError_t TCP_API_SendPayload (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size) {
+    if ((Modem_API_ClearFlag(eModemFlags_SendOK) && Modem_API_ClearFlag(eModemFlags_SendFail)) == false) {
+        return eModemError_ClearFlagFail;
+    }
+
+    size_t cmd_params_size = 0;
+    if (ip_address == NULL) {
+        cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%u", connect_id, (unsigned) server_data_size);
+    } else {
+        cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%u,\"%s\",%u", 
+                                   connect_id, (unsigned) server_data_size, ip_address, (unsigned) port);
+    }
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QISEND, eModemFlags_ReadyToSend, cmd_params_str, cmd_params_size);
+
+    /* A prompt that is only late still opens the data phase, the payload has to follow it or the modem takes the next
+     * command for socket data */
+    if (error_type == eModemError_WaitFlagFail) {
+        error_type = Modem_API_WaitForResult(eModemFlags_ReadyToSend, eModemFlags_Error, SEND_PROMPT_LATE_TIMEOUT_MS);
+
+        if (error_type == eModemError_WaitFlagFail) {
+            return TCP_API_PadOutSend(connect_id, server_data_size);
+        }
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Modem did not prompt for socket %d data!\r\n", connect_id);
+        return eModemError_NoResponse;
+    }
+
+    sString_t data_to_server = {.size = server_data_size, .str = server_data_str};
+    if (UART_API_SendMessage(MODEM_UART, data_to_server) == false) {
+        DEBUG_ERROR("Failed to write %u bytes of socket %d data!\r\n", (unsigned) server_data_size, connect_id);
+        return eModemError_SendFail;
+    }
+
+    if (Modem_API_WaitForResult(eModemFlags_SendOK, eModemFlags_SendFail, SEND_RESULT_TIMEOUT_MS) != eModemError_ATSuccess) {
+        return eModemError_SendFail;
+    }
+
+    return eModemError_ATSuccess;
+}
+
+/* The prompt may have been lost on the line with the modem already counting data bytes, NULs fill the count it asked for
+ * and are dropped by the command parser when it never did */
+static eModemError_t TCP_API_PadOutSend (eServerId_t connect_id, size_t server_data_size) {
+    static char pad[SEND_PAD_CHUNK_SIZE] = {0};
+
+    DEBUG_ERROR("Modem did not prompt for socket %d data, padding out %u bytes!\r\n", connect_id, (unsigned) server_data_size);
+
+    for (size_t offset = 0; offset < server_data_size; offset += SEND_PAD_CHUNK_SIZE) {
+        size_t chunk_size = server_data_size - offset;
+        sString_t pad_chunk = {.size = (chunk_size > SEND_PAD_CHUNK_SIZE) ? SEND_PAD_CHUNK_SIZE : chunk_size, .str = pad};
+
+        if (UART_API_SendMessage(MODEM_UART, pad_chunk) == false) {
+            return eModemError_SendFail;
+        }
+    }
+
+    /* The SEND OK or SEND FAIL of the padding must not be taken for the result of the next send */
+    Modem_API_WaitForResult(eModemFlags_SendOK, eModemFlags_SendFail, SEND_RESULT_TIMEOUT_MS);
+
+    return eModemError_NoResponse;
+}
+
+static eModemError_t TCP_API_SendLocked (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || 
+        (server_data_str == NULL) || (server_data_size == 0) || (server_data_size > TCP_API_MAX_SEND_SIZE)) {
+        DEBUG_INFO("Incorrect socket ID or data!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    eModemError_t error_type = TCP_API_SendPayload(connect_id, ip_address, port, server_data_str, server_data_size);
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+    
+    return error_type;
+}
+
+static void TCP_API_OnModemData (sString_t data, bool is_stream) {
+    eServerId_t stream_connect_id = g_stream_connect_id;
+
+    if ((is_stream == true) && (stream_connect_id != NO_STREAM_SOCKET)) {
+        g_stream_stats.bytes_received += data.size;
+        TCP_API_Deliver(stream_connect_id, data.str, data.size, NULL);
+        return;
+    }
+
+    size_t data_size = (data.size > READ_CHUNK_SIZE) ? READ_CHUNK_SIZE : data.size;
+
+    memcpy(g_read_chunk, data.str, data_size);
+    g_read_chunk_size = data_size;
+}
+
+static void TCP_API_Deliver (eServerId_t connect_id, const char *data, size_t data_size, tcp_api_recv_callback_t filter) {
+    if ((filter != NULL) && (filter(connect_id, data, data_size) == true)) {
+        return;
+    }
+
+    if ((g_recv_callback[connect_id] != NULL) && (g_recv_callback[connect_id](connect_id, data, data_size) == true)) {
+        return;
+    }
+
+    if (osMutexAcquire(g_rx_mutex_id, RX_MUTEX_TIMEOUT_MS) != osOK) {
+        DEBUG_ERROR("Failed to lock socket %d RX ring, dropping %u bytes!\r\n", connect_id, (unsigned) data_size);
+        return;
+    }
+
+    if (g_rx_ring[connect_id] == NULL) {
+        g_rx_ring[connect_id] = RingBuffer_Init(TCP_API_RX_RING_SIZE);
+    }
+
+    size_t stored = 0;
+    while ((stored < data_size) && RingBuffer_Put(g_rx_ring[connect_id], (uint8_t) data[stored])) {
+        stored++;
+    }
+
+    osMutexRelease(g_rx_mutex_id);
+
+    if (stored < data_size) {
+        DEBUG_WARN("Socket %d RX ring is full, dropped %u bytes!\r\n", connect_id, (unsigned) (data_size - stored));
+    }
+
+    osEventFlagsSet(g_rx_flag_id, RX_FLAG(connect_id));
+}
+
+static size_t TCP_API_PopReceived (eServerId_t connect_id, char *buffer, size_t buffer_size) {
+    if (osMutexAcquire(g_rx_mutex_id, RX_MUTEX_TIMEOUT_MS) != osOK) {
+        return 0;
+    }
+
+    size_t received = 0;
+    while ((received < buffer_size) && RingBuffer_Get(g_rx_ring[connect_id], (uint8_t *) &buffer[received])) {
+        received++;
+    }
+
+    osMutexRelease(g_rx_mutex_id);
+
+    return received;
+}
+
+static eModemError_t TCP_API_ConfigureStream (void) {
+    size_t cmd_params_size = 0;
+
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "\"transpktsize\",%d", STREAM_PACKET_SIZE);
+    if (Modem_API_SendChannelCommand(eModemChannel_Data, eModemCommands_QICFG, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+        DEBUG_WARN("Failed to set the transparent mode packet size!\r\n");
+    }
+
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "\"transwaittm\",%d", STREAM_WAIT_TIME_100MS);
+    if (Modem_API_SendChannelCommand(eModemChannel_Data, eModemCommands_QICFG, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+        DEBUG_WARN("Failed to set the transparent mode wait time!\r\n");
+    }
+
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "1");
+    return Modem_API_SendChannelCommand(eModemChannel_Data, eModemCommands_DTRMode, eModemFlags_ResponseOK, cmd_params_str,
+                                        cmd_params_size);
+}
+
+static void TCP_API_EndStream (void) {
+    Modem_API_StopStream();
+    g_stream_stats.active_ms += osKernelGetTickCount() - g_stream_start_tick;
+    g_stream_connect_id = NO_STREAM_SOCKET;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool TCP_API_Init (void) {
+    if (g_rx_mutex_id == NULL) {
+        g_rx_mutex_id = osMutexNew(&g_rx_mutex_attr);
+        if (g_rx_mutex_id == NULL) {
+            DEBUG_ERROR("Failed to create mutex for socket RX rings!\r\n");
+            return false;
+        }
+    }
+
+    if (g_rx_flag_id == NULL) {
+        g_rx_flag_id = osEventFlagsNew(&g_rx_flag_attr);
+        if (g_rx_flag_id == NULL) {
+            DEBUG_ERROR("Failed to create an event flag for socket RX indication!\r\n");
+            return false;
+        }
+    }
+
+    if (Modem_API_SetDataCallback(&TCP_API_OnModemData) == false) {
+        return false;
+    }
+
+    return true;
+}
+
+eModemError_t TCP_API_Connect (eServerId_t connect_id, eSocketService_t service, char *ip_address, size_t port) {
+    if ((ip_address == NULL) || (port < MIN_PORT) || (port > MAX_PORT) ||
+        (connect_id < eServerId_First) || (connect_id >= eServerId_Last) ||
+        (service < eSocketService_First) || (service >= eSocketService_Last)) {
+        DEBUG_INFO("Invalid IP address, port or socket ID!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_GetState() != eModemState_Initialized) {
+        DEBUG_ERROR("Modem is not initialized yet, wait for modem to be initialized!\r\n");
+        return eModemError_InvalidState;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    size_t cmd_params_size = 0;
+    switch (service) {
+        case eSocketService_Tcp: {
+            cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%d,\"TCP\",\"%s\",%u,0,%d", 
+                                       PDP_CONTEXT_ID, connect_id, ip_address, (unsigned) port, SOCKET_ACCESS_MODE_BUFFER);
+            break;
+        }
+        case eSocketService_Udp: {
+            cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%d,\"UDP\",\"%s\",%u,0,%d", 
+                                       PDP_CONTEXT_ID, connect_id, ip_address, (unsigned) port, SOCKET_ACCESS_MODE_BUFFER);
+            break;
+        }
+        default: {
+            cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%d,\"UDP SERVICE\",\"%s\",0,%u,%d", 
+                                       PDP_CONTEXT_ID, connect_id, UDP_SERVICE_LOCAL_ADDRESS, (unsigned) port, SOCKET_ACCESS_MODE_BUFFER);
+            break;
+        }
+    }
+
+    if (Modem_API_SendCommand(eModemCommands_QIOPEN, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+        if (Modem_API_UnlockModem() == false) {
+            return eModemError_Unknown;
+        }
+        return eModemError_SendFail;
+    }
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    return eModemError_ATSuccess;
+}
+
+eModemError_t TCP_API_Send (eServerId_t connect_id, char *server_data_str, size_t server_data_size) {
+    return TCP_API_SendLocked(connect_id, NULL, 0, server_data_str, server_data_size);
+}
+
+eModemError_t TCP_API_SendTo (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size) {
+    if ((ip_address == NULL) || (port < MIN_PORT) || (port > MAX_PORT)) {
+        DEBUG_INFO("Invalid datagram IP address or port!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    return TCP_API_SendLocked(connect_id, ip_address, port, server_data_str, server_data_size);
+}
+
+eModemError_t TCP_API_Disconnect (eServerId_t connect_id) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        DEBUG_INFO("Incorrect socket ID!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    size_t cmd_params_size = 0;
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d", connect_id);
+    if (Modem_API_SendCommand(eModemCommands_QICLOSE, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size) != eModemError_ATSuccess) {
+        if (Modem_API_UnlockModem() == false) {
+            return eModemError_Unknown;
+        }
+        return eModemError_SendFail;
+    }
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+	return eModemError_ATSuccess;
+}
+
+eModemError_t TCP_API_SetKeepalive (uint32_t idle_min, uint32_t interval_s, uint32_t probe_count) {
+    if ((idle_min == 0) || (interval_s == 0) || (probe_count == 0)) {
+        DEBUG_INFO("Invalid keepalive parameters!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    size_t cmd_params_size = 0;
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE,
+                               "\"tcp/keepalive\",1,%lu,%lu,%lu", (unsigned long) idle_min, (unsigned long) interval_s,
+                               (unsigned long) probe_count);
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QICFG, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size);
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    return error_type;
+}
+
+eModemError_t TCP_API_ReactivateContext (void) {
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    size_t cmd_params_size = 0;
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d", PDP_CONTEXT_ID);
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QIDEACT, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size);
+
+    if (error_type == eModemError_ATSuccess) {
+        error_type = Modem_API_SendCommand(eModemCommands_QIACT, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size);
+    }
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    return error_type;
+}
+
+eModemError_t TCP_API_ReadSocket (eServerId_t connect_id, tcp_api_recv_callback_t filter) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        DEBUG_INFO("Incorrect socket ID!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    /* The modem keeps buffering until a read returns nothing, a datagram socket returns one datagram per read. */
+    while (1) {
+        if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+            return eModemError_ResourceBusy;
+        }
+
+        g_read_chunk_size = 0;
+
+        size_t cmd_params_size = 0;
+        cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%d", connect_id, READ_CHUNK_SIZE);
+        eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QIRD, eModemFlags_ResponseOK, cmd_params_str, cmd_params_size);
+        size_t chunk_size = g_read_chunk_size;
+
+        if (Modem_API_UnlockModem() == false) {
+            return eModemError_Unknown;
+        }
+
+        if (error_type != eModemError_ATSuccess) {
+            return error_type;
+        }
+
+        if (chunk_size == 0) {
+            break;
+        }
+
+        TCP_API_Deliver(connect_id, g_read_chunk, chunk_size, filter);
+    }
+
+    return eModemError_ATSuccess;
+}
+
+size_t TCP_API_Recv (eServerId_t connect_id, char *buffer, size_t buffer_size, uint32_t timeout) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || (buffer == NULL) || (buffer_size == 0)) {
+        return 0;
+    }
+
+    osEventFlagsClear(g_rx_flag_id, RX_FLAG(connect_id));
+
+    size_t received = TCP_API_PopReceived(connect_id, buffer, buffer_size);
+
+    if ((received > 0) || (timeout == 0)) {
+        return received;
+    }
+
+    if (osEventFlagsWait(g_rx_flag_id, RX_FLAG(connect_id), osFlagsWaitAny, timeout) >= osFlagsError) {
+        return 0;
+    }
+
+    return TCP_API_PopReceived(connect_id, buffer, buffer_size);
+}
+
+bool TCP_API_SetRecvCallback (eServerId_t connect_id, tcp_api_recv_callback_t callback) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return false;
+    }
+
+    g_recv_callback[connect_id] = callback;
+
+    return true;
+}
+
+void TCP_API_FlushRecv (eServerId_t connect_id) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return;
+    }
+
+    uint8_t byte;
+
+    if (osMutexAcquire(g_rx_mutex_id, RX_MUTEX_TIMEOUT_MS) != osOK) {
+        return;
+    }
+
+    while (RingBuffer_Get(g_rx_ring[connect_id], &byte)) {
+        continue;
+    }
+
+    osMutexRelease(g_rx_mutex_id);
+}
+
+eModemError_t TCP_API_OpenStream (eServerId_t connect_id, char *ip_address, size_t port) {
+    if ((ip_address == NULL) || (port < MIN_PORT) || (port > MAX_PORT) ||
+        (connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        DEBUG_INFO("Invalid IP address, port or socket ID!\r\n");
+        return eModemError_InvalidParameters;
+    }
+
+    if (g_stream_connect_id != NO_STREAM_SOCKET) {
+        DEBUG_INFO("Socket %d is already streaming!\r\n", g_stream_connect_id);
+        return eModemError_InvalidState;
+    }
+
+    if (Modem_API_GetState() != eModemState_Initialized) {
+        DEBUG_ERROR("Modem is not initialized yet, wait for modem to be initialized!\r\n");
+        return eModemError_InvalidState;
+    }
+
+    /* Without the multiplexer the modem stays locked for the whole session, the UART carries nothing but stream bytes
+     * until it is closed. */
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    if (TCP_API_ConfigureStream() != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to enable DTR data mode control!\r\n");
+        Modem_API_UnlockModem();
+        return eModemError_SendFail;
+    }
+
+    Modem_API_RequestStream();
+    g_stream_connect_id = connect_id;
+
+    size_t cmd_params_size = 0;
+    cmd_params_size = snprintf(cmd_params_str, COMMAND_PARAMETERS_BUFFER_SIZE, "%d,%d,\"TCP\",\"%s\",%u,0,%d", 
+                               PDP_CONTEXT_ID, connect_id, ip_address, (unsigned) port, SOCKET_ACCESS_MODE_TRANSPARENT);
+
+    if (Modem_API_ClearFlag(eModemFlags_Connect) == false) {
+        g_stream_connect_id = NO_STREAM_SOCKET;
+        Modem_API_StopStream();
+        Modem_API_UnlockModem();
+        return eModemError_ClearFlagFail;
+    }
+
+    eModemError_t error_type = Modem_API_SendChannelCommand(eModemChannel_Data, eModemCommands_QIOPEN, eModemFlags_Connect,
+                                                            cmd_params_str, cmd_params_size);
+
+    /* CONNECT can take longer than a regular command reply, only a missing reply gets the full connect timeout. An
+     * ERROR or a failed write ends the attempt straight away. */
+    if (error_type == eModemError_WaitFlagFail) {
+        error_type = Modem_API_WaitForResult(eModemFlags_Connect, eModemFlags_Error, STREAM_CONNECT_TIMEOUT_MS);
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Socket %d did not enter data mode!\r\n", connect_id);
+        g_stream_connect_id = NO_STREAM_SOCKET;
+        Modem_API_StopStream();
+        Modem_API_UnlockModem();
+        return (error_type == eModemError_WaitFlagFail) ? eModemError_NoResponse : error_type;
+    }
+
+    g_stream_start_tick = osKernelGetTickCount();
+    g_stream_stats.sessions++;
+
+    /* On its own channel the stream leaves the AT channel to everyone else */
+    g_is_stream_multiplexed = Modem_API_IsMultiplexed();
+
+    if (g_is_stream_multiplexed == true) {
+        Power_API_Lock();
+        Modem_API_UnlockModem();
+    }
+
+    return eModemError_ATSuccess;
+}
+
+eModemError_t TCP_API_StreamWrite (const char *data, size_t data_size) {
+    if ((data == NULL) || (data_size == 0)) {
+        return eModemError_InvalidParameters;
+    }
+
+    if (g_stream_connect_id == NO_STREAM_SOCKET) {
+        return eModemError_InvalidState;
+    }
+
+    sString_t stream_data = {.size = data_size, .str = (char *) data};
+    if (UART_API_SendMessage(Modem_API_GetChannelUart(eModemChannel_Data), stream_data) == false) {
+        return eModemError_SendFail;
+    }
+
+    g_stream_stats.bytes_sent += data_size;
+
+    return eModemError_ATSuccess;
+}
+
+eModemError_t TCP_API_CloseStream (eStreamExit_t exit_method) {
+    if ((exit_method < eStreamExit_First) || (exit_method >= eStreamExit_Last)) {
+        return eModemError_InvalidParameters;
+    }
+
+    if (g_stream_connect_id == NO_STREAM_SOCKET) {
+        return eModemError_InvalidState;
+    }
+
+    /* The OK that confirms command mode is only known to be ours while the modem is locked */
+    bool is_locked = (g_is_stream_multiplexed == false) || Modem_API_LockModem(STREAM_CLOSE_LOCK_TIMEOUT_MS);
+
+    if (is_locked == false) {
+        DEBUG_WARN("Leaving data mode without the modem lock!\r\n");
+    }
+
+    if (Modem_API_ClearFlag(eModemFlags_ResponseOK) == false) {
+        if ((g_is_stream_multiplexed == true) && (is_locked == true)) {
+            Modem_API_UnlockModem();
+        }
+
+        return eModemError_ClearFlagFail;
+    }
+
+    /* Back to line framing before the escape, so the OK that confirms command mode is parsed. */
+    TCP_API_EndStream();
+
+    if ((exit_method == eStreamExit_Dtr) && (g_is_stream_multiplexed == true)) {
+        exit_method = eStreamExit_EscapeSequence;
+    }
+
+    if (exit_method == eStreamExit_EscapeSequence) {
+        sString_t escape_sequence = (sString_t)DEFINE_STRING(STREAM_ESCAPE_SEQUENCE);
+
+        osDelay(STREAM_ESCAPE_GUARD_TIME_MS);
+        UART_API_SendMessage(Modem_API_GetChannelUart(eModemChannel_Data), escape_sequence);
+        osDelay(STREAM_ESCAPE_GUARD_TIME_MS);
+    } else {
+        GPIO_Driver_Write(eGPIODriver_ModemUartDtrPin, eGPIO_PinState_High);
+        osDelay(STREAM_DTR_PULSE_MS);
+        GPIO_Driver_Write(eGPIODriver_ModemUartDtrPin, eGPIO_PinState_Low);
+    }
+
+    eModemError_t error_type = Modem_API_WaitForResult(eModemFlags_ResponseOK, eModemFlags_Error, STREAM_EXIT_TIMEOUT_MS);
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Modem did not confirm leaving data mode!\r\n");
+    }
+
+    if (g_is_stream_multiplexed == true) {
+        g_is_stream_multiplexed = false;
+        Power_API_Unlock();
+    }
+
+    if ((is_locked == true) && (Modem_API_UnlockModem() == false)) {
+        return eModemError_Unknown;
+    }
+
+    return (is_locked == true) ? error_type : eModemError_ResourceBusy;
+}
+
+bool TCP_API_IsStreaming (void) {
+    return (g_stream_connect_id != NO_STREAM_SOCKET);
+}
+
+bool TCP_API_GetStreamStats (sTcpStreamStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    *stats = g_stream_stats;
+
+    if (g_stream_connect_id != NO_STREAM_SOCKET) {
+        stats->active_ms += osKernelGetTickCount() - g_stream_start_tick;
+    }
+
+    return true;
+}
@@ -1,27 +1,59 @@
-#ifndef SOURCE_API_TCP_API_H_
-#define SOURCE_API_TCP_API_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include "message.h"
-#include "error_codes.h"
-#include "tcp_app.h"
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-eModemError_t TCP_API_Connect (eServerId_t connect_id, char *ip_address, size_t port);
-eModemError_t TCP_API_Send (eServerId_t connect_id, char *server_data_str, size_t server_data_size);
-eModemError_t TCP_API_Disconnect (eServerId_t connect_id);
-#endif /* SOURCE_API_TCP_API_H_ */
+#ifndef SOURCE_API_TCP_API_H_
+#define SOURCE_API_TCP_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include "message.h"
+#include "error_codes.h"
+#include "tcp_app.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define TCP_API_MAX_SEND_SIZE 1460
+#define TCP_API_RX_RING_SIZE 512
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Returns true when the data was consumed, otherwise it is kept in the socket RX ring for TCP_API_Recv. */
+typedef bool (*tcp_api_recv_callback_t) (eServerId_t connect_id, const char *data, size_t data_size);
+
+typedef enum eStreamExit {
+    eStreamExit_First = 0,
+    eStreamExit_EscapeSequence = eStreamExit_First,
+    eStreamExit_Dtr,
+    eStreamExit_Last
+} eStreamExit_t;
+
+typedef struct sTcpStreamStats {
+    uint32_t sessions;
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint32_t active_ms;
+} sTcpStreamStats_t;
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool TCP_API_Init (void);
+eModemError_t TCP_API_Connect (eServerId_t connect_id, eSocketService_t service, char *ip_address, size_t port);
+eModemError_t TCP_API_Send (eServerId_t connect_id, char *server_data_str, size_t server_data_size);
+eModemError_t TCP_API_SendTo (eServerId_t connect_id, char *ip_address, size_t port, char *server_data_str, size_t server_data_size);
+eModemError_t TCP_API_Disconnect (eServerId_t connect_id);
+eModemError_t TCP_API_SetKeepalive (uint32_t idle_min, uint32_t interval_s, uint32_t probe_count);
+eModemError_t TCP_API_ReactivateContext (void);
+eModemError_t TCP_API_ReadSocket (eServerId_t connect_id, tcp_api_recv_callback_t filter);
+size_t TCP_API_Recv (eServerId_t connect_id, char *buffer, size_t buffer_size, uint32_t timeout);
+bool TCP_API_SetRecvCallback (eServerId_t connect_id, tcp_api_recv_callback_t callback);
+void TCP_API_FlushRecv (eServerId_t connect_id);
+eModemError_t TCP_API_OpenStream (eServerId_t connect_id, char *ip_address, size_t port);
+eModemError_t TCP_API_StreamWrite (const char *data, size_t data_size);
+/* DTR does not reach the data channel through the multiplexer, a multiplexed stream always leaves by escape sequence */
+eModemError_t TCP_API_CloseStream (eStreamExit_t exit_method);
+bool TCP_API_IsStreaming (void);
+bool TCP_API_GetStreamStats (sTcpStreamStats_t *stats);
+#endif /* SOURCE_API_TCP_API_H_ */
@@ -0,0 +1,221 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "stm32f4xx.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "metrics_api.h"
+#include "trace_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define TRACE_FORMAT_VERSION 1U
+#define TRACE_LINE_SIZE 96U
+#define EVENTS_PER_LINE 4U
+#define NO_OBJECT 0U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* The object is a task number for task events and a queue number for queue events */
+typedef struct sTraceEvent {
+    uint32_t timestamp;
+    uint8_t event;
+    uint8_t exception;
+    uint16_t object;
+} sTraceEvent_t;
+
+typedef struct sTraceObject {
+    void *handle;
+    uint8_t type;
+} sTraceObject_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sTraceEvent_t g_events[TRACE_API_EVENTS];
+/* Counts every event ever written, the ring holds the last TRACE_API_EVENTS of them */
+static volatile uint32_t g_head = 0;
+static volatile bool g_is_recording = false;
+/* Queues get their numbers from the moment they are created, whether recording or not. Slot n is number n + 1. */
+static sTraceObject_t g_objects[TRACE_API_MAX_OBJECTS];
+/* Too big for the stack of the task that asks for the dump */
+static sMetricsTask_t g_dump_tasks[METRICS_API_MAX_TASKS];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Trace_API_WriteLine (trace_write_callback_t write, void *context, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Trace_API_WriteLine (trace_write_callback_t write, void *context, const char *format, ...) {
+    char line[TRACE_LINE_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    int size = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if ((size < 0) || ((size_t) size >= sizeof(line))) {
+        return false;
+    }
+
+    return write(line, (size_t) size, context);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* The timestamps are DWT cycles. They wrap every 43 s at 100 MHz, the host unwraps them, which holds as long as no
+ * gap between two events is longer than that. The metrics timer switches tasks every second. */
+bool Trace_API_Init (void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    Trace_API_Start();
+
+    return true;
+}
+
+void Trace_API_Start (void) {
+    g_is_recording = true;
+}
+
+void Trace_API_Stop (void) {
+    g_is_recording = false;
+}
+
+bool Trace_API_GetStats (sTraceStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    uint32_t head = g_head;
+
+    stats->is_recording = g_is_recording;
+    stats->events = (head < TRACE_API_EVENTS) ? head : TRACE_API_EVENTS;
+    stats->overwritten = head - stats->events;
+    stats->objects = 0;
+
+    for (size_t index = 0; index < TRACE_API_MAX_OBJECTS; index++) {
+        if (g_objects[index].handle != NULL) {
+            stats->objects++;
+        }
+    }
+
+    return true;
+}
+
+/* One line each: a header, the tasks and the queues by number, the events as hex, four to a line, and an end marker.
+ * Every line starts with TRACE so the host can pick them out of a console log. */
+bool Trace_API_Dump (trace_write_callback_t write, void *context) {
+    if (write == NULL) {
+        return false;
+    }
+
+    bool was_recording = g_is_recording;
+    g_is_recording = false;
+
+    uint32_t head = g_head;
+    uint32_t count = (head < TRACE_API_EVENTS) ? head : TRACE_API_EVENTS;
+    size_t task_count = 0;
+    bool is_written = Trace_API_WriteLine(write, context, "TRACE BEGIN %u %lu %lu %lu", TRACE_FORMAT_VERSION,
+                                          SystemCoreClock, count, head - count);
+
+    if (Metrics_API_GetTasks(g_dump_tasks, METRICS_API_MAX_TASKS, &task_count, NULL) == false) {
+        task_count = 0;
+    }
+
+    for (size_t index = 0; (is_written == true) && (index < task_count); index++) {
+        is_written = Trace_API_WriteLine(write, context, "TRACE TASK %lu %lu %s", g_dump_tasks[index].number,
+                                         g_dump_tasks[index].priority, g_dump_tasks[index].name);
+    }
+
+    for (size_t index = 0; (is_written == true) && (index < TRACE_API_MAX_OBJECTS); index++) {
+        if (g_objects[index].handle == NULL) {
+            continue;
+        }
+
+        const char *name = pcQueueGetName((QueueHandle_t) g_objects[index].handle);
+
+        is_written = Trace_API_WriteLine(write, context, "TRACE OBJECT %u %u %s", index + 1U, g_objects[index].type,
+                                         (name != NULL) ? name : "-");
+    }
+
+    for (uint32_t position = head - count; (is_written == true) && (position != head); ) {
+        char line[TRACE_LINE_SIZE];
+        int size = snprintf(line, sizeof(line), "TRACE EVENTS");
+
+        for (size_t index = 0; (index < EVENTS_PER_LINE) && (position != head); index++, position++) {
+            const sTraceEvent_t *event = &g_events[position & (TRACE_API_EVENTS - 1U)];
+
+            size += snprintf(&line[size], sizeof(line) - size, " %08lx%02x%02x%04x", event->timestamp, event->event,
+                             event->exception, event->object);
+        }
+
+        is_written = write(line, (size_t) size, context);
+    }
+
+    if (is_written == true) {
+        is_written = Trace_API_WriteLine(write, context, "TRACE END");
+    }
+
+    g_is_recording = was_recording;
+
+    return is_written;
+}
+
+/* Runs inside the kernel with its interrupts masked most of the time, but not when a task is about to block, so the
+ * mask is raised here as well. A few dozen cycles per event. */
+void Trace_API_Record (eTraceEvent_t event, uint32_t object) {
+    if (g_is_recording == false) {
+        return;
+    }
+
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    sTraceEvent_t *slot = &g_events[g_head & (TRACE_API_EVENTS - 1U)];
+
+    slot->timestamp = DWT->CYCCNT;
+    slot->event = (uint8_t) event;
+    slot->exception = (uint8_t) __get_IPSR();
+    slot->object = (uint16_t) object;
+    g_head++;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+uint32_t Trace_API_AddObject (void *handle, uint8_t type) {
+    uint32_t number = NO_OBJECT;
+    UBaseType_t mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    for (size_t index = 0; index < TRACE_API_MAX_OBJECTS; index++) {
+        if (g_objects[index].handle == NULL) {
+            g_objects[index].handle = handle;
+            g_objects[index].type = type;
+            number = index + 1U;
+            break;
+        }
+    }
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+    return number;
+}
+
+void Trace_API_RemoveObject (uint32_t number) {
+    if ((number == NO_OBJECT) || (number > TRACE_API_MAX_OBJECTS)) {
+        return;
+    }
+
+    g_objects[number - 1U].handle = NULL;
+}
@@ -0,0 +1,107 @@
+#ifndef SOURCE_API_TRACE_API_H_
+#define SOURCE_API_TRACE_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* 0 leaves the kernel hooks empty, nothing is recorded */
+#ifndef TRACE_API_ENABLE
+#define TRACE_API_ENABLE 1
+#endif
+
+/* Power of two, every event takes 8 bytes */
+#define TRACE_API_EVENTS 1024U
+#define TRACE_API_MAX_OBJECTS 64U
+
+/* The kernel hooks, pulled in by FreeRTOSConfig.h. They expand inside tasks.c and queue.c, where the control blocks and
+ * the local pxTCB they name are visible. */
+/* uxTaskGetTaskNumber, which the profiler samples, reads 0 unless set. The TCB number counts from 1, the same number
+ * the task status reports, and leaves 0 to PROFILER_API_TASK_ISR. Set with or without the recorder. */
+#define TRACE_API_NUMBER_TASK(pxNewTCB) ((pxNewTCB)->uxTaskNumber = (pxNewTCB)->uxTCBNumber)
+
+#if (TRACE_API_ENABLE == 1)
+#define traceTASK_SWITCHED_IN() Trace_API_Record(eTraceEvent_TaskSwitch, pxCurrentTCB->uxTCBNumber)
+#define traceTASK_CREATE(pxNewTCB) \
+   do { \
+       TRACE_API_NUMBER_TASK(pxNewTCB); \
+       Trace_API_Record(eTraceEvent_TaskCreate, (pxNewTCB)->uxTCBNumber); \
+   } while (0)
+#define traceTASK_DELETE(pxTCB) Trace_API_Record(eTraceEvent_TaskDelete, (pxTCB)->uxTCBNumber)
+#define traceTASK_NOTIFY() Trace_API_Record(eTraceEvent_Notify, pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_FROM_ISR() Trace_API_Record(eTraceEvent_Notify, pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR() Trace_API_Record(eTraceEvent_Notify, pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_TAKE_BLOCK() Trace_API_Record(eTraceEvent_NotifyBlock, pxCurrentTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_WAIT_BLOCK() Trace_API_Record(eTraceEvent_NotifyBlock, pxCurrentTCB->uxTCBNumber)
+#define traceQUEUE_CREATE(pxNewQueue) \
+   ((pxNewQueue)->uxQueueNumber = Trace_API_AddObject((pxNewQueue), (pxNewQueue)->ucQueueType))
+#define traceQUEUE_DELETE(pxQueue) Trace_API_RemoveObject((pxQueue)->uxQueueNumber)
+/* A mutex is given by a send and taken by a receive, the host tells them apart by the object type */
+#define traceQUEUE_SEND(pxQueue) Trace_API_Record(eTraceEvent_QueueSend, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) Trace_API_Record(eTraceEvent_QueueSend, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_SEND_FAILED(pxQueue) Trace_API_Record(eTraceEvent_QueueSendFailed, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue) \
+   Trace_API_Record(eTraceEvent_QueueSendFailed, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_RECEIVE(pxQueue) Trace_API_Record(eTraceEvent_QueueReceive, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) Trace_API_Record(eTraceEvent_QueueReceive, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) \
+   Trace_API_Record(eTraceEvent_QueueReceiveFailed, (pxQueue)->uxQueueNumber)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) \
+   Trace_API_Record(eTraceEvent_QueueReceiveFailed, (pxQueue)->uxQueueNumber)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) Trace_API_Record(eTraceEvent_QueueBlockSend, (pxQueue)->uxQueueNumber)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+   Trace_API_Record(eTraceEvent_QueueBlockReceive, (pxQueue)->uxQueueNumber)
+#else
+#define traceTASK_CREATE(pxNewTCB) TRACE_API_NUMBER_TASK(pxNewTCB)
+#endif
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* The numbers are part of the dump format, Tools/trace_convert.py has the same list */
+typedef enum eTraceEvent {
+    eTraceEvent_First = 0,
+    eTraceEvent_TaskSwitch = eTraceEvent_First,
+    eTraceEvent_TaskCreate,
+    eTraceEvent_TaskDelete,
+    eTraceEvent_Notify,
+    eTraceEvent_NotifyBlock,
+    eTraceEvent_QueueSend,
+    eTraceEvent_QueueSendFailed,
+    eTraceEvent_QueueReceive,
+    eTraceEvent_QueueReceiveFailed,
+    eTraceEvent_QueueBlockSend,
+    eTraceEvent_QueueBlockReceive,
+    eTraceEvent_Last
+} eTraceEvent_t;
+
+typedef struct sTraceStats {
+    bool is_recording;
+    uint32_t events;
+    uint32_t overwritten;
+    uint32_t objects;
+} sTraceStats_t;
+
+/* Takes one line of the dump without the line ending, false stops the dump */
+typedef bool (*trace_write_callback_t) (const char *line, size_t size, void *context);
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool Trace_API_Init (void);
+void Trace_API_Start (void);
+void Trace_API_Stop (void);
+bool Trace_API_GetStats (sTraceStats_t *stats);
+/* Recording is paused while the ring is written out and picks up again afterwards */
+bool Trace_API_Dump (trace_write_callback_t write, void *context);
+/* Called from the kernel hooks only */
+void Trace_API_Record (eTraceEvent_t event, uint32_t object);
+uint32_t Trace_API_AddObject (void *handle, uint8_t type);
+void Trace_API_RemoveObject (uint32_t number);
+#endif /* SOURCE_API_TRACE_API_H_ */
@@ -1,32 +1,43 @@
-#ifndef SOURCE_API_UART_API_H_
-#define SOURCE_API_UART_API_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdint.h>
-#include "message.h"    
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-typedef enum {
-    eUartApiDevice_First = 0,
-    eUartApiDevice_Modem = eUartApiDevice_First,
-    eUartApiDevice_Debug,
-    eUartApiDevice_Last 
-} eUartApiDevice_t;
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-bool UART_API_Init (eUartApiDevice_t uart, uint32_t baudrate, sString_t delim);
-bool UART_API_SendMessage (eUartApiDevice_t uart, sString_t msg);
-bool UART_API_GetMessage (eUartApiDevice_t uart, sString_t *msg, uint32_t timeout);
-#endif /* SOURCE_API_UART_API_H_ */
+#ifndef SOURCE_API_UART_API_H_
+#define SOURCE_API_UART_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "message.h"    
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define UART_API_RAW_STREAM SIZE_MAX
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum {
+    eUartApiDevice_First = 0,
+    eUartApiDevice_Modem = eUartApiDevice_First,
+    eUartApiDevice_Debug,
+    eUartApiDevice_ModemData,
+    eUartApiDevice_ModemGnss,
+    eUartApiDevice_Last 
+} eUartApiDevice_t;
+
+/* Returns the number of raw bytes that follow a received line, 0 when the next message is delimited as usual,
+ * or UART_API_RAW_STREAM to pass every following byte through unframed until UART_API_StopRawStream. */
+typedef size_t (*uart_api_length_parser_t) (sString_t line);
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool UART_API_Init (eUartApiDevice_t uart, uint32_t baudrate, sString_t delim);
+bool UART_API_SendMessage (eUartApiDevice_t uart, sString_t msg);
+bool UART_API_GetMessage (eUartApiDevice_t uart, sString_t *msg, uint32_t timeout);
+bool UART_API_SetPrompt (eUartApiDevice_t uart, sString_t prompt);
+bool UART_API_SetLengthParser (eUartApiDevice_t uart, uart_api_length_parser_t length_parser);
+bool UART_API_StopRawStream (eUartApiDevice_t uart);
+#endif /* SOURCE_API_UART_API_H_ */
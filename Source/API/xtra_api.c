@@ -0,0 +1,363 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "uart_api.h"
+#include "modem_api.h"
+#include "flash_driver.h"
+#include "http_api.h"
+#include "date_time.h"
+#include "xtra_api.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define XTRA_SERVER_HOST "xtrapath1.izatcloud.net"
+#define XTRA_SERVER_PORT 80
+#define XTRA_SERVER_PATH "/xtra2.bin"
+#define XTRA_MODEM_FILE "\"UFS:xtra2.bin\""
+#define XTRA_FLASH_SECTOR eFlashDriverSector_Xtra
+#define XTRA_HEADER_MAGIC 0x58545241U
+#define XTRA_DATA_OFFSET sizeof(sXtraHeader_t)
+/* The files are built for 7 days, they are refreshed well before that. */
+#define XTRA_REFRESH_AGE_S (3U * DATE_TIME_SECONDS_PER_DAY)
+#define XTRA_VALIDITY_S (7U * DATE_TIME_SECONDS_PER_DAY)
+#define XTRA_DOWNLOAD_RETRY_MS (10U * 60U * 1000U)
+#define XTRA_UPLOAD_TIMEOUT_S 60
+#define XTRA_UPLOAD_RESULT_TIMEOUT_MS 5000
+/* Time injection: UTC, force, uncertainty used, 3.5 s uncertainty */
+#define XTRA_TIME_PARAMETERS "0,\"%04u/%02u/%02u,%02u:%02u:%02u\",1,1,3500"
+#define CHUNK_SIZE 512
+#define COMMAND_PARAMETERS_BUFFER_SIZE 60
+#define CLOCK_QUERY_PARAMETERS "?"
+#define CLOCK_CENTURY 2000
+/* Unsynchronized Quectel clocks report 1980, read as 2080 here */
+#define CLOCK_MAX_YEAR 2079
+#define CLOCK_FIELD_COUNT 6
+#define CLOCK_ZONE_STEP_S (15U * 60U)
+#define MODEM_LOCK_TIMEOUT_MS 450
+#define MODEM_UART eUartApiDevice_Modem
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* Written after the data, an erased or torn download never carries the magic. */
+typedef struct sXtraHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t download_time;
+    uint32_t reserved;
+} sXtraHeader_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(XTRA_API);
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static char g_server_host[] = XTRA_SERVER_HOST;
+static sXtraHeader_t g_header = {0};
+static sXtraStats_t g_stats = {0};
+static volatile bool g_is_clock_valid = false;
+static volatile uint32_t g_network_time = 0;
+static bool g_is_download_attempted = false;
+static uint32_t g_download_attempt_tick = 0;
+static char g_chunk[CHUNK_SIZE];
+static char g_cmd_params[COMMAND_PARAMETERS_BUFFER_SIZE];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool XTRA_API_IsStored (void);
+static bool XTRA_API_ReadNumber (const char **cursor, uint32_t *value);
+static void XTRA_API_OnClock (sString_t clock);
+static eModemError_t XTRA_API_UploadFile (void);
+static eModemError_t XTRA_API_InjectFile (uint32_t unix_time);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool XTRA_API_IsStored (void) {
+    return (g_header.magic == XTRA_HEADER_MAGIC) && (g_header.size > 0) &&
+           (g_header.size <= (Flash_Driver_GetSectorSize(XTRA_FLASH_SECTOR) - XTRA_DATA_OFFSET));
+}
+
+/* Reads a run of digits and steps over the single separator that follows it. */
+static bool XTRA_API_ReadNumber (const char **cursor, uint32_t *value) {
+    const char *digit = *cursor;
+    uint32_t number = 0;
+
+    while ((*digit >= '0') && (*digit <= '9')) {
+        number = (number * 10) + (*digit - '0');
+        digit++;
+    }
+
+    if (digit == *cursor) {
+        return false;
+    }
+
+    *value = number;
+    *cursor = (*digit == '\0') ? digit : (digit + 1);
+
+    return true;
+}
+
+/* "yy/MM/dd,hh:mm:ss+zz", the zone is in quarter hours. Runs in the modem receive task. */
+static void XTRA_API_OnClock (sString_t clock) {
+    const char *cursor = clock.str;
+    uint32_t fields[CLOCK_FIELD_COUNT] = {0};
+
+    while ((*cursor == ' ') || (*cursor == '"')) {
+        cursor++;
+    }
+
+    for (size_t i = 0; i < CLOCK_FIELD_COUNT; i++) {
+        if (XTRA_API_ReadNumber(&cursor, &fields[i]) == false) {
+            return;
+        }
+    }
+
+    /* The separator in front of the zone was consumed with the seconds. */
+    bool is_zone_negative = (*(cursor - 1) == '-');
+    uint32_t zone = 0;
+    XTRA_API_ReadNumber(&cursor, &zone);
+
+    sDateTime_t local_time = {
+        .year = (uint16_t) (CLOCK_CENTURY + fields[0]),
+        .month = (uint8_t) fields[1],
+        .day = (uint8_t) fields[2],
+        .hour = (uint8_t) fields[3],
+        .minute = (uint8_t) fields[4],
+        .second = (uint8_t) fields[5]
+    };
+
+    if ((local_time.year > CLOCK_MAX_YEAR) || (DateTime_IsValid(&local_time) == false)) {
+        return;
+    }
+
+    uint32_t unix_time = DateTime_ToUnix(&local_time);
+    uint32_t zone_offset = zone * CLOCK_ZONE_STEP_S;
+
+    g_network_time = is_zone_negative ? (unix_time + zone_offset) : (unix_time - zone_offset);
+    g_is_clock_valid = true;
+}
+
+static eModemError_t XTRA_API_UploadFile (void) {
+    size_t cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, "%s,%lu,%d",
+                                      XTRA_MODEM_FILE, g_header.size, XTRA_UPLOAD_TIMEOUT_S);
+
+    if (Modem_API_ClearFlag(eModemFlags_FileUploaded) == false) {
+        return eModemError_ClearFlagFail;
+    }
+
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QFUPL, eModemFlags_Connect, g_cmd_params, cmd_params_size);
+    if (error_type != eModemError_ATSuccess) {
+        return error_type;
+    }
+
+    /* The file goes out of flash chunk by chunk, the modem counts the bytes itself. */
+    for (uint32_t offset = 0; offset < g_header.size; offset += CHUNK_SIZE) {
+        size_t chunk_size = ((g_header.size - offset) < CHUNK_SIZE) ? (g_header.size - offset) : CHUNK_SIZE;
+        sString_t chunk = {.str = g_chunk, .size = chunk_size};
+
+        if ((Flash_Driver_Read(XTRA_FLASH_SECTOR, XTRA_DATA_OFFSET + offset, g_chunk, chunk_size) == false) ||
+            (UART_API_SendMessage(MODEM_UART, chunk) == false)) {
+            return eModemError_SendFail;
+        }
+    }
+
+    return Modem_API_WaitForResult(eModemFlags_FileUploaded, eModemFlags_Error, XTRA_UPLOAD_RESULT_TIMEOUT_MS);
+}
+
+static eModemError_t XTRA_API_InjectFile (uint32_t unix_time) {
+    size_t cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, "1");
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_QGPSXTRA, eModemFlags_ResponseOK, g_cmd_params, cmd_params_size);
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to enable XTRA!\r\n");
+        return error_type;
+    }
+
+    /* A file left over from an interrupted injection would make the upload fail. */
+    cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, "%s", XTRA_MODEM_FILE);
+    Modem_API_SendCommand(eModemCommands_QFDEL, eModemFlags_ResponseOK, g_cmd_params, cmd_params_size);
+
+    error_type = XTRA_API_UploadFile();
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to upload the XTRA file!\r\n");
+        return error_type;
+    }
+
+    sDateTime_t utc_time;
+    DateTime_FromUnix(unix_time, &utc_time);
+
+    cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, XTRA_TIME_PARAMETERS, utc_time.year,
+                               utc_time.month, utc_time.day, utc_time.hour, utc_time.minute, utc_time.second);
+    error_type = Modem_API_SendCommand(eModemCommands_QGPSXTRATIME, eModemFlags_ResponseOK, g_cmd_params, cmd_params_size);
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to inject the XTRA time!\r\n");
+        return error_type;
+    }
+
+    cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, "%s", XTRA_MODEM_FILE);
+    error_type = Modem_API_SendCommand(eModemCommands_QGPSXTRADATA, eModemFlags_ResponseOK, g_cmd_params, cmd_params_size);
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_ERROR("Failed to inject the XTRA data!\r\n");
+        return error_type;
+    }
+
+    Modem_API_SendCommand(eModemCommands_QFDEL, eModemFlags_ResponseOK, g_cmd_params, cmd_params_size);
+
+    return eModemError_ATSuccess;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool XTRA_API_Init (void) {
+    if (Modem_API_SetClockCallback(&XTRA_API_OnClock) == false) {
+        DEBUG_ERROR("Failed to register the clock callback!\r\n");
+        return false;
+    }
+
+    if (Flash_Driver_Read(XTRA_FLASH_SECTOR, 0, &g_header, sizeof(g_header)) == false) {
+        DEBUG_ERROR("Failed to read the XTRA header!\r\n");
+        return false;
+    }
+
+    if (XTRA_API_IsStored()) {
+        g_stats.size = g_header.size;
+        g_stats.download_time = g_header.download_time;
+    }
+
+    return true;
+}
+
+eModemError_t XTRA_API_GetNetworkTime (uint32_t *unix_time) {
+    if (unix_time == NULL) {
+        return eModemError_InvalidParameters;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    g_is_clock_valid = false;
+
+    size_t cmd_params_size = snprintf(g_cmd_params, COMMAND_PARAMETERS_BUFFER_SIZE, CLOCK_QUERY_PARAMETERS);
+    eModemError_t error_type = Modem_API_SendCommand(eModemCommands_CCLK, eModemFlags_Clock, g_cmd_params, cmd_params_size);
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        return error_type;
+    }
+
+    if (g_is_clock_valid == false) {
+        DEBUG_INFO("Modem clock is not synchronized yet\r\n");
+        return eModemError_InvalidResponse;
+    }
+
+    *unix_time = g_network_time;
+
+    return eModemError_ATSuccess;
+}
+
+bool XTRA_API_IsStale (uint32_t unix_time) {
+    if ((XTRA_API_IsStored() == false) || (unix_time < g_header.download_time)) {
+        return true;
+    }
+
+    return ((unix_time - g_header.download_time) >= XTRA_REFRESH_AGE_S);
+}
+
+eModemError_t XTRA_API_Download (eServerId_t connect_id, uint32_t unix_time) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return eModemError_InvalidParameters;
+    }
+
+    if ((g_is_download_attempted == true) && ((osKernelGetTickCount() - g_download_attempt_tick) < XTRA_DOWNLOAD_RETRY_MS)) {
+        return eModemError_InvalidState;
+    }
+
+    g_is_download_attempted = true;
+    g_download_attempt_tick = osKernelGetTickCount();
+
+    /* Whatever was stored is gone from here on, the header only comes back with a complete file. */
+    if (Flash_Driver_Erase(XTRA_FLASH_SECTOR) == false) {
+        DEBUG_ERROR("Failed to erase the XTRA sector!\r\n");
+        g_stats.download_failures++;
+        return eModemError_Unknown;
+    }
+
+    memset(&g_header, 0, sizeof(g_header));
+
+    uint32_t file_size = 0;
+    eModemError_t error_type = HTTP_API_Download(connect_id, g_server_host, XTRA_SERVER_PORT, XTRA_SERVER_PATH,
+                                                 XTRA_FLASH_SECTOR, XTRA_DATA_OFFSET, &file_size);
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_WARN("XTRA download failed!\r\n");
+        g_stats.download_failures++;
+        return error_type;
+    }
+
+    sXtraHeader_t header = {
+        .magic = XTRA_HEADER_MAGIC,
+        .size = file_size,
+        .download_time = unix_time
+    };
+
+    if (Flash_Driver_Program(XTRA_FLASH_SECTOR, 0, &header, sizeof(header)) == false) {
+        DEBUG_ERROR("Failed to commit the XTRA data!\r\n");
+        g_stats.download_failures++;
+        return eModemError_Unknown;
+    }
+
+    g_header = header;
+    g_stats.downloads++;
+    g_stats.size = header.size;
+    g_stats.download_time = header.download_time;
+
+    DEBUG_INFO("XTRA data downloaded, %lu bytes\r\n", file_size);
+
+    return eModemError_ATSuccess;
+}
+
+eModemError_t XTRA_API_Inject (uint32_t unix_time) {
+    if ((XTRA_API_IsStored() == false) || (unix_time < g_header.download_time) ||
+        ((unix_time - g_header.download_time) >= XTRA_VALIDITY_S)) {
+        return eModemError_InvalidState;
+    }
+
+    if (Modem_API_LockModem(MODEM_LOCK_TIMEOUT_MS) == false) {
+        return eModemError_ResourceBusy;
+    }
+
+    eModemError_t error_type = XTRA_API_InjectFile(unix_time);
+
+    if (Modem_API_UnlockModem() == false) {
+        return eModemError_Unknown;
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        g_stats.injection_failures++;
+        return error_type;
+    }
+
+    g_stats.injections++;
+
+    return eModemError_ATSuccess;
+}
+
+bool XTRA_API_GetStats (sXtraStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    *stats = g_stats;
+
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SOURCE_API_XTRA_API_H_
+#define SOURCE_API_XTRA_API_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "error_codes.h"
+#include "message.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sXtraStats {
+    uint32_t downloads;
+    uint32_t download_failures;
+    uint32_t injections;
+    uint32_t injection_failures;
+    uint32_t size;
+    uint32_t download_time;
+} sXtraStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool XTRA_API_Init (void);
+/* Network time from the modem clock, seconds since the unix epoch in UTC */
+eModemError_t XTRA_API_GetNetworkTime (uint32_t *unix_time);
+/* True when there is no stored data or it is old enough to be refreshed */
+bool XTRA_API_IsStale (uint32_t unix_time);
+eModemError_t XTRA_API_Download (eServerId_t connect_id, uint32_t unix_time);
+/* Must run while the GNSS engine is off */
+eModemError_t XTRA_API_Inject (uint32_t unix_time);
+bool XTRA_API_GetStats (sXtraStats_t *stats);
+#endif /* SOURCE_API_XTRA_API_H_ */
@@ -1,24 +1,24 @@
-#ifndef SOURCE_APP_CLI_APP_H_
-#define SOURCE_APP_CLI_APP_H_
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdlib.h>
-/**********************************************************************************************************************
-* Exported definitions and macros
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Exported types
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Exported variables
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of exported functions
-*********************************************************************************************************************/
-bool CLI_APP_Init(void);
+#ifndef SOURCE_APP_CLI_APP_H_
+#define SOURCE_APP_CLI_APP_H_
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdlib.h>
+/**********************************************************************************************************************
+* Exported definitions and macros
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Exported types
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Exported variables
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Prototypes of exported functions
+*********************************************************************************************************************/
+bool CLI_APP_Init(void);
 #endif /* SOURCE_APP_CLI_APP_H_ */
\ No newline at end of file
@@ -1,393 +1,1241 @@
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdint.h>
-#include <string.h>
-#include <stdio.h>
-#include "cmsis_os2.h"
-#include "debug_api.h"
-#include "heap_api.h"
-#include "cmd_api.h"
-#include "cli_app.h"
-#include "cli_commands.h"
-#include "led_api.h"
-#include "led_app.h"
-#include "tcp_app.h"
-/**********************************************************************************************************************
- * Private definitions and macros
- *********************************************************************************************************************/
-#define ARGUMENTS_SEPERATOR " ,"
-#define REPLY_INCORRECT_ARG_MESSAGE "Incorrect command arguments!\r\n"
-#define COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE 100
-#define CONVERTED_BACK_NUMBER_STRING_SIZE 10
-#define MAX_SIZE_OF_IPV4_ADDRESS 15
-#define MAX_PORT 65536
-#define MIN_PORT 0
-#define DELIMITER "\r\n"
-#define COMMAND_END_SYMBOL '\032'
-/**********************************************************************************************************************
- * Private typedef
- *********************************************************************************************************************/
-typedef enum eLedState {
-    eLedState_First = 0,
-    eLedState_On = eLedState_First,
-    eLedState_Off,
-    eLedState_Last
-} eLedState_t;
-/**********************************************************************************************************************
- * Private constants
- *********************************************************************************************************************/
-CREATE_MODULE_TAG(CLI_APP_COMMANDS);
-/**********************************************************************************************************************
- * Private variables
- *********************************************************************************************************************/
-static char g_converted_back_number[CONVERTED_BACK_NUMBER_STRING_SIZE] = {0};
-/**********************************************************************************************************************
- * Exported variables and references
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of private functions
- *********************************************************************************************************************/
-static bool MODEM_CMD_GetArgInt (int *arg_value, char **save_ptr);
-static bool MODEM_CMD_IsStringNumber (char *string, size_t string_size);
-bool CLI_CMD_ExecuteLedCommand (sCommandHandlerArgs_t *handler_args, eLedState_t pin_status);
-/**********************************************************************************************************************
- * Definitions of private functions
- *********************************************************************************************************************/
-static bool MODEM_CMD_IsStringNumber (char *string, size_t string_size) {
-    if (memcmp(string, itoa(atoi(string), g_converted_back_number, 10), strnlen(string, string_size)) == 0) {
-        return true;
-    }
-    return false;
-}
-
-static bool MODEM_CMD_GetArgInt (int *arg_value, char **save_ptr) {
-    char *arg_token = strtok_r(NULL, ARGUMENTS_SEPERATOR, save_ptr);
-    if (arg_token == NULL) {
-        return false;
-    }
-    if (MODEM_CMD_IsStringNumber(arg_token, strlen(arg_token)) == false) {
-        return false;
-    }
-    *arg_value = atoi(arg_token);
-    return true;
-}
-
-bool CLI_CMD_ExecuteLedCommand (sCommandHandlerArgs_t *handler_args, eLedState_t pin_status) {
-    if (handler_args->cmd_args.str == NULL) {
-        DEBUG_INFO("Function argument is not valid, the argument is a NULL!\r\n");
-        return false;
-    }
-
-    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
-        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
-        return false;
-    }
-
-    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
-        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
-    }
-
-    int led_int;
-    if (MODEM_CMD_GetArgInt(&led_int, &handler_args->cmd_args.str) == false) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
- 
-    eLed_t *led = (eLed_t *) Heap_API_Calloc(1, sizeof(eLed_t));
-    *led = led_int;
-
-    if (*led == 0) {
-        DEBUG_INFO("Number only, please enter valid pin number!\r\n");
-        Heap_API_Free(led);
-        return false;
-    }
-
-    bool function_status = false;
-
-    switch (*led) {
-        case eLed_Status: {
-            function_status = (pin_status == eLedState_On ? LED_APP_AddTask(eLedAction_On, led)
-                                                          : LED_APP_AddTask(eLedAction_Off, led));
-        } break;
-        case eLed_GpsFix: {
-            function_status = (pin_status == eLedState_On ? LED_APP_AddTask(eLedAction_On, led)
-                                                          : LED_APP_AddTask(eLedAction_Off, led));
-        } break;
-        default: {
-            handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
-                                                            COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
-                                                            "Incorrect led state!\r\n");
-            Heap_API_Free(led);
-            return false;
-        }
-    }
-
-    if (function_status == true) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
-                                                        pin_status == eLedState_On ?
-                                                        "Led state was successfully set!\r\n" :
-                                                        "Led state was successfully reset!\r\n");
-    } else {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
-                                                        "Command execution failed!\r\n");
-    }
-
-    return true;
-}
-/**********************************************************************************************************************
- * Definitions of exported functions
- *********************************************************************************************************************/
-bool CLI_CMD_SetLed (sCommandHandlerArgs_t *handler_args) {
-    return CLI_CMD_ExecuteLedCommand(handler_args, eLedState_On);
-}
-
-bool CLI_CMD_ResetLed (sCommandHandlerArgs_t *handler_args) {
-    return CLI_CMD_ExecuteLedCommand(handler_args, eLedState_Off);
-}
-
-bool CLI_CMD_BlinkLed (sCommandHandlerArgs_t *handler_args) {
-    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
-        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
-        return false;
-    }
-
-    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
-        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
-        return false;
-    }
-
-    int led_int;
-    if (MODEM_CMD_GetArgInt(&led_int, &handler_args->cmd_args.str) == false) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    int frequency;
-    if (MODEM_CMD_GetArgInt(&frequency, &handler_args->cmd_args.str) == false) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    int period_s;
-    if (MODEM_CMD_GetArgInt(&period_s, &handler_args->cmd_args.str) == false) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    sLedActionArgs_t *led_action_args = (sLedActionArgs_t *) Heap_API_Calloc(1, sizeof(sLedActionArgs_t));
-
-    if (led_action_args == NULL) {
-        DEBUG_ERROR("Failed to allocate space for LED function arguments!\r\n");
-        return false;
-    }
-
-    led_action_args->led = led_int;
-    led_action_args->blinks_num = period_s;
-    led_action_args->blink_freq = frequency;
-
-   if ((led_action_args->led == 0) || (led_action_args->blinks_num == 0) || (led_action_args->blink_freq == 0)) {
-       DEBUG_INFO("One or more LED blinking function arguments are 0's!\r\n");
-       Heap_API_Free(led_action_args);
-       return false;
-   }
-
-    bool function_status = false;
-
-    switch (led_action_args->led) {
-        case eLed_Status: {
-            function_status = LED_APP_AddTask(eLedAction_Blink, led_action_args);
-        } break;
-        case eLed_GpsFix: {
-            function_status = LED_APP_AddTask(eLedAction_Blink, led_action_args);
-        } break;
-        default: {
-            handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
-                                                           COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
-                                                           "Incorrect led state!\r\n");
-            Heap_API_Free(led_action_args);
-            return false;
-        }
-    }
-
-    if (function_status == true) {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        "Led blinked successfully!\r\n");
-    } else {
-        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
-                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
-                                                        "Command execution failed!\r\n");
-    }
-
-    return true;
-}
-
-bool CLI_CMD_TcpOpen (sCommandHandlerArgs_t *handler_args) {
-    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
-        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
-        return false;
-    }
-
-    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
-        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
-        return false;
-    }
-
-    int socket_id;
-    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
-        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
-        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
-        return false;
-    }
-
-    char *ip_address = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
-
-    if (ip_address == NULL) {
-        DEBUG_ERROR("Failed to retrieve server IP address!\r\n");
-        return false;
-    }
-
-    int port;
-    if (MODEM_CMD_GetArgInt(&port, &handler_args->cmd_args.str) == false) {
-        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    if ((port < MIN_PORT) || (port > MAX_PORT)) {
-        DEBUG_ERROR("Incorrect server and port number, available port are from 0 to 65536!\r\n");
-        return false;
-    } 
-
-    sTcpConnectJob_t *connect_params = (sTcpConnectJob_t *) Heap_API_Calloc(1, sizeof(sTcpConnectJob_t));
-
-    if (connect_params == NULL) {
-        DEBUG_ERROR("Failed to allocate space for connection to server function arguments!\r\n");
-        return false;
-    }
-
-    connect_params->connect_id = (eServerId_t) socket_id;
-    connect_params->port = port;
-    snprintf(connect_params->ip_address, sizeof(connect_params->ip_address), "%s", ip_address);
-
-    if (strlen(connect_params->ip_address) > MAX_SIZE_OF_IPV4_ADDRESS) {
-        DEBUG_ERROR("Failed to pass server IP address!");
-        Heap_API_Free(connect_params);
-        return false;
-    }
-
-    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect, .data = connect_params};
-
-    if (TCP_APP_AddTask(&tcp_job) == false) {
-        DEBUG_INFO("Failed to connect to the server!\r\n");
-        Heap_API_Free(connect_params);
-        return false;
-    }
-
-    return true;
-}
-
-bool CLI_CMD_TcpSend (sCommandHandlerArgs_t *handler_args) {
-    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
-        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
-        return false;
-    }
-
-    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
-        DEBUG_INFO("Command message does not contain a NULL terminator!\r\n");
-        return false;
-    }
-
-    int socket_id;
-    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
-        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
-        return false;
-    }
-
-    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
-        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
-        return false;
-    }
-
-    char *data = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
-
-    if (data == NULL) {
-        DEBUG_INFO("Failed to tokenize server data!\r\n");
-        return false;
-    }
-
-    sTcpSendJob_t *send_params = (sTcpSendJob_t *) Heap_API_Calloc(1, sizeof(sTcpSendJob_t));
-
-    if (send_params == NULL) {
-        DEBUG_ERROR("Failed to allocate memory for the data to be sent to the server.\r\n");
-        return false;
-    }
-
-    send_params->connect_id = socket_id;
-    send_params->data_size = strlen(data) + 4;  // 4 additional characters: '\r', '\n', '\032', '\0'
-    send_params->data_str = Heap_API_Calloc(1, send_params->data_size);
-
-    snprintf(send_params->data_str, send_params->data_size, "%s%s%c", data, DELIMITER, COMMAND_END_SYMBOL);
-
-    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send, .data = send_params};
-
-    if (TCP_APP_AddTask(&tcp_job) == false) {
-        DEBUG_INFO("Failed to execute TCP task!\r\n");
-        Heap_API_Free(send_params);
-        return false;
-    }
-
-    return true;
-}
-
-bool CLI_CMD_TcpClose (sCommandHandlerArgs_t *handler_args) {
-    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
-        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
-        return false;
-    }
-
-    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
-        DEBUG_INFO("Command message does not contain a NULL terminator!\r\n");
-        return false;
-    }
-
-    int socket_id = atoi(handler_args->cmd_args.str);
-    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
-        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
-        return false;
-    }
-
-    sTcpDisconnectJob_t *disconnect_params = (sTcpDisconnectJob_t *) Heap_API_Calloc(1, sizeof(sTcpDisconnectJob_t));
-
-    if (disconnect_params == NULL) {
-        DEBUG_INFO("Failed to allocate space for TCP disconnect parametrs!\r\n");
-        return false;
-    }
-
-    disconnect_params->connect_id = socket_id;
-    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Disconnect, .data = disconnect_params};
-
-    if (TCP_APP_AddTask(&tcp_job) == false) {
-        DEBUG_INFO("Failed to disconnect from the servers!\r\n");
-        Heap_API_Free(tcp_job.data);
-        return false;
-    }
-    
-    return true;
-}
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "heap_api.h"
+#include "cmd_api.h"
+#include "cli_app.h"
+#include "cli_commands.h"
+#include "led_api.h"
+#include "led_app.h"
+#include "tcp_app.h"
+#include "tcp_api.h"
+#include "gnss_app.h"
+#include "xtra_api.h"
+#include "geodesy.h"
+#include "geofence_app.h"
+#include "report_app.h"
+#include "log_sink_app.h"
+#include "metrics_api.h"
+#include "trace_api.h"
+#include "profiler_api.h"
+#include "power_api.h"
+#include "tim_driver.h"
+#include "stm32f4xx.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define ARGUMENTS_SEPERATOR " ,"
+#define REPLY_INCORRECT_ARG_MESSAGE "Incorrect command arguments!\r\n"
+#define COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE 100
+#define CONVERTED_BACK_NUMBER_STRING_SIZE 10
+#define ALL_LOG_MODULES "*"
+#define MAX_SIZE_OF_IPV4_ADDRESS 15
+#define MAX_PORT 65536
+#define MIN_PORT 0
+#define DELIMITER "\r\n"
+#define SERVICE_NAME_TCP "tcp"
+#define SERVICE_NAME_UDP "udp"
+#define SERVICE_NAME_UDP_SERVICE "udpservice"
+#define RECEIVE_BUFFER_SIZE 100
+#define GEODESY_BENCH_CALLS 256
+#define DUMP_POLL_MS 10
+#define DUMP_WAIT_MS 2000
+/* Two fixes a few hundred metres apart, the loop walks the second one so no call sees the same input twice */
+#define GEODESY_BENCH_LATITUDE 546872000
+#define GEODESY_BENCH_LONGITUDE 252795000
+#define GEODESY_BENCH_STEP 37
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eLedState {
+    eLedState_First = 0,
+    eLedState_On = eLedState_First,
+    eLedState_Off,
+    eLedState_Last
+} eLedState_t;
+
+/* Lines are gathered into TCP payload blocks, a full block is handed to the TCP task */
+typedef struct sTraceTcpWriter {
+    eServerId_t connect_id;
+    char *payload;
+    size_t size;
+} sTraceTcpWriter_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(CLI_APP_COMMANDS);
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static char g_converted_back_number[CONVERTED_BACK_NUMBER_STRING_SIZE] = {0};
+/* Too big for the CLI task stack */
+static sMetricsTask_t g_top_tasks[METRICS_API_MAX_TASKS];
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool MODEM_CMD_GetArgInt (int *arg_value, char **save_ptr);
+static bool MODEM_CMD_IsStringNumber (char *string, size_t string_size);
+bool CLI_CMD_ExecuteLedCommand (sCommandHandlerArgs_t *handler_args, eLedState_t pin_status);
+bool CLI_CMD_ExecuteSendCommand (sCommandHandlerArgs_t *handler_args, bool reliable, bool persistent);
+static uint32_t CLI_CMD_GeodesyCycles (uint32_t (*kernel)(const sGeodesyPoint_t *from, const sGeodesyPoint_t *to));
+static uint32_t CLI_CMD_GeodesyBearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+static bool CLI_CMD_DumpToConsole (const char *line, size_t size, void *context);
+static bool CLI_CMD_TraceFlushTcp (sTraceTcpWriter_t *writer);
+static bool CLI_CMD_TraceWriteTcp (const char *line, size_t size, void *context);
+static uint32_t CLI_CMD_GeodesyEnu (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool MODEM_CMD_IsStringNumber (char *string, size_t string_size) {
+    if (memcmp(string, itoa(atoi(string), g_converted_back_number, 10), strnlen(string, string_size)) == 0) {
+        return true;
+    }
+    return false;
+}
+
+static bool MODEM_CMD_GetArgInt (int *arg_value, char **save_ptr) {
+    char *arg_token = strtok_r(NULL, ARGUMENTS_SEPERATOR, save_ptr);
+    if (arg_token == NULL) {
+        return false;
+    }
+    if (MODEM_CMD_IsStringNumber(arg_token, strlen(arg_token)) == false) {
+        return false;
+    }
+    *arg_value = atoi(arg_token);
+    return true;
+}
+
+/* Average DWT cycle count of one kernel call, the loop overhead is included */
+static uint32_t CLI_CMD_GeodesyCycles (uint32_t (*kernel)(const sGeodesyPoint_t *from, const sGeodesyPoint_t *to)) {
+    sGeodesyPoint_t from = {.latitude = GEODESY_BENCH_LATITUDE, .longitude = GEODESY_BENCH_LONGITUDE};
+    sGeodesyPoint_t to = from;
+    volatile uint32_t sink = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t start = DWT->CYCCNT;
+
+    for (size_t i = 0; i < GEODESY_BENCH_CALLS; i++) {
+        to.latitude += GEODESY_BENCH_STEP;
+        to.longitude += GEODESY_BENCH_STEP;
+        sink += kernel(&from, &to);
+    }
+
+    return (DWT->CYCCNT - start) / GEODESY_BENCH_CALLS;
+}
+
+static uint32_t CLI_CMD_GeodesyBearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    return Geodesy_Bearing(from, to);
+}
+
+static uint32_t CLI_CMD_GeodesyEnu (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    sGeodesyReference_t reference;
+    sGeodesyEnu_t enu;
+
+    Geodesy_SetReference(&reference, from, 0);
+    Geodesy_ToEnu(&reference, to, 0, &enu);
+
+    return (uint32_t) enu.east;
+}
+
+bool CLI_CMD_ExecuteLedCommand (sCommandHandlerArgs_t *handler_args, eLedState_t pin_status) {
+    if (handler_args->cmd_args.str == NULL) {
+        DEBUG_INFO("Function argument is not valid, the argument is a NULL!\r\n");
+        return false;
+    }
+
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
+    }
+
+    int led_int;
+    if (MODEM_CMD_GetArgInt(&led_int, &handler_args->cmd_args.str) == false) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+ 
+    eLed_t *led = (eLed_t *) Heap_API_Calloc(1, sizeof(eLed_t));
+    *led = led_int;
+
+    if (*led == 0) {
+        DEBUG_INFO("Number only, please enter valid pin number!\r\n");
+        Heap_API_Free(led);
+        return false;
+    }
+
+    bool function_status = false;
+
+    switch (*led) {
+        case eLed_Status: {
+            function_status = (pin_status == eLedState_On ? LED_APP_AddTask(eLedAction_On, led)
+                                                          : LED_APP_AddTask(eLedAction_Off, led));
+        } break;
+        case eLed_GpsFix: {
+            function_status = (pin_status == eLedState_On ? LED_APP_AddTask(eLedAction_On, led)
+                                                          : LED_APP_AddTask(eLedAction_Off, led));
+        } break;
+        default: {
+            handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                            COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
+                                                            "Incorrect led state!\r\n");
+            Heap_API_Free(led);
+            return false;
+        }
+    }
+
+    if (function_status == true) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
+                                                        pin_status == eLedState_On ?
+                                                        "Led state was successfully set!\r\n" :
+                                                        "Led state was successfully reset!\r\n");
+    } else {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
+                                                        "Command execution failed!\r\n");
+    }
+
+    return true;
+}
+/* A dump is far bigger than the log ring, every line waits until the console has drained half of it */
+static bool CLI_CMD_DumpToConsole (const char *line, size_t size, void *context) {
+    sLogRingStats_t stats;
+    uint32_t waited = 0;
+
+    while ((Debug_API_GetStats(&stats) == true) && (stats.used > (stats.capacity / 2U))) {
+        if (waited >= DUMP_WAIT_MS) {
+            return false;
+        }
+
+        osDelay(DUMP_POLL_MS);
+        waited += DUMP_POLL_MS;
+    }
+
+    DEBUG_INFO("%.*s\r\n", (int) size, line);
+
+    return true;
+}
+
+static bool CLI_CMD_TraceFlushTcp (sTraceTcpWriter_t *writer) {
+    if (writer->payload == NULL) {
+        return true;
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = writer->connect_id;
+    tcp_job.data.send.data_str = writer->payload;
+    tcp_job.data.send.data_size = writer->size;
+
+    /* The TCP task owns the payload from here on, even when the job is refused */
+    writer->payload = NULL;
+    writer->size = 0;
+
+    return TCP_APP_AddTask(&tcp_job);
+}
+
+static bool CLI_CMD_TraceWriteTcp (const char *line, size_t size, void *context) {
+    sTraceTcpWriter_t *writer = (sTraceTcpWriter_t *) context;
+
+    if ((writer->payload != NULL) && ((writer->size + size + 1U) > TCP_APP_PAYLOAD_BLOCK_SIZE)) {
+        if (CLI_CMD_TraceFlushTcp(writer) == false) {
+            return false;
+        }
+    }
+
+    if (writer->payload == NULL) {
+        writer->payload = TCP_APP_AllocPayload(TCP_APP_PAYLOAD_BLOCK_SIZE);
+
+        if (writer->payload == NULL) {
+            return false;
+        }
+    }
+
+    memcpy(&writer->payload[writer->size], line, size);
+    writer->size += size;
+    writer->payload[writer->size++] = '\n';
+
+    return true;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool CLI_CMD_SetLed (sCommandHandlerArgs_t *handler_args) {
+    return CLI_CMD_ExecuteLedCommand(handler_args, eLedState_On);
+}
+
+bool CLI_CMD_ResetLed (sCommandHandlerArgs_t *handler_args) {
+    return CLI_CMD_ExecuteLedCommand(handler_args, eLedState_Off);
+}
+
+bool CLI_CMD_BlinkLed (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
+        return false;
+    }
+
+    int led_int;
+    if (MODEM_CMD_GetArgInt(&led_int, &handler_args->cmd_args.str) == false) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    int frequency;
+    if (MODEM_CMD_GetArgInt(&frequency, &handler_args->cmd_args.str) == false) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    int period_s;
+    if (MODEM_CMD_GetArgInt(&period_s, &handler_args->cmd_args.str) == false) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    sLedActionArgs_t *led_action_args = (sLedActionArgs_t *) Heap_API_Calloc(1, sizeof(sLedActionArgs_t));
+
+    if (led_action_args == NULL) {
+        DEBUG_ERROR("Failed to allocate space for LED function arguments!\r\n");
+        return false;
+    }
+
+    led_action_args->led = led_int;
+    led_action_args->blinks_num = period_s;
+    led_action_args->blink_freq = frequency;
+
+   if ((led_action_args->led == 0) || (led_action_args->blinks_num == 0) || (led_action_args->blink_freq == 0)) {
+       DEBUG_INFO("One or more LED blinking function arguments are 0's!\r\n");
+       Heap_API_Free(led_action_args);
+       return false;
+   }
+
+    bool function_status = false;
+
+    switch (led_action_args->led) {
+        case eLed_Status: {
+            function_status = LED_APP_AddTask(eLedAction_Blink, led_action_args);
+        } break;
+        case eLed_GpsFix: {
+            function_status = LED_APP_AddTask(eLedAction_Blink, led_action_args);
+        } break;
+        default: {
+            handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                           COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1,
+                                                           "Incorrect led state!\r\n");
+            Heap_API_Free(led_action_args);
+            return false;
+        }
+    }
+
+    if (function_status == true) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        "Led blinked successfully!\r\n");
+    } else {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str, 
+                                                        COMMAND_EXECUTION_RESPONSE_BUFFER_SIZE + 1, 
+                                                        "Command execution failed!\r\n");
+    }
+
+    return true;
+}
+
+bool CLI_CMD_TcpOpen (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    char *ip_address = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (ip_address == NULL) {
+        DEBUG_ERROR("Failed to retrieve server IP address!\r\n");
+        return false;
+    }
+
+    int port;
+    if (MODEM_CMD_GetArgInt(&port, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((port < MIN_PORT) || (port > MAX_PORT)) {
+        DEBUG_ERROR("Incorrect server and port number, available port are from 0 to 65536!\r\n");
+        return false;
+    } 
+
+    if (strlen(ip_address) > MAX_SIZE_OF_IPV4_ADDRESS) {
+        DEBUG_ERROR("Failed to pass server IP address!");
+        return false;
+    }
+
+    eSocketService_t service = eSocketService_Tcp;
+    char *service_name = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (service_name != NULL) {
+        if (strcmp(service_name, SERVICE_NAME_UDP) == 0) {
+            service = eSocketService_Udp;
+        } else if (strcmp(service_name, SERVICE_NAME_UDP_SERVICE) == 0) {
+            service = eSocketService_UdpService;
+        } else if (strcmp(service_name, SERVICE_NAME_TCP) != 0) {
+            DEBUG_ERROR("Unknown service type, available types: tcp, udp, udpservice!\r\n");
+            return false;
+        }
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+    tcp_job.data.connect.connect_id = (eServerId_t) socket_id;
+    tcp_job.data.connect.service = service;
+    tcp_job.data.connect.port = port;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", ip_address);
+
+    if (TCP_APP_AddTask(&tcp_job) == false) {
+        DEBUG_INFO("Failed to connect to the server!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_ExecuteSendCommand (sCommandHandlerArgs_t *handler_args, bool reliable, bool persistent) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_INFO("Command message does not contain a NULL terminator!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    char *data = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (data == NULL) {
+        DEBUG_INFO("Failed to tokenize server data!\r\n");
+        return false;
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = socket_id;
+    tcp_job.data.send.reliable = reliable;
+    tcp_job.data.send.persistent = persistent;
+    tcp_job.data.send.data_size = strlen(data) + sizeof(DELIMITER) - 1;
+    tcp_job.data.send.data_str = TCP_APP_AllocPayload(tcp_job.data.send.data_size + 1);
+
+    if (tcp_job.data.send.data_str == NULL) {
+        DEBUG_ERROR("Failed to allocate memory for the data to be sent to the server.\r\n");
+        return false;
+    }
+
+    snprintf(tcp_job.data.send.data_str, tcp_job.data.send.data_size + 1, "%s%s", data, DELIMITER);
+
+    if (TCP_APP_AddTask(&tcp_job) == false) {
+        DEBUG_INFO("Failed to execute TCP task!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_TcpSend (sCommandHandlerArgs_t *handler_args) {
+    return CLI_CMD_ExecuteSendCommand(handler_args, false, false);
+}
+
+bool CLI_CMD_TcpSendReliable (sCommandHandlerArgs_t *handler_args) {
+    return CLI_CMD_ExecuteSendCommand(handler_args, true, false);
+}
+
+bool CLI_CMD_TcpSendPersistent (sCommandHandlerArgs_t *handler_args) {
+    return CLI_CMD_ExecuteSendCommand(handler_args, false, true);
+}
+
+bool CLI_CMD_TcpClose (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_INFO("Command message does not contain a NULL terminator!\r\n");
+        return false;
+    }
+
+    int socket_id = atoi(handler_args->cmd_args.str);
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Disconnect};
+    tcp_job.data.disconnect.connect_id = socket_id;
+
+    if (TCP_APP_AddTask(&tcp_job) == false) {
+        DEBUG_INFO("Failed to disconnect from the servers!\r\n");
+        return false;
+    }
+    
+    return true;
+}
+
+bool CLI_CMD_TcpRecv (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    char received_data[RECEIVE_BUFFER_SIZE];
+    size_t received_size = TCP_API_Recv((eServerId_t) socket_id, received_data, sizeof(received_data), 0);
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Socket %d received %u bytes: %.*s\r\n",
+                                                    socket_id, received_size, (int) received_size, received_data);
+
+    return true;
+}
+
+bool CLI_CMD_TcpStats (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    sTcpSendStats_t stats;
+    if (TCP_APP_GetSendStats((eServerId_t) socket_id, &stats) == false) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    uint32_t frames_per_send = (stats.sends == 0) ? 0 : (stats.frames / stats.sends);
+    uint32_t bytes_per_send = (stats.sends == 0) ? 0 : (stats.bytes / stats.sends);
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Socket %d (%s): %lu sends, %lu frames/send, %lu bytes/send, %lu reconnects, "
+                                                    "%lu retransmits, %lu lost\r\n",
+                                                    socket_id, TCP_APP_GetSocketStateName(TCP_APP_GetSocketState((eServerId_t) socket_id)),
+                                                    stats.sends, frames_per_send, bytes_per_send, stats.reconnects,
+                                                    stats.retransmits, stats.lost);
+
+    return true;
+}
+
+bool CLI_CMD_TcpCoalesce (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int max_bytes;
+    if (MODEM_CMD_GetArgInt(&max_bytes, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    int max_latency_ms;
+    if (MODEM_CMD_GetArgInt(&max_latency_ms, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((max_bytes <= 0) || (max_latency_ms < 0) || (TCP_APP_SetCoalescing(max_bytes, max_latency_ms) == false)) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        handler_args->response_buffer->size,
+                                                        REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Sends are coalesced up to %d bytes or %d ms!\r\n",
+                                                    max_bytes, max_latency_ms);
+
+    return true;
+}
+
+bool CLI_CMD_OutboxStats (sCommandHandlerArgs_t *handler_args) {
+    sOutboxStats_t stats;
+    uint32_t pending = 0;
+
+    if (TCP_APP_GetOutboxStats(&stats, &pending) == false) {
+        DEBUG_INFO("Outbox is not mounted!\r\n");
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Outbox: %lu pending, %lu stored, %lu delivered, %lu lost, %lu corrupted, "
+                                                    "%lu erases (max %lu per sector)\r\n",
+                                                    pending, stats.appended, stats.committed, stats.lost, stats.corrupted,
+                                                    stats.erases, stats.max_erase_count);
+
+    return true;
+}
+
+bool CLI_CMD_GnssFix (sCommandHandlerArgs_t *handler_args) {
+    sNmeaFix_t fix;
+    uint32_t age_ms = 0;
+
+    if (GNSS_APP_GetFix(&fix, &age_ms) == false) {
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        handler_args->response_buffer->size,
+                                                        "GNSS: no fix, polling every %lu ms\r\n", GNSS_APP_GetPollInterval());
+        return true;
+    }
+
+    /* Coordinates are in 1e-7 degrees, printed without pulling in float formatting. */
+    uint32_t latitude = (fix.latitude < 0) ? -fix.latitude : fix.latitude;
+    uint32_t longitude = (fix.longitude < 0) ? -fix.longitude : fix.longitude;
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "GNSS: %s%lu.%07lu, %s%lu.%07lu, %lu sats, speed %u cm/s, age %lu ms\r\n",
+                                                    (fix.latitude < 0) ? "-" : "", latitude / 10000000, latitude % 10000000,
+                                                    (fix.longitude < 0) ? "-" : "", longitude / 10000000, longitude % 10000000,
+                                                    (uint32_t) fix.satellites_used, fix.speed, age_ms);
+
+    return true;
+}
+
+bool CLI_CMD_GnssTtff (sCommandHandlerArgs_t *handler_args) {
+    sGnssTtffStats_t ttff;
+    sXtraStats_t xtra;
+
+    if ((GNSS_APP_GetTtffStats(&ttff) == false) || (XTRA_API_GetStats(&xtra) == false)) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "TTFF: last %lu ms (%s), XTRA avg %lu ms/%lu, cold avg %lu ms/%lu\r\n"
+                                                    "XTRA: %lu B at %lu, %lu dl (%lu failed), %lu inj (%lu failed)\r\n",
+                                                    ttff.last_ttff_ms, ttff.is_last_assisted ? "XTRA" : "cold",
+                                                    ttff.assisted_average_ms, ttff.assisted_starts,
+                                                    ttff.unassisted_average_ms, ttff.unassisted_starts,
+                                                    xtra.size, xtra.download_time, xtra.downloads, xtra.download_failures,
+                                                    xtra.injections, xtra.injection_failures);
+
+    return true;
+}
+
+bool CLI_CMD_TrackStats (sCommandHandlerArgs_t *handler_args) {
+    sTrackFilterStats_t stats;
+    uint32_t lost = 0;
+
+    if (GNSS_APP_GetTrackStats(&stats, &lost) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Track: %lu fixes, %lu kept, %lu dropped, %lu lost "
+                                                    "(shape %lu, heading %lu, speed %lu, interval %lu)\r\n",
+                                                    stats.points_in, stats.kept, stats.dropped, lost, stats.kept_deviation,
+                                                    stats.kept_heading, stats.kept_speed, stats.kept_interval);
+
+    return true;
+}
+
+/* Runs with the scheduler live, so a busy system reads a little high */
+bool CLI_CMD_GeodesyBench (sCommandHandlerArgs_t *handler_args) {
+    uint32_t haversine = CLI_CMD_GeodesyCycles(&Geodesy_HaversineDistance);
+    uint32_t equirectangular = CLI_CMD_GeodesyCycles(&Geodesy_EquirectangularDistance);
+    uint32_t bearing = CLI_CMD_GeodesyCycles(&CLI_CMD_GeodesyBearing);
+    uint32_t enu = CLI_CMD_GeodesyCycles(&CLI_CMD_GeodesyEnu);
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Geodesy cycles/call: haversine %lu, equirect %lu, bearing %lu, enu %lu\r\n",
+                                                    haversine, equirectangular, bearing, enu);
+
+    return true;
+}
+
+bool CLI_CMD_GeofenceStats (sCommandHandlerArgs_t *handler_args) {
+    sGeofenceAppStats_t stats;
+
+    if (GEOFENCE_APP_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Fences: %lu, inside %lu, %lu fixes (%lu lost), %lu candidates, "
+                                                    "%lu tests, %lu alerts (%lu lost), %lu loads (%lu failed)\r\n",
+                                                    stats.fences, stats.inside, stats.engine.fixes, stats.fixes_lost,
+                                                    stats.engine.candidates, stats.engine.polygon_tests,
+                                                    stats.engine.alerts, stats.alerts_lost, stats.loads,
+                                                    stats.load_failures);
+
+    return true;
+}
+
+bool CLI_CMD_GeofenceLoad (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    if (handler_args->cmd_args.str[handler_args->cmd_args.size] != '\0') {
+        DEBUG_ERROR("Command message doesn't have a null terminator!\r\n");
+        return false;
+    }
+
+    char *host = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (host == NULL) {
+        DEBUG_ERROR("Failed to retrieve the server host!\r\n");
+        return false;
+    }
+
+    int port;
+    if (MODEM_CMD_GetArgInt(&port, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((port < MIN_PORT) || (port > MAX_PORT)) {
+        DEBUG_ERROR("Incorrect server and port number, available port are from 0 to 65536!\r\n");
+        return false;
+    }
+
+    char *path = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (path == NULL) {
+        DEBUG_ERROR("Failed to retrieve the fence set path!\r\n");
+        return false;
+    }
+
+    if (GEOFENCE_APP_Load(host, (size_t) port, path) == false) {
+        DEBUG_INFO("Failed to start the fence set download!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_GeofenceUplink (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if (GEOFENCE_APP_SetUplink((eServerId_t) socket_id) == false) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_ReportStats (sCommandHandlerArgs_t *handler_args) {
+    sReportAppStats_t stats;
+
+    if (REPORT_APP_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Report: %s, csq %d, %lu pending, fixes %lu (%lu/h), "
+                                                    "uploads %lu (%lu/h, %lu batch, %lu radio, %lu forced), "
+                                                    "%lu deferred, %lu points (%lu lost)\r\n",
+                                                    ReportScheduler_GetMotionName(stats.motion), stats.signal,
+                                                    stats.pending, stats.scheduler.fixes, stats.scheduler.fixes_last_hour,
+                                                    stats.scheduler.uploads, stats.scheduler.uploads_last_hour,
+                                                    stats.scheduler.uploads_batch, stats.scheduler.uploads_radio,
+                                                    stats.scheduler.uploads_forced, stats.scheduler.deferrals,
+                                                    stats.points_sent, stats.points_lost);
+
+    return true;
+}
+
+/* "reportpolicy:<motion>" prints a row of the table, "reportpolicy:<motion> <fix s> <upload s> <batch>" replaces it. */
+bool CLI_CMD_ReportPolicy (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int motion;
+    if (MODEM_CMD_GetArgInt(&motion, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((motion < eReportMotion_First) || (motion >= eReportMotion_Last)) {
+        DEBUG_INFO("Motion is out of range, 0 stationary, 1 slow, 2 highway!\r\n");
+        return false;
+    }
+
+    sReportPolicy_t policy;
+    int fix_interval_s;
+
+    if (MODEM_CMD_GetArgInt(&fix_interval_s, &handler_args->cmd_args.str) == false) {
+        if (REPORT_APP_GetPolicy((eReportMotion_t) motion, &policy) == false) {
+            return false;
+        }
+
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        handler_args->response_buffer->size,
+                                                        "Policy %s: fix every %lu s, upload every %lu s or at %u points\r\n",
+                                                        ReportScheduler_GetMotionName((eReportMotion_t) motion),
+                                                        policy.fix_interval_s, policy.upload_interval_s, policy.batch_size);
+        return true;
+    }
+
+    int upload_interval_s;
+    int batch_size;
+    if ((MODEM_CMD_GetArgInt(&upload_interval_s, &handler_args->cmd_args.str) == false) ||
+        (MODEM_CMD_GetArgInt(&batch_size, &handler_args->cmd_args.str) == false) ||
+        (fix_interval_s <= 0) || (upload_interval_s <= 0) || (batch_size <= 0) || (batch_size > UINT16_MAX)) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    policy.fix_interval_s = (uint32_t) fix_interval_s;
+    policy.upload_interval_s = (uint32_t) upload_interval_s;
+    policy.batch_size = (uint16_t) batch_size;
+
+    if (REPORT_APP_SetPolicy((eReportMotion_t) motion, &policy) == false) {
+        DEBUG_INFO("Failed to set the report policy!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_ReportUplink (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if (REPORT_APP_SetUplink((eServerId_t) socket_id) == false) {
+        DEBUG_INFO("Scoket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_LogStats (sCommandHandlerArgs_t *handler_args) {
+    sLogRingStats_t stats;
+
+    if (Debug_API_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Log: %lu records, %lu dropped, %lu/%lu bytes used, high water %lu\r\n",
+                                                    stats.records, stats.dropped, stats.used, stats.capacity,
+                                                    stats.high_water);
+
+    return true;
+}
+
+/* "loglevel:<tag>" prints the level of a module, "loglevel:<tag> <level>" sets it: 0 info, 1 warning, 2 error, 3 off.
+ * The tag "*" lists or sets every module. */
+bool CLI_CMD_LogLevel (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    char *tag = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if (tag == NULL) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    int level;
+    eDebugLevel_t module_level;
+
+    if (MODEM_CMD_GetArgInt(&level, &handler_args->cmd_args.str) == false) {
+        if (strcmp(tag, ALL_LOG_MODULES) == 0) {
+            const char *module_tag_name;
+
+            for (size_t index = 0; Debug_API_GetModule(index, &module_tag_name, &module_level) == true; index++) {
+                DEBUG_INFO("%s: %s\r\n", module_tag_name, Debug_API_GetLevelName(module_level));
+            }
+
+            handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                            handler_args->response_buffer->size,
+                                                            "Log levels of %u modules\r\n",
+                                                            Debug_API_GetModuleCount());
+            return true;
+        }
+
+        if (Debug_API_GetModuleLevel(tag, &module_level) == false) {
+            DEBUG_INFO("No module with the tag %s!\r\n", tag);
+            return false;
+        }
+
+        handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                        handler_args->response_buffer->size,
+                                                        "Log level %s: %s\r\n", tag,
+                                                        Debug_API_GetLevelName(module_level));
+        return true;
+    }
+
+    if ((level < eDebugLevel_First) || (level > eDebugLevel_Last)) {
+        DEBUG_INFO("Level is out of range, 0 info, 1 warning, 2 error, 3 off!\r\n");
+        return false;
+    }
+
+    if (Debug_API_SetModuleLevel(tag, (eDebugLevel_t) level) == false) {
+        DEBUG_INFO("No module with the tag %s!\r\n", tag);
+        return false;
+    }
+
+    return true;
+}
+
+/* "logsink:<socket> <ip> <port> [bytes/s]" mirrors the log to a server, the rate defaults to 256 bytes/s. */
+bool CLI_CMD_LogSinkStart (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Socket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    char *ip_address = strtok_r(NULL, ARGUMENTS_SEPERATOR, &handler_args->cmd_args.str);
+
+    if ((ip_address == NULL) || (strlen(ip_address) > MAX_SIZE_OF_IPV4_ADDRESS)) {
+        DEBUG_ERROR("Failed to retrieve server IP address!\r\n");
+        return false;
+    }
+
+    int port;
+    if ((MODEM_CMD_GetArgInt(&port, &handler_args->cmd_args.str) == false) || (port < MIN_PORT) || (port > MAX_PORT)) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    int rate;
+    if (MODEM_CMD_GetArgInt(&rate, &handler_args->cmd_args.str) == false) {
+        rate = LOG_SINK_APP_DEFAULT_RATE;
+    }
+
+    if (LOG_SINK_APP_Start((eServerId_t) socket_id, ip_address, (size_t) port, (rate > 0) ? (uint32_t) rate : 0) == false) {
+        DEBUG_INFO("Failed to start the log sink, is it already running?\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_LogSinkStop (sCommandHandlerArgs_t *handler_args) {
+    if (LOG_SINK_APP_Stop() == false) {
+        DEBUG_INFO("Log sink is not running!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_LogSinkStats (sCommandHandlerArgs_t *handler_args) {
+    sLogSinkAppStats_t stats;
+
+    if (LOG_SINK_APP_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Log sink: %s, socket %d, %lu B/s, %lu B in %lu blocks, "
+                                                    "%lu/%lu B held, %lu dropped, waits %lu link %lu outbox %lu rate\r\n",
+                                                    (stats.is_enabled == true) ? "on" : "off", stats.connect_id,
+                                                    stats.rate, stats.bytes_sent, stats.blocks_sent, stats.ring.used,
+                                                    stats.ring.capacity, stats.ring.dropped, stats.link_waits,
+                                                    stats.outbox_waits, stats.rate_waits);
+
+    return true;
+}
+
+/* One line per task: priority, state, CPU share over the metrics window and the least free stack in bytes. */
+bool CLI_CMD_Top (sCommandHandlerArgs_t *handler_args) {
+    size_t count;
+    uint32_t window_us;
+    uint16_t load;
+    uint16_t sleep;
+    sMetricsHeap_t heap;
+
+    if ((Metrics_API_GetTasks(g_top_tasks, METRICS_API_MAX_TASKS, &count, &window_us) == false) ||
+        (Metrics_API_GetCpuLoad(&load) == false) || (Metrics_API_GetSleep(&sleep) == false) ||
+        (Metrics_API_GetHeap(&heap) == false)) {
+        return false;
+    }
+
+    DEBUG_INFO("%-15s %3s %s %6s %6s\r\n", "Task", "Pri", "S", "CPU", "Stack");
+
+    for (size_t index = 0; index < count; index++) {
+        DEBUG_INFO("%-15s %3lu %c %3u.%u%% %6lu\r\n", g_top_tasks[index].name, g_top_tasks[index].priority,
+                   g_top_tasks[index].state, g_top_tasks[index].cpu_permille / 10U,
+                   g_top_tasks[index].cpu_permille % 10U, g_top_tasks[index].stack_free);
+    }
+
+    DEBUG_INFO("Heap: %u free, %u min, %u largest in %u blocks, %u allocs %u frees, libc %u/%u used\r\n",
+               heap.rtos_free, heap.rtos_min_free, heap.rtos_largest_block, heap.rtos_free_blocks,
+               heap.rtos_allocations, heap.rtos_frees, heap.libc_used, heap.libc_arena);
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "CPU %u.%u%%, Stop %u.%u%% over %lu ms, %u tasks\r\n", load / 10U,
+                                                    load % 10U, sleep / 10U, sleep % 10U, window_us / 1000U, count);
+
+    return true;
+}
+
+bool CLI_CMD_TraceStats (sCommandHandlerArgs_t *handler_args) {
+    sTraceStats_t stats;
+
+    if (Trace_API_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Trace: %s, %lu events held, %lu overwritten, %lu objects\r\n",
+                                                    (stats.is_recording == true) ? "on" : "off", stats.events,
+                                                    stats.overwritten, stats.objects);
+
+    return true;
+}
+
+bool CLI_CMD_TraceStart (sCommandHandlerArgs_t *handler_args) {
+    Trace_API_Start();
+
+    return true;
+}
+
+bool CLI_CMD_TraceStop (sCommandHandlerArgs_t *handler_args) {
+    Trace_API_Stop();
+
+    return true;
+}
+
+/* "tracedump" prints the trace on the console, Tools/trace_convert.py turns the captured lines into a Perfetto trace */
+bool CLI_CMD_TraceDump (sCommandHandlerArgs_t *handler_args) {
+    if (Trace_API_Dump(&CLI_CMD_DumpToConsole, NULL) == false) {
+        DEBUG_INFO("Trace dump was cut short!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+/* "tracedump:<socket>" sends the same lines over a connected socket */
+bool CLI_CMD_TraceDumpTcp (sCommandHandlerArgs_t *handler_args) {
+    if ((handler_args->cmd_args.str == NULL) || (handler_args->cmd_args.size == 0)) {
+        DEBUG_INFO("No command arguments entered, please enter valid command arguments!\r\n");
+        return false;
+    }
+
+    int socket_id;
+    if (MODEM_CMD_GetArgInt(&socket_id, &handler_args->cmd_args.str) == false) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((socket_id < eServerId_First) || (socket_id >= eServerId_Last)) {
+        DEBUG_INFO("Socket ID is out of range, the range: 0 to 10!\r\n");
+        return false;
+    }
+
+    if (TCP_APP_GetSocketState((eServerId_t) socket_id) != eSocketState_Connected) {
+        DEBUG_INFO("Socket %d is not connected!\r\n", socket_id);
+        return false;
+    }
+
+    sTraceTcpWriter_t writer = {.connect_id = (eServerId_t) socket_id, .payload = NULL, .size = 0};
+    bool is_dumped = Trace_API_Dump(&CLI_CMD_TraceWriteTcp, &writer);
+
+    if (is_dumped == true) {
+        is_dumped = CLI_CMD_TraceFlushTcp(&writer);
+    } else {
+        TCP_APP_FreePayload(writer.payload);
+    }
+
+    if (is_dumped == false) {
+        DEBUG_INFO("Trace dump was cut short!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_ProfilerStats (sCommandHandlerArgs_t *handler_args) {
+    sProfilerStats_t stats;
+
+    if (Profiler_API_GetStats(&stats) == false) {
+        return false;
+    }
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Profiler: %s at %lu Hz, %lu samples, %lu dropped, %lu/%u slots\r\n",
+                                                    (stats.is_running == true) ? "on" : "off", stats.rate_hz,
+                                                    stats.samples, stats.dropped, stats.slots_used, PROFILER_API_SLOTS);
+
+    return true;
+}
+
+/* "profstart" samples at the default rate, "profstart:<rate>" at the given rate in Hz */
+bool CLI_CMD_ProfilerStart (sCommandHandlerArgs_t *handler_args) {
+    int rate = PROFILER_API_DEFAULT_RATE_HZ;
+
+    if ((handler_args->cmd_args.str != NULL) && (handler_args->cmd_args.size > 0) &&
+        (MODEM_CMD_GetArgInt(&rate, &handler_args->cmd_args.str) == false)) {
+        DEBUG_INFO("%s", REPLY_INCORRECT_ARG_MESSAGE);
+        return false;
+    }
+
+    if ((rate <= 0) || (Profiler_API_Start((uint32_t) rate) == false)) {
+        DEBUG_INFO("Rate is out of range, the range: %u to %u Hz!\r\n", TIM_DRIVER_SAMPLE_MIN_HZ,
+                   TIM_DRIVER_SAMPLE_MAX_HZ);
+        return false;
+    }
+
+    return true;
+}
+
+bool CLI_CMD_ProfilerStop (sCommandHandlerArgs_t *handler_args) {
+    Profiler_API_Stop();
+
+    return true;
+}
+
+bool CLI_CMD_ProfilerReset (sCommandHandlerArgs_t *handler_args) {
+    Profiler_API_Reset();
+
+    return true;
+}
+
+/* Tools/profile_report.py turns the captured lines into a flat profile per function */
+bool CLI_CMD_ProfilerDump (sCommandHandlerArgs_t *handler_args) {
+    if (Profiler_API_Dump(&CLI_CMD_DumpToConsole, NULL) == false) {
+        DEBUG_INFO("Profile dump was cut short!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+/* Stops since boot, how many of them a UART cut short, the time spent in Stop and the locks keeping it off right now */
+bool CLI_CMD_PowerStats (sCommandHandlerArgs_t *handler_args) {
+    sPowerStats_t stats;
+    uint16_t sleep = 0;
+
+    if (Power_API_GetStats(&stats) == false) {
+        return false;
+    }
+
+    Metrics_API_GetSleep(&sleep);
+
+    handler_args->response_buffer->count = snprintf(handler_args->response_buffer->str,
+                                                    handler_args->response_buffer->size,
+                                                    "Power: %lu stops, %lu woken early, %lu ms stopped, %u.%u%% of the "
+                                                    "window, %lu locks, LSI %lu Hz\r\n", stats.stops,
+                                                    stats.early_wakeups, stats.stop_us / 1000U, sleep / 10U,
+                                                    sleep % 10U, stats.locks, stats.wake_timer_hz);
+
+    return true;
+}
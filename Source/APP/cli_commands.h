@@ -1,44 +1,77 @@
-#ifndef SOURCE_APP_CLI_COMMANDS_H_
-#define SOURCE_APP_CLI_COMMANDS_H_
-/**********************************************************************************************************************
-* Includes
-*********************************************************************************************************************/
-#include <stdbool.h>
-#include "cmd_api.h"
-#include "led_api.h"
-/**********************************************************************************************************************
-* Exported definitions and macros
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Exported types
-*********************************************************************************************************************/
-typedef struct sLedActionArgs {
-    eLed_t led;
-    size_t blink_freq;
-    size_t blinks_num;
-    void (*callback_func)(eLed_t led);
-} sLedActionArgs_t;
-
-typedef enum eLedAction {
-    eLedAction_First = 0,
-    eLedAction_On = eLedAction_First,
-    eLedAction_Off,
-    eLedAction_Toggle,
-    eLedAction_Blink,
-    eLedAction_Last
-} eLedAction_t;
-/**********************************************************************************************************************
-* Exported variables
-*********************************************************************************************************************/
-
-/**********************************************************************************************************************
-* Prototypes of exported functions
-*********************************************************************************************************************/
-bool CLI_CMD_SetLed (sCommandHandlerArgs_t *handler_args);
-bool CLI_CMD_ResetLed (sCommandHandlerArgs_t *handler_args);
-bool CLI_CMD_BlinkLed (sCommandHandlerArgs_t *handler_args);
-bool CLI_CMD_TcpOpen (sCommandHandlerArgs_t *handler_args);
-bool CLI_CMD_TcpSend (sCommandHandlerArgs_t *handler_args);
-bool CLI_CMD_TcpClose (sCommandHandlerArgs_t *handler_args);
-#endif /* SOURCE_APP_CLI_COMMANDS_H_ */
+#ifndef SOURCE_APP_CLI_COMMANDS_H_
+#define SOURCE_APP_CLI_COMMANDS_H_
+/**********************************************************************************************************************
+* Includes
+*********************************************************************************************************************/
+#include <stdbool.h>
+#include "cmd_api.h"
+#include "led_api.h"
+/**********************************************************************************************************************
+* Exported definitions and macros
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Exported types
+*********************************************************************************************************************/
+typedef struct sLedActionArgs {
+    eLed_t led;
+    size_t blink_freq;
+    size_t blinks_num;
+    void (*callback_func)(eLed_t led);
+} sLedActionArgs_t;
+
+typedef enum eLedAction {
+    eLedAction_First = 0,
+    eLedAction_On = eLedAction_First,
+    eLedAction_Off,
+    eLedAction_Toggle,
+    eLedAction_Blink,
+    eLedAction_Last
+} eLedAction_t;
+/**********************************************************************************************************************
+* Exported variables
+*********************************************************************************************************************/
+
+/**********************************************************************************************************************
+* Prototypes of exported functions
+*********************************************************************************************************************/
+bool CLI_CMD_SetLed (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ResetLed (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_BlinkLed (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpOpen (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpSend (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpSendReliable (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpClose (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpRecv (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpCoalesce (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TcpSendPersistent (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_OutboxStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GnssFix (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GnssTtff (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TrackStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GeodesyBench (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GeofenceStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GeofenceLoad (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_GeofenceUplink (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ReportStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ReportPolicy (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ReportUplink (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_LogStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_LogLevel (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_LogSinkStart (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_LogSinkStop (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_LogSinkStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_Top (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TraceStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TraceStart (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TraceStop (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TraceDump (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_TraceDumpTcp (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ProfilerStats (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ProfilerStart (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ProfilerStop (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ProfilerReset (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_ProfilerDump (sCommandHandlerArgs_t *handler_args);
+bool CLI_CMD_PowerStats (sCommandHandlerArgs_t *handler_args);
+#endif /* SOURCE_APP_CLI_COMMANDS_H_ */
@@ -0,0 +1,323 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "flash_driver.h"
+#include "http_api.h"
+#include "tcp_app.h"
+#include "gnss_app.h"
+#include "geofence.h"
+#include "geofence_app.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define GEOFENCE_TASK_ATTR_NAME "GeofenceTask"
+#define GEOFENCE_TASK_STACK_SIZE 1024U
+#define GEOFENCE_TASK_ARGS NULL
+/* Same level as the GNSS task that feeds it */
+#define GEOFENCE_TASK_PRIORITY 20
+#define GEOFENCE_QUEUE_ATTR_NAME "GeofenceQueue"
+#define GEOFENCE_QUEUE_SIZE 8
+#define FIX_PUT_TIMEOUT_MS 0
+#define LOAD_PUT_TIMEOUT_MS 100
+#define GEOFENCE_FLASH_SECTOR eFlashDriverSector_Geofence
+#define COMMIT_MAGIC 0x4D434647U
+#define IMAGE_OFFSET sizeof(sGeofenceCommit_t)
+#define ALERT_PAYLOAD_SIZE 64
+#define ALERT_FORMAT "GEOFENCE,%u,%s,%lu,%ld,%ld\r\n"
+#define DEFAULT_UPLINK eServerId_First
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* Written after the set has been downloaded and validated, an erased or torn download never carries the magic. */
+typedef struct sGeofenceCommit {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t reserved[2];
+} sGeofenceCommit_t;
+
+typedef enum eGeofenceJob {
+    eGeofenceJob_First = 0,
+    eGeofenceJob_Fix = eGeofenceJob_First,
+    eGeofenceJob_Load,
+    eGeofenceJob_Last
+} eGeofenceJob_t;
+
+typedef struct sGeofenceLoadJob {
+    char host[GEOFENCE_APP_HOST_SIZE];
+    size_t port;
+    char path[GEOFENCE_APP_PATH_SIZE];
+} sGeofenceLoadJob_t;
+
+typedef struct sGeofenceJobMessage {
+    eGeofenceJob_t type;
+    union {
+        sTrackPoint_t fix;
+        sGeofenceLoadJob_t load;
+    } data;
+} sGeofenceJobMessage_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(GEOFENCE_APP);
+static const osThreadAttr_t g_geofence_task_attr = {
+    .name = GEOFENCE_TASK_ATTR_NAME,
+    .stack_size = GEOFENCE_TASK_STACK_SIZE,
+    .priority = GEOFENCE_TASK_PRIORITY
+};
+static const osMessageQueueAttr_t g_geofence_queue_attr = {
+    .name = GEOFENCE_QUEUE_ATTR_NAME
+};
+static const char *g_event_names[eGeofenceEvent_Last] = {
+    [eGeofenceEvent_Enter] = "ENTER",
+    [eGeofenceEvent_Exit] = "EXIT"
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osThreadId_t g_geofence_task_id = NULL;
+static osMessageQueueId_t g_geofence_queue_id = NULL;
+/* Only the geofence task touches the engine once it runs */
+static sGeofence_t g_geofence = {0};
+static sGeofenceAlert_t g_alerts[GEOFENCE_MAX_EVENTS];
+static volatile eServerId_t g_uplink_id = DEFAULT_UPLINK;
+static uint32_t g_fixes_lost = 0;
+static uint32_t g_alerts_lost = 0;
+static uint32_t g_loads = 0;
+static uint32_t g_load_failures = 0;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void GEOFENCE_APP_Task (void *args);
+static bool GEOFENCE_APP_Mount (void);
+static void GEOFENCE_APP_OnFix (const sTrackPoint_t *point);
+static void GEOFENCE_APP_Evaluate (const sTrackPoint_t *point);
+static void GEOFENCE_APP_SendAlert (const sGeofenceAlert_t *alert);
+static void GEOFENCE_APP_Download (const sGeofenceLoadJob_t *load_job);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool GEOFENCE_APP_Mount (void) {
+    sGeofenceCommit_t commit;
+
+    if (Flash_Driver_Read(GEOFENCE_FLASH_SECTOR, 0, &commit, sizeof(commit)) == false) {
+        return false;
+    }
+
+    if ((commit.magic != COMMIT_MAGIC) || (commit.size > (Flash_Driver_GetSectorSize(GEOFENCE_FLASH_SECTOR) - IMAGE_OFFSET))) {
+        return false;
+    }
+
+    const uint8_t *image = (const uint8_t *) Flash_Driver_GetAddress(GEOFENCE_FLASH_SECTOR) + IMAGE_OFFSET;
+
+    return Geofence_Load(&g_geofence, image, commit.size);
+}
+
+/* Runs in the GNSS task, the fix is only handed over. */
+static void GEOFENCE_APP_OnFix (const sTrackPoint_t *point) {
+    sGeofenceJobMessage_t job = {.type = eGeofenceJob_Fix};
+
+    job.data.fix = *point;
+
+    if (osMessageQueuePut(g_geofence_queue_id, &job, 0, FIX_PUT_TIMEOUT_MS) != osOK) {
+        g_fixes_lost++;
+    }
+}
+
+static void GEOFENCE_APP_Evaluate (const sTrackPoint_t *point) {
+    sGeodesyPoint_t position = {.latitude = point->latitude, .longitude = point->longitude};
+    size_t alert_count = Geofence_Evaluate(&g_geofence, &position, point->timestamp, g_alerts);
+
+    for (size_t i = 0; i < alert_count; i++) {
+        GEOFENCE_APP_SendAlert(&g_alerts[i]);
+    }
+}
+
+/* Alerts go out live on a connected uplink, otherwise the outbox keeps them and sends them ahead of its backlog. */
+static void GEOFENCE_APP_SendAlert (const sGeofenceAlert_t *alert) {
+    DEBUG_INFO("Fence %u %s\r\n", alert->fence_id, g_event_names[alert->event]);
+
+    char *payload = TCP_APP_AllocPayload(ALERT_PAYLOAD_SIZE);
+    if (payload == NULL) {
+        DEBUG_WARN("No payload block for the fence %u alert!\r\n", alert->fence_id);
+        g_alerts_lost++;
+        return;
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = g_uplink_id;
+    tcp_job.data.send.data_str = payload;
+    tcp_job.data.send.data_size = snprintf(payload, ALERT_PAYLOAD_SIZE, ALERT_FORMAT, alert->fence_id,
+                                           g_event_names[alert->event], alert->timestamp,
+                                           alert->position.latitude, alert->position.longitude);
+    tcp_job.data.send.persistent = true;
+    tcp_job.data.send.urgent = true;
+
+    if (TCP_APP_AddTask(&tcp_job) == false) {
+        g_alerts_lost++;
+    }
+}
+
+/* The stored set is gone as soon as the sector is erased, fences start outside again with the new set. */
+static void GEOFENCE_APP_Download (const sGeofenceLoadJob_t *load_job) {
+    eServerId_t connect_id = TCP_APP_FindFreeSocket();
+
+    if (connect_id == eServerId_Last) {
+        DEBUG_WARN("No free socket for the fence download!\r\n");
+        g_load_failures++;
+        return;
+    }
+
+    Geofence_Init(&g_geofence, GEOFENCE_DEFAULT_HYSTERESIS);
+
+    if (Flash_Driver_Erase(GEOFENCE_FLASH_SECTOR) == false) {
+        DEBUG_ERROR("Failed to erase the geofence sector!\r\n");
+        g_load_failures++;
+        return;
+    }
+
+    char host[GEOFENCE_APP_HOST_SIZE];
+    uint32_t image_size = 0;
+
+    snprintf(host, sizeof(host), "%s", load_job->host);
+
+    if (HTTP_API_Download(connect_id, host, load_job->port, load_job->path, GEOFENCE_FLASH_SECTOR, IMAGE_OFFSET,
+                          &image_size) != eModemError_ATSuccess) {
+        DEBUG_WARN("Fence set download failed!\r\n");
+        g_load_failures++;
+        return;
+    }
+
+    const uint8_t *image = (const uint8_t *) Flash_Driver_GetAddress(GEOFENCE_FLASH_SECTOR) + IMAGE_OFFSET;
+
+    if (Geofence_Load(&g_geofence, image, image_size) == false) {
+        DEBUG_ERROR("Downloaded fence set is not valid!\r\n");
+        g_load_failures++;
+        return;
+    }
+
+    sGeofenceCommit_t commit = {
+        .magic = COMMIT_MAGIC,
+        .size = image_size
+    };
+
+    if (Flash_Driver_Program(GEOFENCE_FLASH_SECTOR, 0, &commit, sizeof(commit)) == false) {
+        DEBUG_ERROR("Failed to commit the fence set!\r\n");
+        Geofence_Init(&g_geofence, GEOFENCE_DEFAULT_HYSTERESIS);
+        g_load_failures++;
+        return;
+    }
+
+    g_loads++;
+
+    DEBUG_INFO("Fence set loaded, %u fences\r\n", Geofence_GetFenceCount(&g_geofence));
+}
+
+static void GEOFENCE_APP_Task (void *args) {
+    sGeofenceJobMessage_t job;
+
+    while (1) {
+        if (osMessageQueueGet(g_geofence_queue_id, &job, NULL, osWaitForever) != osOK) {
+            continue;
+        }
+
+        switch (job.type) {
+            case eGeofenceJob_Fix: {
+                GEOFENCE_APP_Evaluate(&job.data.fix);
+                break;
+            }
+            case eGeofenceJob_Load: {
+                GEOFENCE_APP_Download(&job.data.load);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool GEOFENCE_APP_Init (void) {
+    if (g_geofence_queue_id == NULL) {
+        Geofence_Init(&g_geofence, GEOFENCE_DEFAULT_HYSTERESIS);
+
+        if (GEOFENCE_APP_Mount()) {
+            DEBUG_INFO("Fence set mounted, %u fences\r\n", Geofence_GetFenceCount(&g_geofence));
+        } else {
+            DEBUG_INFO("No fence set stored\r\n");
+        }
+
+        g_geofence_queue_id = osMessageQueueNew(GEOFENCE_QUEUE_SIZE, sizeof(sGeofenceJobMessage_t), &g_geofence_queue_attr);
+        if (g_geofence_queue_id == NULL) {
+            DEBUG_ERROR("Failed to create the geofence queue!\r\n");
+            return false;
+        }
+    }
+
+    if (g_geofence_task_id == NULL) {
+        g_geofence_task_id = osThreadNew(&GEOFENCE_APP_Task, GEOFENCE_TASK_ARGS, &g_geofence_task_attr);
+        if (g_geofence_task_id == NULL) {
+            DEBUG_ERROR("Failed to create the geofence task!\r\n");
+            return false;
+        }
+    }
+
+    return GNSS_APP_AddFixCallback(&GEOFENCE_APP_OnFix);
+}
+
+bool GEOFENCE_APP_Load (const char *host, size_t port, const char *path) {
+    if ((host == NULL) || (path == NULL) || (g_geofence_queue_id == NULL) ||
+        (strlen(host) >= GEOFENCE_APP_HOST_SIZE) || (strlen(path) >= GEOFENCE_APP_PATH_SIZE)) {
+        return false;
+    }
+
+    sGeofenceJobMessage_t job = {.type = eGeofenceJob_Load};
+
+    snprintf(job.data.load.host, GEOFENCE_APP_HOST_SIZE, "%s", host);
+    snprintf(job.data.load.path, GEOFENCE_APP_PATH_SIZE, "%s", path);
+    job.data.load.port = port;
+
+    if (osMessageQueuePut(g_geofence_queue_id, &job, 0, LOAD_PUT_TIMEOUT_MS) != osOK) {
+        DEBUG_ERROR("Failed to queue the fence set download!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool GEOFENCE_APP_SetUplink (eServerId_t connect_id) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return false;
+    }
+
+    g_uplink_id = connect_id;
+
+    return true;
+}
+
+bool GEOFENCE_APP_GetStats (sGeofenceAppStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    Geofence_GetStats(&g_geofence, &stats->engine);
+    stats->fences = Geofence_GetFenceCount(&g_geofence);
+    stats->inside = Geofence_GetInsideCount(&g_geofence);
+    stats->fixes_lost = g_fixes_lost;
+    stats->alerts_lost = g_alerts_lost;
+    stats->loads = g_loads;
+    stats->load_failures = g_load_failures;
+
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SOURCE_APP_GEOFENCE_APP_H_
+#define SOURCE_APP_GEOFENCE_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "tcp_app.h"
+#include "geofence.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define GEOFENCE_APP_HOST_SIZE 40
+#define GEOFENCE_APP_PATH_SIZE 64
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sGeofenceAppStats {
+    sGeofenceStats_t engine;
+    uint32_t fences;
+    uint32_t inside;
+    uint32_t fixes_lost;
+    uint32_t alerts_lost;
+    uint32_t loads;
+    uint32_t load_failures;
+} sGeofenceAppStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool GEOFENCE_APP_Init (void);
+/* Fetches a fence set over HTTP, it replaces the stored set once it has been validated */
+bool GEOFENCE_APP_Load (const char *host, size_t port, const char *path);
+/* Socket the alerts are sent to, they go through the persistent outbox */
+bool GEOFENCE_APP_SetUplink (eServerId_t connect_id);
+bool GEOFENCE_APP_GetStats (sGeofenceAppStats_t *stats);
+#endif /* SOURCE_APP_GEOFENCE_APP_H_ */
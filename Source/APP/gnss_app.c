@@ -0,0 +1,438 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "heap_api.h"
+#include "led_api.h"
+#include "led_app.h"
+#include "modem_api.h"
+#include "tcp_api.h"
+#include "tcp_app.h"
+#include "gnss_api.h"
+#include "xtra_api.h"
+#include "date_time.h"
+#include "track_filter.h"
+#include "gnss_app.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define GNSS_TASK_ATTR_NAME "GnssTask"
+#define GNSS_TASK_STACK_SIZE 1024U
+#define GNSS_TASK_ARGS NULL
+/* Below the TCP and modem tasks, a location poll only runs when nothing more urgent wants the CPU. */
+#define GNSS_TASK_PRIORITY 20
+#define MODEM_WAIT_INTERVAL_MS 1000
+#define START_RETRY_INTERVAL_MS 5000
+#define SEARCH_POLL_INTERVAL_MS 2000
+#define MOVING_POLL_INTERVAL_MS 1000
+#define STATIONARY_POLL_INTERVAL_MS 10000
+#define BUSY_RETRY_INTERVAL_MS 250
+#define STREAM_WAIT_INTERVAL_MS 1000
+/* 0.01 m/s, about 3.6 km/h */
+#define MOVING_SPEED_THRESHOLD 100
+#define TRACK_QUEUE_ATTR_NAME "GnssTrackQueue"
+#define TRACK_QUEUE_SIZE 16
+#define TRACK_QUEUE_PUT_TIMEOUT_MS 0
+#define DATE_CENTURY 2000
+#define FIX_CALLBACK_COUNT 2
+#define FIX_REQUEST_FLAG 0x01U
+#define FIX_MUTEX_ATTR_NAME "GnssAppFixMutex"
+#define FIX_MUTEX_TIMEOUT_MS 20
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(GNSS_APP);
+static const osThreadAttr_t g_gnss_task_attr = {
+    .name = GNSS_TASK_ATTR_NAME,
+    .stack_size = GNSS_TASK_STACK_SIZE,
+    .priority = GNSS_TASK_PRIORITY
+};
+static const osMessageQueueAttr_t g_track_queue_attr = {
+    .name = TRACK_QUEUE_ATTR_NAME
+};
+static const osMutexAttr_t g_fix_mutex_attr = {
+    .name = FIX_MUTEX_ATTR_NAME
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osThreadId_t g_gnss_task_id = NULL;
+static volatile bool g_has_fix = false;
+static volatile uint32_t g_fix_tick = 0;
+static volatile uint32_t g_poll_interval_ms = MODEM_WAIT_INTERVAL_MS;
+static uint32_t g_start_tick = 0;
+static bool g_is_ttff_pending = false;
+static bool g_is_start_assisted = false;
+static sGnssTtffStats_t g_ttff_stats = {0};
+static osMessageQueueId_t g_track_queue_id = NULL;
+static sTrackFilter_t g_track_filter = {0};
+static uint32_t g_track_points_lost = 0;
+static gnss_app_fix_callback_t g_fix_callbacks[FIX_CALLBACK_COUNT] = {NULL};
+static size_t g_fix_callback_count = 0;
+static volatile bool g_is_on_demand = false;
+/* Outlives the engine, which forgets its fix when it is stopped between on demand requests */
+static sNmeaFix_t g_last_fix = {0};
+static osMutexId_t g_fix_mutex_id = NULL;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void GNSS_APP_Task (void *args);
+static uint32_t GNSS_APP_Poll (void);
+static void GNSS_APP_SetFixState (bool has_fix);
+static bool GNSS_APP_PrepareAssistance (void);
+static eModemError_t GNSS_APP_StartEngine (void);
+static void GNSS_APP_RecordTtff (void);
+static bool GNSS_APP_ToTrackPoint (const sNmeaFix_t *fix, sTrackPoint_t *point);
+static void GNSS_APP_FilterTrack (const sNmeaFix_t *fix);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static void GNSS_APP_SetFixState (bool has_fix) {
+    if (has_fix == g_has_fix) {
+        return;
+    }
+
+    g_has_fix = has_fix;
+
+    eLed_t *led = (eLed_t *) Heap_API_Calloc(1, sizeof(eLed_t));
+    if (led == NULL) {
+        DEBUG_ERROR("Failed to allocate the GPS fix LED request!\r\n");
+        return;
+    }
+
+    *led = eLed_GpsFix;
+
+    if (LED_APP_AddTask(has_fix ? eLedAction_On : eLedAction_Off, led) == false) {
+        Heap_API_Free(led);
+    }
+
+    DEBUG_INFO("GNSS fix %s\r\n", has_fix ? "acquired" : "lost");
+}
+
+/* Best effort, a start without assistance data is only slower. */
+static bool GNSS_APP_PrepareAssistance (void) {
+    uint32_t now = 0;
+
+    if (XTRA_API_GetNetworkTime(&now) != eModemError_ATSuccess) {
+        return false;
+    }
+
+    if (XTRA_API_IsStale(now)) {
+        eServerId_t connect_id = TCP_APP_FindFreeSocket();
+
+        if ((connect_id == eServerId_Last) || (XTRA_API_Download(connect_id, now) != eModemError_ATSuccess)) {
+            DEBUG_INFO("XTRA data could not be refreshed\r\n");
+        }
+    }
+
+    return (XTRA_API_Inject(now) == eModemError_ATSuccess);
+}
+
+static eModemError_t GNSS_APP_StartEngine (void) {
+    bool is_assisted = GNSS_APP_PrepareAssistance();
+
+    eModemError_t error_type = GNSS_API_Start();
+    if (error_type != eModemError_ATSuccess) {
+        return error_type;
+    }
+
+    g_start_tick = osKernelGetTickCount();
+    g_is_ttff_pending = true;
+    g_is_start_assisted = is_assisted;
+    g_ttff_stats.starts++;
+
+    return eModemError_ATSuccess;
+}
+
+static void GNSS_APP_RecordTtff (void) {
+    uint32_t ttff_ms = osKernelGetTickCount() - g_start_tick;
+
+    g_is_ttff_pending = false;
+    g_ttff_stats.last_ttff_ms = ttff_ms;
+    g_ttff_stats.is_last_assisted = g_is_start_assisted;
+
+    /* Running averages, so one odd start does not hide the trend. */
+    if (g_is_start_assisted) {
+        g_ttff_stats.assisted_starts++;
+        g_ttff_stats.assisted_average_ms += ((int32_t) ttff_ms - (int32_t) g_ttff_stats.assisted_average_ms) /
+                                            (int32_t) g_ttff_stats.assisted_starts;
+    } else {
+        g_ttff_stats.unassisted_starts++;
+        g_ttff_stats.unassisted_average_ms += ((int32_t) ttff_ms - (int32_t) g_ttff_stats.unassisted_average_ms) /
+                                              (int32_t) g_ttff_stats.unassisted_starts;
+    }
+
+    if (g_is_start_assisted && (g_ttff_stats.unassisted_starts > 0)) {
+        DEBUG_INFO("TTFF %lu ms with XTRA, %ld ms faster than the %lu ms unassisted average\r\n", ttff_ms,
+                   (int32_t) g_ttff_stats.unassisted_average_ms - (int32_t) ttff_ms, g_ttff_stats.unassisted_average_ms);
+    } else {
+        DEBUG_INFO("TTFF %lu ms %s\r\n", ttff_ms, g_is_start_assisted ? "with XTRA" : "without assistance");
+    }
+}
+
+static bool GNSS_APP_ToTrackPoint (const sNmeaFix_t *fix, sTrackPoint_t *point) {
+    /* The engine reports the date as ddmmyy */
+    sDateTime_t utc_time = {
+        .year = (uint16_t) (DATE_CENTURY + (fix->date % 100)),
+        .month = (uint8_t) ((fix->date / 100) % 100),
+        .day = (uint8_t) (fix->date / 10000),
+        .hour = (uint8_t) (fix->time_ms / 3600000),
+        .minute = (uint8_t) ((fix->time_ms / 60000) % 60),
+        .second = (uint8_t) ((fix->time_ms / 1000) % 60)
+    };
+
+    if (DateTime_IsValid(&utc_time) == false) {
+        return false;
+    }
+
+    point->timestamp = DateTime_ToUnix(&utc_time);
+    point->latitude = fix->latitude;
+    point->longitude = fix->longitude;
+    point->speed = fix->speed;
+    point->course = fix->course;
+
+    return true;
+}
+
+/* Only the points the filter keeps reach the uplink queue. */
+static void GNSS_APP_FilterTrack (const sNmeaFix_t *fix) {
+    sTrackPoint_t point;
+    sTrackPoint_t kept[TRACK_FILTER_MAX_OUTPUT];
+
+    if (GNSS_APP_ToTrackPoint(fix, &point) == false) {
+        return;
+    }
+
+    for (size_t i = 0; i < g_fix_callback_count; i++) {
+        g_fix_callbacks[i](&point);
+    }
+
+    size_t kept_count = TrackFilter_Push(&g_track_filter, &point, kept);
+
+    for (size_t i = 0; i < kept_count; i++) {
+        if (osMessageQueuePut(g_track_queue_id, &kept[i], 0, TRACK_QUEUE_PUT_TIMEOUT_MS) != osOK) {
+            g_track_points_lost++;
+        }
+    }
+}
+
+/* Returns the delay until the next poll. */
+static uint32_t GNSS_APP_Poll (void) {
+    if (Modem_API_GetState() != eModemState_Initialized) {
+        GNSS_APP_SetFixState(false);
+        return MODEM_WAIT_INTERVAL_MS;
+    }
+
+    /* Without the multiplexer the modem UART belongs to the stream for the whole session. */
+    if ((TCP_API_IsStreaming() == true) && (Modem_API_IsMultiplexed() == false)) {
+        return STREAM_WAIT_INTERVAL_MS;
+    }
+
+    if (GNSS_API_IsRunning() == false) {
+        if (GNSS_APP_StartEngine() != eModemError_ATSuccess) {
+            return START_RETRY_INTERVAL_MS;
+        }
+    }
+
+    switch (GNSS_API_PollLocation()) {
+        case eModemError_ATSuccess: {
+            sNmeaFix_t fix;
+
+            if (GNSS_API_GetFix(&fix) == false) {
+                return SEARCH_POLL_INTERVAL_MS;
+            }
+
+            if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) == osOK) {
+                g_last_fix = fix;
+                osMutexRelease(g_fix_mutex_id);
+            }
+
+            g_fix_tick = osKernelGetTickCount();
+            GNSS_APP_SetFixState(true);
+
+            if (g_is_ttff_pending) {
+                GNSS_APP_RecordTtff();
+            }
+
+            GNSS_APP_FilterTrack(&fix);
+
+            /* The engine sleeps until the next request and is started again by the poll it wakes up. A stop that
+             * fails leaves it running until the fix after that. */
+            if (g_is_on_demand) {
+                if (GNSS_API_Stop() != eModemError_ATSuccess) {
+                    DEBUG_WARN("GNSS engine keeps running after an on demand fix!\r\n");
+                }
+
+                return osWaitForever;
+            }
+
+            return (fix.speed >= MOVING_SPEED_THRESHOLD) ? MOVING_POLL_INTERVAL_MS : STATIONARY_POLL_INTERVAL_MS;
+        }
+        case eModemError_ResourceBusy: {
+            return BUSY_RETRY_INTERVAL_MS;
+        }
+        default: {
+            /* An engine woken for an on demand fix has none yet, the last one stands until it has */
+            if ((g_is_on_demand == false) || (g_is_ttff_pending == false)) {
+                GNSS_APP_SetFixState(false);
+            }
+
+            return SEARCH_POLL_INTERVAL_MS;
+        }
+    }
+}
+
+static void GNSS_APP_Task (void *args) {
+    while (1) {
+        g_poll_interval_ms = GNSS_APP_Poll();
+        /* A fix request cuts the wait short */
+        osThreadFlagsWait(FIX_REQUEST_FLAG, osFlagsWaitAny, g_poll_interval_ms);
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool GNSS_APP_Init (void) {
+    if (GNSS_API_Init() == false) {
+        DEBUG_ERROR("Failed to initialize the GNSS API!\r\n");
+        return false;
+    }
+
+    if (XTRA_API_Init() == false) {
+        DEBUG_ERROR("Failed to initialize the XTRA API!\r\n");
+        return false;
+    }
+
+    if (g_track_queue_id == NULL) {
+        TrackFilter_Init(&g_track_filter, NULL);
+
+        g_track_queue_id = osMessageQueueNew(TRACK_QUEUE_SIZE, sizeof(sTrackPoint_t), &g_track_queue_attr);
+        if (g_track_queue_id == NULL) {
+            DEBUG_ERROR("Failed to create the track point queue!\r\n");
+            return false;
+        }
+    }
+
+    if (g_fix_mutex_id == NULL) {
+        g_fix_mutex_id = osMutexNew(&g_fix_mutex_attr);
+        if (g_fix_mutex_id == NULL) {
+            DEBUG_ERROR("Failed to create the GNSS fix mutex!\r\n");
+            return false;
+        }
+    }
+
+    if (g_gnss_task_id == NULL) {
+        g_gnss_task_id = osThreadNew(&GNSS_APP_Task, GNSS_TASK_ARGS, &g_gnss_task_attr);
+        if (g_gnss_task_id == NULL) {
+            DEBUG_ERROR("Failed to create the GNSS task!\r\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool GNSS_APP_GetFix (sNmeaFix_t *fix, uint32_t *age_ms) {
+    if ((fix == NULL) || (g_has_fix == false)) {
+        return false;
+    }
+
+    if (osMutexAcquire(g_fix_mutex_id, FIX_MUTEX_TIMEOUT_MS) != osOK) {
+        return false;
+    }
+
+    *fix = g_last_fix;
+
+    osMutexRelease(g_fix_mutex_id);
+
+    if (age_ms != NULL) {
+        *age_ms = osKernelGetTickCount() - g_fix_tick;
+    }
+
+    return true;
+}
+
+bool GNSS_APP_HasFix (void) {
+    return g_has_fix;
+}
+
+uint32_t GNSS_APP_GetPollInterval (void) {
+    return g_poll_interval_ms;
+}
+
+bool GNSS_APP_GetTtffStats (sGnssTtffStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    *stats = g_ttff_stats;
+
+    return true;
+}
+
+bool GNSS_APP_GetTrackPoint (sTrackPoint_t *point, uint32_t timeout) {
+    if ((point == NULL) || (g_track_queue_id == NULL)) {
+        return false;
+    }
+
+    return (osMessageQueueGet(g_track_queue_id, point, NULL, timeout) == osOK);
+}
+
+bool GNSS_APP_SetTrackFilter (const sTrackFilterConfig_t *config) {
+    return TrackFilter_SetConfig(&g_track_filter, config);
+}
+
+bool GNSS_APP_GetTrackStats (sTrackFilterStats_t *stats, uint32_t *lost) {
+    if ((stats == NULL) || (lost == NULL)) {
+        return false;
+    }
+
+    *lost = g_track_points_lost;
+
+    return TrackFilter_GetStats(&g_track_filter, stats);
+}
+
+/* Callbacks are added at start up, before the first fix can arrive. */
+bool GNSS_APP_AddFixCallback (gnss_app_fix_callback_t callback) {
+    if (callback == NULL) {
+        DEBUG_ERROR("Invalid fix callback!\r\n");
+        return false;
+    }
+
+    if (g_fix_callback_count >= FIX_CALLBACK_COUNT) {
+        DEBUG_ERROR("No free fix callback slot!\r\n");
+        return false;
+    }
+
+    g_fix_callbacks[g_fix_callback_count++] = callback;
+
+    return true;
+}
+
+void GNSS_APP_SetOnDemand (bool is_on_demand) {
+    g_is_on_demand = is_on_demand;
+
+    /* Leaving on demand mode wakes the task, the engine may be off and waiting for a request */
+    if (is_on_demand == false) {
+        GNSS_APP_RequestFix();
+    }
+}
+
+bool GNSS_APP_RequestFix (void) {
+    if (g_gnss_task_id == NULL) {
+        return false;
+    }
+
+    return ((osThreadFlagsSet(g_gnss_task_id, FIX_REQUEST_FLAG) & osFlagsError) == 0);
+}
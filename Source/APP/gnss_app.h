@@ -0,0 +1,53 @@
+#ifndef SOURCE_APP_GNSS_APP_H_
+#define SOURCE_APP_GNSS_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "gnss_api.h"
+#include "track_filter.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Time to first fix, measured from the engine start command */
+typedef struct sGnssTtffStats {
+    uint32_t starts;
+    uint32_t last_ttff_ms;
+    bool is_last_assisted;
+    uint32_t assisted_starts;
+    uint32_t assisted_average_ms;
+    uint32_t unassisted_starts;
+    uint32_t unassisted_average_ms;
+} sGnssTtffStats_t;
+
+/* Run in the GNSS task for every fix with a valid time, before the track filter sees it */
+typedef void (*gnss_app_fix_callback_t) (const sTrackPoint_t *point);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool GNSS_APP_Init (void);
+/* Latest position, false while there is none; age_ms may be NULL */
+bool GNSS_APP_GetFix (sNmeaFix_t *fix, uint32_t *age_ms);
+bool GNSS_APP_HasFix (void);
+uint32_t GNSS_APP_GetPollInterval (void);
+bool GNSS_APP_GetTtffStats (sGnssTtffStats_t *stats);
+/* Simplified track for the uplink, one point per kept fix */
+bool GNSS_APP_GetTrackPoint (sTrackPoint_t *point, uint32_t timeout);
+bool GNSS_APP_SetTrackFilter (const sTrackFilterConfig_t *config);
+bool GNSS_APP_GetTrackStats (sTrackFilterStats_t *stats, uint32_t *lost);
+bool GNSS_APP_AddFixCallback (gnss_app_fix_callback_t callback);
+/* On demand, a held fix is only refreshed by GNSS_APP_RequestFix and the engine is powered down in between; the search
+ * for a lost fix keeps its own pace. */
+void GNSS_APP_SetOnDemand (bool is_on_demand);
+bool GNSS_APP_RequestFix (void);
+#endif /* SOURCE_APP_GNSS_APP_H_ */
@@ -1,26 +1,26 @@
-#ifndef SOURCE_APP_LED_APP_H_
-#define SOURCE_APP_LED_APP_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include "cli_commands.h"
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-bool LED_APP_Init (void);
-bool LED_APP_AddTask (eLedAction_t led_action_type, void *led_action_args);
-void LED_APP_BlinkCompletedCallback (eLed_t led);
+#ifndef SOURCE_APP_LED_APP_H_
+#define SOURCE_APP_LED_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include "cli_commands.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool LED_APP_Init (void);
+bool LED_APP_AddTask (eLedAction_t led_action_type, void *led_action_args);
+void LED_APP_BlinkCompletedCallback (eLed_t led);
 #endif /* SOURCE_APP_LED_APP_H_ */
\ No newline at end of file
@@ -0,0 +1,407 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "debug_api.h"
+#include "tcp_app.h"
+#include "report_app.h"
+#include "metrics_api.h"
+#include "log_ring.h"
+#include "log_sink_app.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define LOG_SINK_TASK_ATTR_NAME "LogSinkTask"
+#define LOG_SINK_TASK_STACK_SIZE 1024U
+#define LOG_SINK_TASK_ARGS NULL
+/* Above the debug drain that feeds it, below every task that does real work */
+#define LOG_SINK_TASK_PRIORITY 9
+#define LOG_SINK_FLAG_DATA 0x01U
+#define LOG_SINK_FLAG_CONFIG 0x02U
+#define LOG_SINK_FLAGS (LOG_SINK_FLAG_DATA | LOG_SINK_FLAG_CONFIG)
+/* Kept while the link is down, the newest lines are dropped once it is full */
+#define LOG_SINK_RING_SIZE 8192
+/* Lines wait this long for company, or until this many bytes are pending */
+#define FLUSH_LATENCY_MS 1000
+#define FLUSH_BYTES 1024
+/* Payload blocks come from the pool the position uploads use, only a few are taken at once */
+#define MAX_BLOCKS_PER_FLUSH 4
+#define LINK_RETRY_MS 5000
+#define METRICS_INTERVAL_MS 60000
+#define RATE_BURST_BYTES 1024
+#define MIN_RATE 16
+#define TIMESTAMP_PREFIX_SIZE 12
+/* A line always fits into an empty block together with its timestamp */
+#define MAX_LINE_SIZE (TCP_APP_PAYLOAD_BLOCK_SIZE - TIMESTAMP_PREFIX_SIZE)
+#define MS_IN_S 1000U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(LOG_SINK_APP);
+static const osThreadAttr_t g_log_sink_task_attr = {
+    .name = LOG_SINK_TASK_ATTR_NAME,
+    .stack_size = LOG_SINK_TASK_STACK_SIZE,
+    .priority = LOG_SINK_TASK_PRIORITY
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osThreadId_t g_log_sink_task_id = NULL;
+/* Kept as 64 bit words so the records are aligned */
+static uint64_t g_sink_ring_storage[LOG_SINK_RING_SIZE / sizeof(uint64_t)] = {0};
+static sLogRing_t g_sink_ring = {0};
+static volatile bool g_is_enabled = false;
+static volatile eServerId_t g_connect_id = eServerId_First;
+static volatile uint32_t g_rate = LOG_SINK_APP_DEFAULT_RATE;
+static bool g_is_own_connection = false;
+/* Written by the drain task when the ring was empty, read by the sink task */
+static volatile uint32_t g_batch_tick = 0;
+/* Only the sink task touches the rest */
+static bool g_was_enabled = false;
+static uint32_t g_tokens = 0;
+static uint32_t g_token_tick = 0;
+static uint32_t g_metrics_tick = 0;
+static uint32_t g_bytes_sent = 0;
+static uint32_t g_blocks_sent = 0;
+static uint32_t g_link_waits = 0;
+static uint32_t g_outbox_waits = 0;
+static uint32_t g_rate_waits = 0;
+static uint32_t g_metrics = 0;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void LOG_SINK_APP_Task (void *args);
+static void LOG_SINK_APP_Mirror (uint32_t timestamp, const char *data, size_t size);
+static void LOG_SINK_APP_Purge (void);
+static void LOG_SINK_APP_RefillTokens (uint32_t now);
+static void LOG_SINK_APP_ReportMetrics (uint32_t now);
+static size_t LOG_SINK_APP_FillBlock (char *block, size_t block_size);
+static void LOG_SINK_APP_Flush (uint32_t now);
+static uint32_t LOG_SINK_APP_GetTimeout (uint32_t now);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Runs in the debug drain task, only copies the line. The lines logged while the sink's own blocks go out are left
+ * out, each of them would cause another send. */
+static void LOG_SINK_APP_Mirror (uint32_t timestamp, const char *data, size_t size) {
+    if ((g_is_enabled == false) || (TCP_APP_IsQuietTick(timestamp) == true)) {
+        return;
+    }
+
+    bool was_empty = false;
+
+    if (LogRing_Write(&g_sink_ring, &timestamp, sizeof(timestamp), data, (size > MAX_LINE_SIZE) ? MAX_LINE_SIZE : size,
+                      &was_empty) == false) {
+        return;
+    }
+
+    if (was_empty == true) {
+        g_batch_tick = osKernelGetTickCount();
+        osThreadFlagsSet(g_log_sink_task_id, LOG_SINK_FLAG_DATA);
+    }
+}
+
+static void LOG_SINK_APP_Purge (void) {
+    size_t size;
+
+    while (LogRing_Peek(&g_sink_ring, &size) != NULL) {
+        LogRing_Release(&g_sink_ring);
+    }
+}
+
+static void LOG_SINK_APP_RefillTokens (uint32_t now) {
+    uint32_t rate = g_rate;
+    uint32_t added = ((now - g_token_tick) * rate) / MS_IN_S;
+
+    if (added == 0) {
+        return;
+    }
+
+    /* Only the time that earned whole bytes is used up */
+    g_token_tick += (added * MS_IN_S) / rate;
+    g_tokens = ((g_tokens + added) > RATE_BURST_BYTES) ? RATE_BURST_BYTES : (g_tokens + added);
+}
+
+/* Goes out as an ordinary log line, so it reaches both the UART and the server in either log mode. */
+static void LOG_SINK_APP_ReportMetrics (uint32_t now) {
+    sLogRingStats_t log_stats = {0};
+    sTcpSendStats_t tcp_stats = {0};
+    sOutboxStats_t outbox_stats;
+    uint32_t outbox_pending = 0;
+    sReportAppStats_t report_stats = {0};
+    uint16_t cpu_load = 0;
+    uint16_t sleep = 0;
+
+    Debug_API_GetStats(&log_stats);
+    TCP_APP_GetSendStats(g_connect_id, &tcp_stats);
+    TCP_APP_GetOutboxStats(&outbox_stats, &outbox_pending);
+    REPORT_APP_GetStats(&report_stats);
+    Metrics_API_GetCpuLoad(&cpu_load);
+    Metrics_API_GetSleep(&sleep);
+
+    /* Two lines, one would not fit into a debug message with every counter at full width */
+    DEBUG_INFO("Metrics: up %lu s, cpu %u.%u%%, stop %u.%u%%, heap %u min %u, log %lu/%lu lost\r\n",
+               (unsigned long) (now / MS_IN_S), cpu_load / 10U, cpu_load % 10U, sleep / 10U, sleep % 10U,
+               (unsigned) xPortGetFreeHeapSize(), (unsigned) xPortGetMinimumEverFreeHeapSize(),
+               (unsigned long) log_stats.records, (unsigned long) log_stats.dropped);
+    DEBUG_INFO("Metrics: tcp %lu B %lu lost, outbox %lu, points %lu/%lu lost\r\n", (unsigned long) tcp_stats.bytes,
+               (unsigned long) tcp_stats.lost, (unsigned long) outbox_pending, (unsigned long) report_stats.points_sent,
+               (unsigned long) report_stats.points_lost);
+    g_metrics++;
+}
+
+/* Whole lines only, each one is paid for from the rate budget. */
+static size_t LOG_SINK_APP_FillBlock (char *block, size_t block_size) {
+    size_t count = 0;
+
+    while (true) {
+        size_t record_size = 0;
+        const uint8_t *record = LogRing_Peek(&g_sink_ring, &record_size);
+
+        if ((record == NULL) || (record_size < sizeof(uint32_t))) {
+            break;
+        }
+
+        uint32_t timestamp;
+        memcpy(&timestamp, record, sizeof(timestamp));
+
+        size_t data_size = record_size - sizeof(timestamp);
+        char prefix[TIMESTAMP_PREFIX_SIZE] = {0};
+        int prefix_size = 0;
+
+#if (DEBUG_API_BINARY_LOG == 0)
+        /* Binary frames carry their own timestamp */
+        prefix_size = snprintf(prefix, sizeof(prefix), "%lu ", (unsigned long) timestamp);
+#endif
+
+        size_t line_size = prefix_size + data_size;
+
+        if (((count + line_size) > block_size) || (line_size > g_tokens)) {
+            break;
+        }
+
+        memcpy(&block[count], prefix, prefix_size);
+        memcpy(&block[count + prefix_size], &record[sizeof(timestamp)], data_size);
+        count += line_size;
+        g_tokens -= line_size;
+        LogRing_Release(&g_sink_ring);
+    }
+
+    return count;
+}
+
+/* Blocks are queued back to back without the urgent flag, the TCP task coalesces them into full QISEND frames. */
+static void LOG_SINK_APP_Flush (uint32_t now) {
+    if (LogRing_IsEmpty(&g_sink_ring) == true) {
+        return;
+    }
+
+    sLogRingStats_t ring_stats;
+    LogRing_GetStats(&g_sink_ring, &ring_stats);
+
+    if ((ring_stats.used < FLUSH_BYTES) && ((now - g_batch_tick) < FLUSH_LATENCY_MS)) {
+        return;
+    }
+
+    if (TCP_APP_GetSocketState(g_connect_id) != eSocketState_Connected) {
+        g_link_waits++;
+        return;
+    }
+
+    /* Position frames waiting for delivery go first */
+    sOutboxStats_t outbox_stats;
+    uint32_t outbox_pending = 0;
+
+    if ((TCP_APP_GetOutboxStats(&outbox_stats, &outbox_pending) == true) && (outbox_pending > 0)) {
+        g_outbox_waits++;
+        return;
+    }
+
+    for (size_t block = 0; block < MAX_BLOCKS_PER_FLUSH; block++) {
+        char *payload = TCP_APP_AllocPayload(TCP_APP_PAYLOAD_BLOCK_SIZE);
+
+        if (payload == NULL) {
+            return;
+        }
+
+        size_t payload_size = LOG_SINK_APP_FillBlock(payload, TCP_APP_PAYLOAD_BLOCK_SIZE);
+
+        if (payload_size == 0) {
+            TCP_APP_FreePayload(payload);
+
+            if (LogRing_IsEmpty(&g_sink_ring) == false) {
+                g_rate_waits++;
+            }
+
+            return;
+        }
+
+        sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+        tcp_job.data.send.connect_id = g_connect_id;
+        tcp_job.data.send.data_str = payload;
+        tcp_job.data.send.data_size = payload_size;
+        tcp_job.data.send.quiet = true;
+
+        if (TCP_APP_AddTask(&tcp_job) == false) {
+            return;
+        }
+
+        g_bytes_sent += payload_size;
+        g_blocks_sent++;
+    }
+}
+
+static uint32_t LOG_SINK_APP_GetTimeout (uint32_t now) {
+    if (g_is_enabled == false) {
+        return osWaitForever;
+    }
+
+    uint32_t elapsed = now - g_metrics_tick;
+    uint32_t timeout = (elapsed >= METRICS_INTERVAL_MS) ? 1 : (METRICS_INTERVAL_MS - elapsed);
+
+    if (LogRing_IsEmpty(&g_sink_ring) == false) {
+        uint32_t retry = (TCP_APP_GetSocketState(g_connect_id) == eSocketState_Connected) ? FLUSH_LATENCY_MS : LINK_RETRY_MS;
+
+        timeout = (retry < timeout) ? retry : timeout;
+    }
+
+    return timeout;
+}
+
+static void LOG_SINK_APP_Task (void *args) {
+    while (1) {
+        osThreadFlagsWait(LOG_SINK_FLAGS, osFlagsWaitAny, LOG_SINK_APP_GetTimeout(osKernelGetTickCount()));
+
+        uint32_t now = osKernelGetTickCount();
+
+        if (g_is_enabled == false) {
+            if (g_was_enabled == true) {
+                LOG_SINK_APP_Purge();
+                g_was_enabled = false;
+            }
+
+            continue;
+        }
+
+        if (g_was_enabled == false) {
+            g_was_enabled = true;
+            g_tokens = RATE_BURST_BYTES;
+            g_token_tick = now;
+            g_metrics_tick = now;
+        }
+
+        LOG_SINK_APP_RefillTokens(now);
+
+        if ((now - g_metrics_tick) >= METRICS_INTERVAL_MS) {
+            g_metrics_tick = now;
+            LOG_SINK_APP_ReportMetrics(now);
+        }
+
+        LOG_SINK_APP_Flush(now);
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool LOG_SINK_APP_Init (void) {
+    if (g_log_sink_task_id != NULL) {
+        return true;
+    }
+
+    if (LogRing_Init(&g_sink_ring, g_sink_ring_storage, sizeof(g_sink_ring_storage)) == false) {
+        DEBUG_ERROR("Failed to set up the log sink ring!\r\n");
+        return false;
+    }
+
+    g_log_sink_task_id = osThreadNew(&LOG_SINK_APP_Task, LOG_SINK_TASK_ARGS, &g_log_sink_task_attr);
+    if (g_log_sink_task_id == NULL) {
+        DEBUG_ERROR("Failed to create the log sink task!\r\n");
+        return false;
+    }
+
+    Debug_API_SetMirror(&LOG_SINK_APP_Mirror);
+
+    return true;
+}
+
+bool LOG_SINK_APP_Start (eServerId_t connect_id, const char *ip_address, size_t port, uint32_t rate) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || (ip_address == NULL) || (rate < MIN_RATE)) {
+        return false;
+    }
+
+    if ((g_log_sink_task_id == NULL) || (g_is_enabled == true)) {
+        return false;
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+
+    g_is_own_connection = (TCP_APP_GetSocketState(connect_id) == eSocketState_Closed);
+
+    if (g_is_own_connection == true) {
+        tcp_job.data.connect.connect_id = connect_id;
+        tcp_job.data.connect.service = eSocketService_Tcp;
+        tcp_job.data.connect.port = port;
+        snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", ip_address);
+
+        if (TCP_APP_AddTask(&tcp_job) == false) {
+            return false;
+        }
+    }
+
+    g_connect_id = connect_id;
+    g_rate = rate;
+    g_is_enabled = true;
+    osThreadFlagsSet(g_log_sink_task_id, LOG_SINK_FLAG_CONFIG);
+
+    return true;
+}
+
+bool LOG_SINK_APP_Stop (void) {
+    if (g_is_enabled == false) {
+        return false;
+    }
+
+    g_is_enabled = false;
+    osThreadFlagsSet(g_log_sink_task_id, LOG_SINK_FLAG_CONFIG);
+
+    if (g_is_own_connection == true) {
+        sTcpJobMessage_t tcp_job = {.type = eTcpJob_Disconnect};
+        tcp_job.data.disconnect.connect_id = g_connect_id;
+        g_is_own_connection = false;
+
+        return TCP_APP_AddTask(&tcp_job);
+    }
+
+    return true;
+}
+
+bool LOG_SINK_APP_GetStats (sLogSinkAppStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    stats->is_enabled = g_is_enabled;
+    stats->connect_id = g_connect_id;
+    stats->rate = g_rate;
+    stats->bytes_sent = g_bytes_sent;
+    stats->blocks_sent = g_blocks_sent;
+    stats->link_waits = g_link_waits;
+    stats->outbox_waits = g_outbox_waits;
+    stats->rate_waits = g_rate_waits;
+    stats->metrics = g_metrics;
+
+    return LogRing_GetStats(&g_sink_ring, &stats->ring);
+}
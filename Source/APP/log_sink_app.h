@@ -0,0 +1,44 @@
+#ifndef SOURCE_APP_LOG_SINK_APP_H_
+#define SOURCE_APP_LOG_SINK_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "tcp_app.h"
+#include "log_ring.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define LOG_SINK_APP_DEFAULT_RATE 256
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sLogSinkAppStats {
+    bool is_enabled;
+    eServerId_t connect_id;
+    uint32_t rate;
+    uint32_t bytes_sent;
+    uint32_t blocks_sent;
+    /* Flushes held back by a closed link, a busy outbox or the rate cap */
+    uint32_t link_waits;
+    uint32_t outbox_waits;
+    uint32_t rate_waits;
+    uint32_t metrics;
+    sLogRingStats_t ring;
+} sLogSinkAppStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool LOG_SINK_APP_Init (void);
+/* Mirrors the log and the metric snapshots to the server, at most rate bytes per second. The socket is opened when
+ * it is closed, an open one is shared. */
+bool LOG_SINK_APP_Start (eServerId_t connect_id, const char *ip_address, size_t port, uint32_t rate);
+bool LOG_SINK_APP_Stop (void);
+bool LOG_SINK_APP_GetStats (sLogSinkAppStats_t *stats);
+#endif /* SOURCE_APP_LOG_SINK_APP_H_ */
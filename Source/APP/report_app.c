@@ -0,0 +1,366 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "modem_api.h"
+#include "tcp_app.h"
+#include "gnss_app.h"
+#include "buffer.h"
+#include "telemetry_frame.h"
+#include "report_scheduler.h"
+#include "report_app.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define REPORT_TASK_ATTR_NAME "ReportTask"
+#define REPORT_TASK_STACK_SIZE 1024U
+#define REPORT_TASK_ARGS NULL
+/* Same level as the GNSS task that feeds it */
+#define REPORT_TASK_PRIORITY 20
+#define REPORT_QUEUE_ATTR_NAME "ReportQueue"
+#define REPORT_QUEUE_SIZE 8
+#define REPORT_TIMER_ATTR_NAME "ReportTimer"
+#define EVENT_PUT_TIMEOUT_MS 0
+#define POLICY_PUT_TIMEOUT_MS 100
+/* osTimerStart does not take a zero delay */
+#define MIN_TIMER_DELAY_MS 1
+#define BATCH_CAPACITY 64
+/* Own frames leave within the coalescing latency, a send later than this came from someone else. */
+#define OWN_SEND_WINDOW_MS 2000
+#define DEFAULT_UPLINK eServerId_First
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eReportJob {
+    eReportJob_First = 0,
+    eReportJob_Timer = eReportJob_First,
+    eReportJob_Fix,
+    eReportJob_Policy,
+    eReportJob_Last
+} eReportJob_t;
+
+typedef struct sReportPolicyJob {
+    eReportMotion_t motion;
+    sReportPolicy_t policy;
+} sReportPolicyJob_t;
+
+typedef struct sReportJobMessage {
+    eReportJob_t type;
+    union {
+        sTrackPoint_t fix;
+        sReportPolicyJob_t policy;
+    } data;
+} sReportJobMessage_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(REPORT_APP);
+static const osThreadAttr_t g_report_task_attr = {
+    .name = REPORT_TASK_ATTR_NAME,
+    .stack_size = REPORT_TASK_STACK_SIZE,
+    .priority = REPORT_TASK_PRIORITY
+};
+static const osMessageQueueAttr_t g_report_queue_attr = {
+    .name = REPORT_QUEUE_ATTR_NAME
+};
+static const osTimerAttr_t g_report_timer_attr = {
+    .name = REPORT_TIMER_ATTR_NAME
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static osThreadId_t g_report_task_id = NULL;
+static osMessageQueueId_t g_report_queue_id = NULL;
+static osTimerId_t g_report_timer_id = NULL;
+/* Only the report task touches the scheduler and the batch once it runs */
+static sReportScheduler_t g_scheduler = {0};
+static sTelemetryPoint_t g_batch[BATCH_CAPACITY];
+static size_t g_batch_count = 0;
+static volatile eServerId_t g_uplink_id = DEFAULT_UPLINK;
+static int g_signal = REPORT_SCHEDULER_SIGNAL_UNKNOWN;
+static uint32_t g_upload_tick = 0;
+static uint32_t g_seen_transmit_tick = 0;
+static uint32_t g_frames = 0;
+static uint32_t g_points_sent = 0;
+static uint32_t g_points_lost = 0;
+static uint32_t g_events_lost = 0;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void REPORT_APP_Task (void *args);
+static void REPORT_APP_OnTimer (void *args);
+static void REPORT_APP_OnFix (const sTrackPoint_t *point);
+static void REPORT_APP_CollectPoints (void);
+static void REPORT_APP_CheckRadio (void);
+static size_t REPORT_APP_Upload (void);
+static void REPORT_APP_Run (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Runs in the timer daemon task, the work is handed over. */
+static void REPORT_APP_OnTimer (void *args) {
+    sReportJobMessage_t job = {.type = eReportJob_Timer};
+
+    if (osMessageQueuePut(g_report_queue_id, &job, 0, EVENT_PUT_TIMEOUT_MS) != osOK) {
+        g_events_lost++;
+    }
+}
+
+/* Runs in the GNSS task, every fix updates the motion state. */
+static void REPORT_APP_OnFix (const sTrackPoint_t *point) {
+    sReportJobMessage_t job = {.type = eReportJob_Fix};
+
+    job.data.fix = *point;
+
+    if (osMessageQueuePut(g_report_queue_id, &job, 0, EVENT_PUT_TIMEOUT_MS) != osOK) {
+        g_events_lost++;
+    }
+}
+
+/* The simplified track waits here until the policy sends it, the oldest point gives way when the batch is full. */
+static void REPORT_APP_CollectPoints (void) {
+    sTrackPoint_t point;
+
+    while (GNSS_APP_GetTrackPoint(&point, 0)) {
+        if (g_batch_count == BATCH_CAPACITY) {
+            memmove(&g_batch[0], &g_batch[1], (BATCH_CAPACITY - 1) * sizeof(g_batch[0]));
+            g_batch_count--;
+            g_points_lost++;
+        }
+
+        sTelemetryPoint_t *entry = &g_batch[g_batch_count++];
+        entry->timestamp = point.timestamp;
+        entry->latitude = point.latitude;
+        entry->longitude = point.longitude;
+        entry->speed = point.speed;
+    }
+}
+
+/* Only looked at when the task wakes up for a fix or a deadline anyway. */
+static void REPORT_APP_CheckRadio (void) {
+    uint32_t transmit_tick = 0;
+
+    if ((TCP_APP_GetLastTransmit(&transmit_tick) == false) || (transmit_tick == g_seen_transmit_tick)) {
+        return;
+    }
+
+    g_seen_transmit_tick = transmit_tick;
+
+    if ((transmit_tick - g_upload_tick) > OWN_SEND_WINDOW_MS) {
+        ReportScheduler_OnRadioActivity(&g_scheduler, transmit_tick);
+    }
+}
+
+/* The batch is split into frames of one payload block each. Returns the points handed to the TCP task. */
+static size_t REPORT_APP_Upload (void) {
+    sTelemetryHeader_t header = {0};
+    sNmeaFix_t fix;
+
+    if (GNSS_APP_GetFix(&fix, NULL)) {
+        header.fix_type = fix.fix_type;
+        header.satellites = fix.satellites_used;
+        header.hdop = fix.hdop;
+    }
+
+    size_t sent = 0;
+
+    while (sent < g_batch_count) {
+        char *payload = TCP_APP_AllocPayload(TCP_APP_PAYLOAD_BLOCK_SIZE);
+        if (payload == NULL) {
+            DEBUG_WARN("No payload block for the track upload!\r\n");
+            break;
+        }
+
+        sBuffer_t buffer = {.str = payload, .size = TCP_APP_PAYLOAD_BLOCK_SIZE, .count = 0};
+        sTelemetryEncoder_t encoder;
+        size_t added = 0;
+
+        TelemetryFrame_Begin(&encoder, &buffer, &header, true);
+
+        while (((sent + added) < g_batch_count) && TelemetryFrame_AddPoint(&encoder, &g_batch[sent + added])) {
+            added++;
+        }
+
+        sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+        tcp_job.data.send.connect_id = g_uplink_id;
+        tcp_job.data.send.data_str = payload;
+        tcp_job.data.send.data_size = TelemetryFrame_Finish(&encoder);
+        tcp_job.data.send.persistent = true;
+
+        if (TCP_APP_AddTask(&tcp_job) == false) {
+            break;
+        }
+
+        sent += added;
+        g_frames++;
+    }
+
+    if (sent > 0) {
+        memmove(&g_batch[0], &g_batch[sent], (g_batch_count - sent) * sizeof(g_batch[0]));
+        g_batch_count -= sent;
+        g_points_sent += sent;
+    }
+
+    return sent;
+}
+
+/* One pass over the policy after every event, then the timer is armed for the next deadline. */
+static void REPORT_APP_Run (void) {
+    uint32_t now = osKernelGetTickCount();
+
+    REPORT_APP_CollectPoints();
+    REPORT_APP_CheckRadio();
+
+    if (ReportScheduler_IsFixDue(&g_scheduler, now)) {
+        if (GNSS_APP_RequestFix() == false) {
+            DEBUG_WARN("Failed to request a GNSS fix!\r\n");
+        }
+
+        ReportScheduler_OnFixRequest(&g_scheduler, now);
+    }
+
+    eReportTrigger_t trigger = ReportScheduler_GetUploadTrigger(&g_scheduler, now, g_batch_count);
+
+    if (trigger != eReportTrigger_None) {
+        /* A busy modem keeps the last reading, the signal changes slower than the upload cadence. */
+        int signal = REPORT_SCHEDULER_SIGNAL_UNKNOWN;
+        if (Modem_API_QuerySignalQuality(&signal) == eModemError_ATSuccess) {
+            g_signal = signal;
+        }
+
+        if (ReportScheduler_CheckSignal(&g_scheduler, now, g_batch_count, g_signal)) {
+            REPORT_APP_Upload();
+            g_upload_tick = now;
+            /* Also after a failed attempt, the points stay and the next interval tries again. */
+            ReportScheduler_OnUpload(&g_scheduler, trigger, now);
+        }
+    }
+
+    uint32_t delay_ms = ReportScheduler_GetDelay(&g_scheduler, osKernelGetTickCount(), g_batch_count);
+    if (delay_ms < MIN_TIMER_DELAY_MS) {
+        delay_ms = MIN_TIMER_DELAY_MS;
+    }
+
+    if (osTimerStart(g_report_timer_id, delay_ms) != osOK) {
+        DEBUG_ERROR("Failed to arm the report timer!\r\n");
+    }
+}
+
+static void REPORT_APP_Task (void *args) {
+    sReportJobMessage_t job;
+
+    REPORT_APP_Run();
+
+    while (1) {
+        if (osMessageQueueGet(g_report_queue_id, &job, NULL, osWaitForever) != osOK) {
+            continue;
+        }
+
+        switch (job.type) {
+            case eReportJob_Fix: {
+                ReportScheduler_OnFix(&g_scheduler, job.data.fix.speed, job.data.fix.course, osKernelGetTickCount());
+                break;
+            }
+            case eReportJob_Policy: {
+                ReportScheduler_SetPolicy(&g_scheduler, job.data.policy.motion, &job.data.policy.policy);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+
+        REPORT_APP_Run();
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool REPORT_APP_Init (void) {
+    if (g_report_queue_id == NULL) {
+        ReportScheduler_Init(&g_scheduler, NULL, osKernelGetTickCount());
+
+        g_report_queue_id = osMessageQueueNew(REPORT_QUEUE_SIZE, sizeof(sReportJobMessage_t), &g_report_queue_attr);
+        if (g_report_queue_id == NULL) {
+            DEBUG_ERROR("Failed to create the report queue!\r\n");
+            return false;
+        }
+    }
+
+    if (g_report_timer_id == NULL) {
+        g_report_timer_id = osTimerNew(&REPORT_APP_OnTimer, osTimerOnce, NULL, &g_report_timer_attr);
+        if (g_report_timer_id == NULL) {
+            DEBUG_ERROR("Failed to create the report timer!\r\n");
+            return false;
+        }
+    }
+
+    if (g_report_task_id == NULL) {
+        g_report_task_id = osThreadNew(&REPORT_APP_Task, REPORT_TASK_ARGS, &g_report_task_attr);
+        if (g_report_task_id == NULL) {
+            DEBUG_ERROR("Failed to create the report task!\r\n");
+            return false;
+        }
+    }
+
+    GNSS_APP_SetOnDemand(true);
+
+    return GNSS_APP_AddFixCallback(&REPORT_APP_OnFix);
+}
+
+bool REPORT_APP_SetPolicy (eReportMotion_t motion, const sReportPolicy_t *policy) {
+    if ((policy == NULL) || (g_report_queue_id == NULL) || (motion < eReportMotion_First) || (motion >= eReportMotion_Last)) {
+        return false;
+    }
+
+    sReportJobMessage_t job = {.type = eReportJob_Policy};
+
+    job.data.policy.motion = motion;
+    job.data.policy.policy = *policy;
+
+    if (osMessageQueuePut(g_report_queue_id, &job, 0, POLICY_PUT_TIMEOUT_MS) != osOK) {
+        DEBUG_ERROR("Failed to queue the report policy!\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool REPORT_APP_GetPolicy (eReportMotion_t motion, sReportPolicy_t *policy) {
+    return ReportScheduler_GetPolicy(&g_scheduler, motion, policy);
+}
+
+bool REPORT_APP_SetUplink (eServerId_t connect_id) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return false;
+    }
+
+    g_uplink_id = connect_id;
+
+    return true;
+}
+
+bool REPORT_APP_GetStats (sReportAppStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    ReportScheduler_GetStats(&g_scheduler, osKernelGetTickCount(), &stats->scheduler);
+    stats->motion = ReportScheduler_GetMotion(&g_scheduler);
+    stats->signal = g_signal;
+    stats->pending = g_batch_count;
+    stats->frames = g_frames;
+    stats->points_sent = g_points_sent;
+    stats->points_lost = g_points_lost;
+    stats->events_lost = g_events_lost;
+
+    return true;
+}
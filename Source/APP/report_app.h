@@ -0,0 +1,41 @@
+#ifndef SOURCE_APP_REPORT_APP_H_
+#define SOURCE_APP_REPORT_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "tcp_app.h"
+#include "report_scheduler.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sReportAppStats {
+    sReportSchedulerStats_t scheduler;
+    eReportMotion_t motion;
+    int signal;
+    uint32_t pending;
+    uint32_t frames;
+    uint32_t points_sent;
+    uint32_t points_lost;
+    uint32_t events_lost;
+} sReportAppStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Takes over the GNSS fix cadence, a held fix is refreshed when the policy asks for it */
+bool REPORT_APP_Init (void);
+bool REPORT_APP_SetPolicy (eReportMotion_t motion, const sReportPolicy_t *policy);
+bool REPORT_APP_GetPolicy (eReportMotion_t motion, sReportPolicy_t *policy);
+/* Socket the telemetry frames are sent to, they go through the persistent outbox */
+bool REPORT_APP_SetUplink (eServerId_t connect_id);
+bool REPORT_APP_GetStats (sReportAppStats_t *stats);
+#endif /* SOURCE_APP_REPORT_APP_H_ */
@@ -1,207 +1,1400 @@
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdbool.h>
-#include <stdio.h>
-#include <string.h>
-#include "cmsis_os2.h"
-#include "debug_api.h"
-#include "heap_api.h"
-#include "tcp_api.h"
-#include "tcp_app.h"
-/**********************************************************************************************************************
- * Private definitions and macros
- *********************************************************************************************************************/
-#define MSG_COUNT 55
-#define MSG_SIZE sizeof(sTcpJobMessage_t)
-#define TCP_TASK_MSG_QUEUE_ATTR_NAME "TcpTaskMessage"
-#define MSG_PRIORITY 0
-#define MSG_QUEUE_PUT_TIMEOUT_MS 30
-#define MSG_QUEUE_GET_TIMEOUT_MS 20
-#define AVAILABLE_SOCKET_BUFFER_SIZE 70
-#define SOCKET_ID_SIZE 5
-#define TCP_JOB_HANDLE_TASK_ATTR_NAME "TcpJobHandleTask"
-#define TCP_JOB_HANDLE_TASK_STACK_SIZE 512U
-#define TCP_JOB_HANDLE_TASK_ARGS NULL
-/**********************************************************************************************************************
- * Private typedef
- *********************************************************************************************************************/
- 
-/**********************************************************************************************************************
- * Private constants
- *********************************************************************************************************************/
-CREATE_MODULE_TAG(TCP_APP);
-static const osMessageQueueAttr_t g_tcp_task_msg_queue_attr = {
-    .name = TCP_TASK_MSG_QUEUE_ATTR_NAME
-};
-static const osThreadAttr_t g_tcp_job_handle_task_attr = {
-    .name = TCP_JOB_HANDLE_TASK_ATTR_NAME,
-    .stack_size = TCP_JOB_HANDLE_TASK_STACK_SIZE,
-    .priority = 25
-};
-/**********************************************************************************************************************
- * Private variables
- *********************************************************************************************************************/
-static sSocketProperties_t g_socket [eServerId_Last];
-static osMessageQueueId_t g_tcp_task_msg_queue_id = NULL;
-static osThreadId_t g_tcp_job_handle_task_id = NULL;
-static sTcpConnectJob_t g_tcp_connect;
-static sTcpSendJob_t g_tcp_send;
-static sTcpDisconnectJob_t g_tcp_close;
-/**********************************************************************************************************************
- * Exported variables and references
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of private functions
- *********************************************************************************************************************/
-void TCP_APP_JobHandler (void *args);
-/**********************************************************************************************************************
- * Definitions of private functions
- *********************************************************************************************************************/
-void TCP_APP_JobHandler (void *args) {
-	sTcpJobMessage_t tcp_job;
-
-    while (1) {
-        if (osMessageQueueGet(g_tcp_task_msg_queue_id, &tcp_job, MSG_PRIORITY, MSG_QUEUE_GET_TIMEOUT_MS) != osOK) {
-            osThreadYield();
-            continue;
-        }
-
-        char socket_str[AVAILABLE_SOCKET_BUFFER_SIZE] = {0};
-        size_t count = 0;
-
-        switch (tcp_job.type) {
-            case eTcpJob_Connect: {
-                g_tcp_connect = *((sTcpConnectJob_t *) tcp_job.data);
-                Heap_API_Free(tcp_job.data);
-
-                if (g_socket[g_tcp_connect.connect_id].is_socket_free == false) {
-                    bool free_sockets = true;
-                    TCP_ADD_ReturnFreeSockets(socket_str, count, free_sockets);
-                    DEBUG_INFO("Connection with this socket is currently running. %s\r\n", socket_str);
-                    continue;
-                }
-
-                if (TCP_API_Connect(g_tcp_connect.connect_id, g_tcp_connect.ip_address, g_tcp_connect.port) == eModemError_ATSuccess) {
-                    g_socket[g_tcp_connect.connect_id].is_socket_free = false;
-                }
-
-                continue;
-            }
-            case eTcpJob_Send: {
-                g_tcp_send = *((sTcpSendJob_t*) tcp_job.data);
-                Heap_API_Free(tcp_job.data);
-
-                if (g_socket[g_tcp_connect.connect_id].is_socket_free == true) {
-                    Heap_API_Free(g_tcp_send.data_str);
-                    bool busy_sockets = false;
-                    TCP_ADD_ReturnFreeSockets(socket_str, count, busy_sockets);
-                    DEBUG_INFO("No previous connection was initiated with socket id: %d. %s\r\n", g_tcp_send.connect_id, socket_str);
-                    continue;
-                }
-
-                TCP_API_Send(g_tcp_send.connect_id, g_tcp_send.data_str, g_tcp_send.data_size);
-                continue;
-            }
-            case eTcpJob_Disconnect: {
-                g_tcp_close = *((sTcpDisconnectJob_t*) tcp_job.data);
-                Heap_API_Free(tcp_job.data);
-
-                if (g_socket[g_tcp_connect.connect_id].is_socket_free == true) {
-                    bool busy_sockets = false;
-                    TCP_ADD_ReturnFreeSockets(socket_str, count, busy_sockets);
-                    DEBUG_INFO("No previous connection was initiated with socket id: %d. %s\r\n", g_tcp_send.connect_id, socket_str);
-                    continue;
-                }
-
-                if (TCP_API_Disconnect(g_tcp_close.connect_id) == eModemError_ATSuccess) {
-                    g_socket[g_tcp_close.connect_id].is_socket_free = true;
-                    DEBUG_INFO("Device has disconnect from the server!\r\n");
-                } else {
-                    DEBUG_INFO("Failed to close the connection!\r\n");
-                }
-
-                continue;
-            }
-            default: {
-                DEBUG_WARN("Uknown TCP job type!\r\n");
-                continue;
-            }
-        }
-    }
-}
-/**********************************************************************************************************************
- * Definitions of exported functions
- *********************************************************************************************************************/
-bool TCP_APP_Init (void) {
-    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
-        g_socket[srv_id].is_socket_free = true;
-    }
-
-    if (g_tcp_task_msg_queue_id == NULL) {
-        g_tcp_task_msg_queue_id = osMessageQueueNew(MSG_COUNT, MSG_SIZE, &g_tcp_task_msg_queue_attr);
-        if (g_tcp_task_msg_queue_id == NULL) {
-            DEBUG_ERROR("Failed to create a message queue for TCP tasks!\r\n");
-            return false;
-        }
-    }
-
-    if (g_tcp_job_handle_task_id == NULL) {
-        g_tcp_job_handle_task_id = osThreadNew(TCP_APP_JobHandler, TCP_JOB_HANDLE_TASK_ARGS, &g_tcp_job_handle_task_attr);
-        if (g_tcp_job_handle_task_id == NULL) {
-            DEBUG_ERROR("Failed to create a Thread for tcp job handling!\r\n");
-            return false;
-        }
-    }
-
-    return true;
-}
-
-void TCP_ADD_ReturnFreeSockets(char *sockets, size_t count, bool socket_state) { 
-    int socket_count = 0;
-    if (socket_state) {
-        count += snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "These are the available socket(s): ");
-    } else {
-        count += snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "These are in-use socket(s): ");
-    }
-
-    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
-        if (g_socket[srv_id].is_socket_free == socket_state) {
-            count += snprintf(&sockets[count], AVAILABLE_SOCKET_BUFFER_SIZE, "%d, ", srv_id);
-        } else {
-            socket_count++;
-        }
-    }
-
-    if (count > AVAILABLE_SOCKET_BUFFER_SIZE) {
-        DEBUG_ERROR("Buffer overflow occured, too many characters were written to the socket buffer size!\r\n");
-        return;
-    }
-
-    if (socket_count == eServerId_Last) {
-        if (socket_state) {
-            snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "All sockets are in use!");
-        } else {
-            snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "No sockets are currently in use!");
-        }
-    } else {
-        sockets[count - 2] = '!';
-    }
-
-    return;
-}
-
-bool TCP_APP_AddTask (sTcpJobMessage_t *tcp_job) {
-    if (tcp_job == NULL) {
-        DEBUG_ERROR("TCP task arguments are invalid!\r\n");
-        return false;
-    }
-
-    if (osMessageQueuePut(g_tcp_task_msg_queue_id, tcp_job, MSG_PRIORITY, MSG_QUEUE_PUT_TIMEOUT_MS) != osOK) {
-        DEBUG_ERROR("Failed to queue the TCP task request!\r\n");
-        return false;
-    }
-
-    return true;
-}
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "tcp_api.h"
+#include "tcp_app.h"
+#include "flash_driver.h"
+#include "outbox.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define MSG_COUNT 55
+#define MSG_SIZE sizeof(sTcpJobMessage_t)
+#define TCP_TASK_MSG_QUEUE_ATTR_NAME "TcpTaskMessage"
+#define MSG_PRIORITY 0
+#define MSG_QUEUE_PUT_TIMEOUT_MS 30
+#define AVAILABLE_SOCKET_BUFFER_SIZE 70
+#define SOCKET_ID_SIZE 5
+#define TCP_JOB_HANDLE_TASK_ATTR_NAME "TcpJobHandleTask"
+#define TCP_JOB_HANDLE_TASK_STACK_SIZE 1024U
+#define TCP_JOB_HANDLE_TASK_ARGS NULL
+#define COALESCE_DEFAULT_MAX_BYTES TCP_API_MAX_SEND_SIZE
+#define COALESCE_DEFAULT_MAX_LATENCY_MS 200
+#define TCP_PAYLOAD_POOL_ATTR_NAME "TcpPayloadPool"
+#define TCP_PAYLOAD_POOL_BLOCK_COUNT 24
+#define TCP_PAYLOAD_ALLOC_TIMEOUT_MS 0
+#define SOCKET_EVENT_PUT_TIMEOUT_MS 0
+#define SOCKET_CONNECT_TIMEOUT_MS 30000
+#define SOCKET_RELEASE_RETRY_MS 500
+#define RECONNECT_MIN_DELAY_MS 1000
+#define RECONNECT_MAX_DELAY_MS 60000
+#define RECONNECT_JITTER_DIVIDER 4
+/* Numerical Recipes LCG, only has to differ between sockets */
+#define JITTER_LCG_MULTIPLIER 1664525U
+#define JITTER_LCG_INCREMENT 1013904223U
+#define KEEPALIVE_IDLE_MIN 2
+#define KEEPALIVE_INTERVAL_S 30
+#define KEEPALIVE_PROBE_COUNT 3
+#define RELIABLE_FRAME_MARKER 0xA5
+#define RELIABLE_ACK_MARKER 0xA6
+#define RELIABLE_HEADER_SIZE 3
+#define RELIABLE_SLOT_COUNT 8
+#define RELIABLE_RETRANSMIT_MS 2000
+#define RELIABLE_MAX_ATTEMPTS 5
+#define OUTBOX_RECORD_HEADER_SIZE 1
+/* Set in the connect_id byte of records that are drained ahead of the log */
+#define OUTBOX_URGENT_FLAG 0x80U
+#define OUTBOX_URGENT_MAX_RECORDS 16
+#define OUTBOX_DRAIN_MAX_BATCHES 4
+#define OUTBOX_DRAIN_MAX_SCAN 64
+#define OUTBOX_BATCH_MAX_RECORDS 16
+#define OUTBOX_RETRY_DELAY_MS 1000
+/* The log drain lags behind the sends by a few lines at most */
+#define QUIET_WINDOW_COUNT 4
+#define OUTBOX_SECTOR_COUNT (eFlashDriverSector_Outbox2 - eFlashDriverSector_Outbox0 + 1)
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sSocketTxBuffer {
+    char data[TCP_API_MAX_SEND_SIZE];
+    size_t count;
+    size_t frames;
+    uint32_t first_frame_tick;
+    bool is_quiet;
+} sSocketTxBuffer_t;
+
+typedef struct sQuietWindow {
+    uint32_t start_tick;
+    uint32_t end_tick;
+} sQuietWindow_t;
+
+/* Reliable datagrams are framed as [0xA5, seq_hi, seq_lo, payload...] and acked by the peer with [0xA6, seq_hi, seq_lo]. */
+typedef struct sReliableSlot {
+    bool is_used;
+    eServerId_t connect_id;
+    uint16_t sequence;
+    uint8_t attempts;
+    uint32_t sent_tick;
+    size_t size;
+    char data[RELIABLE_HEADER_SIZE + TCP_APP_PAYLOAD_BLOCK_SIZE];
+} sReliableSlot_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(TCP_APP);
+static const char *g_socket_state_name[eSocketState_Last] = {
+    [eSocketState_Closed]       = "closed",
+    [eSocketState_Connecting]   = "connecting",
+    [eSocketState_Connected]    = "connected",
+    [eSocketState_Closing]      = "closing",
+    [eSocketState_RemoteClosed] = "remote closed",
+    [eSocketState_Reconnecting] = "reconnecting"
+};
+static const osMessageQueueAttr_t g_tcp_task_msg_queue_attr = {
+    .name = TCP_TASK_MSG_QUEUE_ATTR_NAME
+};
+static const osMemoryPoolAttr_t g_tcp_payload_pool_attr = {
+    .name = TCP_PAYLOAD_POOL_ATTR_NAME
+};
+static const osThreadAttr_t g_tcp_job_handle_task_attr = {
+    .name = TCP_JOB_HANDLE_TASK_ATTR_NAME,
+    .stack_size = TCP_JOB_HANDLE_TASK_STACK_SIZE,
+    .priority = 25
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sSocketProperties_t g_socket [eServerId_Last];
+static osMessageQueueId_t g_tcp_task_msg_queue_id = NULL;
+static osThreadId_t g_tcp_job_handle_task_id = NULL;
+static osMemoryPoolId_t g_tcp_payload_pool_id = NULL;
+static sSocketTxBuffer_t g_tx_buffer [eServerId_Last];
+static sTcpSendStats_t g_send_stats [eServerId_Last];
+static size_t g_coalesce_max_bytes = COALESCE_DEFAULT_MAX_BYTES;
+static uint32_t g_coalesce_max_latency_ms = COALESCE_DEFAULT_MAX_LATENCY_MS;
+static bool g_keepalive_configured = false;
+static bool g_context_lost = false;
+static uint32_t g_jitter_seed = 0;
+static sReliableSlot_t g_reliable_slot [RELIABLE_SLOT_COUNT];
+static uint16_t g_reliable_sequence [eServerId_Last];
+static sOutboxFlash_t g_outbox_flash = {0};
+static sOutbox_t g_outbox = {0};
+static bool g_is_outbox_mounted = false;
+static uint32_t g_outbox_retry_tick = 0;
+static bool g_is_outbox_retry_pending = false;
+static bool g_is_outbox_draining = false;
+static bool g_is_outbox_blocked = false;
+static bool g_is_outbox_sweeping = false;
+static sOutboxCursor_t g_outbox_sweep = {0};
+static uint32_t g_outbox_sweep_erases = 0;
+static sOutboxCursor_t g_outbox_batch_records [OUTBOX_BATCH_MAX_RECORDS];
+/* Oldest first, rebuilt from the flags at mount */
+static sOutboxCursor_t g_outbox_urgent [OUTBOX_URGENT_MAX_RECORDS];
+static size_t g_outbox_urgent_count = 0;
+static char g_outbox_record [OUTBOX_RECORD_HEADER_SIZE + TCP_APP_PAYLOAD_BLOCK_SIZE];
+static char g_outbox_batch [TCP_API_MAX_SEND_SIZE];
+static volatile bool g_has_transmitted = false;
+static volatile uint32_t g_transmit_tick = 0;
+/* Written by the TCP task, read by the debug drain through TCP_APP_IsQuietTick() */
+static sQuietWindow_t g_quiet_window [QUIET_WINDOW_COUNT];
+static volatile size_t g_quiet_window_count = 0;
+static volatile size_t g_quiet_window_head = 0;
+static volatile bool g_is_quiet_open = false;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+void TCP_APP_JobHandler (void *args);
+static bool TCP_APP_FlushSocket (eServerId_t connect_id);
+static void TCP_APP_MarkTransmit (void);
+static void TCP_APP_OpenQuiet (void);
+static void TCP_APP_CloseQuiet (void);
+static void TCP_APP_FlushExpired (void);
+static uint32_t TCP_APP_GetWaitTimeout (void);
+static bool TCP_APP_QueueFrame (eServerId_t connect_id, char *data, size_t data_size, bool is_quiet);
+static void TCP_APP_DropBuffered (eServerId_t connect_id);
+static void TCP_APP_DropJob (sTcpJobMessage_t *tcp_job);
+static void TCP_APP_SetState (eServerId_t connect_id, eSocketState_t state);
+static void TCP_APP_StartConnect (eServerId_t connect_id);
+static void TCP_APP_ScheduleReconnect (eServerId_t connect_id);
+static void TCP_APP_ReleaseSocket (eServerId_t connect_id);
+static void TCP_APP_OnLinkLost (eServerId_t connect_id);
+static void TCP_APP_ServiceSockets (void);
+static void TCP_APP_HandleSocketEvent (sTcpSocketEventJob_t *socket_event);
+static void TCP_APP_OnSocketEvent (int socket_id, eModemSocketEvent_t event);
+static bool TCP_APP_SendDatagram (eServerId_t connect_id, char *data, size_t data_size);
+static bool TCP_APP_QueueReliable (eServerId_t connect_id, char *data, size_t data_size);
+static void TCP_APP_ServiceReliable (void);
+static void TCP_APP_ReleaseReliable (eServerId_t connect_id);
+static bool TCP_APP_OutboxRead (size_t sector, size_t offset, void *data, size_t size);
+static bool TCP_APP_OutboxProgram (size_t sector, size_t offset, const void *data, size_t size);
+static bool TCP_APP_OutboxErase (size_t sector);
+static bool TCP_APP_MountOutbox (void);
+static void TCP_APP_AddUrgent (const sOutboxCursor_t *record);
+static bool TCP_APP_StoreFrame (eServerId_t connect_id, char *data, size_t data_size, bool is_urgent);
+static bool TCP_APP_SendUrgent (eServerId_t connect_id, char *data, size_t data_size);
+static bool TCP_APP_DrainUrgent (void);
+static bool TCP_APP_StartSweep (void);
+static void TCP_APP_DrainOutbox (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Any send keeps the radio connected for a while, others can ride along in that window. */
+static void TCP_APP_MarkTransmit (void) {
+    g_transmit_tick = osKernelGetTickCount();
+    g_has_transmitted = true;
+}
+
+/* Everything logged until the window is closed was caused by a quiet send. */
+static void TCP_APP_OpenQuiet (void) {
+    size_t head = (g_quiet_window_count == 0) ? 0 : ((g_quiet_window_head + 1) % QUIET_WINDOW_COUNT);
+    uint32_t now = osKernelGetTickCount();
+
+    g_quiet_window[head].start_tick = now;
+    g_quiet_window[head].end_tick = now;
+    g_quiet_window_head = head;
+
+    if (g_quiet_window_count < QUIET_WINDOW_COUNT) {
+        g_quiet_window_count++;
+    }
+
+    g_is_quiet_open = true;
+}
+
+static void TCP_APP_CloseQuiet (void) {
+    g_quiet_window[g_quiet_window_head].end_tick = osKernelGetTickCount();
+    g_is_quiet_open = false;
+}
+
+static bool TCP_APP_FlushSocket (eServerId_t connect_id) {
+    sSocketTxBuffer_t *tx_buffer = &g_tx_buffer[connect_id];
+
+    if (tx_buffer->count == 0) {
+        return true;
+    }
+
+    if (g_socket[connect_id].state != eSocketState_Connected) {
+        return false;
+    }
+
+    if (tx_buffer->is_quiet == true) {
+        TCP_APP_OpenQuiet();
+    }
+
+    eModemError_t error_type = TCP_API_Send(connect_id, tx_buffer->data, tx_buffer->count);
+
+    if (tx_buffer->is_quiet == true) {
+        TCP_APP_CloseQuiet();
+    }
+
+    bool is_sent = (error_type == eModemError_ATSuccess);
+
+    if (is_sent) {
+        TCP_APP_MarkTransmit();
+        g_send_stats[connect_id].sends++;
+        g_send_stats[connect_id].frames += tx_buffer->frames;
+        g_send_stats[connect_id].bytes += tx_buffer->count;
+        tx_buffer->count = 0;
+        tx_buffer->frames = 0;
+        tx_buffer->is_quiet = false;
+    } else {
+        DEBUG_WARN("Failed to send %u frame(s) to socket %d, dropping them!\r\n", (unsigned) tx_buffer->frames, connect_id);
+        TCP_APP_DropBuffered(connect_id);
+    }
+
+    if (error_type == eModemError_SendFail) {
+        TCP_APP_OnLinkLost(connect_id);
+    }
+
+    return is_sent;
+}
+
+static void TCP_APP_FlushExpired (void) {
+    uint32_t now = osKernelGetTickCount();
+
+    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+        if ((g_tx_buffer[srv_id].count == 0) || (g_socket[srv_id].state != eSocketState_Connected)) {
+            continue;
+        }
+
+        if ((now - g_tx_buffer[srv_id].first_frame_tick) >= g_coalesce_max_latency_ms) {
+            TCP_APP_FlushSocket(srv_id);
+        }
+    }
+}
+
+static uint32_t TCP_APP_GetWaitTimeout (void) {
+    uint32_t timeout = osWaitForever;
+    uint32_t now = osKernelGetTickCount();
+
+    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+        uint32_t deadline_tick = 0;
+        uint32_t period_ms = 0;
+
+        switch (g_socket[srv_id].state) {
+            case eSocketState_Connected: {
+                if (g_tx_buffer[srv_id].count == 0) {
+                    continue;
+                }
+
+                deadline_tick = g_tx_buffer[srv_id].first_frame_tick;
+                period_ms = g_coalesce_max_latency_ms;
+                break;
+            }
+            case eSocketState_Connecting: {
+                deadline_tick = g_socket[srv_id].state_tick;
+                period_ms = SOCKET_CONNECT_TIMEOUT_MS;
+                break;
+            }
+            case eSocketState_Closing:
+            case eSocketState_RemoteClosed: {
+                deadline_tick = g_socket[srv_id].state_tick;
+                period_ms = SOCKET_RELEASE_RETRY_MS;
+                break;
+            }
+            case eSocketState_Reconnecting: {
+                deadline_tick = g_socket[srv_id].state_tick;
+                period_ms = g_socket[srv_id].retry_delay_ms;
+                break;
+            }
+            default: {
+                continue;
+            }
+        }
+
+        uint32_t elapsed = now - deadline_tick;
+        uint32_t remaining = (elapsed >= period_ms) ? 0 : (period_ms - elapsed);
+
+        if (remaining < timeout) {
+            timeout = remaining;
+        }
+    }
+
+    for (size_t slot = 0; slot < RELIABLE_SLOT_COUNT; slot++) {
+        sReliableSlot_t *reliable = &g_reliable_slot[slot];
+
+        if ((reliable->is_used == false) || (g_socket[reliable->connect_id].state != eSocketState_Connected)) {
+            continue;
+        }
+
+        uint32_t elapsed = now - reliable->sent_tick;
+        uint32_t remaining = ((reliable->attempts == 0) || (elapsed >= RELIABLE_RETRANSMIT_MS)) ? 0 : (RELIABLE_RETRANSMIT_MS - elapsed);
+
+        if (remaining < timeout) {
+            timeout = remaining;
+        }
+    }
+
+    /* A drain that ran out of batches goes on right after the queue, a failed one after the retry delay */
+    if (g_is_outbox_retry_pending == true) {
+        uint32_t elapsed = now - g_outbox_retry_tick;
+        uint32_t remaining = (elapsed >= OUTBOX_RETRY_DELAY_MS) ? 0 : (OUTBOX_RETRY_DELAY_MS - elapsed);
+
+        if (remaining < timeout) {
+            timeout = remaining;
+        }
+    } else if (g_is_outbox_draining == true) {
+        timeout = 0;
+    }
+
+    return timeout;
+}
+
+static bool TCP_APP_QueueFrame (eServerId_t connect_id, char *data, size_t data_size, bool is_quiet) {
+    sSocketTxBuffer_t *tx_buffer = &g_tx_buffer[connect_id];
+
+    if ((data_size == 0) || (data_size > g_coalesce_max_bytes)) {
+        DEBUG_WARN("Frame of %u bytes does not fit into a single send!\r\n", (unsigned) data_size);
+        return false;
+    }
+
+    if ((tx_buffer->count + data_size) > g_coalesce_max_bytes) {
+        TCP_APP_FlushSocket(connect_id);
+    }
+
+    if ((tx_buffer->count + data_size) > g_coalesce_max_bytes) {
+        DEBUG_WARN("Socket %d is not connected, dropping %u buffered frame(s)!\r\n", connect_id, (unsigned) tx_buffer->frames);
+        TCP_APP_DropBuffered(connect_id);
+    }
+
+    if (tx_buffer->count == 0) {
+        tx_buffer->first_frame_tick = osKernelGetTickCount();
+    }
+
+    memcpy(&tx_buffer->data[tx_buffer->count], data, data_size);
+    tx_buffer->count += data_size;
+    tx_buffer->frames++;
+    tx_buffer->is_quiet |= is_quiet;
+
+    if ((tx_buffer->count >= g_coalesce_max_bytes) || (g_coalesce_max_latency_ms == 0)) {
+        return TCP_APP_FlushSocket(connect_id);
+    }
+
+    return true;
+}
+
+/* Only live frames are coalesced, persistent ones are already in the outbox, so dropped frames are lost for good */
+static void TCP_APP_DropBuffered (eServerId_t connect_id) {
+    g_send_stats[connect_id].lost += g_tx_buffer[connect_id].frames;
+    g_tx_buffer[connect_id].count = 0;
+    g_tx_buffer[connect_id].frames = 0;
+    g_tx_buffer[connect_id].is_quiet = false;
+}
+
+static void TCP_APP_DropJob (sTcpJobMessage_t *tcp_job) {
+    if (tcp_job->type == eTcpJob_Send) {
+        TCP_APP_FreePayload(tcp_job->data.send.data_str);
+        tcp_job->data.send.data_str = NULL;
+    }
+}
+
+static void TCP_APP_SetState (eServerId_t connect_id, eSocketState_t state) {
+    sSocketProperties_t *socket = &g_socket[connect_id];
+
+    if (socket->state != state) {
+        DEBUG_INFO("Socket %d: %s -> %s\r\n", connect_id, g_socket_state_name[socket->state], g_socket_state_name[state]);
+    }
+
+    socket->state = state;
+    socket->state_tick = osKernelGetTickCount();
+
+    if (state == eSocketState_Closed) {
+        TCP_APP_DropBuffered(connect_id);
+        TCP_APP_ReleaseReliable(connect_id);
+    }
+
+    /* Records stepped over for this socket are sendable now */
+    if (state == eSocketState_Connected) {
+        g_is_outbox_blocked = false;
+        g_is_outbox_sweeping = false;
+    }
+}
+
+static void TCP_APP_StartConnect (eServerId_t connect_id) {
+    sSocketProperties_t *socket = &g_socket[connect_id];
+
+    if (g_context_lost == true) {
+        if (TCP_API_ReactivateContext() != eModemError_ATSuccess) {
+            DEBUG_WARN("Failed to reactivate the PDP context!\r\n");
+            TCP_APP_ScheduleReconnect(connect_id);
+            return;
+        }
+
+        g_context_lost = false;
+    }
+
+    if ((socket->service == eSocketService_Tcp) && (g_keepalive_configured == false)) {
+        g_keepalive_configured = (TCP_API_SetKeepalive(KEEPALIVE_IDLE_MIN, KEEPALIVE_INTERVAL_S, KEEPALIVE_PROBE_COUNT) == eModemError_ATSuccess);
+
+        if (g_keepalive_configured == false) {
+            DEBUG_WARN("Failed to enable TCP keepalive, will retry on the next connect!\r\n");
+        }
+    }
+
+    if (TCP_API_Connect(connect_id, socket->service, socket->ip_address, socket->port) != eModemError_ATSuccess) {
+        TCP_APP_ScheduleReconnect(connect_id);
+        return;
+    }
+
+    TCP_APP_SetState(connect_id, eSocketState_Connecting);
+}
+
+static void TCP_APP_ScheduleReconnect (eServerId_t connect_id) {
+    sSocketProperties_t *socket = &g_socket[connect_id];
+
+    if (socket->auto_reconnect == false) {
+        TCP_APP_SetState(connect_id, eSocketState_Closed);
+        return;
+    }
+
+    /* Jitter keeps sockets that dropped together from reconnecting in lockstep. Sockets released in one pass see
+     * the same tick, so the tick only seeds a generator that moves on with every socket. */
+    g_jitter_seed = (g_jitter_seed * JITTER_LCG_MULTIPLIER) + JITTER_LCG_INCREMENT + osKernelGetTickCount();
+    uint32_t jitter = (g_jitter_seed >> 16) % ((socket->backoff_ms / RECONNECT_JITTER_DIVIDER) + 1);
+    socket->retry_delay_ms = socket->backoff_ms + jitter;
+    socket->backoff_ms = (socket->backoff_ms >= (RECONNECT_MAX_DELAY_MS / 2)) ? RECONNECT_MAX_DELAY_MS : (socket->backoff_ms * 2);
+
+    DEBUG_INFO("Reconnecting socket %d in %lu ms\r\n", connect_id, (unsigned long) socket->retry_delay_ms);
+    TCP_APP_SetState(connect_id, eSocketState_Reconnecting);
+}
+
+static void TCP_APP_ReleaseSocket (eServerId_t connect_id) {
+    if (TCP_API_Disconnect(connect_id) != eModemError_ATSuccess) {
+        DEBUG_WARN("Failed to release socket %d, retrying!\r\n", connect_id);
+        g_socket[connect_id].state_tick = osKernelGetTickCount();
+        return;
+    }
+
+    if (g_socket[connect_id].auto_reconnect == false) {
+        DEBUG_INFO("Device has disconnect from the server!\r\n");
+    }
+
+    TCP_APP_ScheduleReconnect(connect_id);
+}
+
+static void TCP_APP_OnLinkLost (eServerId_t connect_id) {
+    eSocketState_t state = g_socket[connect_id].state;
+
+    if ((state != eSocketState_Connected) && (state != eSocketState_Connecting)) {
+        return;
+    }
+
+    TCP_APP_SetState(connect_id, eSocketState_RemoteClosed);
+    TCP_APP_ReleaseSocket(connect_id);
+}
+
+static void TCP_APP_ServiceSockets (void) {
+    uint32_t now = osKernelGetTickCount();
+
+    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+        sSocketProperties_t *socket = &g_socket[srv_id];
+        uint32_t elapsed = now - socket->state_tick;
+
+        switch (socket->state) {
+            case eSocketState_Connecting: {
+                if (elapsed >= SOCKET_CONNECT_TIMEOUT_MS) {
+                    DEBUG_WARN("Connection on socket %d timed out!\r\n", srv_id);
+                    TCP_APP_SetState(srv_id, eSocketState_Closing);
+                    TCP_APP_ReleaseSocket(srv_id);
+                }
+                break;
+            }
+            case eSocketState_Closing:
+            case eSocketState_RemoteClosed: {
+                if (elapsed >= SOCKET_RELEASE_RETRY_MS) {
+                    TCP_APP_ReleaseSocket(srv_id);
+                }
+                break;
+            }
+            case eSocketState_Reconnecting: {
+                if (elapsed >= socket->retry_delay_ms) {
+                    socket->reconnects++;
+                    TCP_APP_StartConnect(srv_id);
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+static void TCP_APP_HandleSocketEvent (sTcpSocketEventJob_t *socket_event) {
+    if (socket_event->event == eModemSocketEvent_ContextDeactivated) {
+        g_context_lost = true;
+
+        for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+            TCP_APP_OnLinkLost(srv_id);
+        }
+
+        return;
+    }
+
+    if ((socket_event->connect_id < eServerId_First) || (socket_event->connect_id >= eServerId_Last)) {
+        DEBUG_WARN("Event for unknown socket %d!\r\n", socket_event->connect_id);
+        return;
+    }
+
+    eServerId_t connect_id = (eServerId_t) socket_event->connect_id;
+
+    switch (socket_event->event) {
+        case eModemSocketEvent_Opened: {
+            if (g_socket[connect_id].state != eSocketState_Connecting) {
+                DEBUG_WARN("Socket %d opened while %s!\r\n", connect_id, g_socket_state_name[g_socket[connect_id].state]);
+                break;
+            }
+
+            g_socket[connect_id].backoff_ms = RECONNECT_MIN_DELAY_MS;
+            TCP_APP_SetState(connect_id, eSocketState_Connected);
+            break;
+        }
+        case eModemSocketEvent_OpenFailed: {
+            if (g_socket[connect_id].state != eSocketState_Connecting) {
+                break;
+            }
+
+            TCP_APP_SetState(connect_id, eSocketState_Closing);
+            TCP_APP_ReleaseSocket(connect_id);
+            break;
+        }
+        case eModemSocketEvent_Closed: {
+            TCP_APP_OnLinkLost(connect_id);
+            break;
+        }
+        case eModemSocketEvent_DataReceived: {
+            tcp_api_recv_callback_t filter = (g_socket[connect_id].service != eSocketService_Tcp) ? &TCP_APP_HandleReliableAck : NULL;
+
+            if (TCP_API_ReadSocket(connect_id, filter) != eModemError_ATSuccess) {
+                DEBUG_WARN("Failed to read pending data of socket %d!\r\n", connect_id);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void TCP_APP_OnSocketEvent (int socket_id, eModemSocketEvent_t event) {
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_SocketEvent};
+    tcp_job.data.socket_event.connect_id = socket_id;
+    tcp_job.data.socket_event.event = event;
+
+    if (osMessageQueuePut(g_tcp_task_msg_queue_id, &tcp_job, MSG_PRIORITY, SOCKET_EVENT_PUT_TIMEOUT_MS) != osOK) {
+        DEBUG_ERROR("Failed to queue socket %d event!\r\n", socket_id);
+    }
+}
+
+static bool TCP_APP_SendDatagram (eServerId_t connect_id, char *data, size_t data_size) {
+    sSocketProperties_t *socket = &g_socket[connect_id];
+
+    if (socket->state != eSocketState_Connected) {
+        return false;
+    }
+
+    eModemError_t error_type = eModemError_ATSuccess;
+    if (socket->service == eSocketService_UdpService) {
+        error_type = TCP_API_SendTo(connect_id, socket->ip_address, socket->port, data, data_size);
+    } else {
+        error_type = TCP_API_Send(connect_id, data, data_size);
+    }
+
+    if (error_type != eModemError_ATSuccess) {
+        DEBUG_WARN("Failed to send a datagram of %u bytes on socket %d!\r\n", (unsigned) data_size, connect_id);
+
+        if (error_type == eModemError_SendFail) {
+            TCP_APP_OnLinkLost(connect_id);
+        }
+
+        return false;
+    }
+
+    TCP_APP_MarkTransmit();
+    g_send_stats[connect_id].sends++;
+    g_send_stats[connect_id].frames++;
+    g_send_stats[connect_id].bytes += data_size;
+
+    return true;
+}
+
+static bool TCP_APP_QueueReliable (eServerId_t connect_id, char *data, size_t data_size) {
+    if ((data_size == 0) || (data_size > TCP_APP_PAYLOAD_BLOCK_SIZE)) {
+        DEBUG_WARN("Reliable datagram of %u bytes is too large!\r\n", (unsigned) data_size);
+        return false;
+    }
+
+    for (size_t slot = 0; slot < RELIABLE_SLOT_COUNT; slot++) {
+        sReliableSlot_t *reliable = &g_reliable_slot[slot];
+
+        if (reliable->is_used == true) {
+            continue;
+        }
+
+        uint16_t sequence = g_reliable_sequence[connect_id]++;
+
+        reliable->connect_id = connect_id;
+        reliable->sequence = sequence;
+        reliable->attempts = 0;
+        reliable->size = data_size + RELIABLE_HEADER_SIZE;
+        reliable->data[0] = (char) RELIABLE_FRAME_MARKER;
+        reliable->data[1] = (char) (sequence >> 8);
+        reliable->data[2] = (char) (sequence & 0xFF);
+        memcpy(&reliable->data[RELIABLE_HEADER_SIZE], data, data_size);
+        reliable->is_used = true;
+
+        return true;
+    }
+
+    DEBUG_WARN("No free retransmit slot for socket %d!\r\n", connect_id);
+
+    return false;
+}
+
+static void TCP_APP_ServiceReliable (void) {
+    uint32_t now = osKernelGetTickCount();
+
+    for (size_t slot = 0; slot < RELIABLE_SLOT_COUNT; slot++) {
+        sReliableSlot_t *reliable = &g_reliable_slot[slot];
+
+        if ((reliable->is_used == false) || (g_socket[reliable->connect_id].state != eSocketState_Connected)) {
+            continue;
+        }
+
+        if ((reliable->attempts != 0) && ((now - reliable->sent_tick) < RELIABLE_RETRANSMIT_MS)) {
+            continue;
+        }
+
+        if (reliable->attempts >= RELIABLE_MAX_ATTEMPTS) {
+            DEBUG_WARN("Datagram %u on socket %d was never acked, dropping it!\r\n", reliable->sequence, reliable->connect_id);
+            g_send_stats[reliable->connect_id].lost++;
+            reliable->is_used = false;
+            continue;
+        }
+
+        if (reliable->attempts != 0) {
+            g_send_stats[reliable->connect_id].retransmits++;
+        }
+
+        reliable->attempts++;
+        reliable->sent_tick = now;
+        TCP_APP_SendDatagram(reliable->connect_id, reliable->data, reliable->size);
+    }
+}
+
+static void TCP_APP_ReleaseReliable (eServerId_t connect_id) {
+    for (size_t slot = 0; slot < RELIABLE_SLOT_COUNT; slot++) {
+        if ((g_reliable_slot[slot].is_used == true) && (g_reliable_slot[slot].connect_id == connect_id)) {
+            g_reliable_slot[slot].is_used = false;
+            g_send_stats[connect_id].lost++;
+        }
+    }
+}
+
+static bool TCP_APP_OutboxRead (size_t sector, size_t offset, void *data, size_t size) {
+    return Flash_Driver_Read((eFlashDriverSector_t) (eFlashDriverSector_Outbox0 + sector), offset, data, size);
+}
+
+static bool TCP_APP_OutboxProgram (size_t sector, size_t offset, const void *data, size_t size) {
+    return Flash_Driver_Program((eFlashDriverSector_t) (eFlashDriverSector_Outbox0 + sector), offset, data, size);
+}
+
+static bool TCP_APP_OutboxErase (size_t sector) {
+    return Flash_Driver_Erase((eFlashDriverSector_t) (eFlashDriverSector_Outbox0 + sector));
+}
+
+static bool TCP_APP_MountOutbox (void) {
+    g_outbox_flash.sector_count = OUTBOX_SECTOR_COUNT;
+    g_outbox_flash.sector_size = Flash_Driver_GetSectorSize(eFlashDriverSector_Outbox0);
+    g_outbox_flash.read = &TCP_APP_OutboxRead;
+    g_outbox_flash.program = &TCP_APP_OutboxProgram;
+    g_outbox_flash.erase = &TCP_APP_OutboxErase;
+
+    if (Outbox_Mount(&g_outbox, &g_outbox_flash) == false) {
+        return false;
+    }
+
+    if (Outbox_GetPending(&g_outbox) > 0) {
+        DEBUG_INFO("Outbox holds %lu undelivered record(s)\r\n", (unsigned long) Outbox_GetPending(&g_outbox));
+    }
+
+    sOutboxCursor_t cursor;
+    g_outbox_urgent_count = 0;
+
+    if (Outbox_GetReadCursor(&g_outbox, &cursor) == false) {
+        return true;
+    }
+
+    while (Outbox_Read(&g_outbox, &cursor, g_outbox_record, sizeof(g_outbox_record)) > OUTBOX_RECORD_HEADER_SIZE) {
+        if (((uint8_t) g_outbox_record[0] & OUTBOX_URGENT_FLAG) != 0) {
+            sOutboxCursor_t record = cursor;
+
+            record.offset = record.record_offset;
+            TCP_APP_AddUrgent(&record);
+        }
+    }
+
+    return true;
+}
+
+/* Past the list size urgent records wait for the sweep like any other */
+static void TCP_APP_AddUrgent (const sOutboxCursor_t *record) {
+    if (g_outbox_urgent_count >= OUTBOX_URGENT_MAX_RECORDS) {
+        DEBUG_WARN("Urgent record %lu waits for its turn in the outbox!\r\n", (unsigned long) record->sequence);
+        return;
+    }
+
+    g_outbox_urgent[g_outbox_urgent_count++] = *record;
+}
+
+/* Outbox records are [connect_id, payload...], they are delivered to the same socket once it is connected. */
+static bool TCP_APP_StoreFrame (eServerId_t connect_id, char *data, size_t data_size, bool is_urgent) {
+    if (g_is_outbox_mounted == false) {
+        DEBUG_WARN("Outbox is not available, dropping a frame for socket %d!\r\n", connect_id);
+        return false;
+    }
+
+    if ((data_size == 0) || (data_size > TCP_APP_PAYLOAD_BLOCK_SIZE)) {
+        DEBUG_WARN("Frame of %u bytes does not fit into an outbox record!\r\n", (unsigned) data_size);
+        return false;
+    }
+
+    sOutboxCursor_t record;
+
+    g_outbox_record[0] = (char) (is_urgent ? ((uint8_t) connect_id | OUTBOX_URGENT_FLAG) : (uint8_t) connect_id);
+    memcpy(&g_outbox_record[OUTBOX_RECORD_HEADER_SIZE], data, data_size);
+
+    if (Outbox_Append(&g_outbox, g_outbox_record, OUTBOX_RECORD_HEADER_SIZE + data_size, &record) == false) {
+        DEBUG_ERROR("Failed to append a frame for socket %d to the outbox!\r\n", connect_id);
+        return false;
+    }
+
+    if (is_urgent == true) {
+        TCP_APP_AddUrgent(&record);
+    }
+
+    g_is_outbox_blocked = false;
+
+    return true;
+}
+
+/* Sent at once, frames coalesced for the socket so far ride along in the same send */
+static bool TCP_APP_SendUrgent (eServerId_t connect_id, char *data, size_t data_size) {
+    if (g_socket[connect_id].state != eSocketState_Connected) {
+        return false;
+    }
+
+    if (g_socket[connect_id].service != eSocketService_Tcp) {
+        return TCP_APP_SendDatagram(connect_id, data, data_size);
+    }
+
+    /* Sent on its own after whatever is buffered, so a failure leaves only the urgent frame to the outbox */
+    return TCP_APP_FlushSocket(connect_id) && TCP_APP_SendDatagram(connect_id, data, data_size);
+}
+
+/* Urgent records go out one by one ahead of the log. A cursor whose record was delivered by the sweep or lost to a
+ * recycled sector reads another sequence and is dropped. Returns false if a send failed. */
+static bool TCP_APP_DrainUrgent (void) {
+    size_t kept = 0;
+    bool is_delivered = false;
+    bool is_failed = false;
+
+    for (size_t i = 0; i < g_outbox_urgent_count; i++) {
+        sOutboxCursor_t cursor = g_outbox_urgent[i];
+
+        if (is_failed == true) {
+            g_outbox_urgent[kept++] = g_outbox_urgent[i];
+            continue;
+        }
+
+        size_t record_size = Outbox_Read(&g_outbox, &cursor, g_outbox_record, sizeof(g_outbox_record));
+
+        if ((record_size <= OUTBOX_RECORD_HEADER_SIZE) || (cursor.sequence != g_outbox_urgent[i].sequence)) {
+            continue;
+        }
+
+        eServerId_t connect_id = (eServerId_t) ((uint8_t) g_outbox_record[0] & ~OUTBOX_URGENT_FLAG);
+
+        if (connect_id >= eServerId_Last) {
+            continue;
+        }
+
+        if (g_socket[connect_id].state != eSocketState_Connected) {
+            g_outbox_urgent[kept++] = g_outbox_urgent[i];
+            continue;
+        }
+
+        if (TCP_APP_SendUrgent(connect_id, &g_outbox_record[OUTBOX_RECORD_HEADER_SIZE],
+                               record_size - OUTBOX_RECORD_HEADER_SIZE) == false) {
+            g_outbox_urgent[kept++] = g_outbox_urgent[i];
+            is_failed = true;
+            continue;
+        }
+
+        if (Outbox_MarkDelivered(&g_outbox, &cursor) == false) {
+            DEBUG_WARN("Failed to mark outbox record %lu as delivered!\r\n", (unsigned long) cursor.sequence);
+        }
+
+        is_delivered = true;
+    }
+
+    g_outbox_urgent_count = kept;
+
+    if ((is_delivered == true) && (Outbox_CommitDelivered(&g_outbox) == false)) {
+        DEBUG_ERROR("Failed to commit the outbox read cursor!\r\n");
+    }
+
+    return (is_failed == false);
+}
+
+/* A sweep walks the log from the oldest pending record, recycling a sector moves records under it so it starts over */
+static bool TCP_APP_StartSweep (void) {
+    sOutboxStats_t stats;
+
+    if ((Outbox_GetReadCursor(&g_outbox, &g_outbox_sweep) == false) || (Outbox_GetStats(&g_outbox, &stats) == false)) {
+        return false;
+    }
+
+    g_outbox_sweep_erases = stats.erases;
+    g_is_outbox_sweeping = true;
+
+    return true;
+}
+
+/* Records of sockets that are down are stepped over and stay pending, the others are marked delivered out of order. */
+static void TCP_APP_DrainOutbox (void) {
+    g_is_outbox_draining = false;
+
+    if ((g_is_outbox_mounted == false) || (g_is_outbox_blocked == true) || (Outbox_GetPending(&g_outbox) == 0)) {
+        return;
+    }
+
+    if ((g_is_outbox_retry_pending == true) && ((osKernelGetTickCount() - g_outbox_retry_tick) < OUTBOX_RETRY_DELAY_MS)) {
+        return;
+    }
+
+    g_is_outbox_retry_pending = false;
+
+    if (TCP_APP_DrainUrgent() == false) {
+        g_is_outbox_retry_pending = true;
+        g_outbox_retry_tick = osKernelGetTickCount();
+        return;
+    }
+
+    size_t scanned = 0;
+
+    for (size_t batch = 0; batch < OUTBOX_DRAIN_MAX_BATCHES; batch++) {
+        sOutboxStats_t stats;
+
+        if ((Outbox_GetStats(&g_outbox, &stats) == false) || (stats.erases != g_outbox_sweep_erases)) {
+            g_is_outbox_sweeping = false;
+        }
+
+        if ((g_is_outbox_sweeping == false) && (TCP_APP_StartSweep() == false)) {
+            return;
+        }
+
+        sOutboxCursor_t read_cursor;
+        if (Outbox_GetReadCursor(&g_outbox, &read_cursor) == false) {
+            return;
+        }
+
+        sOutboxCursor_t cursor = g_outbox_sweep;
+        sOutboxCursor_t batch_start = cursor;
+        eServerId_t batch_id = eServerId_Last;
+        size_t batch_size = 0;
+        size_t batch_records = 0;
+        bool is_end = false;
+
+        /* Oldest first: consecutive records for one socket are packed into a single send. */
+        while (batch_records < OUTBOX_BATCH_MAX_RECORDS) {
+            sOutboxCursor_t next_cursor = cursor;
+            size_t record_size = Outbox_Read(&g_outbox, &next_cursor, g_outbox_record, sizeof(g_outbox_record));
+
+            if (record_size <= OUTBOX_RECORD_HEADER_SIZE) {
+                is_end = true;
+                break;
+            }
+
+            eServerId_t connect_id = (eServerId_t) ((uint8_t) g_outbox_record[0] & ~OUTBOX_URGENT_FLAG);
+            size_t payload_size = record_size - OUTBOX_RECORD_HEADER_SIZE;
+
+            if (connect_id >= eServerId_Last) {
+                Outbox_MarkDelivered(&g_outbox, &next_cursor);
+                cursor = next_cursor;
+
+                if (batch_id == eServerId_Last) {
+                    batch_start = cursor;
+                }
+
+                continue;
+            }
+
+            if (batch_id == eServerId_Last) {
+                if (g_socket[connect_id].state != eSocketState_Connected) {
+                    cursor = next_cursor;
+                    batch_start = cursor;
+
+                    if (++scanned >= OUTBOX_DRAIN_MAX_SCAN) {
+                        break;
+                    }
+
+                    continue;
+                }
+
+                batch_id = connect_id;
+            } else if ((connect_id != batch_id) || ((batch_size + payload_size) > g_coalesce_max_bytes) ||
+                       (g_socket[batch_id].service != eSocketService_Tcp)) {
+                break;
+            }
+
+            memcpy(&g_outbox_batch[batch_size], &g_outbox_record[OUTBOX_RECORD_HEADER_SIZE], payload_size);
+            batch_size += payload_size;
+            g_outbox_batch_records[batch_records++] = next_cursor;
+            cursor = next_cursor;
+        }
+
+        g_outbox_sweep = cursor;
+
+        if (batch_size == 0) {
+            /* Nothing left that a connected socket could take, wait for a connect or a new record */
+            if (is_end == true) {
+                g_is_outbox_sweeping = false;
+                g_is_outbox_blocked = true;
+                Outbox_CommitDelivered(&g_outbox);
+            } else {
+                g_is_outbox_draining = true;
+            }
+
+            return;
+        }
+
+        bool is_sent = false;
+        if (g_socket[batch_id].service == eSocketService_Tcp) {
+            eModemError_t error_type = TCP_API_Send(batch_id, g_outbox_batch, batch_size);
+            is_sent = (error_type == eModemError_ATSuccess);
+
+            if (is_sent) {
+                TCP_APP_MarkTransmit();
+                g_send_stats[batch_id].sends++;
+                g_send_stats[batch_id].frames += batch_records;
+                g_send_stats[batch_id].bytes += batch_size;
+            } else if (error_type == eModemError_SendFail) {
+                TCP_APP_OnLinkLost(batch_id);
+            }
+        } else {
+            is_sent = TCP_APP_SendDatagram(batch_id, g_outbox_batch, batch_size);
+        }
+
+        if (is_sent == false) {
+            g_outbox_sweep = batch_start;
+            g_is_outbox_retry_pending = true;
+            g_outbox_retry_tick = osKernelGetTickCount();
+            return;
+        }
+
+        /* A batch at the head of the log is committed in one record, one behind skipped records is marked per record */
+        if ((batch_start.sector == read_cursor.sector) && (batch_start.offset == read_cursor.offset)) {
+            if (Outbox_Commit(&g_outbox, &cursor) == false) {
+                DEBUG_ERROR("Failed to commit the outbox read cursor!\r\n");
+                return;
+            }
+        } else {
+            for (size_t i = 0; i < batch_records; i++) {
+                if (Outbox_MarkDelivered(&g_outbox, &g_outbox_batch_records[i]) == false) {
+                    DEBUG_WARN("Failed to mark outbox record %lu as delivered!\r\n", (unsigned long) g_outbox_batch_records[i].sequence);
+                }
+            }
+        }
+
+        if (Outbox_CommitDelivered(&g_outbox) == false) {
+            DEBUG_ERROR("Failed to commit the outbox read cursor!\r\n");
+            return;
+        }
+    }
+
+    g_is_outbox_draining = true;
+}
+
+void TCP_APP_JobHandler (void *args) {
+	sTcpJobMessage_t tcp_job;
+
+    while (1) {
+        TCP_APP_FlushExpired();
+        TCP_APP_ServiceSockets();
+        TCP_APP_ServiceReliable();
+        TCP_APP_DrainOutbox();
+
+        if (osMessageQueueGet(g_tcp_task_msg_queue_id, &tcp_job, MSG_PRIORITY, TCP_APP_GetWaitTimeout()) != osOK) {
+            continue;
+        }
+
+        char socket_str[AVAILABLE_SOCKET_BUFFER_SIZE] = {0};
+        size_t count = 0;
+
+        switch (tcp_job.type) {
+            case eTcpJob_Connect: {
+                sTcpConnectJob_t *connect_job = &tcp_job.data.connect;
+                sSocketProperties_t *socket = &g_socket[connect_job->connect_id];
+
+                if (socket->state != eSocketState_Closed) {
+                    bool free_sockets = true;
+                    TCP_ADD_ReturnFreeSockets(socket_str, count, free_sockets);
+                    DEBUG_INFO("Connection with this socket is currently running. %s\r\n", socket_str);
+                    continue;
+                }
+
+                snprintf(socket->ip_address, sizeof(socket->ip_address), "%s", connect_job->ip_address);
+                socket->port = connect_job->port;
+                socket->service = connect_job->service;
+                socket->auto_reconnect = true;
+                socket->backoff_ms = RECONNECT_MIN_DELAY_MS;
+                TCP_API_FlushRecv(connect_job->connect_id);
+                TCP_APP_StartConnect(connect_job->connect_id);
+                continue;
+            }
+            case eTcpJob_Send: {
+                sTcpSendJob_t *send_job = &tcp_job.data.send;
+                eSocketState_t state = g_socket[send_job->connect_id].state;
+
+                if (send_job->persistent == true) {
+                    /* Urgent frames only wait in the outbox while they cannot go out live */
+                    if ((send_job->urgent == true) &&
+                        TCP_APP_SendUrgent(send_job->connect_id, send_job->data_str, send_job->data_size)) {
+                        TCP_APP_DropJob(&tcp_job);
+                        continue;
+                    }
+
+                    if (TCP_APP_StoreFrame(send_job->connect_id, send_job->data_str, send_job->data_size,
+                                           send_job->urgent) == true) {
+                        TCP_APP_DropJob(&tcp_job);
+                        continue;
+                    }
+
+                    DEBUG_WARN("Outbox refused a frame for socket %d, sending it live!\r\n", send_job->connect_id);
+                }
+
+                if ((state == eSocketState_Closed) || (state == eSocketState_Closing)) {
+                    if (send_job->persistent == true) {
+                        DEBUG_WARN("Dropped a persistent frame for socket %d!\r\n", send_job->connect_id);
+                        g_send_stats[send_job->connect_id].lost++;
+                    }
+
+                    TCP_APP_DropJob(&tcp_job);
+                    bool busy_sockets = false;
+                    TCP_ADD_ReturnFreeSockets(socket_str, count, busy_sockets);
+                    DEBUG_INFO("No previous connection was initiated with socket id: %d. %s\r\n", send_job->connect_id, socket_str);
+                    continue;
+                }
+
+                /* TCP retransmits by itself, and its acks would arrive coalesced with the rest of the stream */
+                bool is_datagram = (g_socket[send_job->connect_id].service != eSocketService_Tcp);
+
+                if ((send_job->reliable == true) && (is_datagram == true)) {
+                    if (TCP_APP_QueueReliable(send_job->connect_id, send_job->data_str, send_job->data_size) == false) {
+                        DEBUG_WARN("Dropped a reliable datagram for socket %d!\r\n", send_job->connect_id);
+                        g_send_stats[send_job->connect_id].lost++;
+                    }
+                } else if (is_datagram == false) {
+                    if (TCP_APP_QueueFrame(send_job->connect_id, send_job->data_str, send_job->data_size, send_job->quiet) &&
+                        send_job->urgent) {
+                        TCP_APP_FlushSocket(send_job->connect_id);
+                    }
+                } else {
+                    if (send_job->quiet == true) {
+                        TCP_APP_OpenQuiet();
+                    }
+
+                    TCP_APP_SendDatagram(send_job->connect_id, send_job->data_str, send_job->data_size);
+
+                    if (send_job->quiet == true) {
+                        TCP_APP_CloseQuiet();
+                    }
+                }
+
+                TCP_APP_DropJob(&tcp_job);
+                continue;
+            }
+            case eTcpJob_Disconnect: {
+                eServerId_t connect_id = tcp_job.data.disconnect.connect_id;
+
+                if (g_socket[connect_id].state == eSocketState_Closed) {
+                    bool busy_sockets = false;
+                    TCP_ADD_ReturnFreeSockets(socket_str, count, busy_sockets);
+                    DEBUG_INFO("No previous connection was initiated with socket id: %d. %s\r\n", connect_id, socket_str);
+                    continue;
+                }
+
+                g_socket[connect_id].auto_reconnect = false;
+                TCP_APP_FlushSocket(connect_id);
+
+                switch (g_socket[connect_id].state) {
+                    case eSocketState_Closed: {
+                        break;
+                    }
+                    case eSocketState_Reconnecting: {
+                        TCP_APP_SetState(connect_id, eSocketState_Closed);
+                        break;
+                    }
+                    default: {
+                        TCP_APP_SetState(connect_id, eSocketState_Closing);
+                        TCP_APP_ReleaseSocket(connect_id);
+                        break;
+                    }
+                }
+
+                continue;
+            }
+            case eTcpJob_SocketEvent: {
+                TCP_APP_HandleSocketEvent(&tcp_job.data.socket_event);
+                continue;
+            }
+            default: {
+                DEBUG_WARN("Uknown TCP job type!\r\n");
+                TCP_APP_DropJob(&tcp_job);
+                continue;
+            }
+        }
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool TCP_APP_Init (void) {
+    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+        g_socket[srv_id].state = eSocketState_Closed;
+        g_socket[srv_id].backoff_ms = RECONNECT_MIN_DELAY_MS;
+    }
+
+    if (TCP_API_Init() == false) {
+        DEBUG_ERROR("Failed to initialize the socket receive path!\r\n");
+        return false;
+    }
+
+    if (g_is_outbox_mounted == false) {
+        g_is_outbox_mounted = TCP_APP_MountOutbox();
+        if (g_is_outbox_mounted == false) {
+            DEBUG_WARN("Failed to mount the outbox, persistent frames will be dropped!\r\n");
+        }
+    }
+
+    if (g_tcp_payload_pool_id == NULL) {
+        g_tcp_payload_pool_id = osMemoryPoolNew(TCP_PAYLOAD_POOL_BLOCK_COUNT, TCP_APP_PAYLOAD_BLOCK_SIZE, &g_tcp_payload_pool_attr);
+        if (g_tcp_payload_pool_id == NULL) {
+            DEBUG_ERROR("Failed to create a memory pool for TCP payloads!\r\n");
+            return false;
+        }
+    }
+
+    if (g_tcp_task_msg_queue_id == NULL) {
+        g_tcp_task_msg_queue_id = osMessageQueueNew(MSG_COUNT, MSG_SIZE, &g_tcp_task_msg_queue_attr);
+        if (g_tcp_task_msg_queue_id == NULL) {
+            DEBUG_ERROR("Failed to create a message queue for TCP tasks!\r\n");
+            return false;
+        }
+    }
+
+    if (g_tcp_job_handle_task_id == NULL) {
+        g_tcp_job_handle_task_id = osThreadNew(TCP_APP_JobHandler, TCP_JOB_HANDLE_TASK_ARGS, &g_tcp_job_handle_task_attr);
+        if (g_tcp_job_handle_task_id == NULL) {
+            DEBUG_ERROR("Failed to create a Thread for tcp job handling!\r\n");
+            return false;
+        }
+    }
+
+    if (Modem_API_SetSocketEventCallback(&TCP_APP_OnSocketEvent) == false) {
+        return false;
+    }
+
+    return true;
+}
+
+void TCP_ADD_ReturnFreeSockets(char *sockets, size_t count, bool socket_state) { 
+    int socket_count = 0;
+    if (socket_state) {
+        count += snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "These are the available socket(s): ");
+    } else {
+        count += snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "These are in-use socket(s): ");
+    }
+
+    for (eServerId_t srv_id = eServerId_First; srv_id < eServerId_Last; srv_id++) {
+        if ((g_socket[srv_id].state == eSocketState_Closed) == socket_state) {
+            count += snprintf(&sockets[count], AVAILABLE_SOCKET_BUFFER_SIZE, "%d, ", srv_id);
+        } else {
+            socket_count++;
+        }
+    }
+
+    if (count > AVAILABLE_SOCKET_BUFFER_SIZE) {
+        DEBUG_ERROR("Buffer overflow occured, too many characters were written to the socket buffer size!\r\n");
+        return;
+    }
+
+    if (socket_count == eServerId_Last) {
+        if (socket_state) {
+            snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "All sockets are in use!");
+        } else {
+            snprintf(sockets, AVAILABLE_SOCKET_BUFFER_SIZE, "No sockets are currently in use!");
+        }
+    } else {
+        sockets[count - 2] = '!';
+    }
+
+    return;
+}
+
+bool TCP_APP_AddTask (sTcpJobMessage_t *tcp_job) {
+    if (tcp_job == NULL) {
+        DEBUG_ERROR("TCP task arguments are invalid!\r\n");
+        return false;
+    }
+
+    if (osMessageQueuePut(g_tcp_task_msg_queue_id, tcp_job, MSG_PRIORITY, MSG_QUEUE_PUT_TIMEOUT_MS) != osOK) {
+        DEBUG_ERROR("Failed to queue the TCP task request!\r\n");
+        TCP_APP_DropJob(tcp_job);
+        return false;
+    }
+
+    return true;
+}
+
+char *TCP_APP_AllocPayload (size_t payload_size) {
+    if ((payload_size == 0) || (payload_size > TCP_APP_PAYLOAD_BLOCK_SIZE) || (g_tcp_payload_pool_id == NULL)) {
+        return NULL;
+    }
+
+    return (char *) osMemoryPoolAlloc(g_tcp_payload_pool_id, TCP_PAYLOAD_ALLOC_TIMEOUT_MS);
+}
+
+void TCP_APP_FreePayload (char *payload) {
+    if ((payload == NULL) || (g_tcp_payload_pool_id == NULL)) {
+        return;
+    }
+
+    if (osMemoryPoolFree(g_tcp_payload_pool_id, payload) != osOK) {
+        DEBUG_ERROR("Failed to return a TCP payload to the pool!\r\n");
+    }
+}
+
+bool TCP_APP_SetCoalescing (size_t max_bytes, uint32_t max_latency_ms) {
+    if ((max_bytes == 0) || (max_bytes > TCP_API_MAX_SEND_SIZE)) {
+        DEBUG_ERROR("Coalescing byte budget must be between 1 and %u!\r\n", TCP_API_MAX_SEND_SIZE);
+        return false;
+    }
+
+    g_coalesce_max_bytes = max_bytes;
+    g_coalesce_max_latency_ms = max_latency_ms;
+
+    return true;
+}
+
+bool TCP_APP_GetSendStats (eServerId_t connect_id, sTcpSendStats_t *stats) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last) || (stats == NULL)) {
+        return false;
+    }
+
+    *stats = g_send_stats[connect_id];
+    stats->reconnects = g_socket[connect_id].reconnects;
+
+    return true;
+}
+
+eSocketState_t TCP_APP_GetSocketState (eServerId_t connect_id) {
+    if ((connect_id < eServerId_First) || (connect_id >= eServerId_Last)) {
+        return eSocketState_Last;
+    }
+
+    return g_socket[connect_id].state;
+}
+
+eServerId_t TCP_APP_FindFreeSocket (void) {
+    for (eServerId_t connect_id = eServerId_Last; connect_id > eServerId_First; connect_id--) {
+        if (g_socket[connect_id - 1].state == eSocketState_Closed) {
+            return connect_id - 1;
+        }
+    }
+
+    return eServerId_Last;
+}
+
+const char *TCP_APP_GetSocketStateName (eSocketState_t state) {
+    if ((state < eSocketState_First) || (state >= eSocketState_Last)) {
+        return "unknown";
+    }
+
+    return g_socket_state_name[state];
+}
+
+bool TCP_APP_HandleReliableAck (eServerId_t connect_id, const char *data, size_t data_size) {
+    if ((data == NULL) || (data_size == 0) || ((data_size % RELIABLE_HEADER_SIZE) != 0)) {
+        return false;
+    }
+
+    /* A server may batch several acks into one datagram, anything else in it makes it application data */
+    for (size_t offset = 0; offset < data_size; offset += RELIABLE_HEADER_SIZE) {
+        if ((uint8_t) data[offset] != RELIABLE_ACK_MARKER) {
+            return false;
+        }
+    }
+
+    for (size_t offset = 0; offset < data_size; offset += RELIABLE_HEADER_SIZE) {
+        uint16_t sequence = (uint16_t) (((uint8_t) data[offset + 1] << 8) | (uint8_t) data[offset + 2]);
+
+        for (size_t slot = 0; slot < RELIABLE_SLOT_COUNT; slot++) {
+            sReliableSlot_t *reliable = &g_reliable_slot[slot];
+
+            if ((reliable->is_used == true) && (reliable->connect_id == connect_id) && (reliable->sequence == sequence)) {
+                reliable->is_used = false;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TCP_APP_GetOutboxStats (sOutboxStats_t *stats, uint32_t *pending) {
+    if ((stats == NULL) || (pending == NULL) || (g_is_outbox_mounted == false)) {
+        return false;
+    }
+
+    *pending = Outbox_GetPending(&g_outbox);
+
+    return Outbox_GetStats(&g_outbox, stats);
+}
+
+bool TCP_APP_GetLastTransmit (uint32_t *tick) {
+    if ((tick == NULL) || (g_has_transmitted == false)) {
+        return false;
+    }
+
+    *tick = g_transmit_tick;
+
+    return true;
+}
+
+bool TCP_APP_IsQuietTick (uint32_t tick) {
+    uint32_t now = osKernelGetTickCount();
+    size_t head = g_quiet_window_head;
+
+    for (size_t window = 0; window < g_quiet_window_count; window++) {
+        uint32_t start_tick = g_quiet_window[window].start_tick;
+        uint32_t end_tick = ((window == head) && (g_is_quiet_open == true)) ? now : g_quiet_window[window].end_tick;
+
+        /* Wraps with the tick counter, a tick before the start is far past the end */
+        if ((tick - start_tick) <= (end_tick - start_tick)) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -1,72 +1,146 @@
-#ifndef SOURCE_API_TCP_APP_H_
-#define SOURCE_API_TCP_APP_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdint.h>
-#include "message.h"
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-typedef enum eServerId {
-    eServerId_First = 0,
-    eServerId_Second,
-    eServerId_Third,
-    eServerId_Fourth,
-    eServerId_Fifth,
-    eServerId_Sixth,
-    eServerId_Seventh,
-    eServerId_Eighth,
-    eServerId_Nineth,
-    eServerId_Tenth,
-    eServerId_Eleventh,
-    eServerId_Last
-} eServerId_t;
-
-typedef struct sTcpConnectJob {
-    eServerId_t connect_id;
-    char ip_address[16];
-    size_t port;
-} sTcpConnectJob_t;
-
-typedef struct sSocketProperties {
-    bool is_socket_free;
-} sSocketProperties_t;
-
-typedef struct sTcpSendJob {
-    eServerId_t connect_id;
-    char *data_str;
-    size_t data_size;
-} sTcpSendJob_t;
-
-typedef struct sTcpDisconnectJob {
-    eServerId_t connect_id;
-} sTcpDisconnectJob_t;
-
-typedef enum eTcpJob {
-    eTcpJob_First = 0,
-    eTcpJob_Connect = eTcpJob_First,
-    eTcpJob_Send,
-    eTcpJob_Disconnect,
-    eTcpJob_Last
-} eTcpJob_t;
-
-typedef struct sTcpJobMessage {
-    eTcpJob_t type;
-    void *data;
-} sTcpJobMessage_t;
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-bool TCP_APP_Init (void);
-bool TCP_APP_AddTask (sTcpJobMessage_t *tcp_job_msg);
-void TCP_ADD_ReturnFreeSockets (char *sockets, size_t count, bool socket_state);
-#endif /* SOURCE_API_TCP_APP_H_ */
+#ifndef SOURCE_API_TCP_APP_H_
+#define SOURCE_API_TCP_APP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "message.h"
+#include "modem_api.h"
+#include "outbox.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define TCP_APP_PAYLOAD_BLOCK_SIZE 256
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eServerId {
+    eServerId_First = 0,
+    eServerId_Second,
+    eServerId_Third,
+    eServerId_Fourth,
+    eServerId_Fifth,
+    eServerId_Sixth,
+    eServerId_Seventh,
+    eServerId_Eighth,
+    eServerId_Nineth,
+    eServerId_Tenth,
+    eServerId_Eleventh,
+    eServerId_Last
+} eServerId_t;
+
+typedef enum eSocketService {
+    eSocketService_First = 0,
+    eSocketService_Tcp = eSocketService_First,
+    eSocketService_Udp,
+    eSocketService_UdpService,
+    eSocketService_Last
+} eSocketService_t;
+
+/* For eSocketService_UdpService the port is both the local port and the peer port datagrams are sent to. */
+typedef struct sTcpConnectJob {
+    eServerId_t connect_id;
+    eSocketService_t service;
+    char ip_address[16];
+    size_t port;
+} sTcpConnectJob_t;
+
+typedef enum eSocketState {
+    eSocketState_First = 0,
+    eSocketState_Closed = eSocketState_First,
+    eSocketState_Connecting,
+    eSocketState_Connected,
+    eSocketState_Closing,
+    eSocketState_RemoteClosed,
+    eSocketState_Reconnecting,
+    eSocketState_Last
+} eSocketState_t;
+
+typedef struct sSocketProperties {
+    eSocketState_t state;
+    eSocketService_t service;
+    char ip_address[16];
+    size_t port;
+    bool auto_reconnect;
+    uint32_t state_tick;
+    uint32_t retry_delay_ms;
+    uint32_t backoff_ms;
+    uint32_t reconnects;
+} sSocketProperties_t;
+
+typedef struct sTcpSendJob {
+    eServerId_t connect_id;
+    char *data_str;
+    size_t data_size;
+    bool reliable;
+    bool persistent;
+    /* Skips the coalescing delay, e.g. for alerts. Persistent ones are sent live on a connected socket and are stored
+     * only while they cannot be, then drained ahead of the rest of the outbox. */
+    bool urgent;
+    /* Log sink data, the lines logged while it is being sent are kept off the log mirror */
+    bool quiet;
+} sTcpSendJob_t;
+
+typedef struct sTcpDisconnectJob {
+    eServerId_t connect_id;
+} sTcpDisconnectJob_t;
+
+typedef struct sTcpSocketEventJob {
+    int connect_id;
+    eModemSocketEvent_t event;
+} sTcpSocketEventJob_t;
+
+typedef enum eTcpJob {
+    eTcpJob_First = 0,
+    eTcpJob_Connect = eTcpJob_First,
+    eTcpJob_Send,
+    eTcpJob_Disconnect,
+    eTcpJob_SocketEvent,
+    eTcpJob_Last
+} eTcpJob_t;
+
+typedef struct sTcpJobMessage {
+    eTcpJob_t type;
+    union {
+        sTcpConnectJob_t connect;
+        sTcpSendJob_t send;
+        sTcpDisconnectJob_t disconnect;
+        sTcpSocketEventJob_t socket_event;
+    } data;
+} sTcpJobMessage_t;
+
+typedef struct sTcpSendStats {
+    uint32_t sends;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t reconnects;
+    uint32_t retransmits;
+    uint32_t lost;
+} sTcpSendStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool TCP_APP_Init (void);
+bool TCP_APP_AddTask (sTcpJobMessage_t *tcp_job_msg);
+char *TCP_APP_AllocPayload (size_t payload_size);
+void TCP_APP_FreePayload (char *payload);
+void TCP_ADD_ReturnFreeSockets (char *sockets, size_t count, bool socket_state);
+bool TCP_APP_SetCoalescing (size_t max_bytes, uint32_t max_latency_ms);
+bool TCP_APP_GetSendStats (eServerId_t connect_id, sTcpSendStats_t *stats);
+eSocketState_t TCP_APP_GetSocketState (eServerId_t connect_id);
+/* Highest closed socket for short lived downloads, eServerId_Last when every socket is taken */
+eServerId_t TCP_APP_FindFreeSocket (void);
+const char *TCP_APP_GetSocketStateName (eSocketState_t state);
+bool TCP_APP_HandleReliableAck (eServerId_t connect_id, const char *data, size_t data_size);
+bool TCP_APP_GetOutboxStats (sOutboxStats_t *stats, uint32_t *pending);
+/* Tick of the last successful send on any socket, false before the first one */
+bool TCP_APP_GetLastTransmit (uint32_t *tick);
+/* True when tick falls into the send of a quiet frame, the last few sends are remembered */
+bool TCP_APP_IsQuietTick (uint32_t tick);
+#endif /* SOURCE_API_TCP_APP_H_ */
@@ -0,0 +1,277 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "uart_driver.h"
+#include "ring_buffer.h"
+#include "cmux_frame.h"
+#include "cmux_driver.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define CMUX_RX_RING_SIZE 512
+#define CMUX_TX_MUTEX_TIMEOUT_MS 100
+#define CMUX_CLOSE_GUARD_MS 100
+#define DLC_FLAG(dlc) (1U << (dlc))
+/* Control channel message type octet: EA bit, C/R bit, message type */
+#define CONTROL_MESSAGE_CR 0x02
+#define CONTROL_MESSAGE_CLD 0xC3
+#define CONTROL_MESSAGE_LENGTH_EA 0x01
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const osMutexAttr_t g_cmux_tx_mutex_attr = {
+    .name = "CmuxTxMutex"
+};
+static const osEventFlagsAttr_t g_cmux_dlc_flags_attr = {
+    .name = "CmuxDlcFlags"
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static eUartDriver_t g_cmux_uart = eUartDriver_Last;
+static volatile bool g_is_active = false;
+static osMutexId_t g_tx_mutex_id = NULL;
+static osEventFlagsId_t g_dlc_flags_id = NULL;
+static RingBufferHandle_t g_rx_ring[eCmuxDlc_Last] = {0};
+static sCmuxDeframer_t g_deframer = {0};
+static uint8_t g_tx_frame[CMUX_FRAME_MAX_SIZE] = {0};
+static sCmuxStats_t g_stats = {0};
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool CMUX_Driver_SendFrame (const sCmuxFrame_t *frame);
+static void CMUX_Driver_HandleFrame (const sCmuxFrame_t *frame);
+static void CMUX_Driver_Pump (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool CMUX_Driver_SendFrame (const sCmuxFrame_t *frame) {
+    if (osMutexAcquire(g_tx_mutex_id, CMUX_TX_MUTEX_TIMEOUT_MS) != osOK) {
+        return false;
+    }
+
+    size_t frame_size = CmuxFrame_Encode(frame, g_tx_frame, sizeof(g_tx_frame));
+    bool is_sent = (frame_size > 0) && UART_Driver_SendBytes(g_cmux_uart, g_tx_frame, frame_size);
+
+    if (is_sent == true) {
+        g_stats.frames_sent++;
+    }
+
+    osMutexRelease(g_tx_mutex_id);
+
+    return is_sent;
+}
+
+static void CMUX_Driver_HandleFrame (const sCmuxFrame_t *frame) {
+    g_stats.frames_received++;
+
+    if (frame->dlci >= eCmuxDlc_Last) {
+        return;
+    }
+
+    switch (frame->control) {
+        case CMUX_FRAME_UA: {
+            osEventFlagsSet(g_dlc_flags_id, DLC_FLAG(frame->dlci));
+            break;
+        }
+        case CMUX_FRAME_DM:
+        case CMUX_FRAME_DISC: {
+            if (frame->dlci == eCmuxDlc_Control) {
+                g_is_active = false;
+            }
+
+            break;
+        }
+        case CMUX_FRAME_UI:
+        case CMUX_FRAME_UIH: {
+            if (frame->dlci != eCmuxDlc_Control) {
+                for (size_t i = 0; i < frame->info_size; i++) {
+                    if (RingBuffer_Put(g_rx_ring[frame->dlci], frame->info[i]) == false) {
+                        g_stats.dropped_bytes++;
+                    }
+                }
+
+                break;
+            }
+
+            /* Every control channel command (MSC, PSC, Test, ...) is acknowledged by echoing it with C/R cleared. */
+            if ((frame->info_size == 0) || ((frame->info[0] & CONTROL_MESSAGE_CR) == 0)) {
+                break;
+            }
+
+            uint8_t response[CMUX_FRAME_MAX_INFO_SIZE];
+            memcpy(response, frame->info, frame->info_size);
+            response[0] &= ~CONTROL_MESSAGE_CR;
+
+            sCmuxFrame_t response_frame = {.dlci = eCmuxDlc_Control, .control = CMUX_FRAME_UIH, .is_command = true,
+                                           .poll_final = false, .info = response, .info_size = frame->info_size};
+            CMUX_Driver_SendFrame(&response_frame);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void CMUX_Driver_Pump (void) {
+    uint8_t byte;
+    sCmuxFrame_t frame;
+
+    while (UART_Driver_GetByte(g_cmux_uart, &byte)) {
+        if (CmuxFrame_Decode(&g_deframer, byte, &frame)) {
+            CMUX_Driver_HandleFrame(&frame);
+        }
+    }
+
+    g_stats.fcs_errors = g_deframer.fcs_errors;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool CMUX_Driver_Init (eUartDriver_t uart) {
+    if (uart >= eUartDriver_Last) {
+        return false;
+    }
+
+    for (eCmuxDlc_t dlc = eCmuxDlc_At; dlc < eCmuxDlc_Last; dlc++) {
+        if (g_rx_ring[dlc] == NULL) {
+            g_rx_ring[dlc] = RingBuffer_Init(CMUX_RX_RING_SIZE);
+            if (g_rx_ring[dlc] == NULL) {
+                return false;
+            }
+        }
+    }
+
+    if (g_tx_mutex_id == NULL) {
+        g_tx_mutex_id = osMutexNew(&g_cmux_tx_mutex_attr);
+        if (g_tx_mutex_id == NULL) {
+            return false;
+        }
+    }
+
+    if (g_dlc_flags_id == NULL) {
+        g_dlc_flags_id = osEventFlagsNew(&g_cmux_dlc_flags_attr);
+        if (g_dlc_flags_id == NULL) {
+            return false;
+        }
+    }
+
+    g_cmux_uart = uart;
+
+    return true;
+}
+
+bool CMUX_Driver_Open (uint32_t timeout) {
+    if (g_cmux_uart >= eUartDriver_Last) {
+        return false;
+    }
+
+    /* From here on every byte on the UART is a frame, the modem answered AT+CMUX already. */
+    CmuxFrame_ResetDeframer(&g_deframer);
+    g_is_active = true;
+
+    for (eCmuxDlc_t dlc = eCmuxDlc_First; dlc < eCmuxDlc_Last; dlc++) {
+        osEventFlagsClear(g_dlc_flags_id, DLC_FLAG(dlc));
+
+        sCmuxFrame_t sabm = {.dlci = dlc, .control = CMUX_FRAME_SABM, .is_command = true, .poll_final = true, 
+                             .info = NULL, .info_size = 0};
+
+        if (CMUX_Driver_SendFrame(&sabm) == false) {
+            CMUX_Driver_Close();
+            return false;
+        }
+
+        /* A modem that took AT+CMUX but not the channels is closed down again, so it goes back to AT commands */
+        uint32_t flags = osEventFlagsWait(g_dlc_flags_id, DLC_FLAG(dlc), osFlagsWaitAny, timeout);
+        if ((flags >= osFlagsError) || ((flags & DLC_FLAG(dlc)) == 0)) {
+            CMUX_Driver_Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CMUX_Driver_Close (void) {
+    if (g_is_active == false) {
+        return true;
+    }
+
+    uint8_t close_down[] = {CONTROL_MESSAGE_CLD, CONTROL_MESSAGE_LENGTH_EA};
+    sCmuxFrame_t cld = {.dlci = eCmuxDlc_Control, .control = CMUX_FRAME_UIH, .is_command = true, .poll_final = false,
+                        .info = close_down, .info_size = sizeof(close_down)};
+
+    bool is_sent = CMUX_Driver_SendFrame(&cld);
+
+    osDelay(CMUX_CLOSE_GUARD_MS);
+    g_is_active = false;
+
+    return is_sent;
+}
+
+bool CMUX_Driver_IsActive (void) {
+    return g_is_active;
+}
+
+bool CMUX_Driver_SendBytes (eCmuxDlc_t dlc, uint8_t *data, size_t length) {
+    if ((dlc <= eCmuxDlc_Control) || (dlc >= eCmuxDlc_Last) || (data == NULL) || (length == 0)) {
+        return false;
+    }
+
+    if (g_is_active == false) {
+        return false;
+    }
+
+    while (length > 0) {
+        size_t chunk_size = (length > CMUX_FRAME_MAX_INFO_SIZE) ? CMUX_FRAME_MAX_INFO_SIZE : length;
+        sCmuxFrame_t frame = {.dlci = dlc, .control = CMUX_FRAME_UIH, .is_command = true, .poll_final = false,
+                              .info = data, .info_size = chunk_size};
+
+        if (CMUX_Driver_SendFrame(&frame) == false) {
+            return false;
+        }
+
+        data += chunk_size;
+        length -= chunk_size;
+    }
+
+    return true;
+}
+
+bool CMUX_Driver_GetByte (eCmuxDlc_t dlc, uint8_t *data) {
+    if ((dlc <= eCmuxDlc_Control) || (dlc >= eCmuxDlc_Last) || (data == NULL)) {
+        return false;
+    }
+
+    if (g_is_active == false) {
+        return false;
+    }
+
+    /* Demultiplexing runs on whichever task polls the channels, the UART API collector in practice. */
+    CMUX_Driver_Pump();
+
+    return RingBuffer_Get(g_rx_ring[dlc], data);
+}
+
+bool CMUX_Driver_GetStats (sCmuxStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    *stats = g_stats;
+
+    return true;
+}
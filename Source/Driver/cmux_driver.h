@@ -0,0 +1,46 @@
+#ifndef SOURCE_DRIVER_CMUX_DRIVER_H_
+#define SOURCE_DRIVER_CMUX_DRIVER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "uart_driver.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eCmuxDlc {
+    eCmuxDlc_First = 0,
+    eCmuxDlc_Control = eCmuxDlc_First,
+    eCmuxDlc_At,
+    eCmuxDlc_Data,
+    eCmuxDlc_Gnss,
+    eCmuxDlc_Last
+} eCmuxDlc_t;
+
+typedef struct sCmuxStats {
+    uint32_t frames_sent;
+    uint32_t frames_received;
+    uint32_t fcs_errors;
+    uint32_t dropped_bytes;
+} sCmuxStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool CMUX_Driver_Init (eUartDriver_t uart);
+bool CMUX_Driver_Open (uint32_t timeout);
+bool CMUX_Driver_Close (void);
+bool CMUX_Driver_IsActive (void);
+bool CMUX_Driver_SendBytes (eCmuxDlc_t dlc, uint8_t *data, size_t length);
+bool CMUX_Driver_GetByte (eCmuxDlc_t dlc, uint8_t *data);
+bool CMUX_Driver_GetStats (sCmuxStats_t *stats);
+#endif /* SOURCE_DRIVER_CMUX_DRIVER_H_ */
@@ -0,0 +1,171 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "stm32f4xx_hal.h"
+#include "cmsis_os2.h"
+#include "flash_driver.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SECTOR_SIZE_128K (128U * 1024U)
+/* A 128 KiB sector erase takes up to 2 s */
+#define FLASH_MUTEX_TIMEOUT_MS 3000
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sFlashSectorDesc {
+    uint32_t hal_sector;
+    uint32_t address;
+    size_t size;
+} sFlashSectorDesc_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+/* Must match the OUTBOX, XTRA and GEOFENCE regions in the linker scripts */
+static const sFlashSectorDesc_t g_sector_lut[eFlashDriverSector_Last] = {
+    [eFlashDriverSector_Outbox0] = {.hal_sector = FLASH_SECTOR_9,  .address = 0x080A0000, .size = SECTOR_SIZE_128K},
+    [eFlashDriverSector_Outbox1] = {.hal_sector = FLASH_SECTOR_10, .address = 0x080C0000, .size = SECTOR_SIZE_128K},
+    [eFlashDriverSector_Outbox2] = {.hal_sector = FLASH_SECTOR_11, .address = 0x080E0000, .size = SECTOR_SIZE_128K},
+    [eFlashDriverSector_Xtra]    = {.hal_sector = FLASH_SECTOR_8,  .address = 0x08080000, .size = SECTOR_SIZE_128K},
+    [eFlashDriverSector_Geofence] = {.hal_sector = FLASH_SECTOR_7, .address = 0x08060000, .size = SECTOR_SIZE_128K}
+};
+static const osMutexAttr_t g_flash_mutex_attr = {
+    .name = "FlashMutex"
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+/* One program or erase at a time, the controller is unlocked and locked again around each of them */
+static osMutexId_t g_flash_mutex_id = NULL;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Flash_Driver_IsRangeValid (eFlashDriverSector_t sector, size_t offset, size_t size);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Flash_Driver_IsRangeValid (eFlashDriverSector_t sector, size_t offset, size_t size) {
+    if (sector >= eFlashDriverSector_Last) {
+        return false;
+    }
+
+    return (offset <= g_sector_lut[sector].size) && (size <= (g_sector_lut[sector].size - offset));
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Flash_Driver_Init (void) {
+    if (g_flash_mutex_id == NULL) {
+        g_flash_mutex_id = osMutexNew(&g_flash_mutex_attr);
+        if (g_flash_mutex_id == NULL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t Flash_Driver_GetSectorSize (eFlashDriverSector_t sector) {
+    if (sector >= eFlashDriverSector_Last) {
+        return 0;
+    }
+
+    return g_sector_lut[sector].size;
+}
+
+const void *Flash_Driver_GetAddress (eFlashDriverSector_t sector) {
+    if (sector >= eFlashDriverSector_Last) {
+        return NULL;
+    }
+
+    return (const void *) (uintptr_t) g_sector_lut[sector].address;
+}
+
+bool Flash_Driver_Read (eFlashDriverSector_t sector, size_t offset, void *data, size_t size) {
+    if ((data == NULL) || (Flash_Driver_IsRangeValid(sector, offset, size) == false)) {
+        return false;
+    }
+
+    memcpy(data, (const void *) (g_sector_lut[sector].address + offset), size);
+
+    return true;
+}
+
+bool Flash_Driver_Program (eFlashDriverSector_t sector, size_t offset, const void *data, size_t size) {
+    if ((data == NULL) || (Flash_Driver_IsRangeValid(sector, offset, size) == false)) {
+        return false;
+    }
+
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t address = g_sector_lut[sector].address + offset;
+    bool is_programmed = true;
+
+    if (osMutexAcquire(g_flash_mutex_id, FLASH_MUTEX_TIMEOUT_MS) != osOK) {
+        return false;
+    }
+
+    if (HAL_FLASH_Unlock() != HAL_OK) {
+        osMutexRelease(g_flash_mutex_id);
+        return false;
+    }
+
+    /* Whole words where the address allows it, the unaligned head and tail go byte by byte. */
+    while ((size > 0) && (is_programmed == true)) {
+        if (((address & 0x3U) == 0) && (size >= sizeof(uint32_t))) {
+            uint32_t word;
+            memcpy(&word, bytes, sizeof(word));
+            is_programmed = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word) == HAL_OK);
+            address += sizeof(word);
+            bytes += sizeof(word);
+            size -= sizeof(word);
+        } else {
+            is_programmed = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, address, *bytes) == HAL_OK);
+            address++;
+            bytes++;
+            size--;
+        }
+    }
+
+    HAL_FLASH_Lock();
+    osMutexRelease(g_flash_mutex_id);
+
+    return is_programmed;
+}
+
+bool Flash_Driver_Erase (eFlashDriverSector_t sector) {
+    if (sector >= eFlashDriverSector_Last) {
+        return false;
+    }
+
+    FLASH_EraseInitTypeDef erase_init = {0};
+    uint32_t sector_error = 0;
+
+    erase_init.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase_init.Sector = g_sector_lut[sector].hal_sector;
+    erase_init.NbSectors = 1;
+    erase_init.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    if (osMutexAcquire(g_flash_mutex_id, FLASH_MUTEX_TIMEOUT_MS) != osOK) {
+        return false;
+    }
+
+    if (HAL_FLASH_Unlock() != HAL_OK) {
+        osMutexRelease(g_flash_mutex_id);
+        return false;
+    }
+
+    bool is_erased = (HAL_FLASHEx_Erase(&erase_init, &sector_error) == HAL_OK);
+
+    HAL_FLASH_Lock();
+    osMutexRelease(g_flash_mutex_id);
+
+    return is_erased;
+}
@@ -0,0 +1,40 @@
+#ifndef SOURCE_DRIVER_FLASH_DRIVER_H_
+#define SOURCE_DRIVER_FLASH_DRIVER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eFlashDriverSector {
+    eFlashDriverSector_First = 0,
+    eFlashDriverSector_Outbox0 = eFlashDriverSector_First,
+    eFlashDriverSector_Outbox1,
+    eFlashDriverSector_Outbox2,
+    eFlashDriverSector_Xtra,
+    eFlashDriverSector_Geofence,
+    eFlashDriverSector_Last
+} eFlashDriverSector_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* After osKernelInitialize, program and erase fail until it ran */
+bool Flash_Driver_Init (void);
+size_t Flash_Driver_GetSectorSize (eFlashDriverSector_t sector);
+/* Flash is memory mapped, data that is only read can be used in place */
+const void *Flash_Driver_GetAddress (eFlashDriverSector_t sector);
+bool Flash_Driver_Read (eFlashDriverSector_t sector, size_t offset, void *data, size_t size);
+bool Flash_Driver_Program (eFlashDriverSector_t sector, size_t offset, const void *data, size_t size);
+bool Flash_Driver_Erase (eFlashDriverSector_t sector);
+#endif /* SOURCE_DRIVER_FLASH_DRIVER_H_ */
@@ -0,0 +1,227 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_rcc.h"
+#include "stm32f4xx_ll_pwr.h"
+#include "stm32f4xx_ll_exti.h"
+#include "stm32f4xx_ll_system.h"
+#include "stm32f4xx_ll_cortex.h"
+#include "uart_driver.h"
+#include "power_driver.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define LPTIM1_RELOAD 0xFFFFU
+/* LPTIM1 reaches the EXTI, and through it the core in Stop, on line 23 */
+#define LPTIM1_EXTI_LINE LL_EXTI_LINE_23
+/* The handlers only clear flags, the priority just has to let them through the kernel mask */
+#define WAKE_IRQ_PRIORITY 5
+/* About 8 ms of LSI */
+#define LSI_CALIBRATION_COUNTS 256U
+/* The LSI is only specified between these, anything outside is a failed measurement */
+#define LSI_MIN_HZ 17000U
+#define LSI_MAX_HZ 47000U
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sPowerWakePin {
+    uint32_t exti_port;
+    uint32_t exti_source;
+    uint32_t exti_line;
+} sPowerWakePin_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+/* The RX pins of the UARTs, PB7 for USART1 and PD6 for USART2 */
+const static sPowerWakePin_t g_static_wake_pin_lut[eUartDriver_Last] = {
+    [eUartDriver_1] = {.exti_port = LL_SYSCFG_EXTI_PORTB, .exti_source = LL_SYSCFG_EXTI_LINE7,
+                       .exti_line = LL_EXTI_LINE_7},
+
+    [eUartDriver_2] = {.exti_port = LL_SYSCFG_EXTI_PORTD, .exti_source = LL_SYSCFG_EXTI_LINE6,
+                       .exti_line = LL_EXTI_LINE_6}
+};
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static uint32_t g_wake_timer_hz = 0;
+static uint32_t g_wake_lines = 0;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+void LPTIM1_IRQHandler (void);
+void EXTI9_5_IRQHandler (void);
+static uint32_t Power_Driver_GetCounter (void);
+static uint32_t Power_Driver_MeasureLsi (void);
+static void Power_Driver_RestoreClock (void);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+void LPTIM1_IRQHandler (void) {
+    LPTIM1->ICR = LPTIM_ICR_CMPMCF;
+    LL_EXTI_ClearFlag_0_31(LPTIM1_EXTI_LINE);
+}
+
+/* Only there to take the core out of Stop, the UART picks the bytes up itself once the clock is back */
+void EXTI9_5_IRQHandler (void) {
+    LL_EXTI_ClearFlag_0_31(g_wake_lines);
+}
+
+/* The counter runs off the LSI, a read only holds when two in a row agree */
+static uint32_t Power_Driver_GetCounter (void) {
+    uint32_t first;
+    uint32_t second = LPTIM1->CNT;
+
+    do {
+        first = second;
+        second = LPTIM1->CNT;
+    } while (first != second);
+
+    return first;
+}
+
+static uint32_t Power_Driver_MeasureLsi (void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Start right on an edge of the LSI */
+    uint32_t count = Power_Driver_GetCounter();
+
+    while (Power_Driver_GetCounter() == count) {
+    }
+
+    uint32_t cycles = DWT->CYCCNT;
+
+    count = Power_Driver_GetCounter();
+
+    while (((Power_Driver_GetCounter() - count) & LPTIM1_RELOAD) < LSI_CALIBRATION_COUNTS) {
+    }
+
+    cycles = DWT->CYCCNT - cycles;
+
+    return (uint32_t) (((uint64_t) LSI_CALIBRATION_COUNTS * SystemCoreClock) / cycles);
+}
+
+/* Stop leaves the core running from the HSI with the PLL off. The PLL setup, the bus dividers and the flash latency
+ * are all kept, so turning the PLL back on and switching to it is enough. */
+static void Power_Driver_RestoreClock (void) {
+    LL_RCC_PLL_Enable();
+    while (LL_RCC_PLL_IsReady() != 1) {
+    }
+
+    LL_RCC_SetSysClkSource(LL_RCC_SYS_CLKSOURCE_PLL);
+    while (LL_RCC_GetSysClkSource() != LL_RCC_SYS_CLKSOURCE_STATUS_PLL) {
+    }
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Power_Driver_Init (void) {
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_PWR);
+    LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_SYSCFG);
+
+    LL_RCC_LSI_Enable();
+    while (LL_RCC_LSI_IsReady() != 1) {
+    }
+
+    LL_RCC_SetLPTIMClockSource(LL_RCC_LPTIM1_CLKSOURCE_LSI);
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_LPTIM1);
+
+    /* The configuration and the interrupt enable only take while the timer is disabled */
+    LPTIM1->CR = 0;
+    LPTIM1->CFGR = 0;
+    LPTIM1->IER = LPTIM_IER_CMPMIE;
+    LPTIM1->CR = LPTIM_CR_ENABLE;
+    LPTIM1->ARR = LPTIM1_RELOAD;
+    while ((LPTIM1->ISR & LPTIM_ISR_ARROK) == 0) {
+    }
+
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+    LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_CNTSTRT;
+
+    uint32_t lsi_hz = Power_Driver_MeasureLsi();
+
+    if ((lsi_hz < LSI_MIN_HZ) || (lsi_hz > LSI_MAX_HZ)) {
+        return false;
+    }
+
+    /* The lines are armed only around a Stop, while running the UARTs take the bytes as usual */
+    g_wake_lines = 0;
+
+    for (eUartDriver_t uart = eUartDriver_First; uart < eUartDriver_Last; uart++) {
+        LL_SYSCFG_SetEXTISource(g_static_wake_pin_lut[uart].exti_port, g_static_wake_pin_lut[uart].exti_source);
+        LL_EXTI_EnableFallingTrig_0_31(g_static_wake_pin_lut[uart].exti_line);
+        g_wake_lines |= g_static_wake_pin_lut[uart].exti_line;
+    }
+
+    LL_EXTI_DisableIT_0_31(g_wake_lines | LPTIM1_EXTI_LINE);
+    LL_EXTI_EnableRisingTrig_0_31(LPTIM1_EXTI_LINE);
+
+    NVIC_SetPriority(LPTIM1_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), WAKE_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(LPTIM1_IRQn);
+    NVIC_SetPriority(EXTI9_5_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), WAKE_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(EXTI9_5_IRQn);
+
+    g_wake_timer_hz = lsi_hz;
+
+    return true;
+}
+
+uint32_t Power_Driver_GetWakeTimerHz (void) {
+    return g_wake_timer_hz;
+}
+
+/* A falling RX line wakes the core within the start bit, but the UART has no clock until the PLL is back, so the byte
+ * that woke it, and the next one or two at 115200, are lost or garbled. */
+uint32_t Power_Driver_Stop (uint32_t counts) {
+    if (g_wake_timer_hz == 0) {
+        return 0;
+    }
+
+    if (counts > POWER_DRIVER_MAX_STOP_COUNTS) {
+        counts = POWER_DRIVER_MAX_STOP_COUNTS;
+    }
+
+    uint32_t start = Power_Driver_GetCounter();
+    uint32_t compare = (start + counts) & LPTIM1_RELOAD;
+
+    /* The compare value has to stay below the reload */
+    if (compare == LPTIM1_RELOAD) {
+        compare = 0;
+    }
+
+    LPTIM1->ICR = LPTIM_ICR_CMPMCF | LPTIM_ICR_CMPOKCF;
+    LPTIM1->CMP = compare;
+
+    LL_EXTI_ClearFlag_0_31(g_wake_lines | LPTIM1_EXTI_LINE);
+    LL_EXTI_EnableIT_0_31(g_wake_lines | LPTIM1_EXTI_LINE);
+
+    LL_PWR_SetPowerMode(LL_PWR_MODE_STOP_LPREGU);
+    LL_LPM_EnableDeepSleep();
+    __DSB();
+    __WFI();
+    LL_LPM_EnableSleep();
+
+    Power_Driver_RestoreClock();
+
+    LL_EXTI_DisableIT_0_31(g_wake_lines | LPTIM1_EXTI_LINE);
+
+    /* The compare register takes a few LSI periods to pick up a write, the next one has to wait for that */
+    while ((LPTIM1->ISR & LPTIM_ISR_CMPOK) == 0) {
+    }
+
+    return ((Power_Driver_GetCounter() - start) & LPTIM1_RELOAD);
+}
@@ -0,0 +1,34 @@
+#ifndef SOURCE_DRIVER_POWER_DRIVER_H_
+#define SOURCE_DRIVER_POWER_DRIVER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* LPTIM1 counts the LSI with a 16 bit reload, a Stop is kept well inside one turn of it */
+#define POWER_DRIVER_MAX_STOP_COUNTS 0xF000U
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Starts the LSI and LPTIM1 and measures the LSI against the core clock, which must be set up by then */
+bool Power_Driver_Init (void);
+/* The measured LSI, the rate the Stop counts are in */
+uint32_t Power_Driver_GetWakeTimerHz (void);
+/* Stops the core until LPTIM1 has counted the given number of LSI periods or a UART RX line falls, then brings the
+ * PLL back. Called with interrupts disabled, returns the LSI periods actually spent. */
+uint32_t Power_Driver_Stop (uint32_t counts);
+
+#endif /* SOURCE_DRIVER_POWER_DRIVER_H_ */
@@ -1,70 +1,189 @@
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include "tim_driver.h"
-#include "stm32f4xx_ll_tim.h"
-#include "stm32f4xx_ll_bus.h"
-/**********************************************************************************************************************
- * Private definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Private typedef
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Private constants
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Private variables
- *********************************************************************************************************************/
-volatile unsigned long ulHighFrequencyTimerTicks;
-/**********************************************************************************************************************
- * Exported variables and references
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of private functions
- *********************************************************************************************************************/
-void TIM8_UP_TIM13_IRQHandler (void);
-
-/**********************************************************************************************************************
- * Definitions of private functions
- *********************************************************************************************************************/
-void TIM8_UP_TIM13_IRQHandler (void) {
-    if (LL_TIM_IsActiveFlag_UPDATE(TIM13)) {
-        ulHighFrequencyTimerTicks++;
-        LL_TIM_ClearFlag_UPDATE(TIM13);
-    }
-}
-
-/**********************************************************************************************************************
- * Definitions of exported functions
- *********************************************************************************************************************/
-void configureTimerForRunTimeStats (void) {
-    ulHighFrequencyTimerTicks = 0;
-    LL_TIM_EnableIT_UPDATE(TIM13);
-    LL_TIM_EnableCounter(TIM13);
-}
-
-unsigned long getRunTimeCounterValue (void) {
-    return ulHighFrequencyTimerTicks;
-}
-
-void TIM13_Init (void) {
-    LL_TIM_InitTypeDef TIM_InitStruct = {0};
-
-    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM13);
-
-    NVIC_SetPriority(TIM8_UP_TIM13_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
-    NVIC_EnableIRQ(TIM8_UP_TIM13_IRQn);
-
-    TIM_InitStruct.Prescaler = 960 - LL_TIM_IC_FILTER_FDIV1_N2;
-    TIM_InitStruct.CounterMode = LL_TIM_COUNTERMODE_UP;
-    TIM_InitStruct.Autoreload = 65535;
-    TIM_InitStruct.ClockDivision = LL_TIM_CLOCKDIVISION_DIV1;
-    LL_TIM_Init(TIM13, &TIM_InitStruct);
-    LL_TIM_DisableARRPreload(TIM13);
-}
-
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include "tim_driver.h"
+#include "stm32f4xx_ll_tim.h"
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_rcc.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define TIM13_PERIOD 0x10000U
+#define TIM14_COUNTER_HZ 1000000U
+/* Above the kernel interrupts, so critical sections are sampled as well */
+#define TIM14_IRQ_PRIORITY 4
+#define EXCEPTION_NUMBER_MASK 0x1FFU
+#define STACKED_PC 6
+#define STACKED_XPSR 7
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+/* High half of the run time counter, TIM13 itself is only 16 bits wide */
+static volatile uint32_t g_run_time_overflows = 0;
+/* Time TIM13 spent stopped along with the core, added on top of what it counted */
+static volatile uint32_t g_run_time_stopped = 0;
+static volatile tim_sample_callback_t g_sample_callback = NULL;
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+void TIM8_UP_TIM13_IRQHandler (void);
+void TIM8_TRG_COM_TIM14_IRQHandler (void);
+/* Reached from the assembly of the handler, so it keeps its plain name */
+void TIM14_OnSample (const uint32_t *frame) __attribute__((used, noinline));
+static uint32_t TIM_GetApb1Clock (void);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+void TIM8_UP_TIM13_IRQHandler (void) {
+    if (LL_TIM_IsActiveFlag_UPDATE(TIM13)) {
+        LL_TIM_ClearFlag_UPDATE(TIM13);
+        g_run_time_overflows++;
+    }
+}
+
+/* Hands the exception frame of the interrupted code to TIM14_OnSample, from whichever stack it was pushed on. */
+__attribute__((naked)) void TIM8_TRG_COM_TIM14_IRQHandler (void) {
+    __asm volatile (
+        "tst lr, #4         \n"
+        "ite eq             \n"
+        "mrseq r0, msp      \n"
+        "mrsne r0, psp      \n"
+        "b TIM14_OnSample   \n"
+    );
+}
+
+void TIM14_OnSample (const uint32_t *frame) {
+    if (LL_TIM_IsActiveFlag_UPDATE(TIM14) == 0) {
+        return;
+    }
+
+    LL_TIM_ClearFlag_UPDATE(TIM14);
+
+    tim_sample_callback_t callback = g_sample_callback;
+
+    if (callback != NULL) {
+        callback(frame[STACKED_PC], frame[STACKED_XPSR] & EXCEPTION_NUMBER_MASK);
+    }
+}
+
+static uint32_t TIM_GetApb1Clock (void) {
+    LL_RCC_ClocksTypeDef clocks;
+
+    LL_RCC_GetSystemClocksFreq(&clocks);
+
+    /* The APB1 timers run at twice the bus clock whenever the bus is divided */
+    if (LL_RCC_GetAPB1Prescaler() == LL_RCC_APB1_DIV_1) {
+        return clocks.PCLK1_Frequency;
+    }
+
+    return (clocks.PCLK1_Frequency * 2U);
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void configureTimerForRunTimeStats (void) {
+    g_run_time_overflows = 0;
+    g_run_time_stopped = 0;
+    LL_TIM_SetCounter(TIM13, 0);
+    LL_TIM_ClearFlag_UPDATE(TIM13);
+    LL_TIM_EnableIT_UPDATE(TIM13);
+    LL_TIM_EnableCounter(TIM13);
+}
+
+/* Microseconds, wraps after about 71 minutes. The scheduler reads it during a context switch with the TIM13 interrupt
+ * masked, so an overflow that is still pending is counted here. */
+unsigned long getRunTimeCounterValue (void) {
+    uint32_t overflows;
+    uint32_t high;
+    uint32_t counter;
+
+    do {
+        overflows = g_run_time_overflows;
+        counter = LL_TIM_GetCounter(TIM13);
+        high = overflows;
+
+        if ((LL_TIM_IsActiveFlag_UPDATE(TIM13) != 0) && (counter < (TIM13_PERIOD / 2U))) {
+            high++;
+        }
+    } while (overflows != g_run_time_overflows);
+
+    return (((high << 16) | counter) + g_run_time_stopped);
+}
+
+/* Called with interrupts disabled by the idle task on its way out of Stop */
+void TIM13_AddRunTime (uint32_t us) {
+    g_run_time_stopped += us;
+}
+
+void TIM13_Init (void) {
+    LL_TIM_InitTypeDef TIM_InitStruct = {0};
+
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM13);
+
+    NVIC_SetPriority(TIM8_UP_TIM13_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+    NVIC_EnableIRQ(TIM8_UP_TIM13_IRQn);
+
+    TIM_InitStruct.Prescaler = (uint16_t) ((TIM_GetApb1Clock() / TIM_DRIVER_RUN_TIME_HZ) - 1U);
+    TIM_InitStruct.CounterMode = LL_TIM_COUNTERMODE_UP;
+    TIM_InitStruct.Autoreload = TIM13_PERIOD - 1U;
+    TIM_InitStruct.ClockDivision = LL_TIM_CLOCKDIVISION_DIV1;
+    LL_TIM_Init(TIM13, &TIM_InitStruct);
+    LL_TIM_DisableARRPreload(TIM13);
+}
+
+void TIM14_Init (void) {
+    LL_TIM_InitTypeDef TIM_InitStruct = {0};
+
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM14);
+
+    NVIC_SetPriority(TIM8_TRG_COM_TIM14_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), TIM14_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(TIM8_TRG_COM_TIM14_IRQn);
+
+    TIM_InitStruct.Prescaler = (uint16_t) ((TIM_GetApb1Clock() / TIM14_COUNTER_HZ) - 1U);
+    TIM_InitStruct.CounterMode = LL_TIM_COUNTERMODE_UP;
+    TIM_InitStruct.Autoreload = (TIM14_COUNTER_HZ / TIM_DRIVER_SAMPLE_MAX_HZ) - 1U;
+    TIM_InitStruct.ClockDivision = LL_TIM_CLOCKDIVISION_DIV1;
+    LL_TIM_Init(TIM14, &TIM_InitStruct);
+    LL_TIM_DisableARRPreload(TIM14);
+}
+
+/* The callback runs in an interrupt above the kernel ones and must not call into the kernel */
+bool TIM14_StartSampling (uint32_t rate_hz, tim_sample_callback_t callback) {
+    if ((callback == NULL) || (rate_hz < TIM_DRIVER_SAMPLE_MIN_HZ) || (rate_hz > TIM_DRIVER_SAMPLE_MAX_HZ)) {
+        return false;
+    }
+
+    TIM14_StopSampling();
+
+    g_sample_callback = callback;
+    LL_TIM_SetAutoReload(TIM14, (TIM14_COUNTER_HZ / rate_hz) - 1U);
+    LL_TIM_SetCounter(TIM14, 0);
+    LL_TIM_ClearFlag_UPDATE(TIM14);
+    LL_TIM_EnableIT_UPDATE(TIM14);
+    LL_TIM_EnableCounter(TIM14);
+
+    return true;
+}
+
+void TIM14_StopSampling (void) {
+    LL_TIM_DisableCounter(TIM14);
+    LL_TIM_DisableIT_UPDATE(TIM14);
+    LL_TIM_ClearFlag_UPDATE(TIM14);
+    NVIC_ClearPendingIRQ(TIM8_TRG_COM_TIM14_IRQn);
+    g_sample_callback = NULL;
+}
@@ -1,26 +1,39 @@
-#ifndef SOURCE_DRIVER_TIM_DRIVER_H_
-#define SOURCE_DRIVER_TIM_DRIVER_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-void configureTimerForRunTimeStats (void);
-unsigned long getRunTimeCounterValue (void);
-void TIM13_Init (void);
-
-#endif /* SOURCE_DRIVER_TIM_DRIVER_H_ */
+#ifndef SOURCE_DRIVER_TIM_DRIVER_H_
+#define SOURCE_DRIVER_TIM_DRIVER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Rate of the FreeRTOS run time stats counter, TIM13_Init must run after the clock is set up */
+#define TIM_DRIVER_RUN_TIME_HZ 1000000U
+/* TIM14 counts at 1 MHz with a 16 bit reload */
+#define TIM_DRIVER_SAMPLE_MIN_HZ 16U
+#define TIM_DRIVER_SAMPLE_MAX_HZ 20000U
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* The interrupted program counter and exception number, 0 when a task was running */
+typedef void (*tim_sample_callback_t) (uint32_t pc, uint32_t exception);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+void configureTimerForRunTimeStats (void);
+unsigned long getRunTimeCounterValue (void);
+void TIM13_Init (void);
+void TIM13_AddRunTime (uint32_t us);
+void TIM14_Init (void);
+bool TIM14_StartSampling (uint32_t rate_hz, tim_sample_callback_t callback);
+void TIM14_StopSampling (void);
+
+#endif /* SOURCE_DRIVER_TIM_DRIVER_H_ */
@@ -1,27 +1,27 @@
-#ifndef SOURCE_UTILITY_BUFFER_H_
-#define SOURCE_UTILITY_BUFFER_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stdlib.h>
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-typedef struct sBuffer {
-    char *str;
-    size_t size;
-    size_t count;
-} sBuffer_t;
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-
-#endif /* SOURCE_UTILITY_BUFFER_H_ */
+#ifndef SOURCE_UTILITY_BUFFER_H_
+#define SOURCE_UTILITY_BUFFER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdlib.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sBuffer {
+    char *str;
+    size_t size;
+    size_t count;
+} sBuffer_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+#endif /* SOURCE_UTILITY_BUFFER_H_ */
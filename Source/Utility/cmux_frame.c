@@ -0,0 +1,247 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cmux_frame.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define FCS_INIT 0xFF
+#define FCS_GOOD 0xCF
+#define ADDRESS_EA 0x01
+#define ADDRESS_CR 0x02
+#define LENGTH_EA 0x01
+#define MAX_SINGLE_BYTE_LENGTH 127
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+/* 3GPP 27.010 FCS, reversed polynomial x^8 + x^2 + x + 1 */
+static const uint8_t g_fcs_table[256] = {
+    0x00, 0x91, 0xE3, 0x72, 0x07, 0x96, 0xE4, 0x75, 0x0E, 0x9F, 0xED, 0x7C, 0x09, 0x98, 0xEA, 0x7B,
+    0x1C, 0x8D, 0xFF, 0x6E, 0x1B, 0x8A, 0xF8, 0x69, 0x12, 0x83, 0xF1, 0x60, 0x15, 0x84, 0xF6, 0x67,
+    0x38, 0xA9, 0xDB, 0x4A, 0x3F, 0xAE, 0xDC, 0x4D, 0x36, 0xA7, 0xD5, 0x44, 0x31, 0xA0, 0xD2, 0x43,
+    0x24, 0xB5, 0xC7, 0x56, 0x23, 0xB2, 0xC0, 0x51, 0x2A, 0xBB, 0xC9, 0x58, 0x2D, 0xBC, 0xCE, 0x5F,
+    0x70, 0xE1, 0x93, 0x02, 0x77, 0xE6, 0x94, 0x05, 0x7E, 0xEF, 0x9D, 0x0C, 0x79, 0xE8, 0x9A, 0x0B,
+    0x6C, 0xFD, 0x8F, 0x1E, 0x6B, 0xFA, 0x88, 0x19, 0x62, 0xF3, 0x81, 0x10, 0x65, 0xF4, 0x86, 0x17,
+    0x48, 0xD9, 0xAB, 0x3A, 0x4F, 0xDE, 0xAC, 0x3D, 0x46, 0xD7, 0xA5, 0x34, 0x41, 0xD0, 0xA2, 0x33,
+    0x54, 0xC5, 0xB7, 0x26, 0x53, 0xC2, 0xB0, 0x21, 0x5A, 0xCB, 0xB9, 0x28, 0x5D, 0xCC, 0xBE, 0x2F,
+    0xE0, 0x71, 0x03, 0x92, 0xE7, 0x76, 0x04, 0x95, 0xEE, 0x7F, 0x0D, 0x9C, 0xE9, 0x78, 0x0A, 0x9B,
+    0xFC, 0x6D, 0x1F, 0x8E, 0xFB, 0x6A, 0x18, 0x89, 0xF2, 0x63, 0x11, 0x80, 0xF5, 0x64, 0x16, 0x87,
+    0xD8, 0x49, 0x3B, 0xAA, 0xDF, 0x4E, 0x3C, 0xAD, 0xD6, 0x47, 0x35, 0xA4, 0xD1, 0x40, 0x32, 0xA3,
+    0xC4, 0x55, 0x27, 0xB6, 0xC3, 0x52, 0x20, 0xB1, 0xCA, 0x5B, 0x29, 0xB8, 0xCD, 0x5C, 0x2E, 0xBF,
+    0x90, 0x01, 0x73, 0xE2, 0x97, 0x06, 0x74, 0xE5, 0x9E, 0x0F, 0x7D, 0xEC, 0x99, 0x08, 0x7A, 0xEB,
+    0x8C, 0x1D, 0x6F, 0xFE, 0x8B, 0x1A, 0x68, 0xF9, 0x82, 0x13, 0x61, 0xF0, 0x85, 0x14, 0x66, 0xF7,
+    0xA8, 0x39, 0x4B, 0xDA, 0xAF, 0x3E, 0x4C, 0xDD, 0xA6, 0x37, 0x45, 0xD4, 0xA1, 0x30, 0x42, 0xD3,
+    0xB4, 0x25, 0x57, 0xC6, 0xB3, 0x22, 0x50, 0xC1, 0xBA, 0x2B, 0x59, 0xC8, 0xBD, 0x2C, 0x5E, 0xCF,
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static inline uint8_t CmuxFrame_UpdateFcs (uint8_t fcs, uint8_t byte);
+static bool CmuxFrame_Finish (sCmuxDeframer_t *deframer, sCmuxFrame_t *frame);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static inline uint8_t CmuxFrame_UpdateFcs (uint8_t fcs, uint8_t byte) {
+    return g_fcs_table[fcs ^ byte];
+}
+
+static bool CmuxFrame_Finish (sCmuxDeframer_t *deframer, sCmuxFrame_t *frame) {
+    /* Basic mode UIH frames protect only the header, the other frame types cover the information field as well. */
+    uint8_t control = deframer->header[1] & ~CMUX_FRAME_PF;
+
+    if (control != CMUX_FRAME_UIH) {
+        for (size_t i = 0; i < deframer->info_count; i++) {
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, deframer->info[i]);
+        }
+    }
+
+    if (deframer->fcs != FCS_GOOD) {
+        deframer->fcs_errors++;
+        return false;
+    }
+
+    frame->dlci = deframer->header[0] >> 2;
+    frame->is_command = ((deframer->header[0] & ADDRESS_CR) != 0);
+    frame->control = control;
+    frame->poll_final = ((deframer->header[1] & CMUX_FRAME_PF) != 0);
+    frame->info = deframer->info;
+    frame->info_size = deframer->info_count;
+
+    return true;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+uint8_t CmuxFrame_CalculateFcs (const uint8_t *data, size_t size) {
+    uint8_t fcs = FCS_INIT;
+
+    if (data == NULL) {
+        return fcs;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        fcs = CmuxFrame_UpdateFcs(fcs, data[i]);
+    }
+
+    return (uint8_t) (FCS_INIT - fcs);
+}
+
+size_t CmuxFrame_Encode (const sCmuxFrame_t *frame, uint8_t *buffer, size_t buffer_size) {
+    if ((frame == NULL) || (buffer == NULL) || (frame->dlci > CMUX_FRAME_MAX_DLCI) || 
+        ((frame->info == NULL) && (frame->info_size > 0)) || (frame->info_size > CMUX_FRAME_MAX_INFO_SIZE) ||
+        (buffer_size < (frame->info_size + CMUX_FRAME_OVERHEAD))) {
+        return 0;
+    }
+
+    size_t position = 0;
+
+    buffer[position++] = CMUX_FRAME_FLAG;
+    buffer[position++] = (uint8_t) ((frame->dlci << 2) | (frame->is_command ? ADDRESS_CR : 0) | ADDRESS_EA);
+    buffer[position++] = (uint8_t) (frame->control | (frame->poll_final ? CMUX_FRAME_PF : 0));
+    buffer[position++] = (uint8_t) ((frame->info_size << 1) | LENGTH_EA);
+
+    uint8_t fcs = FCS_INIT;
+    for (size_t i = 1; i < position; i++) {
+        fcs = CmuxFrame_UpdateFcs(fcs, buffer[i]);
+    }
+
+    for (size_t i = 0; i < frame->info_size; i++) {
+        buffer[position++] = frame->info[i];
+
+        if (frame->control != CMUX_FRAME_UIH) {
+            fcs = CmuxFrame_UpdateFcs(fcs, frame->info[i]);
+        }
+    }
+
+    buffer[position++] = (uint8_t) (FCS_INIT - fcs);
+    buffer[position++] = CMUX_FRAME_FLAG;
+
+    return position;
+}
+
+void CmuxFrame_ResetDeframer (sCmuxDeframer_t *deframer) {
+    if (deframer == NULL) {
+        return;
+    }
+
+    deframer->state = eCmuxDeframerState_Hunt;
+    deframer->header_size = 0;
+    deframer->info_size = 0;
+    deframer->info_count = 0;
+    deframer->fcs = FCS_INIT;
+}
+
+bool CmuxFrame_Decode (sCmuxDeframer_t *deframer, uint8_t byte, sCmuxFrame_t *frame) {
+    if ((deframer == NULL) || (frame == NULL)) {
+        return false;
+    }
+
+    switch (deframer->state) {
+        case eCmuxDeframerState_Hunt: {
+            if (byte == CMUX_FRAME_FLAG) {
+                CmuxFrame_ResetDeframer(deframer);
+                deframer->state = eCmuxDeframerState_Address;
+            }
+
+            break;
+        }
+        case eCmuxDeframerState_Address: {
+            /* Back to back frames may share one flag or send two, either way an extra flag is skipped. */
+            if (byte == CMUX_FRAME_FLAG) {
+                break;
+            }
+
+            if ((byte & ADDRESS_EA) == 0) {
+                deframer->state = eCmuxDeframerState_Hunt;
+                break;
+            }
+
+            deframer->header[deframer->header_size++] = byte;
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, byte);
+            deframer->state = eCmuxDeframerState_Control;
+            break;
+        }
+        case eCmuxDeframerState_Control: {
+            deframer->header[deframer->header_size++] = byte;
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, byte);
+            deframer->state = eCmuxDeframerState_Length;
+            break;
+        }
+        case eCmuxDeframerState_Length: {
+            deframer->header[deframer->header_size++] = byte;
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, byte);
+            deframer->info_size = byte >> 1;
+
+            if ((byte & LENGTH_EA) == 0) {
+                deframer->state = eCmuxDeframerState_LengthHigh;
+                break;
+            }
+
+            deframer->state = (deframer->info_size > 0) ? eCmuxDeframerState_Info : eCmuxDeframerState_Fcs;
+            break;
+        }
+        case eCmuxDeframerState_LengthHigh: {
+            deframer->header[deframer->header_size++] = byte;
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, byte);
+            deframer->info_size |= ((size_t) byte) << 7;
+
+            if (deframer->info_size > CMUX_FRAME_MAX_INFO_SIZE) {
+                deframer->oversized++;
+                deframer->state = eCmuxDeframerState_Hunt;
+                break;
+            }
+
+            deframer->state = (deframer->info_size > 0) ? eCmuxDeframerState_Info : eCmuxDeframerState_Fcs;
+            break;
+        }
+        case eCmuxDeframerState_Info: {
+            deframer->info[deframer->info_count++] = byte;
+
+            if (deframer->info_count == deframer->info_size) {
+                deframer->state = eCmuxDeframerState_Fcs;
+            }
+
+            break;
+        }
+        case eCmuxDeframerState_Fcs: {
+            deframer->fcs = CmuxFrame_UpdateFcs(deframer->fcs, byte);
+            deframer->state = eCmuxDeframerState_Flag;
+            break;
+        }
+        case eCmuxDeframerState_Flag: {
+            if (byte != CMUX_FRAME_FLAG) {
+                deframer->state = eCmuxDeframerState_Hunt;
+                break;
+            }
+
+            bool is_frame_valid = CmuxFrame_Finish(deframer, frame);
+
+            /* The closing flag may also open the next frame. */
+            CmuxFrame_ResetDeframer(deframer);
+            deframer->state = eCmuxDeframerState_Address;
+
+            return is_frame_valid;
+        }
+        default: {
+            CmuxFrame_ResetDeframer(deframer);
+            break;
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
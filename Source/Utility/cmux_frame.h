@@ -0,0 +1,73 @@
+#ifndef SOURCE_UTILITY_CMUX_FRAME_H_
+#define SOURCE_UTILITY_CMUX_FRAME_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define CMUX_FRAME_FLAG 0xF9
+#define CMUX_FRAME_MAX_INFO_SIZE 127
+#define CMUX_FRAME_OVERHEAD 6
+#define CMUX_FRAME_MAX_SIZE (CMUX_FRAME_MAX_INFO_SIZE + CMUX_FRAME_OVERHEAD)
+#define CMUX_FRAME_MAX_DLCI 63
+
+/* Control field values, without the P/F bit */
+#define CMUX_FRAME_SABM 0x2F
+#define CMUX_FRAME_UA 0x63
+#define CMUX_FRAME_DM 0x0F
+#define CMUX_FRAME_DISC 0x43
+#define CMUX_FRAME_UIH 0xEF
+#define CMUX_FRAME_UI 0x03
+#define CMUX_FRAME_PF 0x10
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eCmuxDeframerState {
+    eCmuxDeframerState_First = 0,
+    eCmuxDeframerState_Hunt = eCmuxDeframerState_First,
+    eCmuxDeframerState_Address,
+    eCmuxDeframerState_Control,
+    eCmuxDeframerState_Length,
+    eCmuxDeframerState_LengthHigh,
+    eCmuxDeframerState_Info,
+    eCmuxDeframerState_Fcs,
+    eCmuxDeframerState_Flag,
+    eCmuxDeframerState_Last
+} eCmuxDeframerState_t;
+
+typedef struct sCmuxFrame {
+    uint8_t dlci;
+    uint8_t control;
+    bool is_command;
+    bool poll_final;
+    const uint8_t *info;
+    size_t info_size;
+} sCmuxFrame_t;
+
+typedef struct sCmuxDeframer {
+    eCmuxDeframerState_t state;
+    uint8_t header[4];
+    size_t header_size;
+    size_t info_size;
+    size_t info_count;
+    uint8_t fcs;
+    uint8_t info[CMUX_FRAME_MAX_INFO_SIZE];
+    uint32_t fcs_errors;
+    uint32_t oversized;
+} sCmuxDeframer_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+uint8_t CmuxFrame_CalculateFcs (const uint8_t *data, size_t size);
+size_t CmuxFrame_Encode (const sCmuxFrame_t *frame, uint8_t *buffer, size_t buffer_size);
+void CmuxFrame_ResetDeframer (sCmuxDeframer_t *deframer);
+bool CmuxFrame_Decode (sCmuxDeframer_t *deframer, uint8_t byte, sCmuxFrame_t *frame);
+#endif /* SOURCE_UTILITY_CMUX_FRAME_H_ */
@@ -0,0 +1,93 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "date_time.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define UNIX_EPOCH_YEAR 1970
+#define MAX_YEAR 2105
+/* Days from 0000-03-01 to 1970-01-01 in the proleptic Gregorian calendar */
+#define UNIX_EPOCH_DAYS 719468
+#define DAYS_PER_ERA 146097
+#define YEARS_PER_ERA 400
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const uint8_t g_days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool DateTime_IsLeapYear (uint32_t year);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool DateTime_IsLeapYear (uint32_t year) {
+    return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool DateTime_IsValid (const sDateTime_t *date_time) {
+    if ((date_time == NULL) || (date_time->year < UNIX_EPOCH_YEAR) || (date_time->year > MAX_YEAR) ||
+        (date_time->month < 1) || (date_time->month > 12) || (date_time->day < 1) ||
+        (date_time->hour > 23) || (date_time->minute > 59) || (date_time->second > 59)) {
+        return false;
+    }
+
+    uint8_t days_in_month = g_days_in_month[date_time->month - 1];
+    if ((date_time->month == 2) && DateTime_IsLeapYear(date_time->year)) {
+        days_in_month++;
+    }
+
+    return (date_time->day <= days_in_month);
+}
+
+/* Era based day count, the year starts in March so the leap day is the last day of the year. */
+uint32_t DateTime_ToUnix (const sDateTime_t *date_time) {
+    uint32_t year = date_time->year - ((date_time->month <= 2) ? 1 : 0);
+    uint32_t era = year / YEARS_PER_ERA;
+    uint32_t year_of_era = year - (era * YEARS_PER_ERA);
+    uint32_t month = (date_time->month > 2) ? (date_time->month - 3) : (date_time->month + 9);
+    uint32_t day_of_year = (((153 * month) + 2) / 5) + date_time->day - 1;
+    uint32_t day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+    uint32_t days = (era * DAYS_PER_ERA) + day_of_era - UNIX_EPOCH_DAYS;
+
+    return (days * DATE_TIME_SECONDS_PER_DAY) + (date_time->hour * 3600U) + (date_time->minute * 60U) + date_time->second;
+}
+
+void DateTime_FromUnix (uint32_t unix_time, sDateTime_t *date_time) {
+    if (date_time == NULL) {
+        return;
+    }
+
+    uint32_t seconds = unix_time % DATE_TIME_SECONDS_PER_DAY;
+    uint32_t days = (unix_time / DATE_TIME_SECONDS_PER_DAY) + UNIX_EPOCH_DAYS;
+    uint32_t era = days / DAYS_PER_ERA;
+    uint32_t day_of_era = days - (era * DAYS_PER_ERA);
+    uint32_t year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+    uint32_t day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+    uint32_t month = ((5 * day_of_year) + 2) / 153;
+
+    date_time->day = (uint8_t) (day_of_year - (((153 * month) + 2) / 5) + 1);
+    date_time->month = (uint8_t) ((month < 10) ? (month + 3) : (month - 9));
+    date_time->year = (uint16_t) ((era * YEARS_PER_ERA) + year_of_era + ((date_time->month <= 2) ? 1 : 0));
+    date_time->hour = (uint8_t) (seconds / 3600);
+    date_time->minute = (uint8_t) ((seconds / 60) % 60);
+    date_time->second = (uint8_t) (seconds % 60);
+}
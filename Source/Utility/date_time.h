@@ -0,0 +1,34 @@
+#ifndef SOURCE_UTILITY_DATE_TIME_H_
+#define SOURCE_UTILITY_DATE_TIME_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define DATE_TIME_SECONDS_PER_DAY 86400U
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sDateTime {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+} sDateTime_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool DateTime_IsValid (const sDateTime_t *date_time);
+/* Seconds since 1970-01-01 00:00:00 UTC, valid until 2106 */
+uint32_t DateTime_ToUnix (const sDateTime_t *date_time);
+void DateTime_FromUnix (uint32_t unix_time, sDateTime_t *date_time);
+#endif /* SOURCE_UTILITY_DATE_TIME_H_ */
@@ -0,0 +1,441 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "geodesy.h"
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#endif
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+/* 2^32 / 360e7 angle units per 1e-7 deg, as a Q31 factor */
+#define ANGLE_PER_DEGREE_E7_Q31 2562047788LL
+/* pi in Q29, turns an eighth of a turn into Q31 radians */
+#define PI_Q29 1686629713LL
+#define QUARTER_TURN 0x40000000UL
+#define EIGHTH_TURN 0x20000000UL
+#define FULL_CIRCLE_DEGREES_E7 3600000000LL
+#define HALF_CIRCLE_DEGREES_E7 1800000000LL
+/* 1e-7 deg of arc on the mean earth radius of 6371008.8 m is 1.11195 cm, as a Q30 factor */
+#define CM_PER_DEGREE_E7_Q30 1193948083ULL
+/* The haversine yields half the central angle, 4 * pi * R / 2^32 cm per angle unit as a Q32 factor */
+#define CM_PER_HALF_ANGLE_Q32 8006045777ULL
+/* 2 * R / 2^31 cm per Q31 radian of the half angle, as a Q32 factor */
+#define CM_PER_HALF_RADIAN_Q32 2548403520ULL
+/* Below about 100 km the half angle comes from the asin series, CORDIC rounding would be tens of cm there */
+#define SMALL_ANGLE_LIMIT_Q31 (1UL << 25)
+#define Q62_ONE (1ULL << 62)
+#define CORDIC_ITERATIONS 30
+/* Largest bit the CORDIC input may use, leaves headroom for the sqrt(2) and the 1.647 gain */
+#define CORDIC_INPUT_BITS 29
+#define CENTIDEGREES_PER_TURN 36000ULL
+/* Hops under about 1 km take the bearing on the local plane, there the angle units are coarser than the input */
+#define SHORT_HOP_DEGREES_E7 100000
+#define SHORT_HOP_EAST_SHIFT 18
+#define SHORT_HOP_NORTH_SHIFT 13
+#define MS_PER_S 1000ULL
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+/* Taylor coefficients, halved so every Horner step is a single multiply high and accumulate */
+static const int32_t g_sine_coefficients[] = {-178956971, 8947849, -213044, 2959, -27};
+static const int32_t g_cosine_coefficients[] = {44739243, -1491308, 26631, -296, 2};
+/* atan(2^-i) in angle units */
+static const uint32_t g_cordic_angles[CORDIC_ITERATIONS] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465, 10679838, 5340245, 2670163, 1335087,
+    667544, 333772, 166886, 83443, 41722, 20861, 10430, 5215, 2608, 1304,
+    652, 326, 163, 81, 41, 20, 10, 5, 3, 1
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static inline int32_t Geodesy_MulHighAdd (int32_t a, int32_t b, int32_t accumulator);
+static inline int32_t Geodesy_MulQ31 (int32_t a, int32_t b);
+static inline int32_t Geodesy_AddSaturate (int32_t a, int32_t b);
+static inline int32_t Geodesy_SubSaturate (int32_t a, int32_t b);
+static inline uint32_t Geodesy_LeadingZeros (uint32_t value);
+static int32_t Geodesy_Polynomial (const int32_t *coefficients, size_t count, int32_t x2);
+static void Geodesy_SinCosKernel (uint32_t angle, int32_t *sine, int32_t *cosine);
+static void Geodesy_SinCos (uint32_t angle, int32_t *sine, int32_t *cosine);
+static int64_t Geodesy_LongitudeDelta (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+static int32_t Geodesy_DegreesToCm (int64_t degrees);
+static uint16_t Geodesy_AngleToCentidegrees (uint32_t angle);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* accumulator + (a * b) / 2^32, SMMLA on the M4 */
+static inline int32_t Geodesy_MulHighAdd (int32_t a, int32_t b, int32_t accumulator) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __SMMLA(a, b, accumulator);
+#else
+    return (int32_t) (((int64_t) a * b) >> 32) + accumulator;
+#endif
+}
+
+static inline int32_t Geodesy_MulQ31 (int32_t a, int32_t b) {
+    return Geodesy_MulHighAdd(a, b, 0) * 2;
+}
+
+static inline int32_t Geodesy_AddSaturate (int32_t a, int32_t b) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __QADD(a, b);
+#else
+    int64_t sum = (int64_t) a + b;
+
+    return (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : (int32_t) sum);
+#endif
+}
+
+static inline int32_t Geodesy_SubSaturate (int32_t a, int32_t b) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __QSUB(a, b);
+#else
+    int64_t difference = (int64_t) a - b;
+
+    return (difference > INT32_MAX) ? INT32_MAX : ((difference < INT32_MIN) ? INT32_MIN : (int32_t) difference);
+#endif
+}
+
+static inline uint32_t Geodesy_LeadingZeros (uint32_t value) {
+    if (value == 0) {
+        return 32;
+    }
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __CLZ(value);
+#else
+    uint32_t count = 0;
+
+    while ((value & 0x80000000UL) == 0) {
+        value <<= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+/* Horner on the halved coefficients, returns the polynomial in x^2 at full Q31 scale */
+static int32_t Geodesy_Polynomial (const int32_t *coefficients, size_t count, int32_t x2) {
+    int32_t half = coefficients[count - 1];
+
+    for (size_t i = count - 1; i > 0; i--) {
+        half = Geodesy_MulHighAdd(x2, half * 2, coefficients[i - 1]);
+    }
+
+    return half * 2;
+}
+
+/* Angle up to an eighth of a turn, where both series converge within a couple of LSB */
+static void Geodesy_SinCosKernel (uint32_t angle, int32_t *sine, int32_t *cosine) {
+    int32_t x = (int32_t) (((int64_t) angle * PI_Q29) >> 29);
+    int32_t x2 = Geodesy_MulQ31(x, x);
+
+    int32_t x3 = Geodesy_MulQ31(x, x2);
+    *sine = Geodesy_AddSaturate(x, Geodesy_MulQ31(x3, Geodesy_Polynomial(g_sine_coefficients, 5, x2)));
+
+    int32_t x4 = Geodesy_MulQ31(x2, x2);
+    int32_t cosine_value = Geodesy_SubSaturate(GEODESY_Q31_ONE, x2 / 2);
+    *cosine = Geodesy_AddSaturate(cosine_value, Geodesy_MulQ31(x4, Geodesy_Polynomial(g_cosine_coefficients, 5, x2)));
+}
+
+/* Folds the angle into the first eighth of a turn and maps the kernel back by quadrant */
+static void Geodesy_SinCos (uint32_t angle, int32_t *sine, int32_t *cosine) {
+    uint32_t quadrant = angle >> 30;
+    uint32_t remainder = angle & (QUARTER_TURN - 1);
+    int32_t s;
+    int32_t c;
+
+    if (remainder <= EIGHTH_TURN) {
+        Geodesy_SinCosKernel(remainder, &s, &c);
+    } else {
+        Geodesy_SinCosKernel(QUARTER_TURN - remainder, &c, &s);
+    }
+
+    switch (quadrant) {
+        case 0: {
+            *sine = s;
+            *cosine = c;
+            break;
+        }
+        case 1: {
+            *sine = c;
+            *cosine = -s;
+            break;
+        }
+        case 2: {
+            *sine = -s;
+            *cosine = -c;
+            break;
+        }
+        default: {
+            *sine = -c;
+            *cosine = s;
+            break;
+        }
+    }
+}
+
+/* Shortest way around, in 1e-7 deg */
+static int64_t Geodesy_LongitudeDelta (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    int64_t delta = (int64_t) to->longitude - from->longitude;
+
+    if (delta > HALF_CIRCLE_DEGREES_E7) {
+        delta -= FULL_CIRCLE_DEGREES_E7;
+    } else if (delta < -HALF_CIRCLE_DEGREES_E7) {
+        delta += FULL_CIRCLE_DEGREES_E7;
+    }
+
+    return delta;
+}
+
+static int32_t Geodesy_DegreesToCm (int64_t degrees) {
+    return (int32_t) ((degrees * (int64_t) CM_PER_DEGREE_E7_Q30) >> 30);
+}
+
+static uint16_t Geodesy_AngleToCentidegrees (uint32_t angle) {
+    uint32_t centidegrees = (uint32_t) ((((uint64_t) angle * CENTIDEGREES_PER_TURN) + (1ULL << 31)) >> 32);
+
+    return (uint16_t) ((centidegrees >= CENTIDEGREES_PER_TURN) ? 0 : centidegrees);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+uint32_t Geodesy_DegreesToAngle (int32_t degrees) {
+    return (uint32_t) (((int64_t) degrees * ANGLE_PER_DEGREE_E7_Q31) >> 31);
+}
+
+int32_t Geodesy_Sin (uint32_t angle) {
+    int32_t sine;
+    int32_t cosine;
+
+    Geodesy_SinCos(angle, &sine, &cosine);
+
+    return sine;
+}
+
+int32_t Geodesy_Cos (uint32_t angle) {
+    int32_t sine;
+    int32_t cosine;
+
+    Geodesy_SinCos(angle, &sine, &cosine);
+
+    return cosine;
+}
+
+/* CORDIC in vectoring mode. The vector is normalised first so short inputs keep their resolution. */
+uint32_t Geodesy_Atan2 (int32_t y, int32_t x) {
+    if ((x == 0) && (y == 0)) {
+        return 0;
+    }
+
+    uint32_t magnitude = ((x < 0) ? (0U - (uint32_t) x) : (uint32_t) x) | ((y < 0) ? (0U - (uint32_t) y) : (uint32_t) y);
+    int32_t shift = (int32_t) Geodesy_LeadingZeros(magnitude) - (32 - CORDIC_INPUT_BITS);
+
+    if (shift > 0) {
+        x = (int32_t) ((uint32_t) x << shift);
+        y = (int32_t) ((uint32_t) y << shift);
+    } else if (shift < 0) {
+        x >>= -shift;
+        y >>= -shift;
+    }
+
+    uint32_t angle = 0;
+
+    if (x < 0) {
+        angle = GEODESY_ANGLE_HALF_TURN;
+        x = -x;
+        y = -y;
+    }
+
+    for (size_t i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t next_x;
+
+        if (y > 0) {
+            next_x = x + (y >> i);
+            y -= x >> i;
+            angle += g_cordic_angles[i];
+        } else {
+            next_x = x - (y >> i);
+            y += x >> i;
+            angle -= g_cordic_angles[i];
+        }
+
+        x = next_x;
+    }
+
+    return angle;
+}
+
+uint32_t Geodesy_Sqrt (uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= (root + bit)) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (uint32_t) root;
+}
+
+/* The atan2 form of the haversine, a is summed in Q62 so metre scale distances do not vanish in the squares. */
+uint32_t Geodesy_HaversineDistance (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    if ((from == NULL) || (to == NULL)) {
+        return 0;
+    }
+
+    uint32_t from_latitude = Geodesy_DegreesToAngle(from->latitude);
+    uint32_t to_latitude = Geodesy_DegreesToAngle(to->latitude);
+    int32_t delta_latitude = (int32_t) (to_latitude - from_latitude);
+    int32_t delta_longitude = (int32_t) (Geodesy_DegreesToAngle(to->longitude) - Geodesy_DegreesToAngle(from->longitude));
+    int32_t half_latitude_sine;
+    int32_t half_longitude_sine;
+    int32_t from_cosine;
+    int32_t to_cosine;
+    int32_t unused;
+
+    Geodesy_SinCos((uint32_t) (delta_latitude / 2), &half_latitude_sine, &unused);
+    Geodesy_SinCos((uint32_t) (delta_longitude / 2), &half_longitude_sine, &unused);
+    Geodesy_SinCos(from_latitude, &unused, &from_cosine);
+    Geodesy_SinCos(to_latitude, &unused, &to_cosine);
+
+    int32_t cosine_product = Geodesy_MulQ31(from_cosine, to_cosine);
+    int32_t cosine_root = (cosine_product > 0) ? (int32_t) Geodesy_Sqrt((uint64_t) cosine_product << 31) : 0;
+    int32_t scaled_longitude = (int32_t) (((int64_t) cosine_root * half_longitude_sine) >> 31);
+
+    uint64_t a = ((uint64_t) ((int64_t) half_latitude_sine * half_latitude_sine)) +
+                 ((uint64_t) ((int64_t) scaled_longitude * scaled_longitude));
+    if (a > Q62_ONE) {
+        a = Q62_ONE;
+    }
+
+    uint32_t a_root = Geodesy_Sqrt(a);
+
+    if (a_root < SMALL_ANGLE_LIMIT_Q31) {
+        /* asin(s) = s + s^3 / 6, the next term is below a millimetre at the limit */
+        uint64_t half_radians = a_root + ((((uint64_t) a_root * a_root) >> 31) * a_root) / (6ULL << 31);
+
+        return (uint32_t) ((half_radians * CM_PER_HALF_RADIAN_Q32) >> 32);
+    }
+
+    uint32_t complement_root = Geodesy_Sqrt(Q62_ONE - a);
+    uint32_t half_angle = Geodesy_Atan2((int32_t) ((a_root > INT32_MAX) ? INT32_MAX : a_root),
+                                        (int32_t) ((complement_root > INT32_MAX) ? INT32_MAX : complement_root));
+
+    return (uint32_t) (((uint64_t) half_angle * CM_PER_HALF_ANGLE_Q32) >> 32);
+}
+
+uint32_t Geodesy_EquirectangularDistance (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    if ((from == NULL) || (to == NULL)) {
+        return 0;
+    }
+
+    int64_t delta_latitude = (int64_t) to->latitude - from->latitude;
+    int32_t mean_latitude = (int32_t) (from->latitude + (delta_latitude / 2));
+    int64_t delta_longitude = (Geodesy_LongitudeDelta(from, to) * Geodesy_Cos(Geodesy_DegreesToAngle(mean_latitude))) >> 31;
+    uint32_t distance = Geodesy_Sqrt((uint64_t) ((delta_longitude * delta_longitude) + (delta_latitude * delta_latitude)));
+
+    return (uint32_t) (((uint64_t) distance * CM_PER_DEGREE_E7_Q30) >> 30);
+}
+
+/* x is rewritten as sin(dlat) + sin(lat1) * cos(lat2) * versin(dlon) to stay exact for short hops, both sides are
+ * halved so the sum cannot overflow Q31. */
+uint16_t Geodesy_Bearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    if ((from == NULL) || (to == NULL)) {
+        return 0;
+    }
+
+    int64_t delta_latitude_degrees = (int64_t) to->latitude - from->latitude;
+    int64_t delta_longitude_degrees = Geodesy_LongitudeDelta(from, to);
+
+    if ((delta_latitude_degrees > -SHORT_HOP_DEGREES_E7) && (delta_latitude_degrees < SHORT_HOP_DEGREES_E7) &&
+        (delta_longitude_degrees > -SHORT_HOP_DEGREES_E7) && (delta_longitude_degrees < SHORT_HOP_DEGREES_E7)) {
+        int32_t mean_latitude = (int32_t) (from->latitude + (delta_latitude_degrees / 2));
+        int32_t east = (int32_t) ((delta_longitude_degrees * Geodesy_Cos(Geodesy_DegreesToAngle(mean_latitude))) >> SHORT_HOP_EAST_SHIFT);
+        int32_t north = (int32_t) (delta_latitude_degrees * (1 << SHORT_HOP_NORTH_SHIFT));
+
+        return Geodesy_AngleToCentidegrees(Geodesy_Atan2(east, north));
+    }
+
+    uint32_t from_latitude = Geodesy_DegreesToAngle(from->latitude);
+    uint32_t to_latitude = Geodesy_DegreesToAngle(to->latitude);
+    int32_t delta_longitude = (int32_t) (Geodesy_DegreesToAngle(to->longitude) - Geodesy_DegreesToAngle(from->longitude));
+    int32_t from_sine;
+    int32_t from_cosine;
+    int32_t to_sine;
+    int32_t to_cosine;
+    int32_t latitude_sine;
+    int32_t longitude_sine;
+    int32_t half_longitude_sine;
+    int32_t unused;
+
+    Geodesy_SinCos(from_latitude, &from_sine, &from_cosine);
+    Geodesy_SinCos(to_latitude, &to_sine, &to_cosine);
+    Geodesy_SinCos(to_latitude - from_latitude, &latitude_sine, &unused);
+    Geodesy_SinCos((uint32_t) delta_longitude, &longitude_sine, &unused);
+    Geodesy_SinCos((uint32_t) (delta_longitude / 2), &half_longitude_sine, &unused);
+
+    int32_t y = Geodesy_MulQ31(longitude_sine, to_cosine) / 2;
+    int32_t versine_half = Geodesy_MulQ31(half_longitude_sine, half_longitude_sine);
+    int32_t x = Geodesy_AddSaturate(latitude_sine / 2, Geodesy_MulQ31(Geodesy_MulQ31(from_sine, to_cosine), versine_half));
+
+    return Geodesy_AngleToCentidegrees(Geodesy_Atan2(y, x));
+}
+
+uint16_t Geodesy_Speed (uint32_t distance_cm, uint32_t elapsed_ms) {
+    if (elapsed_ms == 0) {
+        return 0;
+    }
+
+    uint64_t speed = ((uint64_t) distance_cm * MS_PER_S) / elapsed_ms;
+
+    return (speed > UINT16_MAX) ? UINT16_MAX : (uint16_t) speed;
+}
+
+void Geodesy_SetReference (sGeodesyReference_t *reference, const sGeodesyPoint_t *origin, int32_t altitude) {
+    if ((reference == NULL) || (origin == NULL)) {
+        return;
+    }
+
+    reference->origin = *origin;
+    reference->altitude = altitude;
+    reference->cos_latitude = Geodesy_Cos(Geodesy_DegreesToAngle(origin->latitude));
+}
+
+void Geodesy_ToEnu (const sGeodesyReference_t *reference, const sGeodesyPoint_t *point, int32_t altitude, sGeodesyEnu_t *enu) {
+    if ((reference == NULL) || (point == NULL) || (enu == NULL)) {
+        return;
+    }
+
+    int64_t delta_longitude = Geodesy_LongitudeDelta(&reference->origin, point);
+
+    enu->east = Geodesy_DegreesToCm((delta_longitude * reference->cos_latitude) >> 31);
+    enu->north = Geodesy_DegreesToCm((int64_t) point->latitude - reference->origin.latitude);
+    enu->up = altitude - reference->altitude;
+}
@@ -0,0 +1,60 @@
+#ifndef SOURCE_UTILITY_GEODESY_H_
+#define SOURCE_UTILITY_GEODESY_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Angles are binary: a full turn is 2^32, so differences wrap around the antimeridian for free */
+#define GEODESY_ANGLE_HALF_TURN 0x80000000UL
+#define GEODESY_Q31_ONE INT32_MAX
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Coordinates in 1e-7 deg, same as sNmeaFix_t */
+typedef struct sGeodesyPoint {
+    int32_t latitude;
+    int32_t longitude;
+} sGeodesyPoint_t;
+
+/* Tangent plane origin, the cosine is taken once so projecting a point is a few multiplies */
+typedef struct sGeodesyReference {
+    sGeodesyPoint_t origin;
+    int32_t altitude;
+    int32_t cos_latitude;
+} sGeodesyReference_t;
+
+/* East, north and up from the reference in cm */
+typedef struct sGeodesyEnu {
+    int32_t east;
+    int32_t north;
+    int32_t up;
+} sGeodesyEnu_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+uint32_t Geodesy_DegreesToAngle (int32_t degrees);
+/* Q31 results, accurate to a few LSB over the full turn */
+int32_t Geodesy_Sin (uint32_t angle);
+int32_t Geodesy_Cos (uint32_t angle);
+uint32_t Geodesy_Atan2 (int32_t y, int32_t x);
+uint32_t Geodesy_Sqrt (uint64_t value);
+/* Great circle distance in cm on the mean earth radius, good at any range */
+uint32_t Geodesy_HaversineDistance (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+/* Flat earth distance in cm, cheaper and within 0.1% up to some tens of km */
+uint32_t Geodesy_EquirectangularDistance (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+/* Initial great circle bearing in 0.01 deg clockwise from north, same as the NMEA course */
+uint16_t Geodesy_Bearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+/* cm/s, which is the 0.01 m/s of the NMEA speed, saturated to the type */
+uint16_t Geodesy_Speed (uint32_t distance_cm, uint32_t elapsed_ms);
+void Geodesy_SetReference (sGeodesyReference_t *reference, const sGeodesyPoint_t *origin, int32_t altitude);
+/* Altitudes in cm. The local plane is for short ranges, use the haversine for anything beyond a few km. */
+void Geodesy_ToEnu (const sGeodesyReference_t *reference, const sGeodesyPoint_t *point, int32_t altitude, sGeodesyEnu_t *enu);
+#endif /* SOURCE_UTILITY_GEODESY_H_ */
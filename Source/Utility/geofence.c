@@ -0,0 +1,395 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "geodesy.h"
+#include "geofence.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+/* Keeps the crossing test products within 2^60, about 107 deg of latitude or longitude */
+#define MAX_FENCE_SPAN (1UL << 30)
+#define NO_CELL GEOFENCE_GRID_CELLS
+#define MAX_PENDING UINT8_MAX
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Geofence_IsInBox (const sGeofenceBox_t *box, const sGeodesyPoint_t *position);
+static bool Geofence_CheckFence (const sGeofence_t *geofence, const sGeofenceRecord_t *fence, size_t vertex_count);
+static size_t Geofence_GetRow (const sGeofence_t *geofence, int32_t latitude);
+static size_t Geofence_GetColumn (const sGeofence_t *geofence, int32_t longitude);
+static size_t Geofence_FindCell (const sGeofence_t *geofence, const sGeodesyPoint_t *position);
+static bool Geofence_BuildIndex (sGeofence_t *geofence);
+static bool Geofence_Test (sGeofence_t *geofence, size_t index, const sGeodesyPoint_t *position);
+static void Geofence_Track (sGeofence_t *geofence, size_t index);
+static size_t Geofence_Observe (sGeofence_t *geofence, size_t index, bool is_inside, const sGeodesyPoint_t *position,
+                                uint32_t timestamp, sGeofenceAlert_t *alerts, size_t alert_count);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Geofence_IsInBox (const sGeofenceBox_t *box, const sGeodesyPoint_t *position) {
+    return (position->latitude >= box->min_latitude) && (position->latitude <= box->max_latitude) &&
+           (position->longitude >= box->min_longitude) && (position->longitude <= box->max_longitude);
+}
+
+/* The box in the record has to be the exact box of the vertices, a torn or hand edited image fails here. */
+static bool Geofence_CheckFence (const sGeofence_t *geofence, const sGeofenceRecord_t *fence, size_t vertex_count) {
+    if ((fence->vertex_count < GEOFENCE_MIN_VERTICES) || (fence->first_vertex > vertex_count) ||
+        (fence->vertex_count > (vertex_count - fence->first_vertex))) {
+        return false;
+    }
+
+    const sGeodesyPoint_t *vertex = &geofence->vertices[fence->first_vertex];
+    sGeofenceBox_t box = {
+        .min_latitude = vertex->latitude,
+        .min_longitude = vertex->longitude,
+        .max_latitude = vertex->latitude,
+        .max_longitude = vertex->longitude
+    };
+
+    for (size_t i = 1; i < fence->vertex_count; i++) {
+        vertex++;
+        box.min_latitude = (vertex->latitude < box.min_latitude) ? vertex->latitude : box.min_latitude;
+        box.max_latitude = (vertex->latitude > box.max_latitude) ? vertex->latitude : box.max_latitude;
+        box.min_longitude = (vertex->longitude < box.min_longitude) ? vertex->longitude : box.min_longitude;
+        box.max_longitude = (vertex->longitude > box.max_longitude) ? vertex->longitude : box.max_longitude;
+    }
+
+    if (memcmp(&box, &fence->box, sizeof(box)) != 0) {
+        return false;
+    }
+
+    return (((uint32_t) box.max_latitude - (uint32_t) box.min_latitude) < MAX_FENCE_SPAN) &&
+           (((uint32_t) box.max_longitude - (uint32_t) box.min_longitude) < MAX_FENCE_SPAN);
+}
+
+static size_t Geofence_GetRow (const sGeofence_t *geofence, int32_t latitude) {
+    size_t row = ((uint32_t) latitude - (uint32_t) geofence->bounds.min_latitude) / geofence->cell_height;
+
+    return (row < GEOFENCE_GRID_SIZE) ? row : (GEOFENCE_GRID_SIZE - 1);
+}
+
+static size_t Geofence_GetColumn (const sGeofence_t *geofence, int32_t longitude) {
+    size_t column = ((uint32_t) longitude - (uint32_t) geofence->bounds.min_longitude) / geofence->cell_width;
+
+    return (column < GEOFENCE_GRID_SIZE) ? column : (GEOFENCE_GRID_SIZE - 1);
+}
+
+static size_t Geofence_FindCell (const sGeofence_t *geofence, const sGeodesyPoint_t *position) {
+    if ((geofence->fence_count == 0) || (Geofence_IsInBox(&geofence->bounds, position) == false)) {
+        return NO_CELL;
+    }
+
+    return (Geofence_GetRow(geofence, position->latitude) * GEOFENCE_GRID_SIZE) +
+           Geofence_GetColumn(geofence, position->longitude);
+}
+
+/* Every fence is listed in each cell its box overlaps. The first pass counts, the counts are turned into cell ends
+ * and the second pass fills each cell from the back, which leaves cell_start at the start of every cell. */
+static bool Geofence_BuildIndex (sGeofence_t *geofence) {
+    geofence->cell_height = (((uint32_t) geofence->bounds.max_latitude - (uint32_t) geofence->bounds.min_latitude) / GEOFENCE_GRID_SIZE) + 1;
+    geofence->cell_width = (((uint32_t) geofence->bounds.max_longitude - (uint32_t) geofence->bounds.min_longitude) / GEOFENCE_GRID_SIZE) + 1;
+
+    size_t entries = 0;
+
+    for (size_t pass = 0; pass < 2; pass++) {
+        for (size_t index = geofence->fence_count; index > 0; index--) {
+            const sGeofenceBox_t *box = &geofence->fences[index - 1].box;
+            size_t last_row = Geofence_GetRow(geofence, box->max_latitude);
+            size_t last_column = Geofence_GetColumn(geofence, box->max_longitude);
+
+            for (size_t row = Geofence_GetRow(geofence, box->min_latitude); row <= last_row; row++) {
+                for (size_t column = Geofence_GetColumn(geofence, box->min_longitude); column <= last_column; column++) {
+                    size_t cell = (row * GEOFENCE_GRID_SIZE) + column;
+
+                    if (pass == 0) {
+                        if (++entries > GEOFENCE_MAX_CELL_ENTRIES) {
+                            return false;
+                        }
+
+                        geofence->cell_start[cell]++;
+                    } else {
+                        geofence->cell_fences[--geofence->cell_start[cell]] = (uint16_t) (index - 1);
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (size_t cell = 1; cell <= GEOFENCE_GRID_CELLS; cell++) {
+                geofence->cell_start[cell] += geofence->cell_start[cell - 1];
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool Geofence_Test (sGeofence_t *geofence, size_t index, const sGeodesyPoint_t *position) {
+    const sGeofenceRecord_t *fence = &geofence->fences[index];
+
+    if (Geofence_IsInBox(&fence->box, position) == false) {
+        return false;
+    }
+
+    geofence->stats.polygon_tests++;
+
+    return Geofence_IsInside(position, &geofence->vertices[fence->first_vertex], fence->vertex_count);
+}
+
+static void Geofence_Track (sGeofence_t *geofence, size_t index) {
+    sGeofenceState_t *state = &geofence->state[index];
+
+    if (state->is_active == true) {
+        return;
+    }
+
+    if (geofence->active_count == GEOFENCE_MAX_ACTIVE) {
+        geofence->stats.untracked++;
+        return;
+    }
+
+    geofence->active[geofence->active_count++] = (uint16_t) index;
+    state->is_active = true;
+}
+
+/* A fence only changes state after hysteresis fixes in a row disagree with it. Returns the new alert count. */
+static size_t Geofence_Observe (sGeofence_t *geofence, size_t index, bool is_inside, const sGeodesyPoint_t *position,
+                                uint32_t timestamp, sGeofenceAlert_t *alerts, size_t alert_count) {
+    sGeofenceState_t *state = &geofence->state[index];
+
+    if (is_inside == state->is_inside) {
+        state->pending = 0;
+        return alert_count;
+    }
+
+    if (state->pending < MAX_PENDING) {
+        state->pending++;
+    }
+
+    Geofence_Track(geofence, index);
+
+    if (state->pending < geofence->hysteresis) {
+        return alert_count;
+    }
+
+    const sGeofenceRecord_t *fence = &geofence->fences[index];
+    bool is_alert = ((fence->flags & (is_inside ? GEOFENCE_FLAG_ENTRY : GEOFENCE_FLAG_EXIT)) != 0);
+
+    if (is_alert && (alert_count == GEOFENCE_MAX_EVENTS)) {
+        geofence->stats.deferred++;
+        return alert_count;
+    }
+
+    state->is_inside = is_inside;
+    state->pending = 0;
+
+    if (is_alert) {
+        sGeofenceAlert_t *alert = &alerts[alert_count++];
+
+        alert->fence_id = fence->id;
+        alert->event = is_inside ? eGeofenceEvent_Enter : eGeofenceEvent_Exit;
+        alert->timestamp = timestamp;
+        alert->position = *position;
+        geofence->stats.alerts++;
+    }
+
+    return alert_count;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void Geofence_Init (sGeofence_t *geofence, uint8_t hysteresis) {
+    if (geofence == NULL) {
+        return;
+    }
+
+    memset(geofence, 0, sizeof(*geofence));
+    geofence->hysteresis = hysteresis;
+}
+
+bool Geofence_Load (sGeofence_t *geofence, const void *image, size_t image_size) {
+    if (geofence == NULL) {
+        return false;
+    }
+
+    Geofence_Init(geofence, geofence->hysteresis);
+
+    if ((image == NULL) || ((((uintptr_t) image) % sizeof(uint32_t)) != 0) || (image_size < sizeof(sGeofenceSetHeader_t))) {
+        return false;
+    }
+
+    const sGeofenceSetHeader_t *header = (const sGeofenceSetHeader_t *) image;
+    uint64_t expected_size = sizeof(*header) + ((uint64_t) header->fence_count * sizeof(sGeofenceRecord_t)) +
+                             ((uint64_t) header->vertex_count * sizeof(sGeodesyPoint_t));
+
+    if ((header->magic != GEOFENCE_SET_MAGIC) || (header->version != GEOFENCE_SET_VERSION) ||
+        (header->fence_count > GEOFENCE_MAX_FENCES) || (expected_size > image_size)) {
+        return false;
+    }
+
+    geofence->fences = (const sGeofenceRecord_t *) (header + 1);
+    geofence->vertices = (const sGeodesyPoint_t *) (geofence->fences + header->fence_count);
+
+    for (size_t index = 0; index < header->fence_count; index++) {
+        const sGeofenceRecord_t *fence = &geofence->fences[index];
+
+        if (Geofence_CheckFence(geofence, fence, header->vertex_count) == false) {
+            Geofence_Init(geofence, geofence->hysteresis);
+            return false;
+        }
+
+        if (index == 0) {
+            geofence->bounds = fence->box;
+            continue;
+        }
+
+        sGeofenceBox_t *bounds = &geofence->bounds;
+        bounds->min_latitude = (fence->box.min_latitude < bounds->min_latitude) ? fence->box.min_latitude : bounds->min_latitude;
+        bounds->max_latitude = (fence->box.max_latitude > bounds->max_latitude) ? fence->box.max_latitude : bounds->max_latitude;
+        bounds->min_longitude = (fence->box.min_longitude < bounds->min_longitude) ? fence->box.min_longitude : bounds->min_longitude;
+        bounds->max_longitude = (fence->box.max_longitude > bounds->max_longitude) ? fence->box.max_longitude : bounds->max_longitude;
+    }
+
+    geofence->fence_count = header->fence_count;
+
+    if (Geofence_BuildIndex(geofence) == false) {
+        Geofence_Init(geofence, geofence->hysteresis);
+        return false;
+    }
+
+    return true;
+}
+
+/* Fences already active are checked first wherever the position is, then the rest of the fences in its cell. */
+size_t Geofence_Evaluate (sGeofence_t *geofence, const sGeodesyPoint_t *position, uint32_t timestamp,
+                          sGeofenceAlert_t alerts[GEOFENCE_MAX_EVENTS]) {
+    if ((geofence == NULL) || (position == NULL) || (alerts == NULL)) {
+        return 0;
+    }
+
+    size_t alert_count = 0;
+    size_t active_count = geofence->active_count;
+
+    geofence->stats.fixes++;
+
+    for (size_t i = 0; i < active_count; i++) {
+        size_t index = geofence->active[i];
+
+        geofence->state[index].is_checked = true;
+        alert_count = Geofence_Observe(geofence, index, Geofence_Test(geofence, index, position), position, timestamp,
+                                       alerts, alert_count);
+    }
+
+    size_t cell = Geofence_FindCell(geofence, position);
+
+    if (cell != NO_CELL) {
+        for (size_t entry = geofence->cell_start[cell]; entry < geofence->cell_start[cell + 1]; entry++) {
+            size_t index = geofence->cell_fences[entry];
+
+            if (geofence->state[index].is_checked == true) {
+                continue;
+            }
+
+            geofence->stats.candidates++;
+            alert_count = Geofence_Observe(geofence, index, Geofence_Test(geofence, index, position), position,
+                                           timestamp, alerts, alert_count);
+        }
+    }
+
+    /* Settled outside fences leave the active list, the rest stay for the next fix. */
+    size_t kept = 0;
+
+    for (size_t i = 0; i < geofence->active_count; i++) {
+        sGeofenceState_t *state = &geofence->state[geofence->active[i]];
+
+        state->is_checked = false;
+
+        if ((state->is_inside == false) && (state->pending == 0)) {
+            state->is_active = false;
+            continue;
+        }
+
+        geofence->active[kept++] = geofence->active[i];
+    }
+
+    geofence->active_count = kept;
+
+    return alert_count;
+}
+
+/* Crossing number on a ray towards east. Each edge test is a sign check on a 64-bit cross product, no division. */
+bool Geofence_IsInside (const sGeodesyPoint_t *position, const sGeodesyPoint_t *vertices, size_t vertex_count) {
+    if ((position == NULL) || (vertices == NULL)) {
+        return false;
+    }
+
+    bool is_inside = false;
+
+    for (size_t i = 0, j = vertex_count - 1; i < vertex_count; j = i++) {
+        const sGeodesyPoint_t *from = &vertices[j];
+        const sGeodesyPoint_t *to = &vertices[i];
+
+        if ((to->latitude > position->latitude) == (from->latitude > position->latitude)) {
+            continue;
+        }
+
+        int64_t cross = (((int64_t) from->longitude - to->longitude) * ((int64_t) position->latitude - to->latitude)) -
+                        (((int64_t) position->longitude - to->longitude) * ((int64_t) from->latitude - to->latitude));
+
+        if ((from->latitude > to->latitude) ? (cross > 0) : (cross < 0)) {
+            is_inside = !is_inside;
+        }
+    }
+
+    return is_inside;
+}
+
+size_t Geofence_GetFenceCount (const sGeofence_t *geofence) {
+    return (geofence != NULL) ? geofence->fence_count : 0;
+}
+
+size_t Geofence_GetInsideCount (const sGeofence_t *geofence) {
+    if (geofence == NULL) {
+        return 0;
+    }
+
+    size_t inside = 0;
+
+    for (size_t i = 0; i < geofence->active_count; i++) {
+        if (geofence->state[geofence->active[i]].is_inside == true) {
+            inside++;
+        }
+    }
+
+    return inside;
+}
+
+bool Geofence_GetStats (const sGeofence_t *geofence, sGeofenceStats_t *stats) {
+    if ((geofence == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    *stats = geofence->stats;
+
+    return true;
+}
@@ -0,0 +1,121 @@
+#ifndef SOURCE_UTILITY_GEOFENCE_H_
+#define SOURCE_UTILITY_GEOFENCE_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "geodesy.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define GEOFENCE_SET_MAGIC 0x434E4647UL
+#define GEOFENCE_SET_VERSION 1
+#define GEOFENCE_MAX_FENCES 1024
+#define GEOFENCE_MIN_VERTICES 3
+/* The bounding box of the whole set is split into GRID_SIZE x GRID_SIZE cells */
+#define GEOFENCE_GRID_SIZE 32
+#define GEOFENCE_GRID_CELLS (GEOFENCE_GRID_SIZE * GEOFENCE_GRID_SIZE)
+#define GEOFENCE_MAX_CELL_ENTRIES 4096
+/* Fences the position is inside of, or about to enter, are re-checked on every fix wherever the position is */
+#define GEOFENCE_MAX_ACTIVE 64
+#define GEOFENCE_MAX_EVENTS 4
+#define GEOFENCE_DEFAULT_HYSTERESIS 3
+
+#define GEOFENCE_FLAG_ENTRY 0x01
+#define GEOFENCE_FLAG_EXIT 0x02
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Fence set image as it is stored in flash, little endian. The header is followed by fence_count records and then by
+ * vertex_count vertices. Fences may not cross the antimeridian. */
+typedef struct sGeofenceSetHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t fence_count;
+    uint32_t vertex_count;
+    uint32_t reserved;
+} sGeofenceSetHeader_t;
+
+typedef struct sGeofenceBox {
+    int32_t min_latitude;
+    int32_t min_longitude;
+    int32_t max_latitude;
+    int32_t max_longitude;
+} sGeofenceBox_t;
+
+/* The box has to match the vertices exactly, the loader checks it */
+typedef struct sGeofenceRecord {
+    uint16_t id;
+    uint8_t flags;
+    uint8_t vertex_count;
+    uint32_t first_vertex;
+    sGeofenceBox_t box;
+} sGeofenceRecord_t;
+
+typedef enum eGeofenceEvent {
+    eGeofenceEvent_First = 0,
+    eGeofenceEvent_Enter = eGeofenceEvent_First,
+    eGeofenceEvent_Exit,
+    eGeofenceEvent_Last
+} eGeofenceEvent_t;
+
+typedef struct sGeofenceAlert {
+    uint16_t fence_id;
+    eGeofenceEvent_t event;
+    uint32_t timestamp;
+    sGeodesyPoint_t position;
+} sGeofenceAlert_t;
+
+typedef struct sGeofenceState {
+    bool is_inside;
+    bool is_active;
+    bool is_checked;
+    uint8_t pending;
+} sGeofenceState_t;
+
+typedef struct sGeofenceStats {
+    uint32_t fixes;
+    uint32_t candidates;
+    uint32_t polygon_tests;
+    uint32_t alerts;
+    uint32_t deferred;
+    uint32_t untracked;
+} sGeofenceStats_t;
+
+typedef struct sGeofence {
+    const sGeofenceRecord_t *fences;
+    const sGeodesyPoint_t *vertices;
+    size_t fence_count;
+    sGeofenceBox_t bounds;
+    uint32_t cell_height;
+    uint32_t cell_width;
+    uint8_t hysteresis;
+    uint16_t cell_start[GEOFENCE_GRID_CELLS + 1];
+    uint16_t cell_fences[GEOFENCE_MAX_CELL_ENTRIES];
+    sGeofenceState_t state[GEOFENCE_MAX_FENCES];
+    uint16_t active[GEOFENCE_MAX_ACTIVE];
+    size_t active_count;
+    sGeofenceStats_t stats;
+} sGeofence_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* An empty engine that never raises an alert */
+void Geofence_Init (sGeofence_t *geofence, uint8_t hysteresis);
+/* Validates the image and indexes it, the image is used in place and has to outlive the engine. Every fence starts
+ * outside. On failure the engine is left empty. */
+bool Geofence_Load (sGeofence_t *geofence, const void *image, size_t image_size);
+/* Returns how many alerts were written. A transition that does not fit is held back to the next fix. */
+size_t Geofence_Evaluate (sGeofence_t *geofence, const sGeodesyPoint_t *position, uint32_t timestamp,
+                          sGeofenceAlert_t alerts[GEOFENCE_MAX_EVENTS]);
+bool Geofence_IsInside (const sGeodesyPoint_t *position, const sGeodesyPoint_t *vertices, size_t vertex_count);
+size_t Geofence_GetFenceCount (const sGeofence_t *geofence);
+size_t Geofence_GetInsideCount (const sGeofence_t *geofence);
+bool Geofence_GetStats (const sGeofence_t *geofence, sGeofenceStats_t *stats);
+#endif /* SOURCE_UTILITY_GEOFENCE_H_ */
@@ -0,0 +1,223 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "log_ring.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define COMMIT_MAGIC 0x474F4C52U
+#define PADDING_MAGIC 0x44415052U
+#define HEADER_SIZE sizeof(sLogRingHeader_t)
+#define ALIGN_UP(size) (((size) + (LOG_RING_ALIGNMENT - 1U)) & ~(LOG_RING_ALIGNMENT - 1U))
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* In front of every record. The commit word is written last, a record without it is still being filled in. */
+typedef struct sLogRingHeader {
+    uint32_t commit;
+    uint16_t size;
+    uint16_t length;
+} sLogRingHeader_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static sLogRingHeader_t *LogRing_GetHeader (const sLogRing_t *ring, uint32_t position);
+static void LogRing_RaiseHighWater (sLogRing_t *ring, uint32_t used);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static sLogRingHeader_t *LogRing_GetHeader (const sLogRing_t *ring, uint32_t position) {
+    return (sLogRingHeader_t *) &ring->storage[position & (ring->capacity - 1U)];
+}
+
+static void LogRing_RaiseHighWater (sLogRing_t *ring, uint32_t used) {
+    uint32_t high_water = __atomic_load_n(&ring->high_water, __ATOMIC_RELAXED);
+
+    while ((used > high_water) &&
+           (__atomic_compare_exchange_n(&ring->high_water, &high_water, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == false)) {
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool LogRing_Init (sLogRing_t *ring, void *storage, size_t capacity) {
+    if ((ring == NULL) || (storage == NULL) || (((uintptr_t) storage % LOG_RING_ALIGNMENT) != 0)) {
+        return false;
+    }
+
+    if ((capacity < (4U * LOG_RING_ALIGNMENT)) || (capacity > LOG_RING_MAX_CAPACITY) || ((capacity & (capacity - 1U)) != 0)) {
+        return false;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    memset(storage, 0, capacity);
+    ring->storage = (uint8_t *) storage;
+    ring->capacity = (uint32_t) capacity;
+
+    return true;
+}
+
+/* Space is claimed with a compare and swap on the head, the record is then filled in without any lock. A record that
+ * would run past the end leaves a padding record behind and starts over at the beginning. */
+bool LogRing_Write (sLogRing_t *ring, const void *meta, size_t meta_size, const void *message, size_t message_size,
+                    bool *was_empty) {
+    if ((ring == NULL) || (ring->storage == NULL) || ((meta == NULL) && (meta_size != 0)) ||
+        ((message == NULL) && (message_size != 0))) {
+        return false;
+    }
+
+    size_t length = meta_size + message_size;
+    uint32_t size = ALIGN_UP(HEADER_SIZE + length);
+
+    if (size > (ring->capacity / 2U)) {
+        __atomic_fetch_add(&ring->dropped, 1U, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t padding;
+    uint32_t used;
+
+    while (true) {
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        uint32_t to_end = ring->capacity - (head & (ring->capacity - 1U));
+
+        padding = (to_end < size) ? to_end : 0;
+        used = head - tail;
+
+        /* The reader moved the tail past a head read before it, both are read again */
+        if (used > ring->capacity) {
+            head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if ((used + padding + size) > ring->capacity) {
+            __atomic_fetch_add(&ring->dropped, 1U, __ATOMIC_RELAXED);
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&ring->head, &head, head + padding + size, true, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_RELAXED) == true) {
+            break;
+        }
+    }
+
+    /* Checked after the claim, against a reader that empties the ring and then looks at the head. One of the two
+     * always sees the other, so the reader is never left asleep with a record waiting. */
+    if (was_empty != NULL) {
+        *was_empty = (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) == head);
+    }
+
+    if (padding > 0) {
+        sLogRingHeader_t *padding_header = LogRing_GetHeader(ring, head);
+
+        padding_header->size = (uint16_t) padding;
+        padding_header->length = 0;
+        __atomic_store_n(&padding_header->commit, PADDING_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    sLogRingHeader_t *header = LogRing_GetHeader(ring, head + padding);
+    uint8_t *payload = (uint8_t *) (header + 1);
+
+    header->size = (uint16_t) size;
+    header->length = (uint16_t) length;
+
+    if (meta_size > 0) {
+        memcpy(payload, meta, meta_size);
+    }
+
+    if (message_size > 0) {
+        memcpy(&payload[meta_size], message, message_size);
+    }
+
+    __atomic_store_n(&header->commit, COMMIT_MAGIC, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&ring->records, 1U, __ATOMIC_RELAXED);
+    LogRing_RaiseHighWater(ring, used + padding + size);
+
+    return true;
+}
+
+/* A writer that claimed space but was preempted before its commit holds back every record behind it. */
+const void *LogRing_Peek (sLogRing_t *ring, size_t *size) {
+    if ((ring == NULL) || (size == NULL)) {
+        return NULL;
+    }
+
+    while (ring->tail != __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST)) {
+        sLogRingHeader_t *header = LogRing_GetHeader(ring, ring->tail);
+        uint32_t commit = __atomic_load_n(&header->commit, __ATOMIC_ACQUIRE);
+
+        if (commit == PADDING_MAGIC) {
+            LogRing_Release(ring);
+            continue;
+        }
+
+        if (commit != COMMIT_MAGIC) {
+            return NULL;
+        }
+
+        *size = header->length;
+
+        return (header + 1);
+    }
+
+    return NULL;
+}
+
+/* The space is wiped before it is handed back, so a stale commit word can never be taken for a new record. */
+void LogRing_Release (sLogRing_t *ring) {
+    if (ring == NULL) {
+        return;
+    }
+
+    uint32_t tail = ring->tail;
+    sLogRingHeader_t *header = LogRing_GetHeader(ring, tail);
+    uint32_t commit = __atomic_load_n(&header->commit, __ATOMIC_ACQUIRE);
+
+    if ((tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) || ((commit != COMMIT_MAGIC) && (commit != PADDING_MAGIC))) {
+        return;
+    }
+
+    uint32_t size = header->size;
+
+    memset(header, 0, size);
+    __atomic_store_n(&ring->tail, tail + size, __ATOMIC_SEQ_CST);
+}
+
+bool LogRing_IsEmpty (const sLogRing_t *ring) {
+    if (ring == NULL) {
+        return true;
+    }
+
+    return (__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == ring->tail);
+}
+
+bool LogRing_GetStats (const sLogRing_t *ring, sLogRingStats_t *stats) {
+    if ((ring == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    stats->records = ring->records;
+    stats->dropped = ring->dropped;
+    stats->used = ring->head - ring->tail;
+    stats->high_water = ring->high_water;
+    stats->capacity = ring->capacity;
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef SOURCE_UTILITY_LOG_RING_H_
+#define SOURCE_UTILITY_LOG_RING_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Records start on a header sized boundary, the storage size must be a power of two */
+#define LOG_RING_ALIGNMENT 8U
+#define LOG_RING_MAX_CAPACITY 32768U
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Any number of writers, tasks or interrupts, and a single reader. Head and tail run freely and wrap. */
+typedef struct sLogRing {
+    uint8_t *storage;
+    uint32_t capacity;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t records;
+    volatile uint32_t dropped;
+    volatile uint32_t high_water;
+} sLogRing_t;
+
+typedef struct sLogRingStats {
+    uint32_t records;
+    uint32_t dropped;
+    uint32_t used;
+    uint32_t high_water;
+    uint32_t capacity;
+} sLogRingStats_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool LogRing_Init (sLogRing_t *ring, void *storage, size_t capacity);
+/* A record is a fixed part followed by a message, either may be empty. Never blocks, false when the ring is full.
+ * was_empty is set when the ring held nothing before this record, it may be NULL. */
+bool LogRing_Write (sLogRing_t *ring, const void *meta, size_t meta_size, const void *message, size_t message_size,
+                    bool *was_empty);
+/* Oldest committed record in place, NULL when there is none yet. Reader only. */
+const void *LogRing_Peek (sLogRing_t *ring, size_t *size);
+void LogRing_Release (sLogRing_t *ring);
+bool LogRing_IsEmpty (const sLogRing_t *ring);
+bool LogRing_GetStats (const sLogRing_t *ring, sLogRingStats_t *stats);
+#endif /* SOURCE_UTILITY_LOG_RING_H_ */
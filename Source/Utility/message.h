@@ -1,26 +1,26 @@
-#ifndef SOURCE_UTILITY_MESSAGE_H_
-#define SOURCE_UTILITY_MESSAGE_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-#include <stddef.h>
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-typedef struct {
-    char *str;
-    size_t size;
-} sString_t;
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-
-#endif /* SOURCE_UTILITY_MESSAGE_H_ */
+#ifndef SOURCE_UTILITY_MESSAGE_H_
+#define SOURCE_UTILITY_MESSAGE_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stddef.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct {
+    char *str;
+    size_t size;
+} sString_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+#endif /* SOURCE_UTILITY_MESSAGE_H_ */
@@ -0,0 +1,469 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nmea_parser.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SENTENCE_START '$'
+#define CHECKSUM_START '*'
+#define FIELD_SEPARATOR ','
+#define ADDRESS_SIZE 5
+#define TALKER_SIZE 2
+#define CHECKSUM_DIGITS 2
+#define COORDINATE_DECIMALS 5
+#define TIME_DECIMALS 3
+#define VALUE_DECIMALS 2
+#define SPEED_DECIMALS 3
+/* knots * 1000 -> 0.01 m/s, 1 kn = 0.514444 m/s */
+#define KNOTS_E3_TO_SPEED(value) (((int64_t) (value) * 514444) / 10000000)
+/* km/h * 1000 -> 0.01 m/s */
+#define KMH_E3_TO_SPEED(value) ((value) / 36)
+#define GSV_FIRST_SATELLITE_FIELD 4
+#define GSV_FIELDS_PER_SATELLITE 4
+#define GSV_SNR_OFFSET 3
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sNmeaSentenceDesc {
+    const char *type;
+    size_t min_fields;
+} sNmeaSentenceDesc_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const int32_t g_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+static const sNmeaSentenceDesc_t g_sentence_lut[eNmeaSentence_Last] = {
+    [eNmeaSentence_GGA] = {.type = "GGA", .min_fields = 10},
+    [eNmeaSentence_RMC] = {.type = "RMC", .min_fields = 10},
+    [eNmeaSentence_GSA] = {.type = "GSA", .min_fields = 18},
+    [eNmeaSentence_GSV] = {.type = "GSV", .min_fields = 4},
+    [eNmeaSentence_VTG] = {.type = "VTG", .min_fields = 9}
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool NmeaParser_ParseUnsigned (const char *field, uint32_t *value);
+static bool NmeaParser_ParseCoordinate (const char *field, const char *hemisphere, int32_t *value);
+static int NmeaParser_HexValue (char digit);
+static void NmeaParser_HandleGGA (sNmeaParser_t *parser, char **fields, size_t field_count);
+static void NmeaParser_HandleRMC (sNmeaParser_t *parser, char **fields, size_t field_count);
+static void NmeaParser_HandleGSA (sNmeaParser_t *parser, char **fields, size_t field_count);
+static void NmeaParser_HandleGSV (sNmeaParser_t *parser, char **fields, size_t field_count);
+static void NmeaParser_HandleVTG (sNmeaParser_t *parser, char **fields, size_t field_count);
+static uint32_t NmeaParser_ProcessSentence (sNmeaParser_t *parser);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static bool NmeaParser_ParseUnsigned (const char *field, uint32_t *value) {
+    int32_t parsed = 0;
+
+    if ((NmeaParser_ParseFixed(field, 0, &parsed) == false) || (parsed < 0)) {
+        return false;
+    }
+
+    *value = (uint32_t) parsed;
+
+    return true;
+}
+
+/* "dddmm.mmmmm" and a hemisphere letter to 1e-7 degrees */
+static bool NmeaParser_ParseCoordinate (const char *field, const char *hemisphere, int32_t *value) {
+    int32_t raw = 0;
+
+    if ((NmeaParser_ParseFixed(field, COORDINATE_DECIMALS, &raw) == false) || (raw < 0) || (hemisphere == NULL)) {
+        return false;
+    }
+
+    int32_t degrees = raw / 10000000;
+    int32_t minutes_e5 = raw % 10000000;
+    int32_t result = (degrees * 10000000) + (((minutes_e5 * 10) + 3) / 6);
+
+    if ((*hemisphere == 'S') || (*hemisphere == 'W')) {
+        result = -result;
+    } else if ((*hemisphere != 'N') && (*hemisphere != 'E')) {
+        return false;
+    }
+
+    *value = result;
+
+    return true;
+}
+
+
+static int NmeaParser_HexValue (char digit) {
+    if ((digit >= '0') && (digit <= '9')) {
+        return digit - '0';
+    }
+
+    if ((digit >= 'A') && (digit <= 'F')) {
+        return digit - 'A' + 10;
+    }
+
+    if ((digit >= 'a') && (digit <= 'f')) {
+        return digit - 'a' + 10;
+    }
+
+    return -1;
+}
+
+static void NmeaParser_HandleGGA (sNmeaParser_t *parser, char **fields, size_t field_count) {
+    sNmeaFix_t *fix = &parser->fix;
+    uint32_t value = 0;
+    int32_t fixed = 0;
+
+    NmeaParser_ParseTime(fields[1], &fix->time_ms);
+    NmeaParser_ParseCoordinate(fields[2], fields[3], &fix->latitude);
+    NmeaParser_ParseCoordinate(fields[4], fields[5], &fix->longitude);
+
+    if (NmeaParser_ParseUnsigned(fields[6], &value)) {
+        fix->quality = (uint8_t) value;
+    }
+
+    if (NmeaParser_ParseUnsigned(fields[7], &value)) {
+        fix->satellites_used = (uint8_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[8], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->hdop = (uint16_t) fixed;
+    }
+
+    if (NmeaParser_ParseFixed(fields[9], VALUE_DECIMALS, &fixed)) {
+        fix->altitude = fixed;
+    }
+}
+
+static void NmeaParser_HandleRMC (sNmeaParser_t *parser, char **fields, size_t field_count) {
+    sNmeaFix_t *fix = &parser->fix;
+    uint32_t value = 0;
+    int32_t fixed = 0;
+
+    NmeaParser_ParseTime(fields[1], &fix->time_ms);
+    fix->is_valid = (fields[2][0] == 'A');
+    NmeaParser_ParseCoordinate(fields[3], fields[4], &fix->latitude);
+    NmeaParser_ParseCoordinate(fields[5], fields[6], &fix->longitude);
+
+    if (NmeaParser_ParseFixed(fields[7], SPEED_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->speed = (uint16_t) KNOTS_E3_TO_SPEED(fixed);
+    }
+
+    if (NmeaParser_ParseFixed(fields[8], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->course = (uint16_t) fixed;
+    }
+
+    if (NmeaParser_ParseUnsigned(fields[9], &value)) {
+        fix->date = value;
+    }
+}
+
+static void NmeaParser_HandleGSA (sNmeaParser_t *parser, char **fields, size_t field_count) {
+    sNmeaFix_t *fix = &parser->fix;
+    uint32_t value = 0;
+    int32_t fixed = 0;
+
+    if (NmeaParser_ParseUnsigned(fields[2], &value)) {
+        fix->fix_type = (uint8_t) value;
+    }
+
+    if (NmeaParser_ParseFixed(fields[15], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->pdop = (uint16_t) fixed;
+    }
+
+    if (NmeaParser_ParseFixed(fields[16], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->hdop = (uint16_t) fixed;
+    }
+
+    if (NmeaParser_ParseFixed(fields[17], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->vdop = (uint16_t) fixed;
+    }
+}
+
+static void NmeaParser_HandleGSV (sNmeaParser_t *parser, char **fields, size_t field_count) {
+    uint32_t total = 0;
+    uint32_t number = 0;
+    uint32_t value = 0;
+
+    if ((NmeaParser_ParseUnsigned(fields[1], &total) == false) || (NmeaParser_ParseUnsigned(fields[2], &number) == false)) {
+        return;
+    }
+
+    if (number == 1) {
+        parser->gsv_max_snr = 0;
+    }
+
+    for (size_t i = GSV_FIRST_SATELLITE_FIELD + GSV_SNR_OFFSET; i < field_count; i += GSV_FIELDS_PER_SATELLITE) {
+        if (NmeaParser_ParseUnsigned(fields[i], &value) && (value > parser->gsv_max_snr)) {
+            parser->gsv_max_snr = (uint8_t) value;
+        }
+    }
+
+    /* Publish once the whole cycle of GSV messages is in. */
+    if (number == total) {
+        if (NmeaParser_ParseUnsigned(fields[3], &value)) {
+            parser->fix.satellites_in_view = (uint8_t) value;
+        }
+
+        parser->fix.max_snr = parser->gsv_max_snr;
+    }
+}
+
+static void NmeaParser_HandleVTG (sNmeaParser_t *parser, char **fields, size_t field_count) {
+    sNmeaFix_t *fix = &parser->fix;
+    int32_t fixed = 0;
+
+    if (NmeaParser_ParseFixed(fields[1], VALUE_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->course = (uint16_t) fixed;
+    }
+
+    if (NmeaParser_ParseFixed(fields[7], SPEED_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->speed = (uint16_t) KMH_E3_TO_SPEED(fixed);
+    } else if (NmeaParser_ParseFixed(fields[5], SPEED_DECIMALS, &fixed) && (fixed >= 0)) {
+        fix->speed = (uint16_t) KNOTS_E3_TO_SPEED(fixed);
+    }
+}
+
+static uint32_t NmeaParser_ProcessSentence (sNmeaParser_t *parser) {
+    char *sentence = parser->sentence;
+
+    if ((parser->checksum_position == 0) || (parser->length != (parser->checksum_position + 1 + CHECKSUM_DIGITS))) {
+        parser->stats.checksum_errors++;
+        return 0;
+    }
+
+    int high = NmeaParser_HexValue(sentence[parser->checksum_position + 1]);
+    int low = NmeaParser_HexValue(sentence[parser->checksum_position + 2]);
+
+    if ((high < 0) || (low < 0) || (parser->checksum != (uint8_t) ((high << 4) | low))) {
+        parser->stats.checksum_errors++;
+        return 0;
+    }
+
+    sentence[parser->checksum_position] = '\0';
+
+    /* Split in place, empty fields become empty strings. */
+    char *fields[NMEA_MAX_FIELDS];
+    size_t field_count = 0;
+
+    fields[field_count++] = sentence;
+    for (char *cursor = sentence; *cursor != '\0'; cursor++) {
+        if (*cursor != FIELD_SEPARATOR) {
+            continue;
+        }
+
+        *cursor = '\0';
+
+        if (field_count >= NMEA_MAX_FIELDS) {
+            break;
+        }
+
+        fields[field_count++] = cursor + 1;
+    }
+
+    parser->stats.sentences++;
+
+    if (strlen(fields[0]) != ADDRESS_SIZE) {
+        parser->stats.ignored++;
+        return 0;
+    }
+
+    for (eNmeaSentence_t type = eNmeaSentence_First; type < eNmeaSentence_Last; type++) {
+        if (memcmp(&fields[0][TALKER_SIZE], g_sentence_lut[type].type, ADDRESS_SIZE - TALKER_SIZE) != 0) {
+            continue;
+        }
+
+        if (field_count < g_sentence_lut[type].min_fields) {
+            parser->stats.ignored++;
+            return 0;
+        }
+
+        switch (type) {
+            case eNmeaSentence_GGA: {
+                NmeaParser_HandleGGA(parser, fields, field_count);
+                break;
+            }
+            case eNmeaSentence_RMC: {
+                NmeaParser_HandleRMC(parser, fields, field_count);
+                break;
+            }
+            case eNmeaSentence_GSA: {
+                NmeaParser_HandleGSA(parser, fields, field_count);
+                break;
+            }
+            case eNmeaSentence_GSV: {
+                NmeaParser_HandleGSV(parser, fields, field_count);
+                break;
+            }
+            case eNmeaSentence_VTG: {
+                NmeaParser_HandleVTG(parser, fields, field_count);
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+
+        return (1U << type);
+    }
+
+    parser->stats.ignored++;
+
+    return 0;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* Decimal string to an integer scaled by 10^decimals, extra fraction digits are truncated. */
+bool NmeaParser_ParseFixed (const char *field, uint8_t decimals, int32_t *value) {
+    if ((field == NULL) || (*field == '\0') || (decimals >= (sizeof(g_pow10) / sizeof(g_pow10[0])))) {
+        return false;
+    }
+
+    bool is_negative = (*field == '-');
+    if (is_negative) {
+        field++;
+    }
+
+    int32_t integer = 0;
+    int32_t fraction = 0;
+    uint8_t fraction_digits = 0;
+    bool is_fraction = false;
+    bool has_digits = false;
+
+    for (; *field != '\0'; field++) {
+        if (*field == '.') {
+            if (is_fraction) {
+                return false;
+            }
+
+            is_fraction = true;
+            continue;
+        }
+
+        if ((*field < '0') || (*field > '9')) {
+            return false;
+        }
+
+        has_digits = true;
+
+        if (is_fraction == false) {
+            integer = (integer * 10) + (*field - '0');
+        } else if (fraction_digits < decimals) {
+            fraction = (fraction * 10) + (*field - '0');
+            fraction_digits++;
+        }
+    }
+
+    if (has_digits == false) {
+        return false;
+    }
+
+    int32_t result = (integer * g_pow10[decimals]) + (fraction * g_pow10[decimals - fraction_digits]);
+    *value = is_negative ? -result : result;
+
+    return true;
+}
+
+/* "hhmmss.sss" to milliseconds since midnight */
+bool NmeaParser_ParseTime (const char *field, uint32_t *time_ms) {
+    int32_t raw = 0;
+
+    if ((NmeaParser_ParseFixed(field, TIME_DECIMALS, &raw) == false) || (raw < 0)) {
+        return false;
+    }
+
+    uint32_t hours = raw / 10000000;
+    uint32_t minutes = (raw / 100000) % 100;
+    uint32_t milliseconds = raw % 100000;
+
+    *time_ms = (((hours * 60) + minutes) * 60 * 1000) + milliseconds;
+
+    return true;
+}
+
+void NmeaParser_Init (sNmeaParser_t *parser) {
+    if (parser == NULL) {
+        return;
+    }
+
+    memset(parser, 0, sizeof(sNmeaParser_t));
+}
+
+uint32_t NmeaParser_Feed (sNmeaParser_t *parser, const char *data, size_t size) {
+    if ((parser == NULL) || (data == NULL)) {
+        return 0;
+    }
+
+    uint32_t completed = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        char byte = data[i];
+
+        if (byte == SENTENCE_START) {
+            parser->is_collecting = true;
+            parser->length = 0;
+            parser->checksum = 0;
+            parser->checksum_position = 0;
+            continue;
+        }
+
+        if (parser->is_collecting == false) {
+            continue;
+        }
+
+        if ((byte == '\r') || (byte == '\n')) {
+            parser->is_collecting = false;
+            parser->sentence[parser->length] = '\0';
+            completed |= NmeaParser_ProcessSentence(parser);
+            continue;
+        }
+
+        if (parser->length >= NMEA_MAX_SENTENCE_SIZE) {
+            parser->is_collecting = false;
+            parser->stats.overflows++;
+            continue;
+        }
+
+        if ((byte == CHECKSUM_START) && (parser->checksum_position == 0)) {
+            parser->checksum_position = parser->length;
+        } else if (parser->checksum_position == 0) {
+            parser->checksum ^= (uint8_t) byte;
+        }
+
+        parser->sentence[parser->length++] = byte;
+    }
+
+    return completed;
+}
+
+bool NmeaParser_GetFix (const sNmeaParser_t *parser, sNmeaFix_t *fix) {
+    if ((parser == NULL) || (fix == NULL)) {
+        return false;
+    }
+
+    *fix = parser->fix;
+
+    return true;
+}
+
+bool NmeaParser_GetStats (const sNmeaParser_t *parser, sNmeaStats_t *stats) {
+    if ((parser == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    *stats = parser->stats;
+
+    return true;
+}
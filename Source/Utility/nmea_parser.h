@@ -0,0 +1,79 @@
+#ifndef SOURCE_UTILITY_NMEA_PARSER_H_
+#define SOURCE_UTILITY_NMEA_PARSER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define NMEA_MAX_SENTENCE_SIZE 82
+#define NMEA_MAX_FIELDS 24
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eNmeaSentence {
+    eNmeaSentence_First = 0,
+    eNmeaSentence_GGA = eNmeaSentence_First,
+    eNmeaSentence_RMC,
+    eNmeaSentence_GSA,
+    eNmeaSentence_GSV,
+    eNmeaSentence_VTG,
+    eNmeaSentence_Last
+} eNmeaSentence_t;
+
+/* Fixed-point units: coordinates 1e-7 deg, altitude cm, speed 0.01 m/s, course 0.01 deg, DOPs 0.01 */
+typedef struct sNmeaFix {
+    bool is_valid;
+    uint8_t quality;
+    uint8_t fix_type;
+    uint8_t satellites_used;
+    uint8_t satellites_in_view;
+    uint8_t max_snr;
+    uint32_t time_ms;
+    uint32_t date;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    uint16_t speed;
+    uint16_t course;
+    uint16_t hdop;
+    uint16_t pdop;
+    uint16_t vdop;
+} sNmeaFix_t;
+
+typedef struct sNmeaStats {
+    uint32_t sentences;
+    uint32_t checksum_errors;
+    uint32_t overflows;
+    uint32_t ignored;
+} sNmeaStats_t;
+
+typedef struct sNmeaParser {
+    char sentence[NMEA_MAX_SENTENCE_SIZE + 1];
+    size_t length;
+    bool is_collecting;
+    uint8_t checksum;
+    size_t checksum_position;
+    uint8_t gsv_max_snr;
+    sNmeaFix_t fix;
+    sNmeaStats_t stats;
+} sNmeaParser_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+void NmeaParser_Init (sNmeaParser_t *parser);
+/* Returns a mask of (1 << eNmeaSentence_t) for every sentence completed in this chunk */
+uint32_t NmeaParser_Feed (sNmeaParser_t *parser, const char *data, size_t size);
+bool NmeaParser_GetFix (const sNmeaParser_t *parser, sNmeaFix_t *fix);
+bool NmeaParser_GetStats (const sNmeaParser_t *parser, sNmeaStats_t *stats);
+/* Field helpers, shared with the modem location report which uses the same number formats */
+bool NmeaParser_ParseFixed (const char *field, uint8_t decimals, int32_t *value);
+bool NmeaParser_ParseTime (const char *field, uint32_t *time_ms);
+#endif /* SOURCE_UTILITY_NMEA_PARSER_H_ */
@@ -0,0 +1,555 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "outbox.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SECTOR_MAGIC 0x3158424FU
+#define RECORD_TYPE_DATA 0x5A
+#define RECORD_TYPE_COMMIT 0x3C
+#define RECORD_TYPE_ERASED 0xFF
+/* A delivered record has its flags programmed to 0 in place, any cleared bit counts in case the write was torn */
+#define RECORD_FLAGS_PENDING 0xFF
+#define RECORD_FLAGS_DELIVERED 0x00
+#define RECORD_ALIGNMENT 4U
+#define RECORD_ALIGN(size) (((size) + (RECORD_ALIGNMENT - 1U)) & ~(RECORD_ALIGNMENT - 1U))
+#define CRC_INIT 0xFFFFFFFFU
+#define CRC_CHUNK_SIZE 32
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* Every sector starts with this header, a sector without a valid one is treated as free. */
+typedef struct sOutboxSectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t erase_count;
+    uint32_t crc;
+} sOutboxSectorHeader_t;
+
+/* Records follow back to back, 4-byte aligned, until the first erased header. The CRC covers the header fields
+ * before it, with the flags as written, and the payload, so a write torn by a reset is skipped on the next mount. */
+typedef struct sOutboxRecordHeader {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t size;
+    uint32_t sequence;
+    uint32_t crc;
+} sOutboxRecordHeader_t;
+
+typedef enum eRecordStatus {
+    eRecordStatus_First = 0,
+    eRecordStatus_Valid = eRecordStatus_First,
+    eRecordStatus_Corrupted,
+    eRecordStatus_End,
+    eRecordStatus_Last
+} eRecordStatus_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const uint32_t g_crc_nibble_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static uint32_t Outbox_UpdateCrc (uint32_t crc, const void *data, size_t size);
+static size_t Outbox_NextSector (const sOutbox_t *outbox, size_t sector);
+static size_t Outbox_FindOldestSector (const sOutbox_t *outbox);
+static eRecordStatus_t Outbox_CheckRecord (const sOutbox_t *outbox, size_t sector, size_t offset, sOutboxRecordHeader_t *header);
+static bool Outbox_NextRecord (sOutbox_t *outbox, sOutboxCursor_t *cursor, sOutboxRecordHeader_t *header);
+static bool Outbox_WriteRecord (sOutbox_t *outbox, uint8_t type, uint32_t sequence, const void *data, size_t size);
+static bool Outbox_OpenSector (sOutbox_t *outbox, size_t sector);
+static bool Outbox_Rotate (sOutbox_t *outbox);
+static void Outbox_Seek (sOutbox_t *outbox);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static uint32_t Outbox_UpdateCrc (uint32_t crc, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *) data;
+
+    for (size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ g_crc_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ g_crc_nibble_table[crc & 0x0F];
+    }
+
+    return crc;
+}
+
+static size_t Outbox_NextSector (const sOutbox_t *outbox, size_t sector) {
+    return (sector + 1) % outbox->flash->sector_count;
+}
+
+static size_t Outbox_FindOldestSector (const sOutbox_t *outbox) {
+    size_t sector = Outbox_NextSector(outbox, outbox->write_sector);
+
+    /* Sectors are filled in ring order, so the first used one after the write sector holds the oldest records. */
+    while ((sector != outbox->write_sector) && (outbox->sector_sequence[sector] == 0)) {
+        sector = Outbox_NextSector(outbox, sector);
+    }
+
+    return sector;
+}
+
+static eRecordStatus_t Outbox_CheckRecord (const sOutbox_t *outbox, size_t sector, size_t offset, sOutboxRecordHeader_t *header) {
+    const sOutboxFlash_t *flash = outbox->flash;
+
+    if ((offset + sizeof(sOutboxRecordHeader_t)) > flash->sector_size) {
+        return eRecordStatus_End;
+    }
+
+    if (flash->read(sector, offset, header, sizeof(sOutboxRecordHeader_t)) == false) {
+        return eRecordStatus_End;
+    }
+
+    if (header->type == RECORD_TYPE_ERASED) {
+        return eRecordStatus_End;
+    }
+
+    /* A header that is not even self-consistent cannot be skipped, the rest of the sector is given up. */
+    if (((header->type != RECORD_TYPE_DATA) && (header->type != RECORD_TYPE_COMMIT)) ||
+        (header->size > OUTBOX_MAX_RECORD_SIZE) ||
+        ((offset + RECORD_ALIGN(sizeof(sOutboxRecordHeader_t) + header->size)) > flash->sector_size)) {
+        return eRecordStatus_End;
+    }
+
+    sOutboxRecordHeader_t written = *header;
+    written.flags = RECORD_FLAGS_PENDING;
+
+    uint32_t crc = Outbox_UpdateCrc(CRC_INIT, &written, offsetof(sOutboxRecordHeader_t, crc));
+    uint8_t chunk[CRC_CHUNK_SIZE];
+    size_t payload_offset = offset + sizeof(sOutboxRecordHeader_t);
+
+    for (size_t done = 0; done < header->size; ) {
+        size_t chunk_size = ((header->size - done) > sizeof(chunk)) ? sizeof(chunk) : (header->size - done);
+
+        if (flash->read(sector, payload_offset + done, chunk, chunk_size) == false) {
+            return eRecordStatus_Corrupted;
+        }
+
+        crc = Outbox_UpdateCrc(crc, chunk, chunk_size);
+        done += chunk_size;
+    }
+
+    return ((crc ^ CRC_INIT) == header->crc) ? eRecordStatus_Valid : eRecordStatus_Corrupted;
+}
+
+static bool Outbox_NextRecord (sOutbox_t *outbox, sOutboxCursor_t *cursor, sOutboxRecordHeader_t *header) {
+    while (1) {
+        eRecordStatus_t status = Outbox_CheckRecord(outbox, cursor->sector, cursor->offset, header);
+
+        if (status == eRecordStatus_Valid) {
+            return true;
+        }
+
+        if (status == eRecordStatus_Corrupted) {
+            cursor->offset += RECORD_ALIGN(sizeof(sOutboxRecordHeader_t) + header->size);
+            continue;
+        }
+
+        if (cursor->sector == outbox->write_sector) {
+            return false;
+        }
+
+        cursor->sector = Outbox_NextSector(outbox, cursor->sector);
+        cursor->offset = sizeof(sOutboxSectorHeader_t);
+    }
+}
+
+static bool Outbox_WriteRecord (sOutbox_t *outbox, uint8_t type, uint32_t sequence, const void *data, size_t size) {
+    sOutboxRecordHeader_t header = {.type = type, .flags = RECORD_FLAGS_PENDING, .size = (uint16_t) size, .sequence = sequence};
+    size_t offset = outbox->write_offset;
+
+    header.crc = Outbox_UpdateCrc(CRC_INIT, &header, offsetof(sOutboxRecordHeader_t, crc));
+    header.crc = Outbox_UpdateCrc(header.crc, data, size) ^ CRC_INIT;
+
+    outbox->write_offset += RECORD_ALIGN(sizeof(header) + size);
+
+    /* A header that did not make it reads as the end of the log, whatever follows in the sector would be lost. */
+    if ((outbox->flash->program(outbox->write_sector, offset, &header, sizeof(header)) == false) ||
+        (outbox->flash->program(outbox->write_sector, offset + sizeof(header), data, size) == false)) {
+        outbox->write_offset = outbox->flash->sector_size;
+        return false;
+    }
+
+    return true;
+}
+
+static bool Outbox_OpenSector (sOutbox_t *outbox, size_t sector) {
+    uint32_t sequence = outbox->sector_sequence[outbox->write_sector] + 1;
+    sOutboxSectorHeader_t header = {.magic = SECTOR_MAGIC, .sequence = sequence, .erase_count = outbox->erase_count[sector] + 1};
+
+    outbox->sector_sequence[sector] = 0;
+
+    if (outbox->flash->erase(sector) == false) {
+        return false;
+    }
+
+    outbox->stats.erases++;
+    outbox->erase_count[sector] = header.erase_count;
+
+    if (header.erase_count > outbox->stats.max_erase_count) {
+        outbox->stats.max_erase_count = header.erase_count;
+    }
+
+    header.crc = Outbox_UpdateCrc(CRC_INIT, &header, offsetof(sOutboxSectorHeader_t, crc)) ^ CRC_INIT;
+
+    if (outbox->flash->program(sector, 0, &header, sizeof(header)) == false) {
+        return false;
+    }
+
+    outbox->sector_sequence[sector] = sequence;
+    outbox->write_sector = sector;
+    outbox->write_offset = sizeof(header);
+
+    /* The erased sector may have held the latest commit record, restate it before any new data. */
+    if (outbox->committed_sequence > 0) {
+        return Outbox_WriteRecord(outbox, RECORD_TYPE_COMMIT, outbox->committed_sequence,
+                                  &outbox->committed_sequence, sizeof(outbox->committed_sequence));
+    }
+
+    return true;
+}
+
+static bool Outbox_Rotate (sOutbox_t *outbox) {
+    size_t next_sector = Outbox_NextSector(outbox, outbox->write_sector);
+
+    /* The outbox is full, the oldest sector is recycled and whatever was still pending in it is lost. */
+    if (outbox->sector_sequence[next_sector] != 0) {
+        sOutboxCursor_t cursor = {.sector = next_sector, .offset = sizeof(sOutboxSectorHeader_t), .sequence = 0};
+        sOutboxRecordHeader_t header;
+
+        while ((cursor.sector == next_sector) && Outbox_NextRecord(outbox, &cursor, &header)) {
+            if (cursor.sector != next_sector) {
+                break;
+            }
+
+            if ((header.type == RECORD_TYPE_DATA) && (header.sequence > outbox->committed_sequence)) {
+                if (header.flags == RECORD_FLAGS_PENDING) {
+                    outbox->stats.lost++;
+                }
+
+                outbox->committed_sequence = header.sequence;
+            }
+
+            cursor.offset += RECORD_ALIGN(sizeof(header) + header.size);
+        }
+    }
+
+    bool is_opened = Outbox_OpenSector(outbox, next_sector);
+
+    Outbox_Seek(outbox);
+
+    return is_opened;
+}
+
+static void Outbox_Seek (sOutbox_t *outbox) {
+    sOutboxCursor_t cursor = {.sector = Outbox_FindOldestSector(outbox), .offset = sizeof(sOutboxSectorHeader_t),
+                              .sequence = outbox->committed_sequence};
+    sOutboxRecordHeader_t header;
+
+    while (Outbox_NextRecord(outbox, &cursor, &header)) {
+        if ((header.type == RECORD_TYPE_DATA) && (header.sequence > outbox->committed_sequence)) {
+            break;
+        }
+
+        cursor.offset += RECORD_ALIGN(sizeof(header) + header.size);
+    }
+
+    outbox->read_cursor = cursor;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Outbox_Mount (sOutbox_t *outbox, const sOutboxFlash_t *flash) {
+    if ((outbox == NULL) || (flash == NULL) || (flash->read == NULL) || (flash->program == NULL) || (flash->erase == NULL) ||
+        (flash->sector_count < 2) || (flash->sector_count > OUTBOX_MAX_SECTORS) ||
+        (flash->sector_size <= (sizeof(sOutboxSectorHeader_t) + sizeof(sOutboxRecordHeader_t) + OUTBOX_MAX_RECORD_SIZE))) {
+        return false;
+    }
+
+    memset(outbox, 0, sizeof(sOutbox_t));
+    outbox->flash = flash;
+
+    bool is_any_used = false;
+
+    for (size_t sector = 0; sector < flash->sector_count; sector++) {
+        sOutboxSectorHeader_t header;
+
+        if (flash->read(sector, 0, &header, sizeof(header)) == false) {
+            return false;
+        }
+
+        uint32_t crc = Outbox_UpdateCrc(CRC_INIT, &header, offsetof(sOutboxSectorHeader_t, crc)) ^ CRC_INIT;
+
+        if ((header.magic != SECTOR_MAGIC) || (header.crc != crc) || (header.sequence == 0)) {
+            continue;
+        }
+
+        outbox->sector_sequence[sector] = header.sequence;
+        outbox->erase_count[sector] = header.erase_count;
+
+        if (header.erase_count > outbox->stats.max_erase_count) {
+            outbox->stats.max_erase_count = header.erase_count;
+        }
+
+        if ((is_any_used == false) || (header.sequence > outbox->sector_sequence[outbox->write_sector])) {
+            outbox->write_sector = sector;
+        }
+
+        is_any_used = true;
+    }
+
+    outbox->next_sequence = 1;
+
+    if (is_any_used == false) {
+        if (Outbox_OpenSector(outbox, 0) == false) {
+            return false;
+        }
+
+        outbox->read_cursor = (sOutboxCursor_t) {.sector = 0, .offset = outbox->write_offset, .sequence = 0};
+        outbox->is_mounted = true;
+
+        return true;
+    }
+
+    /* Replay the log oldest first: the newest data sequence, the newest commit and the write position. */
+    sOutboxCursor_t cursor = {.sector = Outbox_FindOldestSector(outbox), .offset = sizeof(sOutboxSectorHeader_t), .sequence = 0};
+
+    while (1) {
+        sOutboxRecordHeader_t header;
+        eRecordStatus_t status = Outbox_CheckRecord(outbox, cursor.sector, cursor.offset, &header);
+
+        if (status == eRecordStatus_Valid) {
+            if ((header.type == RECORD_TYPE_DATA) && (header.sequence >= outbox->next_sequence)) {
+                outbox->next_sequence = header.sequence + 1;
+            } else if ((header.type == RECORD_TYPE_COMMIT) && (header.sequence > outbox->committed_sequence)) {
+                outbox->committed_sequence = header.sequence;
+            }
+        } else if (status == eRecordStatus_Corrupted) {
+            outbox->stats.corrupted++;
+        }
+
+        if (status != eRecordStatus_End) {
+            cursor.offset += RECORD_ALIGN(sizeof(header) + header.size);
+            continue;
+        }
+
+        if (cursor.sector == outbox->write_sector) {
+            break;
+        }
+
+        cursor.sector = Outbox_NextSector(outbox, cursor.sector);
+        cursor.offset = sizeof(sOutboxSectorHeader_t);
+    }
+
+    outbox->write_offset = cursor.offset;
+
+    /* Whatever follows the last record must still be erased, otherwise start over in a fresh sector. */
+    uint8_t probe[sizeof(sOutboxRecordHeader_t)];
+    if ((outbox->write_offset + sizeof(probe)) <= flash->sector_size) {
+        if (flash->read(outbox->write_sector, outbox->write_offset, probe, sizeof(probe)) == false) {
+            return false;
+        }
+
+        for (size_t i = 0; i < sizeof(probe); i++) {
+            if (probe[i] != RECORD_TYPE_ERASED) {
+                outbox->write_offset = flash->sector_size;
+                break;
+            }
+        }
+    }
+
+    Outbox_Seek(outbox);
+    outbox->is_mounted = true;
+
+    return true;
+}
+
+bool Outbox_Append (sOutbox_t *outbox, const void *data, size_t size, sOutboxCursor_t *record) {
+    if ((outbox == NULL) || (outbox->is_mounted == false) || (data == NULL) || (size == 0) || (size > OUTBOX_MAX_RECORD_SIZE)) {
+        return false;
+    }
+
+    if ((outbox->write_offset + RECORD_ALIGN(sizeof(sOutboxRecordHeader_t) + size)) > outbox->flash->sector_size) {
+        if (Outbox_Rotate(outbox) == false) {
+            return false;
+        }
+    }
+
+    size_t offset = outbox->write_offset;
+
+    if (Outbox_WriteRecord(outbox, RECORD_TYPE_DATA, outbox->next_sequence, data, size) == false) {
+        outbox->next_sequence++;
+        return false;
+    }
+
+    if (record != NULL) {
+        *record = (sOutboxCursor_t) {.sector = outbox->write_sector, .offset = offset, .sequence = outbox->next_sequence,
+                                     .record_offset = offset};
+    }
+
+    outbox->next_sequence++;
+    outbox->stats.appended++;
+
+    return true;
+}
+
+bool Outbox_GetReadCursor (const sOutbox_t *outbox, sOutboxCursor_t *cursor) {
+    if ((outbox == NULL) || (outbox->is_mounted == false) || (cursor == NULL)) {
+        return false;
+    }
+
+    *cursor = outbox->read_cursor;
+
+    return true;
+}
+
+size_t Outbox_Read (sOutbox_t *outbox, sOutboxCursor_t *cursor, void *buffer, size_t buffer_size) {
+    if ((outbox == NULL) || (outbox->is_mounted == false) || (cursor == NULL) || (buffer == NULL)) {
+        return 0;
+    }
+
+    sOutboxRecordHeader_t header;
+
+    while (Outbox_NextRecord(outbox, cursor, &header)) {
+        if ((header.type != RECORD_TYPE_DATA) || (header.sequence <= outbox->committed_sequence) ||
+            (header.flags != RECORD_FLAGS_PENDING)) {
+            cursor->offset += RECORD_ALIGN(sizeof(header) + header.size);
+            continue;
+        }
+
+        if (header.size > buffer_size) {
+            return 0;
+        }
+
+        if (outbox->flash->read(cursor->sector, cursor->offset + sizeof(header), buffer, header.size) == false) {
+            return 0;
+        }
+
+        cursor->record_offset = cursor->offset;
+        cursor->offset += RECORD_ALIGN(sizeof(header) + header.size);
+        cursor->sequence = header.sequence;
+
+        return header.size;
+    }
+
+    return 0;
+}
+
+bool Outbox_Commit (sOutbox_t *outbox, const sOutboxCursor_t *cursor) {
+    if ((outbox == NULL) || (outbox->is_mounted == false) || (cursor == NULL)) {
+        return false;
+    }
+
+    if (cursor->sequence <= outbox->committed_sequence) {
+        return true;
+    }
+
+    uint32_t sequence = cursor->sequence;
+
+    if ((outbox->write_offset + RECORD_ALIGN(sizeof(sOutboxRecordHeader_t) + sizeof(sequence))) > outbox->flash->sector_size) {
+        outbox->stats.committed += sequence - outbox->committed_sequence;
+        outbox->committed_sequence = sequence;
+
+        /* Opening the next sector writes the commit record already. */
+        return Outbox_Rotate(outbox);
+    }
+
+    if (Outbox_WriteRecord(outbox, RECORD_TYPE_COMMIT, sequence, &sequence, sizeof(sequence)) == false) {
+        return false;
+    }
+
+    outbox->stats.committed += sequence - outbox->committed_sequence;
+    outbox->committed_sequence = sequence;
+    outbox->read_cursor = *cursor;
+
+    return true;
+}
+
+bool Outbox_MarkDelivered (sOutbox_t *outbox, const sOutboxCursor_t *record) {
+    if ((outbox == NULL) || (outbox->is_mounted == false) || (record == NULL)) {
+        return false;
+    }
+
+    if (record->sequence <= outbox->committed_sequence) {
+        return true;
+    }
+
+    sOutboxRecordHeader_t header;
+
+    if (outbox->flash->read(record->sector, record->record_offset, &header, sizeof(header)) == false) {
+        return false;
+    }
+
+    /* The sector may have been recycled since the record was read */
+    if ((header.type != RECORD_TYPE_DATA) || (header.sequence != record->sequence)) {
+        return false;
+    }
+
+    uint8_t flags = RECORD_FLAGS_DELIVERED;
+
+    return outbox->flash->program(record->sector, record->record_offset + offsetof(sOutboxRecordHeader_t, flags),
+                                  &flags, sizeof(flags));
+}
+
+bool Outbox_CommitDelivered (sOutbox_t *outbox) {
+    if ((outbox == NULL) || (outbox->is_mounted == false)) {
+        return false;
+    }
+
+    sOutboxCursor_t cursor = outbox->read_cursor;
+    sOutboxCursor_t commit_cursor = cursor;
+    sOutboxRecordHeader_t header;
+
+    commit_cursor.sequence = outbox->committed_sequence;
+
+    /* The commit moves up to the first record that is still pending */
+    while (Outbox_NextRecord(outbox, &cursor, &header)) {
+        if ((header.type == RECORD_TYPE_DATA) && (header.sequence > outbox->committed_sequence)) {
+            if (header.flags == RECORD_FLAGS_PENDING) {
+                break;
+            }
+
+            commit_cursor.sequence = header.sequence;
+        }
+
+        cursor.offset += RECORD_ALIGN(sizeof(header) + header.size);
+        commit_cursor.sector = cursor.sector;
+        commit_cursor.offset = cursor.offset;
+    }
+
+    return Outbox_Commit(outbox, &commit_cursor);
+}
+
+uint32_t Outbox_GetPending (const sOutbox_t *outbox) {
+    if ((outbox == NULL) || (outbox->is_mounted == false)) {
+        return 0;
+    }
+
+    return (outbox->next_sequence - 1) - outbox->committed_sequence;
+}
+
+bool Outbox_GetStats (const sOutbox_t *outbox, sOutboxStats_t *stats) {
+    if ((outbox == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    *stats = outbox->stats;
+
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef SOURCE_UTILITY_OUTBOX_H_
+#define SOURCE_UTILITY_OUTBOX_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define OUTBOX_MAX_SECTORS 4
+#define OUTBOX_MAX_RECORD_SIZE 512
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Flash access used by the outbox, erased bytes must read back as 0xFF and programming may only clear bits. */
+typedef struct sOutboxFlash {
+    size_t sector_count;
+    size_t sector_size;
+    bool (*read) (size_t sector, size_t offset, void *data, size_t size);
+    bool (*program) (size_t sector, size_t offset, const void *data, size_t size);
+    bool (*erase) (size_t sector);
+} sOutboxFlash_t;
+
+typedef struct sOutboxCursor {
+    size_t sector;
+    size_t offset;
+    uint32_t sequence;
+    /* Where the record Outbox_Read returned last starts */
+    size_t record_offset;
+} sOutboxCursor_t;
+
+typedef struct sOutboxStats {
+    uint32_t appended;
+    uint32_t committed;
+    uint32_t lost;
+    uint32_t corrupted;
+    uint32_t erases;
+    uint32_t max_erase_count;
+} sOutboxStats_t;
+
+typedef struct sOutbox {
+    const sOutboxFlash_t *flash;
+    bool is_mounted;
+    size_t write_sector;
+    size_t write_offset;
+    uint32_t sector_sequence[OUTBOX_MAX_SECTORS];
+    uint32_t erase_count[OUTBOX_MAX_SECTORS];
+    uint32_t next_sequence;
+    uint32_t committed_sequence;
+    sOutboxCursor_t read_cursor;
+    sOutboxStats_t stats;
+} sOutbox_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool Outbox_Mount (sOutbox_t *outbox, const sOutboxFlash_t *flash);
+/* The cursor of the new record is returned through record unless it is NULL, Outbox_Read from it yields that record */
+bool Outbox_Append (sOutbox_t *outbox, const void *data, size_t size, sOutboxCursor_t *record);
+bool Outbox_GetReadCursor (const sOutbox_t *outbox, sOutboxCursor_t *cursor);
+size_t Outbox_Read (sOutbox_t *outbox, sOutboxCursor_t *cursor, void *buffer, size_t buffer_size);
+bool Outbox_Commit (sOutbox_t *outbox, const sOutboxCursor_t *cursor);
+/* Out of order delivery: the record last read with the cursor is skipped from now on, Outbox_CommitDelivered moves
+ * the commit over every delivered record up to the first pending one */
+bool Outbox_MarkDelivered (sOutbox_t *outbox, const sOutboxCursor_t *record);
+bool Outbox_CommitDelivered (sOutbox_t *outbox);
+/* Records behind the commit, delivered ones queued behind a pending record included */
+uint32_t Outbox_GetPending (const sOutbox_t *outbox);
+bool Outbox_GetStats (const sOutbox_t *outbox, sOutboxStats_t *stats);
+#endif /* SOURCE_UTILITY_OUTBOX_H_ */
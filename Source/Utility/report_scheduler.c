@@ -0,0 +1,375 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "report_scheduler.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define MS_PER_S 1000U
+#define HOUR_MS 3600000U
+/* Keeps every interval in ms inside 32 bits */
+#define MAX_INTERVAL_S 86400U
+#define FULL_CIRCLE 36000
+#define HALF_CIRCLE 18000
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const sReportSchedulerConfig_t g_default_config = {
+    .policy = {
+        [eReportMotion_Stationary] = {.fix_interval_s = 300, .upload_interval_s = 1800, .batch_size = 16},
+        [eReportMotion_Slow] = {.fix_interval_s = 10, .upload_interval_s = 120, .batch_size = 24},
+        [eReportMotion_Highway] = {.fix_interval_s = 5, .upload_interval_s = 60, .batch_size = 24}
+    },
+    .slow_speed = REPORT_SCHEDULER_DEFAULT_SLOW_SPEED,
+    .highway_speed = REPORT_SCHEDULER_DEFAULT_HIGHWAY_SPEED,
+    .turn_heading_change = REPORT_SCHEDULER_DEFAULT_TURN_HEADING_CHANGE,
+    .turn_fix_interval_s = REPORT_SCHEDULER_DEFAULT_TURN_FIX_INTERVAL_S,
+    .stop_dwell_s = REPORT_SCHEDULER_DEFAULT_STOP_DWELL_S,
+    .backlog_limit = REPORT_SCHEDULER_DEFAULT_BACKLOG_LIMIT,
+    .min_signal = REPORT_SCHEDULER_DEFAULT_MIN_SIGNAL,
+    .max_defer_s = REPORT_SCHEDULER_DEFAULT_MAX_DEFER_S,
+    .signal_retry_s = REPORT_SCHEDULER_DEFAULT_SIGNAL_RETRY_S,
+    .radio_tail_s = REPORT_SCHEDULER_DEFAULT_RADIO_TAIL_S
+};
+
+static const char *g_motion_names[eReportMotion_Last] = {
+    [eReportMotion_Stationary] = "stationary",
+    [eReportMotion_Slow] = "slow",
+    [eReportMotion_Highway] = "highway"
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static uint32_t ReportScheduler_Remaining (uint32_t elapsed_ms, uint32_t interval_ms);
+static uint32_t ReportScheduler_GetFixInterval (const sReportScheduler_t *scheduler);
+static eReportMotion_t ReportScheduler_Classify (const sReportScheduler_t *scheduler, uint16_t speed);
+static uint32_t ReportScheduler_HeadingChange (uint16_t from, uint16_t to);
+static bool ReportScheduler_IsRadioAwake (const sReportScheduler_t *scheduler, uint32_t now_ms);
+static void ReportScheduler_RollHour (sReportScheduler_t *scheduler, uint32_t now_ms);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static uint32_t ReportScheduler_Remaining (uint32_t elapsed_ms, uint32_t interval_ms) {
+    return (elapsed_ms >= interval_ms) ? 0 : (interval_ms - elapsed_ms);
+}
+
+/* A turn shortens the fix interval until the heading settles, so corners are not cut from the track. */
+static uint32_t ReportScheduler_GetFixInterval (const sReportScheduler_t *scheduler) {
+    uint32_t interval_s = scheduler->config.policy[scheduler->motion].fix_interval_s;
+
+    if (scheduler->is_turning && (scheduler->config.turn_fix_interval_s < interval_s)) {
+        interval_s = scheduler->config.turn_fix_interval_s;
+    }
+
+    return interval_s * MS_PER_S;
+}
+
+/* A level is left downwards only a quarter below its threshold, a speed hovering at a threshold does not flip the
+ * cadence on every fix. */
+static eReportMotion_t ReportScheduler_Classify (const sReportScheduler_t *scheduler, uint16_t speed) {
+    const sReportSchedulerConfig_t *config = &scheduler->config;
+    eReportMotion_t motion = eReportMotion_Stationary;
+
+    if (speed >= config->highway_speed) {
+        motion = eReportMotion_Highway;
+    } else if (speed >= config->slow_speed) {
+        motion = eReportMotion_Slow;
+    }
+
+    if (motion < scheduler->motion) {
+        uint16_t threshold = (scheduler->motion == eReportMotion_Highway) ? config->highway_speed : config->slow_speed;
+
+        if (speed >= (threshold - (threshold / 4))) {
+            motion = scheduler->motion;
+        }
+    }
+
+    return motion;
+}
+
+static uint32_t ReportScheduler_HeadingChange (uint16_t from, uint16_t to) {
+    uint32_t change = (from > to) ? (from - to) : (to - from);
+
+    change %= FULL_CIRCLE;
+
+    return (change > HALF_CIRCLE) ? (FULL_CIRCLE - change) : change;
+}
+
+/* Only traffic after the last upload counts, the upload itself would otherwise keep the radio awake for good. */
+static bool ReportScheduler_IsRadioAwake (const sReportScheduler_t *scheduler, uint32_t now_ms) {
+    if (scheduler->has_radio_activity == false) {
+        return false;
+    }
+
+    if ((int32_t) (scheduler->radio_ms - scheduler->upload_ms) <= 0) {
+        return false;
+    }
+
+    return ((now_ms - scheduler->radio_ms) < (scheduler->config.radio_tail_s * MS_PER_S));
+}
+
+static void ReportScheduler_RollHour (sReportScheduler_t *scheduler, uint32_t now_ms) {
+    uint32_t elapsed_ms = now_ms - scheduler->hour_start_ms;
+
+    if (elapsed_ms < HOUR_MS) {
+        return;
+    }
+
+    if (elapsed_ms < (2 * HOUR_MS)) {
+        scheduler->stats.fixes_last_hour = scheduler->stats.fixes_this_hour;
+        scheduler->stats.uploads_last_hour = scheduler->stats.uploads_this_hour;
+        scheduler->hour_start_ms += HOUR_MS;
+    } else {
+        scheduler->stats.fixes_last_hour = 0;
+        scheduler->stats.uploads_last_hour = 0;
+        scheduler->hour_start_ms = now_ms;
+    }
+
+    scheduler->stats.fixes_this_hour = 0;
+    scheduler->stats.uploads_this_hour = 0;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void ReportScheduler_Init (sReportScheduler_t *scheduler, const sReportSchedulerConfig_t *config, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return;
+    }
+
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->config = (config != NULL) ? *config : g_default_config;
+    scheduler->motion = eReportMotion_Stationary;
+    scheduler->fix_request_ms = now_ms - ReportScheduler_GetFixInterval(scheduler);
+    scheduler->upload_ms = now_ms;
+    scheduler->hour_start_ms = now_ms;
+}
+
+bool ReportScheduler_SetPolicy (sReportScheduler_t *scheduler, eReportMotion_t motion, const sReportPolicy_t *policy) {
+    if ((scheduler == NULL) || (policy == NULL) || (motion < eReportMotion_First) || (motion >= eReportMotion_Last)) {
+        return false;
+    }
+
+    if ((policy->fix_interval_s == 0) || (policy->fix_interval_s > MAX_INTERVAL_S) ||
+        (policy->upload_interval_s == 0) || (policy->upload_interval_s > MAX_INTERVAL_S) || (policy->batch_size == 0)) {
+        return false;
+    }
+
+    scheduler->config.policy[motion] = *policy;
+
+    return true;
+}
+
+bool ReportScheduler_GetPolicy (const sReportScheduler_t *scheduler, eReportMotion_t motion, sReportPolicy_t *policy) {
+    if ((scheduler == NULL) || (policy == NULL) || (motion < eReportMotion_First) || (motion >= eReportMotion_Last)) {
+        return false;
+    }
+
+    *policy = scheduler->config.policy[motion];
+
+    return true;
+}
+
+eReportMotion_t ReportScheduler_GetMotion (const sReportScheduler_t *scheduler) {
+    return (scheduler != NULL) ? scheduler->motion : eReportMotion_Stationary;
+}
+
+const char *ReportScheduler_GetMotionName (eReportMotion_t motion) {
+    if ((motion < eReportMotion_First) || (motion >= eReportMotion_Last)) {
+        return "unknown";
+    }
+
+    return g_motion_names[motion];
+}
+
+bool ReportScheduler_IsFixDue (const sReportScheduler_t *scheduler, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return false;
+    }
+
+    return ((now_ms - scheduler->fix_request_ms) >= ReportScheduler_GetFixInterval(scheduler));
+}
+
+void ReportScheduler_OnFixRequest (sReportScheduler_t *scheduler, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return;
+    }
+
+    scheduler->fix_request_ms = now_ms;
+}
+
+void ReportScheduler_OnFix (sReportScheduler_t *scheduler, uint16_t speed, uint16_t course, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return;
+    }
+
+    ReportScheduler_RollHour(scheduler, now_ms);
+    scheduler->stats.fixes++;
+    scheduler->stats.fixes_this_hour++;
+
+    eReportMotion_t motion = ReportScheduler_Classify(scheduler, speed);
+
+    if ((motion == eReportMotion_Stationary) && (scheduler->motion != eReportMotion_Stationary)) {
+        if (scheduler->is_stopping == false) {
+            scheduler->is_stopping = true;
+            scheduler->stop_ms = now_ms;
+        }
+
+        if ((now_ms - scheduler->stop_ms) < (scheduler->config.stop_dwell_s * MS_PER_S)) {
+            motion = eReportMotion_Slow;
+        }
+    } else {
+        scheduler->is_stopping = false;
+    }
+
+    if (motion != scheduler->motion) {
+        scheduler->motion = motion;
+        scheduler->stats.motion_changes++;
+    }
+
+    /* The course of a standing receiver is noise */
+    bool has_course = (speed >= scheduler->config.slow_speed);
+
+    scheduler->is_turning = has_course && scheduler->has_course && (scheduler->config.turn_heading_change != 0) &&
+                            (ReportScheduler_HeadingChange(scheduler->course, course) > scheduler->config.turn_heading_change);
+    scheduler->has_course = has_course;
+    scheduler->course = course;
+}
+
+void ReportScheduler_OnRadioActivity (sReportScheduler_t *scheduler, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return;
+    }
+
+    scheduler->has_radio_activity = true;
+    scheduler->radio_ms = now_ms;
+}
+
+eReportTrigger_t ReportScheduler_GetUploadTrigger (const sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending) {
+    if ((scheduler == NULL) || (pending == 0)) {
+        return eReportTrigger_None;
+    }
+
+    /* A deferred upload only asks for the signal again after the retry interval. */
+    if (scheduler->is_deferring && ((now_ms - scheduler->signal_check_ms) < (scheduler->config.signal_retry_s * MS_PER_S))) {
+        return eReportTrigger_None;
+    }
+
+    const sReportPolicy_t *policy = &scheduler->config.policy[scheduler->motion];
+
+    if (pending >= policy->batch_size) {
+        return eReportTrigger_Batch;
+    }
+
+    if ((now_ms - scheduler->upload_ms) >= (policy->upload_interval_s * MS_PER_S)) {
+        return eReportTrigger_Interval;
+    }
+
+    if (ReportScheduler_IsRadioAwake(scheduler, now_ms)) {
+        return eReportTrigger_Radio;
+    }
+
+    return eReportTrigger_None;
+}
+
+/* A poor or unknown signal holds the upload back, a full backlog or one held back too long goes out anyway. */
+bool ReportScheduler_CheckSignal (sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending, int signal) {
+    if (scheduler == NULL) {
+        return false;
+    }
+
+    const sReportSchedulerConfig_t *config = &scheduler->config;
+    bool is_poor = (signal == REPORT_SCHEDULER_SIGNAL_UNKNOWN) || (signal < config->min_signal);
+
+    scheduler->signal_check_ms = now_ms;
+
+    if (is_poor == false) {
+        scheduler->is_deferring = false;
+        return true;
+    }
+
+    if ((pending >= config->backlog_limit) ||
+        (scheduler->is_deferring && ((now_ms - scheduler->defer_start_ms) >= (config->max_defer_s * MS_PER_S)))) {
+        scheduler->is_deferring = false;
+        scheduler->stats.uploads_forced++;
+        return true;
+    }
+
+    if (scheduler->is_deferring == false) {
+        scheduler->is_deferring = true;
+        scheduler->defer_start_ms = now_ms;
+        scheduler->stats.deferrals++;
+    }
+
+    return false;
+}
+
+void ReportScheduler_OnUpload (sReportScheduler_t *scheduler, eReportTrigger_t trigger, uint32_t now_ms) {
+    if (scheduler == NULL) {
+        return;
+    }
+
+    ReportScheduler_RollHour(scheduler, now_ms);
+    scheduler->upload_ms = now_ms;
+    scheduler->stats.uploads++;
+    scheduler->stats.uploads_this_hour++;
+
+    if (trigger == eReportTrigger_Batch) {
+        scheduler->stats.uploads_batch++;
+    } else if (trigger == eReportTrigger_Radio) {
+        scheduler->stats.uploads_radio++;
+    }
+}
+
+/* Radio activity is not counted here, the caller evaluates again when it reports it. */
+uint32_t ReportScheduler_GetDelay (const sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending) {
+    if (scheduler == NULL) {
+        return 0;
+    }
+
+    uint32_t delay_ms = ReportScheduler_Remaining(now_ms - scheduler->fix_request_ms, ReportScheduler_GetFixInterval(scheduler));
+
+    if (pending == 0) {
+        return delay_ms;
+    }
+
+    const sReportPolicy_t *policy = &scheduler->config.policy[scheduler->motion];
+    uint32_t upload_delay_ms = 0;
+
+    if (scheduler->is_deferring) {
+        upload_delay_ms = ReportScheduler_Remaining(now_ms - scheduler->signal_check_ms, scheduler->config.signal_retry_s * MS_PER_S);
+    } else if (pending < policy->batch_size) {
+        upload_delay_ms = ReportScheduler_Remaining(now_ms - scheduler->upload_ms, policy->upload_interval_s * MS_PER_S);
+    }
+
+    return (upload_delay_ms < delay_ms) ? upload_delay_ms : delay_ms;
+}
+
+/* Read only, the hour is rolled on a copy so other tasks can ask. */
+bool ReportScheduler_GetStats (const sReportScheduler_t *scheduler, uint32_t now_ms, sReportSchedulerStats_t *stats) {
+    if ((scheduler == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    sReportScheduler_t snapshot = *scheduler;
+
+    ReportScheduler_RollHour(&snapshot, now_ms);
+    *stats = snapshot.stats;
+
+    return true;
+}
@@ -0,0 +1,130 @@
+#ifndef SOURCE_UTILITY_REPORT_SCHEDULER_H_
+#define SOURCE_UTILITY_REPORT_SCHEDULER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Same unit as the +CSQ rssi, 99 is an unknown level */
+#define REPORT_SCHEDULER_SIGNAL_UNKNOWN 99
+
+#define REPORT_SCHEDULER_DEFAULT_SLOW_SPEED 140
+#define REPORT_SCHEDULER_DEFAULT_HIGHWAY_SPEED 2000
+#define REPORT_SCHEDULER_DEFAULT_TURN_HEADING_CHANGE 3000
+#define REPORT_SCHEDULER_DEFAULT_TURN_FIX_INTERVAL_S 2
+#define REPORT_SCHEDULER_DEFAULT_STOP_DWELL_S 120
+#define REPORT_SCHEDULER_DEFAULT_BACKLOG_LIMIT 48
+#define REPORT_SCHEDULER_DEFAULT_MIN_SIGNAL 8
+#define REPORT_SCHEDULER_DEFAULT_MAX_DEFER_S 600
+#define REPORT_SCHEDULER_DEFAULT_SIGNAL_RETRY_S 60
+#define REPORT_SCHEDULER_DEFAULT_RADIO_TAIL_S 10
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eReportMotion {
+    eReportMotion_First = 0,
+    eReportMotion_Stationary = eReportMotion_First,
+    eReportMotion_Slow,
+    eReportMotion_Highway,
+    eReportMotion_Last
+} eReportMotion_t;
+
+typedef enum eReportTrigger {
+    eReportTrigger_First = 0,
+    eReportTrigger_None = eReportTrigger_First,
+    eReportTrigger_Interval,
+    eReportTrigger_Batch,
+    /* Another sender woke the radio up, the points ride along before it goes idle again */
+    eReportTrigger_Radio,
+    eReportTrigger_Last
+} eReportTrigger_t;
+
+/* One row of the policy table, picked by the motion state */
+typedef struct sReportPolicy {
+    uint32_t fix_interval_s;
+    uint32_t upload_interval_s;
+    /* Pending points that start an upload before the interval runs out */
+    uint16_t batch_size;
+} sReportPolicy_t;
+
+/* Speeds in 0.01 m/s and heading in 0.01 deg, as in sTrackPoint_t. */
+typedef struct sReportSchedulerConfig {
+    sReportPolicy_t policy[eReportMotion_Last];
+    uint16_t slow_speed;
+    uint16_t highway_speed;
+    uint16_t turn_heading_change;
+    uint32_t turn_fix_interval_s;
+    /* Time at standstill before the stationary row applies, a traffic light does not stretch the cadence */
+    uint32_t stop_dwell_s;
+    /* Pending points that are sent even on a poor signal */
+    uint32_t backlog_limit;
+    int min_signal;
+    uint32_t max_defer_s;
+    uint32_t signal_retry_s;
+    uint32_t radio_tail_s;
+} sReportSchedulerConfig_t;
+
+typedef struct sReportSchedulerStats {
+    uint32_t fixes;
+    uint32_t uploads;
+    uint32_t uploads_batch;
+    uint32_t uploads_radio;
+    uint32_t uploads_forced;
+    uint32_t deferrals;
+    uint32_t motion_changes;
+    /* The last full hour and the one in progress */
+    uint32_t fixes_last_hour;
+    uint32_t uploads_last_hour;
+    uint32_t fixes_this_hour;
+    uint32_t uploads_this_hour;
+} sReportSchedulerStats_t;
+
+/* Times are in ms of a free running tick, wrap around is handled. */
+typedef struct sReportScheduler {
+    sReportSchedulerConfig_t config;
+    sReportSchedulerStats_t stats;
+    eReportMotion_t motion;
+    bool has_course;
+    uint16_t course;
+    bool is_turning;
+    bool is_stopping;
+    uint32_t stop_ms;
+    uint32_t fix_request_ms;
+    uint32_t upload_ms;
+    bool is_deferring;
+    uint32_t defer_start_ms;
+    uint32_t signal_check_ms;
+    bool has_radio_activity;
+    uint32_t radio_ms;
+    uint32_t hour_start_ms;
+} sReportScheduler_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* A NULL config selects the defaults. The first fix is due at once. */
+void ReportScheduler_Init (sReportScheduler_t *scheduler, const sReportSchedulerConfig_t *config, uint32_t now_ms);
+bool ReportScheduler_SetPolicy (sReportScheduler_t *scheduler, eReportMotion_t motion, const sReportPolicy_t *policy);
+bool ReportScheduler_GetPolicy (const sReportScheduler_t *scheduler, eReportMotion_t motion, sReportPolicy_t *policy);
+eReportMotion_t ReportScheduler_GetMotion (const sReportScheduler_t *scheduler);
+const char *ReportScheduler_GetMotionName (eReportMotion_t motion);
+bool ReportScheduler_IsFixDue (const sReportScheduler_t *scheduler, uint32_t now_ms);
+void ReportScheduler_OnFixRequest (sReportScheduler_t *scheduler, uint32_t now_ms);
+void ReportScheduler_OnFix (sReportScheduler_t *scheduler, uint16_t speed, uint16_t course, uint32_t now_ms);
+/* Traffic from other senders, it marks the radio as awake */
+void ReportScheduler_OnRadioActivity (sReportScheduler_t *scheduler, uint32_t now_ms);
+eReportTrigger_t ReportScheduler_GetUploadTrigger (const sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending);
+/* Only asked once an upload is due, false defers it. */
+bool ReportScheduler_CheckSignal (sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending, int signal);
+void ReportScheduler_OnUpload (sReportScheduler_t *scheduler, eReportTrigger_t trigger, uint32_t now_ms);
+/* Time until the next fix or upload is due, the single timer of the caller is armed with it. */
+uint32_t ReportScheduler_GetDelay (const sReportScheduler_t *scheduler, uint32_t now_ms, size_t pending);
+bool ReportScheduler_GetStats (const sReportScheduler_t *scheduler, uint32_t now_ms, sReportSchedulerStats_t *stats);
+#endif /* SOURCE_UTILITY_REPORT_SCHEDULER_H_ */
@@ -1,23 +1,23 @@
-#ifndef SOURCE_UTILITY_STRING_UTIL_H_
-#define SOURCE_UTILITY_STRING_UTIL_H_
-/**********************************************************************************************************************
- * Includes
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported definitions and macros
- *********************************************************************************************************************/
-#define DEFINE_STRING(s) { .str = (s), .size = (sizeof(s) - 1) }
-/**********************************************************************************************************************
- * Exported types
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Exported variables
- *********************************************************************************************************************/
-
-/**********************************************************************************************************************
- * Prototypes of exported functions
- *********************************************************************************************************************/
-
-#endif /* SOURCE_UTILITY_STRING_UTIL_H_ */
+#ifndef SOURCE_UTILITY_STRING_UTIL_H_
+#define SOURCE_UTILITY_STRING_UTIL_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define DEFINE_STRING(s) { .str = (s), .size = (sizeof(s) - 1) }
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+#endif /* SOURCE_UTILITY_STRING_UTIL_H_ */
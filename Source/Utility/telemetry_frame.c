@@ -0,0 +1,238 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "telemetry_frame.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define VARINT_CONTINUE 0x80
+#define VARINT_PAYLOAD 0x7F
+#define VARINT_MAX_SIZE 10
+#define CRC16_INIT 0xFFFF
+#define CRC16_POLY 0x1021
+#define CRC_SIZE 2
+#define VERSION_SHIFT 4
+#define FLAGS_MASK 0x0F
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static inline uint64_t TelemetryFrame_ZigZag (int64_t value);
+static inline int64_t TelemetryFrame_UnZigZag (uint64_t value);
+static bool TelemetryFrame_PutVarint (sBuffer_t *buffer, int64_t value);
+static bool TelemetryFrame_GetVarint (const uint8_t *data, size_t size, size_t *position, int64_t *value);
+static uint16_t TelemetryFrame_Crc16 (const uint8_t *data, size_t size);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static inline uint64_t TelemetryFrame_ZigZag (int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static inline int64_t TelemetryFrame_UnZigZag (uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1U);
+}
+
+static bool TelemetryFrame_PutVarint (sBuffer_t *buffer, int64_t value) {
+    uint64_t encoded = TelemetryFrame_ZigZag(value);
+
+    do {
+        if (buffer->count >= buffer->size) {
+            return false;
+        }
+
+        uint8_t byte = (uint8_t) (encoded & VARINT_PAYLOAD);
+        encoded >>= 7;
+
+        if (encoded != 0) {
+            byte |= VARINT_CONTINUE;
+        }
+
+        buffer->str[buffer->count++] = (char) byte;
+    } while (encoded != 0);
+
+    return true;
+}
+
+static bool TelemetryFrame_GetVarint (const uint8_t *data, size_t size, size_t *position, int64_t *value) {
+    uint64_t encoded = 0;
+
+    for (size_t shift = 0, i = 0; i < VARINT_MAX_SIZE; i++, shift += 7) {
+        if (*position >= size) {
+            return false;
+        }
+
+        uint8_t byte = data[(*position)++];
+        encoded |= ((uint64_t) (byte & VARINT_PAYLOAD)) << shift;
+
+        if ((byte & VARINT_CONTINUE) == 0) {
+            *value = TelemetryFrame_UnZigZag(encoded);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint16_t TelemetryFrame_Crc16 (const uint8_t *data, size_t size) {
+    uint16_t crc = CRC16_INIT;
+
+    for (size_t i = 0; i < size; i++) {
+        crc ^= (uint16_t) data[i] << 8;
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ CRC16_POLY) : (uint16_t) (crc << 1);
+        }
+    }
+
+    return crc;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool TelemetryFrame_Begin (sTelemetryEncoder_t *encoder, sBuffer_t *buffer, const sTelemetryHeader_t *header, bool with_crc) {
+    if ((encoder == NULL) || (buffer == NULL) || (buffer->str == NULL) || (header == NULL) ||
+        (buffer->size < TELEMETRY_FRAME_OVERHEAD)) {
+        return false;
+    }
+
+    memset(encoder, 0, sizeof(sTelemetryEncoder_t));
+    encoder->buffer = buffer;
+    encoder->with_crc = with_crc;
+
+    buffer->count = 0;
+    buffer->str[buffer->count++] = (char) ((TELEMETRY_FRAME_VERSION << VERSION_SHIFT) | (with_crc ? TELEMETRY_FRAME_FLAG_CRC : 0));
+    buffer->str[buffer->count++] = (char) ((TELEMETRY_HEADER_FIELD_COUNT << VERSION_SHIFT) | TELEMETRY_POINT_FIELD_COUNT);
+
+#define TELEMETRY_ENCODE_HEADER(name, type, unit) TelemetryFrame_PutVarint(buffer, (int64_t) header->name);
+    TELEMETRY_HEADER_FIELDS(TELEMETRY_ENCODE_HEADER)
+#undef TELEMETRY_ENCODE_HEADER
+
+    return true;
+}
+
+bool TelemetryFrame_AddPoint (sTelemetryEncoder_t *encoder, const sTelemetryPoint_t *point) {
+    if ((encoder == NULL) || (encoder->buffer == NULL) || (point == NULL)) {
+        return false;
+    }
+
+    sBuffer_t *buffer = encoder->buffer;
+    size_t reserved = encoder->with_crc ? CRC_SIZE : 0;
+
+    /* Worst case check up front, so a point that does not fit leaves the frame untouched. */
+    if ((buffer->count + TELEMETRY_POINT_MAX_SIZE + reserved) > buffer->size) {
+        return false;
+    }
+
+#define TELEMETRY_ENCODE_POINT(name, type, unit) \
+    TelemetryFrame_PutVarint(buffer, (int64_t) point->name - (int64_t) encoder->previous.name);
+    TELEMETRY_POINT_FIELDS(TELEMETRY_ENCODE_POINT)
+#undef TELEMETRY_ENCODE_POINT
+
+    encoder->previous = *point;
+    encoder->points++;
+
+    return true;
+}
+
+size_t TelemetryFrame_Finish (sTelemetryEncoder_t *encoder) {
+    if ((encoder == NULL) || (encoder->buffer == NULL)) {
+        return 0;
+    }
+
+    sBuffer_t *buffer = encoder->buffer;
+
+    if (encoder->with_crc == true) {
+        uint16_t crc = TelemetryFrame_Crc16((const uint8_t *) buffer->str, buffer->count);
+        buffer->str[buffer->count++] = (char) (crc >> 8);
+        buffer->str[buffer->count++] = (char) (crc & 0xFF);
+    }
+
+    return buffer->count;
+}
+
+bool TelemetryFrame_Decode (sString_t frame, sTelemetryHeader_t *header, sTelemetryPoint_t *points, size_t max_points, size_t *point_count) {
+    if ((frame.str == NULL) || (frame.size < 2) || (header == NULL) || (point_count == NULL) || 
+        ((points == NULL) && (max_points > 0))) {
+        return false;
+    }
+
+    const uint8_t *data = (const uint8_t *) frame.str;
+    size_t size = frame.size;
+    size_t position = 0;
+
+    if ((data[0] >> VERSION_SHIFT) != TELEMETRY_FRAME_VERSION) {
+        return false;
+    }
+
+    if (data[1] != ((TELEMETRY_HEADER_FIELD_COUNT << VERSION_SHIFT) | TELEMETRY_POINT_FIELD_COUNT)) {
+        return false;
+    }
+
+    if ((data[0] & FLAGS_MASK & TELEMETRY_FRAME_FLAG_CRC) != 0) {
+        if (size < (2 + CRC_SIZE)) {
+            return false;
+        }
+
+        size -= CRC_SIZE;
+
+        uint16_t crc = (uint16_t) ((data[size] << 8) | data[size + 1]);
+        if (TelemetryFrame_Crc16(data, size) != crc) {
+            return false;
+        }
+    }
+
+    position = 2;
+    int64_t value = 0;
+
+#define TELEMETRY_DECODE_HEADER(name, type, unit) \
+    if (TelemetryFrame_GetVarint(data, size, &position, &value) == false) { \
+        return false; \
+    } \
+    header->name = (type) value;
+    TELEMETRY_HEADER_FIELDS(TELEMETRY_DECODE_HEADER)
+#undef TELEMETRY_DECODE_HEADER
+
+    sTelemetryPoint_t previous = {0};
+    *point_count = 0;
+
+    while (position < size) {
+        sTelemetryPoint_t point;
+
+        if (*point_count >= max_points) {
+            return false;
+        }
+
+#define TELEMETRY_DECODE_POINT(name, type, unit) \
+        if (TelemetryFrame_GetVarint(data, size, &position, &value) == false) { \
+            return false; \
+        } \
+        point.name = (type) ((int64_t) previous.name + value);
+        TELEMETRY_POINT_FIELDS(TELEMETRY_DECODE_POINT)
+#undef TELEMETRY_DECODE_POINT
+
+        points[(*point_count)++] = point;
+        previous = point;
+    }
+
+    return true;
+}
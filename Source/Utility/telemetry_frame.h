@@ -0,0 +1,74 @@
+#ifndef SOURCE_UTILITY_TELEMETRY_FRAME_H_
+#define SOURCE_UTILITY_TELEMETRY_FRAME_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "buffer.h"
+#include "message.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Frame schema. The header is sent once per frame, the first point follows in absolute form and every later point
+ * as a delta to the one before it. All fields go on the wire as zigzag varints, in the order listed here.
+ * X(name, type, unit) */
+#define TELEMETRY_HEADER_FIELDS(X) \
+    X(fix_type,   uint8_t,  "0 none, 2 2D, 3 3D") \
+    X(satellites, uint8_t,  "count") \
+    X(hdop,       uint16_t, "0.01")
+
+#define TELEMETRY_POINT_FIELDS(X) \
+    X(timestamp,  uint32_t, "s, unix time") \
+    X(latitude,   int32_t,  "1e-7 deg") \
+    X(longitude,  int32_t,  "1e-7 deg") \
+    X(speed,      uint16_t, "0.01 m/s")
+
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_FRAME_FLAG_CRC 0x01
+
+/* Zigzag adds one bit, a varint carries 7 bits per byte */
+#define TELEMETRY_VARINT_MAX_SIZE(type) (((sizeof(type) * 8U) + 1U + 6U) / 7U)
+#define TELEMETRY_FIELD_MAX_SIZE(name, type, unit) + TELEMETRY_VARINT_MAX_SIZE(type)
+#define TELEMETRY_FIELD_COUNT(name, type, unit) + 1U
+
+#define TELEMETRY_HEADER_MAX_SIZE (0U TELEMETRY_HEADER_FIELDS(TELEMETRY_FIELD_MAX_SIZE))
+#define TELEMETRY_POINT_MAX_SIZE (0U TELEMETRY_POINT_FIELDS(TELEMETRY_FIELD_MAX_SIZE))
+#define TELEMETRY_HEADER_FIELD_COUNT (0U TELEMETRY_HEADER_FIELDS(TELEMETRY_FIELD_COUNT))
+#define TELEMETRY_POINT_FIELD_COUNT (0U TELEMETRY_POINT_FIELDS(TELEMETRY_FIELD_COUNT))
+/* Version/flags byte, field count byte, header, optional CRC-16 */
+#define TELEMETRY_FRAME_OVERHEAD (2U + TELEMETRY_HEADER_MAX_SIZE + 2U)
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+#define TELEMETRY_STRUCT_FIELD(name, type, unit) type name;
+
+typedef struct sTelemetryHeader {
+    TELEMETRY_HEADER_FIELDS(TELEMETRY_STRUCT_FIELD)
+} sTelemetryHeader_t;
+
+typedef struct sTelemetryPoint {
+    TELEMETRY_POINT_FIELDS(TELEMETRY_STRUCT_FIELD)
+} sTelemetryPoint_t;
+
+#undef TELEMETRY_STRUCT_FIELD
+
+typedef struct sTelemetryEncoder {
+    sBuffer_t *buffer;
+    bool with_crc;
+    size_t points;
+    sTelemetryPoint_t previous;
+} sTelemetryEncoder_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+bool TelemetryFrame_Begin (sTelemetryEncoder_t *encoder, sBuffer_t *buffer, const sTelemetryHeader_t *header, bool with_crc);
+bool TelemetryFrame_AddPoint (sTelemetryEncoder_t *encoder, const sTelemetryPoint_t *point);
+size_t TelemetryFrame_Finish (sTelemetryEncoder_t *encoder);
+bool TelemetryFrame_Decode (sString_t frame, sTelemetryHeader_t *header, sTelemetryPoint_t *points, size_t max_points, size_t *point_count);
+#endif /* SOURCE_UTILITY_TELEMETRY_FRAME_H_ */
@@ -0,0 +1,237 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "track_filter.h"
+#include "geodesy.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define FULL_CIRCLE 36000
+#define HALF_CIRCLE 18000
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sPlanePoint {
+    int64_t x;
+    int64_t y;
+} sPlanePoint_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const sTrackFilterConfig_t g_default_config = {
+    .max_deviation_cm = TRACK_FILTER_DEFAULT_MAX_DEVIATION_CM,
+    .max_heading_change = TRACK_FILTER_DEFAULT_MAX_HEADING_CHANGE,
+    .min_heading_speed = TRACK_FILTER_DEFAULT_MIN_HEADING_SPEED,
+    .max_speed_change = TRACK_FILTER_DEFAULT_MAX_SPEED_CHANGE,
+    .max_interval_s = TRACK_FILTER_DEFAULT_MAX_INTERVAL_S
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static sPlanePoint_t TrackFilter_Project (const sGeodesyReference_t *reference, const sTrackPoint_t *point);
+static uint64_t TrackFilter_SegmentDistance (sPlanePoint_t end, sPlanePoint_t point);
+static bool TrackFilter_IsOffLine (const sTrackFilter_t *filter, const sTrackPoint_t *point);
+static uint32_t TrackFilter_HeadingChange (uint16_t from, uint16_t to);
+static void TrackFilter_Keep (sTrackFilter_t *filter, const sTrackPoint_t *point, size_t dropped);
+static void TrackFilter_ThinWindow (sTrackFilter_t *filter);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Local flat plane in cm around the origin, the segments checked here are short enough for it. */
+static sPlanePoint_t TrackFilter_Project (const sGeodesyReference_t *reference, const sTrackPoint_t *point) {
+    sGeodesyPoint_t position = {.latitude = point->latitude, .longitude = point->longitude};
+    sGeodesyEnu_t enu;
+    sPlanePoint_t plane;
+
+    Geodesy_ToEnu(reference, &position, 0, &enu);
+    plane.x = enu.east;
+    plane.y = enu.north;
+
+    return plane;
+}
+
+/* Distance from point to the segment between the origin and end. */
+static uint64_t TrackFilter_SegmentDistance (sPlanePoint_t end, sPlanePoint_t point) {
+    int64_t length_squared = (end.x * end.x) + (end.y * end.y);
+    int64_t dot = (point.x * end.x) + (point.y * end.y);
+
+    if ((length_squared == 0) || (dot <= 0)) {
+        return Geodesy_Sqrt((uint64_t) ((point.x * point.x) + (point.y * point.y)));
+    }
+
+    if (dot >= length_squared) {
+        int64_t dx = point.x - end.x;
+        int64_t dy = point.y - end.y;
+
+        return Geodesy_Sqrt((uint64_t) ((dx * dx) + (dy * dy)));
+    }
+
+    int64_t cross = (end.x * point.y) - (end.y * point.x);
+    if (cross < 0) {
+        cross = -cross;
+    }
+
+    return (uint64_t) cross / Geodesy_Sqrt((uint64_t) length_squared);
+}
+
+/* Would the held back points stray too far from a straight line between the anchor and the new point? */
+static bool TrackFilter_IsOffLine (const sTrackFilter_t *filter, const sTrackPoint_t *point) {
+    if (filter->config.max_deviation_cm == 0) {
+        return false;
+    }
+
+    sGeodesyPoint_t origin = {.latitude = filter->anchor.latitude, .longitude = filter->anchor.longitude};
+    sGeodesyReference_t reference;
+
+    Geodesy_SetReference(&reference, &origin, 0);
+    sPlanePoint_t end = TrackFilter_Project(&reference, point);
+
+    for (size_t i = 0; i < filter->window_count; i++) {
+        sPlanePoint_t held = TrackFilter_Project(&reference, &filter->window[i]);
+
+        if (TrackFilter_SegmentDistance(end, held) > filter->config.max_deviation_cm) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint32_t TrackFilter_HeadingChange (uint16_t from, uint16_t to) {
+    uint32_t change = (from > to) ? (from - to) : (to - from);
+
+    change %= FULL_CIRCLE;
+
+    return (change > HALF_CIRCLE) ? (FULL_CIRCLE - change) : change;
+}
+
+static void TrackFilter_Keep (sTrackFilter_t *filter, const sTrackPoint_t *point, size_t dropped) {
+    filter->anchor = *point;
+    filter->window_count = 0;
+    filter->stats.kept++;
+    filter->stats.dropped += dropped;
+}
+
+/* Long straight runs keep every other held back point, the deviation check then runs on a coarser sample of the
+ * segment instead of closing it early. The newest point always stays. */
+static void TrackFilter_ThinWindow (sTrackFilter_t *filter) {
+    size_t kept = 0;
+
+    for (size_t i = 1; i < filter->window_count; i += 2) {
+        filter->window[kept++] = filter->window[i];
+    }
+
+    filter->stats.dropped += filter->window_count - kept;
+    filter->window_count = kept;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void TrackFilter_Init (sTrackFilter_t *filter, const sTrackFilterConfig_t *config) {
+    if (filter == NULL) {
+        return;
+    }
+
+    memset(filter, 0, sizeof(*filter));
+    filter->config = (config != NULL) ? *config : g_default_config;
+}
+
+bool TrackFilter_SetConfig (sTrackFilter_t *filter, const sTrackFilterConfig_t *config) {
+    if ((filter == NULL) || (config == NULL)) {
+        return false;
+    }
+
+    filter->config = *config;
+
+    return true;
+}
+
+size_t TrackFilter_Push (sTrackFilter_t *filter, const sTrackPoint_t *point, sTrackPoint_t output[TRACK_FILTER_MAX_OUTPUT]) {
+    if ((filter == NULL) || (point == NULL) || (output == NULL)) {
+        return 0;
+    }
+
+    size_t output_count = 0;
+    filter->stats.points_in++;
+
+    if (filter->has_anchor == false) {
+        filter->has_anchor = true;
+        TrackFilter_Keep(filter, point, 0);
+        output[output_count++] = *point;
+        return output_count;
+    }
+
+    /* Close the segment at the last point that still fit, it becomes the anchor for the new point. */
+    if ((filter->window_count > 0) && TrackFilter_IsOffLine(filter, point)) {
+        sTrackPoint_t corner = filter->window[filter->window_count - 1];
+
+        TrackFilter_Keep(filter, &corner, filter->window_count - 1);
+        filter->stats.kept_deviation++;
+        output[output_count++] = corner;
+    }
+
+    const sTrackFilterConfig_t *config = &filter->config;
+    const sTrackPoint_t *anchor = &filter->anchor;
+    bool is_kept = false;
+
+    if ((config->max_heading_change != 0) && (point->speed >= config->min_heading_speed) &&
+        (anchor->speed >= config->min_heading_speed) &&
+        (TrackFilter_HeadingChange(anchor->course, point->course) > config->max_heading_change)) {
+        filter->stats.kept_heading++;
+        is_kept = true;
+    } else if ((config->max_speed_change != 0) &&
+               (((point->speed > anchor->speed) ? (point->speed - anchor->speed) : (anchor->speed - point->speed)) > config->max_speed_change)) {
+        filter->stats.kept_speed++;
+        is_kept = true;
+    } else if ((config->max_interval_s != 0) && ((point->timestamp - anchor->timestamp) >= config->max_interval_s)) {
+        filter->stats.kept_interval++;
+        is_kept = true;
+    }
+
+    if (is_kept) {
+        TrackFilter_Keep(filter, point, filter->window_count);
+        output[output_count++] = *point;
+        return output_count;
+    }
+
+    if (filter->window_count == TRACK_FILTER_WINDOW_SIZE) {
+        TrackFilter_ThinWindow(filter);
+    }
+
+    filter->window[filter->window_count++] = *point;
+
+    return output_count;
+}
+
+bool TrackFilter_Flush (sTrackFilter_t *filter, sTrackPoint_t *output) {
+    if ((filter == NULL) || (output == NULL) || (filter->window_count == 0)) {
+        return false;
+    }
+
+    *output = filter->window[filter->window_count - 1];
+    TrackFilter_Keep(filter, output, filter->window_count - 1);
+
+    return true;
+}
+
+bool TrackFilter_GetStats (const sTrackFilter_t *filter, sTrackFilterStats_t *stats) {
+    if ((filter == NULL) || (stats == NULL)) {
+        return false;
+    }
+
+    *stats = filter->stats;
+
+    return true;
+}
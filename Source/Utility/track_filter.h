@@ -0,0 +1,75 @@
+#ifndef SOURCE_UTILITY_TRACK_FILTER_H_
+#define SOURCE_UTILITY_TRACK_FILTER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Points held back while the track still fits a straight line from the last kept point */
+#define TRACK_FILTER_WINDOW_SIZE 32
+/* A single push can close the current segment and start a new one at the same time */
+#define TRACK_FILTER_MAX_OUTPUT 2
+
+#define TRACK_FILTER_DEFAULT_MAX_DEVIATION_CM 1000
+#define TRACK_FILTER_DEFAULT_MAX_HEADING_CHANGE 2000
+#define TRACK_FILTER_DEFAULT_MIN_HEADING_SPEED 140
+#define TRACK_FILTER_DEFAULT_MAX_SPEED_CHANGE 300
+#define TRACK_FILTER_DEFAULT_MAX_INTERVAL_S 300
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sTrackPoint {
+    uint32_t timestamp;
+    int32_t latitude;
+    int32_t longitude;
+    uint16_t speed;
+    uint16_t course;
+} sTrackPoint_t;
+
+/* Units follow sTrackPoint_t: cm, 0.01 deg, 0.01 m/s and seconds. Zero disables a bound. */
+typedef struct sTrackFilterConfig {
+    uint32_t max_deviation_cm;
+    uint16_t max_heading_change;
+    uint16_t min_heading_speed;
+    uint16_t max_speed_change;
+    uint32_t max_interval_s;
+} sTrackFilterConfig_t;
+
+typedef struct sTrackFilterStats {
+    uint32_t points_in;
+    uint32_t kept;
+    uint32_t dropped;
+    uint32_t kept_deviation;
+    uint32_t kept_heading;
+    uint32_t kept_speed;
+    uint32_t kept_interval;
+} sTrackFilterStats_t;
+
+typedef struct sTrackFilter {
+    sTrackFilterConfig_t config;
+    sTrackFilterStats_t stats;
+    bool has_anchor;
+    sTrackPoint_t anchor;
+    sTrackPoint_t window[TRACK_FILTER_WINDOW_SIZE];
+    size_t window_count;
+} sTrackFilter_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* A NULL config selects the defaults above */
+void TrackFilter_Init (sTrackFilter_t *filter, const sTrackFilterConfig_t *config);
+bool TrackFilter_SetConfig (sTrackFilter_t *filter, const sTrackFilterConfig_t *config);
+/* Returns how many points were written to output, in track order */
+size_t TrackFilter_Push (sTrackFilter_t *filter, const sTrackPoint_t *point, sTrackPoint_t output[TRACK_FILTER_MAX_OUTPUT]);
+/* Releases the newest held back point, e.g. before the device goes to sleep */
+bool TrackFilter_Flush (sTrackFilter_t *filter, sTrackPoint_t *output);
+bool TrackFilter_GetStats (const sTrackFilter_t *filter, sTrackFilterStats_t *stats);
+#endif /* SOURCE_UTILITY_TRACK_FILTER_H_ */
@@ -0,0 +1,13 @@
+#ifndef TESTS_HOST_FREERTOS_H_
+#define TESTS_HOST_FREERTOS_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stddef.h>
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* The heap figures of heap_4, the host heap has no such limit and reports a fixed size */
+size_t xPortGetFreeHeapSize (void);
+size_t xPortGetMinimumEverFreeHeapSize (void);
+#endif /* TESTS_HOST_FREERTOS_H_ */
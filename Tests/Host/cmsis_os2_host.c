@@ -0,0 +1,594 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "cmsis_os2.h"
+#include "FreeRTOS.h"
+#include "host.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define HOST_MAX_THREADS 32
+#define HOST_NO_DEADLINE UINT64_MAX
+/* configTOTAL_HEAP_SIZE of the target */
+#define HOST_HEAP_SIZE 32768U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+/* Only one thread runs at a time, like on the single core target. A thread gives up the core only where the RTOS
+ * would block it, and once nothing can run the clock jumps to the earliest timeout. */
+typedef struct sHostThread {
+    bool is_used;
+    bool is_blocked;
+    bool is_timed_out;
+    const char *name;
+    pthread_t handle;
+    pthread_cond_t wake;
+    const void *wait_object;
+    uint64_t deadline;
+    uint32_t flags;
+    osThreadFunc_t function;
+    void *argument;
+} sHostThread_t;
+
+typedef struct sHostMutex {
+    sHostThread_t *owner;
+    uint32_t count;
+    bool is_recursive;
+} sHostMutex_t;
+
+typedef struct sHostEventFlags {
+    uint32_t flags;
+} sHostEventFlags_t;
+
+typedef struct sHostQueue {
+    uint32_t capacity;
+    uint32_t message_size;
+    uint32_t count;
+    uint32_t head;
+    uint8_t *data;
+} sHostQueue_t;
+
+typedef struct sHostPool {
+    uint32_t block_count;
+    uint32_t block_size;
+    uint8_t *data;
+    bool *is_taken;
+} sHostPool_t;
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static pthread_mutex_t g_core = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_finished = PTHREAD_COND_INITIALIZER;
+static sHostThread_t g_thread[HOST_MAX_THREADS];
+static __thread sHostThread_t *g_current = NULL;
+static uint64_t g_now = 0;
+static uint32_t g_ready = 0;
+static bool g_is_finished = false;
+static int g_exit_code = 0;
+static bool g_is_in_isr = false;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static sHostThread_t *Host_AllocThread (const char *name);
+static void *Host_ThreadEntry (void *argument);
+static void Host_Advance (void);
+static bool Host_Block (const void *object, uint32_t timeout);
+static void Host_WakeAll (const void *object);
+static void Host_Finish (int exit_code);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static sHostThread_t *Host_AllocThread (const char *name) {
+    for (size_t i = 0; i < HOST_MAX_THREADS; i++) {
+        if (g_thread[i].is_used == false) {
+            memset(&g_thread[i], 0, sizeof(g_thread[i]));
+            g_thread[i].is_used = true;
+            g_thread[i].name = (name != NULL) ? name : "thread";
+            pthread_cond_init(&g_thread[i].wake, NULL);
+            return &g_thread[i];
+        }
+    }
+
+    fprintf(stderr, "host: out of threads\n");
+    abort();
+}
+
+static void *Host_ThreadEntry (void *argument) {
+    sHostThread_t *thread = (sHostThread_t *) argument;
+
+    pthread_mutex_lock(&g_core);
+    g_current = thread;
+
+    while (thread->is_blocked == true) {
+        pthread_cond_wait(&thread->wake, &g_core);
+    }
+
+    thread->function(thread->argument);
+    osThreadExit();
+
+    return NULL;
+}
+
+/* Called with the core held once the last ready thread blocked */
+static void Host_Advance (void) {
+    while (g_ready == 0) {
+        uint64_t deadline = HOST_NO_DEADLINE;
+
+        for (size_t i = 0; i < HOST_MAX_THREADS; i++) {
+            if ((g_thread[i].is_used == true) && (g_thread[i].is_blocked == true) && (g_thread[i].deadline < deadline)) {
+                deadline = g_thread[i].deadline;
+            }
+        }
+
+        if (deadline == HOST_NO_DEADLINE) {
+            fprintf(stderr, "host: every thread waits forever at tick %llu\n", (unsigned long long) g_now);
+
+            for (size_t i = 0; i < HOST_MAX_THREADS; i++) {
+                if (g_thread[i].is_used == true) {
+                    fprintf(stderr, "host:   %s\n", g_thread[i].name);
+                }
+            }
+
+            Host_Finish(2);
+            return;
+        }
+
+        if (deadline > g_now) {
+            g_now = deadline;
+        }
+
+        for (size_t i = 0; i < HOST_MAX_THREADS; i++) {
+            sHostThread_t *thread = &g_thread[i];
+
+            if ((thread->is_used == true) && (thread->is_blocked == true) && (thread->deadline <= g_now)) {
+                thread->is_blocked = false;
+                thread->is_timed_out = true;
+                g_ready++;
+                pthread_cond_signal(&thread->wake);
+            }
+        }
+    }
+}
+
+/* False when the timeout ran out before the object was signalled */
+static bool Host_Block (const void *object, uint32_t timeout) {
+    sHostThread_t *thread = g_current;
+
+    if ((thread == NULL) || (g_is_in_isr == true)) {
+        fprintf(stderr, "host: blocking outside of a thread\n");
+        abort();
+    }
+
+    thread->is_blocked = true;
+    thread->is_timed_out = false;
+    thread->wait_object = object;
+    thread->deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+    g_ready--;
+
+    Host_Advance();
+
+    while ((thread->is_blocked == true) || (g_is_finished == true)) {
+        pthread_cond_wait(&thread->wake, &g_core);
+    }
+
+    g_current = thread;
+    thread->wait_object = NULL;
+
+    return (thread->is_timed_out == false);
+}
+
+static void Host_WakeAll (const void *object) {
+    for (size_t i = 0; i < HOST_MAX_THREADS; i++) {
+        sHostThread_t *thread = &g_thread[i];
+
+        if ((thread->is_used == true) && (thread->is_blocked == true) && (thread->wait_object == object)) {
+            thread->is_blocked = false;
+            g_ready++;
+            pthread_cond_signal(&thread->wake);
+        }
+    }
+}
+
+static void Host_Finish (int exit_code) {
+    g_is_finished = true;
+    g_exit_code = exit_code;
+    pthread_cond_signal(&g_finished);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int Host_Run (osThreadFunc_t function, void *argument) {
+    pthread_mutex_lock(&g_core);
+
+    osThreadAttr_t attr = {.name = "main"};
+    g_ready = 0;
+
+    if (osThreadNew(function, argument, &attr) == NULL) {
+        return 1;
+    }
+
+    while (g_is_finished == false) {
+        pthread_cond_wait(&g_finished, &g_core);
+    }
+
+    /* The other threads stay parked on the core, the process ends under them */
+    fflush(stdout);
+
+    return g_exit_code;
+}
+
+void Host_Exit (int exit_code) {
+    Host_Finish(exit_code);
+
+    while (1) {
+        pthread_cond_wait(&g_current->wake, &g_core);
+    }
+}
+
+uint64_t Host_GetTime (void) {
+    return g_now;
+}
+
+void Host_EnterIsr (void) {
+    g_is_in_isr = true;
+}
+
+void Host_ExitIsr (void) {
+    g_is_in_isr = false;
+}
+
+osKernelState_t osKernelGetState (void) {
+    return osKernelRunning;
+}
+
+uint32_t osKernelGetTickCount (void) {
+    return (uint32_t) g_now;
+}
+
+uint32_t osKernelGetTickFreq (void) {
+    return 1000U;
+}
+
+osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAttr_t *attr) {
+    sHostThread_t *thread = Host_AllocThread((attr != NULL) ? attr->name : NULL);
+
+    thread->function = func;
+    thread->argument = argument;
+    /* Created ready, it gets the core the next time the creator blocks */
+    g_ready++;
+
+    pthread_attr_t thread_attr;
+    pthread_attr_init(&thread_attr);
+    pthread_attr_setdetachstate(&thread_attr, PTHREAD_CREATE_DETACHED);
+
+    if (pthread_create(&thread->handle, &thread_attr, &Host_ThreadEntry, thread) != 0) {
+        thread->is_used = false;
+        g_ready--;
+        return NULL;
+    }
+
+    return (osThreadId_t) thread;
+}
+
+const char *osThreadGetName (osThreadId_t thread_id) {
+    return (thread_id != NULL) ? ((sHostThread_t *) thread_id)->name : NULL;
+}
+
+osThreadId_t osThreadGetId (void) {
+    return (osThreadId_t) g_current;
+}
+
+osStatus_t osThreadYield (void) {
+    sHostThread_t *thread = g_current;
+
+    pthread_mutex_unlock(&g_core);
+    sched_yield();
+    pthread_mutex_lock(&g_core);
+    g_current = thread;
+
+    return osOK;
+}
+
+__NO_RETURN void osThreadExit (void) {
+    sHostThread_t *thread = g_current;
+
+    thread->is_used = false;
+    g_ready--;
+    Host_Advance();
+    pthread_mutex_unlock(&g_core);
+    pthread_exit(NULL);
+}
+
+uint32_t osThreadFlagsSet (osThreadId_t thread_id, uint32_t flags) {
+    sHostThread_t *thread = (sHostThread_t *) thread_id;
+
+    if (thread == NULL) {
+        return osFlagsErrorParameter;
+    }
+
+    thread->flags |= flags;
+    Host_WakeAll(&thread->flags);
+
+    return thread->flags;
+}
+
+uint32_t osThreadFlagsWait (uint32_t flags, uint32_t options, uint32_t timeout) {
+    sHostThread_t *thread = g_current;
+    uint64_t deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+
+    while (1) {
+        uint32_t matched = thread->flags & flags;
+
+        if (((options & osFlagsWaitAll) != 0) ? (matched == flags) : (matched != 0)) {
+            uint32_t result = thread->flags;
+
+            if ((options & osFlagsNoClear) == 0) {
+                thread->flags &= ~flags;
+            }
+
+            return result;
+        }
+
+        if ((timeout == 0) || (g_now >= deadline)) {
+            return (timeout == 0) ? osFlagsErrorResource : osFlagsErrorTimeout;
+        }
+
+        Host_Block(&thread->flags, (deadline == HOST_NO_DEADLINE) ? osWaitForever : (uint32_t) (deadline - g_now));
+    }
+}
+
+osStatus_t osDelay (uint32_t ticks) {
+    if (ticks == 0) {
+        return osThreadYield();
+    }
+
+    Host_Block(NULL, ticks);
+
+    return osOK;
+}
+
+osMutexId_t osMutexNew (const osMutexAttr_t *attr) {
+    sHostMutex_t *mutex = calloc(1, sizeof(sHostMutex_t));
+
+    if ((mutex != NULL) && (attr != NULL)) {
+        mutex->is_recursive = ((attr->attr_bits & osMutexRecursive) != 0);
+    }
+
+    return (osMutexId_t) mutex;
+}
+
+osStatus_t osMutexAcquire (osMutexId_t mutex_id, uint32_t timeout) {
+    sHostMutex_t *mutex = (sHostMutex_t *) mutex_id;
+    uint64_t deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+
+    if (mutex == NULL) {
+        return osErrorParameter;
+    }
+
+    while (1) {
+        if ((mutex->owner == NULL) || ((mutex->owner == g_current) && (mutex->is_recursive == true))) {
+            mutex->owner = g_current;
+            mutex->count++;
+            return osOK;
+        }
+
+        if ((timeout == 0) || (g_now >= deadline)) {
+            return (timeout == 0) ? osErrorResource : osErrorTimeout;
+        }
+
+        Host_Block(mutex, (deadline == HOST_NO_DEADLINE) ? osWaitForever : (uint32_t) (deadline - g_now));
+    }
+}
+
+osStatus_t osMutexRelease (osMutexId_t mutex_id) {
+    sHostMutex_t *mutex = (sHostMutex_t *) mutex_id;
+
+    if ((mutex == NULL) || (mutex->owner != g_current)) {
+        return osErrorResource;
+    }
+
+    if (--mutex->count == 0) {
+        mutex->owner = NULL;
+        Host_WakeAll(mutex);
+    }
+
+    return osOK;
+}
+
+osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr) {
+    return (osEventFlagsId_t) calloc(1, sizeof(sHostEventFlags_t));
+}
+
+uint32_t osEventFlagsSet (osEventFlagsId_t ef_id, uint32_t flags) {
+    sHostEventFlags_t *event_flags = (sHostEventFlags_t *) ef_id;
+
+    if (event_flags == NULL) {
+        return osFlagsErrorParameter;
+    }
+
+    event_flags->flags |= flags;
+    Host_WakeAll(event_flags);
+
+    return event_flags->flags;
+}
+
+uint32_t osEventFlagsClear (osEventFlagsId_t ef_id, uint32_t flags) {
+    sHostEventFlags_t *event_flags = (sHostEventFlags_t *) ef_id;
+
+    if (event_flags == NULL) {
+        return osFlagsErrorParameter;
+    }
+
+    uint32_t previous = event_flags->flags;
+    event_flags->flags &= ~flags;
+
+    return previous;
+}
+
+uint32_t osEventFlagsGet (osEventFlagsId_t ef_id) {
+    sHostEventFlags_t *event_flags = (sHostEventFlags_t *) ef_id;
+
+    return (event_flags != NULL) ? event_flags->flags : 0;
+}
+
+uint32_t osEventFlagsWait (osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout) {
+    sHostEventFlags_t *event_flags = (sHostEventFlags_t *) ef_id;
+    uint64_t deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+
+    if (event_flags == NULL) {
+        return osFlagsErrorParameter;
+    }
+
+    while (1) {
+        uint32_t matched = event_flags->flags & flags;
+
+        if (((options & osFlagsWaitAll) != 0) ? (matched == flags) : (matched != 0)) {
+            uint32_t result = event_flags->flags;
+
+            if ((options & osFlagsNoClear) == 0) {
+                event_flags->flags &= ~flags;
+            }
+
+            return result;
+        }
+
+        if ((timeout == 0) || (g_now >= deadline)) {
+            return (timeout == 0) ? osFlagsErrorResource : osFlagsErrorTimeout;
+        }
+
+        Host_Block(event_flags, (deadline == HOST_NO_DEADLINE) ? osWaitForever : (uint32_t) (deadline - g_now));
+    }
+}
+
+osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr) {
+    sHostQueue_t *queue = calloc(1, sizeof(sHostQueue_t));
+
+    if (queue == NULL) {
+        return NULL;
+    }
+
+    queue->capacity = msg_count;
+    queue->message_size = msg_size;
+    queue->data = calloc(msg_count, msg_size);
+
+    return (osMessageQueueId_t) queue;
+}
+
+osStatus_t osMessageQueuePut (osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout) {
+    sHostQueue_t *queue = (sHostQueue_t *) mq_id;
+    uint64_t deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+
+    if ((queue == NULL) || (msg_ptr == NULL)) {
+        return osErrorParameter;
+    }
+
+    while (queue->count == queue->capacity) {
+        if ((timeout == 0) || (g_now >= deadline) || (g_is_in_isr == true)) {
+            return (timeout == 0) ? osErrorResource : osErrorTimeout;
+        }
+
+        Host_Block(queue, (deadline == HOST_NO_DEADLINE) ? osWaitForever : (uint32_t) (deadline - g_now));
+    }
+
+    uint32_t tail = (queue->head + queue->count) % queue->capacity;
+    memcpy(&queue->data[tail * queue->message_size], msg_ptr, queue->message_size);
+    queue->count++;
+    Host_WakeAll(queue);
+
+    return osOK;
+}
+
+osStatus_t osMessageQueueGet (osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout) {
+    sHostQueue_t *queue = (sHostQueue_t *) mq_id;
+    uint64_t deadline = (timeout == osWaitForever) ? HOST_NO_DEADLINE : (g_now + timeout);
+
+    if ((queue == NULL) || (msg_ptr == NULL)) {
+        return osErrorParameter;
+    }
+
+    while (queue->count == 0) {
+        if ((timeout == 0) || (g_now >= deadline) || (g_is_in_isr == true)) {
+            return (timeout == 0) ? osErrorResource : osErrorTimeout;
+        }
+
+        Host_Block(queue, (deadline == HOST_NO_DEADLINE) ? osWaitForever : (uint32_t) (deadline - g_now));
+    }
+
+    memcpy(msg_ptr, &queue->data[queue->head * queue->message_size], queue->message_size);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    Host_WakeAll(queue);
+
+    return osOK;
+}
+
+uint32_t osMessageQueueGetCount (osMessageQueueId_t mq_id) {
+    sHostQueue_t *queue = (sHostQueue_t *) mq_id;
+
+    return (queue != NULL) ? queue->count : 0;
+}
+
+osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+    sHostPool_t *pool = calloc(1, sizeof(sHostPool_t));
+
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->block_count = block_count;
+    pool->block_size = block_size;
+    pool->data = calloc(block_count, block_size);
+    pool->is_taken = calloc(block_count, sizeof(bool));
+
+    return (osMemoryPoolId_t) pool;
+}
+
+void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
+    sHostPool_t *pool = (sHostPool_t *) mp_id;
+
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    for (uint32_t block = 0; block < pool->block_count; block++) {
+        if (pool->is_taken[block] == false) {
+            pool->is_taken[block] = true;
+            return &pool->data[block * pool->block_size];
+        }
+    }
+
+    return NULL;
+}
+
+osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
+    sHostPool_t *pool = (sHostPool_t *) mp_id;
+
+    if ((pool == NULL) || (block == NULL)) {
+        return osErrorParameter;
+    }
+
+    size_t offset = (size_t) ((uint8_t *) block - pool->data);
+
+    if ((offset >= ((size_t) pool->block_count * pool->block_size)) || ((offset % pool->block_size) != 0) ||
+        (pool->is_taken[offset / pool->block_size] == false)) {
+        return osErrorParameter;
+    }
+
+    pool->is_taken[offset / pool->block_size] = false;
+
+    return osOK;
+}
+
+size_t xPortGetFreeHeapSize (void) {
+    return HOST_HEAP_SIZE;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize (void) {
+    return HOST_HEAP_SIZE;
+}
@@ -0,0 +1,141 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "flash_driver.h"
+#include "flash_ram.h"
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static uint8_t g_sector[eFlashDriverSector_Last][FLASH_RAM_MAX_SECTOR_SIZE];
+static size_t g_sector_size = FLASH_RAM_MAX_SECTOR_SIZE;
+static size_t g_budget = FLASH_RAM_NO_CUT;
+static bool g_is_power_cut = false;
+static bool g_is_initialized = false;
+static sFlashRamStats_t g_stats = {0};
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Flash_Ram_IsRangeValid (eFlashDriverSector_t sector, size_t offset, size_t size);
+static size_t Flash_Ram_Spend (size_t size);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Flash_Ram_IsRangeValid (eFlashDriverSector_t sector, size_t offset, size_t size) {
+    if (g_is_initialized == false) {
+        Flash_Ram_Reset(0);
+    }
+
+    return (sector < eFlashDriverSector_Last) && (offset <= g_sector_size) && (size <= (g_sector_size - offset));
+}
+
+/* How much of a write of this size gets done before the power goes */
+static size_t Flash_Ram_Spend (size_t size) {
+    if (g_is_power_cut == true) {
+        return 0;
+    }
+
+    if (size < g_budget) {
+        if (g_budget != FLASH_RAM_NO_CUT) {
+            g_budget -= size;
+        }
+        return size;
+    }
+
+    size_t done = g_budget;
+    g_budget = 0;
+    g_is_power_cut = true;
+    g_stats.power_cuts++;
+
+    return done;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void Flash_Ram_Reset (size_t sector_size) {
+    g_sector_size = ((sector_size == 0) || (sector_size > FLASH_RAM_MAX_SECTOR_SIZE)) ? FLASH_RAM_MAX_SECTOR_SIZE : sector_size;
+    memset(g_sector, 0xFF, sizeof(g_sector));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_budget = FLASH_RAM_NO_CUT;
+    g_is_power_cut = false;
+    g_is_initialized = true;
+}
+
+void Flash_Ram_CutPowerAfter (size_t bytes) {
+    g_budget = bytes;
+}
+
+void Flash_Ram_RestorePower (void) {
+    g_budget = FLASH_RAM_NO_CUT;
+    g_is_power_cut = false;
+}
+
+bool Flash_Ram_IsPowerCut (void) {
+    return g_is_power_cut;
+}
+
+const sFlashRamStats_t *Flash_Ram_GetStats (void) {
+    return &g_stats;
+}
+
+bool Flash_Driver_Init (void) {
+    return true;
+}
+
+size_t Flash_Driver_GetSectorSize (eFlashDriverSector_t sector) {
+    if (g_is_initialized == false) {
+        Flash_Ram_Reset(0);
+    }
+
+    return (sector < eFlashDriverSector_Last) ? g_sector_size : 0;
+}
+
+const void *Flash_Driver_GetAddress (eFlashDriverSector_t sector) {
+    return (sector < eFlashDriverSector_Last) ? g_sector[sector] : NULL;
+}
+
+bool Flash_Driver_Read (eFlashDriverSector_t sector, size_t offset, void *data, size_t size) {
+    if ((data == NULL) || (Flash_Ram_IsRangeValid(sector, offset, size) == false)) {
+        return false;
+    }
+
+    memcpy(data, &g_sector[sector][offset], size);
+
+    return true;
+}
+
+/* NOR flash, programming only ever clears bits */
+bool Flash_Driver_Program (eFlashDriverSector_t sector, size_t offset, const void *data, size_t size) {
+    if ((data == NULL) || (Flash_Ram_IsRangeValid(sector, offset, size) == false)) {
+        return false;
+    }
+
+    const uint8_t *bytes = (const uint8_t *) data;
+    size_t done = Flash_Ram_Spend(size);
+
+    for (size_t i = 0; i < done; i++) {
+        g_sector[sector][offset + i] &= bytes[i];
+    }
+
+    g_stats.programs++;
+    g_stats.bytes_programmed += done;
+
+    return (done == size);
+}
+
+/* A cut erase leaves the front of the sector erased and the rest as it was */
+bool Flash_Driver_Erase (eFlashDriverSector_t sector) {
+    if (Flash_Ram_IsRangeValid(sector, 0, 0) == false) {
+        return false;
+    }
+
+    size_t done = Flash_Ram_Spend(g_sector_size);
+
+    memset(g_sector[sector], 0xFF, done);
+    g_stats.erases++;
+
+    return (done == g_sector_size);
+}
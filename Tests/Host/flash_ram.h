@@ -0,0 +1,35 @@
+#ifndef TESTS_HOST_FLASH_RAM_H_
+#define TESTS_HOST_FLASH_RAM_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "flash_driver.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define FLASH_RAM_MAX_SECTOR_SIZE (128U * 1024U)
+#define FLASH_RAM_NO_CUT SIZE_MAX
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sFlashRamStats {
+    uint32_t programs;
+    uint32_t erases;
+    size_t bytes_programmed;
+    uint32_t power_cuts;
+} sFlashRamStats_t;
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Every sector erased and sized like on the target unless a smaller size is given, 0 keeps the target size */
+void Flash_Ram_Reset (size_t sector_size);
+/* Power fails once this many more bytes were written, an erase counts as its sector size. The write that hits the
+ * limit is left half done and fails, as do all writes after it until Flash_Ram_RestorePower. */
+void Flash_Ram_CutPowerAfter (size_t bytes);
+void Flash_Ram_RestorePower (void);
+bool Flash_Ram_IsPowerCut (void);
+const sFlashRamStats_t *Flash_Ram_GetStats (void);
+#endif /* TESTS_HOST_FLASH_RAM_H_ */
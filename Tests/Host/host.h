@@ -0,0 +1,40 @@
+#ifndef TESTS_HOST_HOST_H_
+#define TESTS_HOST_HOST_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "cmsis_os2.h"
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+/* Failures name the file and line, the test goes on so one run reports every broken check */
+#define HOST_CHECK(condition) Host_Check((condition), #condition, __FILE__, __LINE__)
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* Runs the firmware threads on a virtual 1 kHz tick, the clock only moves once every thread is blocked */
+int Host_Run (osThreadFunc_t function, void *argument);
+void Host_Exit (int exit_code);
+uint64_t Host_GetTime (void);
+/* Marks code that stands in for an interrupt handler, it must not block */
+void Host_EnterIsr (void);
+void Host_ExitIsr (void);
+bool Host_Check (bool condition, const char *expression, const char *file, int line);
+int Host_GetFailures (void);
+/* Cycle counter of the host core for the benchmarks, 0 where there is none */
+uint64_t Host_ReadCycles (void);
+/* Monotonic wall time in nanoseconds */
+uint64_t Host_ReadNanoseconds (void);
+#endif /* TESTS_HOST_HOST_H_ */
@@ -0,0 +1,266 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "gpio_driver.h"
+#include "power_api.h"
+#include "uart_driver.h"
+#include "host.h"
+#include "host_board.h"
+#include "host_compat.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+/* Stand-ins for the board: the modem UART is wired to the modem stand-in, the debug UART and the log go to stdout */
+static uart_rx_callback_t g_rx_callback[eUartDriver_Last] = {0};
+static eGPIO_PinState_t g_pin_state[eGPIODriver_Last] = {0};
+static sHostBoardStats_t g_stats = {0};
+static int g_is_verbose = -1;
+static const char *g_level_name[eDebugLevel_Last] = {"I", "W", "E"};
+/* Gets every line right away, the target hands them over later from the drain task with the time they were logged */
+static debug_mirror_callback_t g_mirror = NULL;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Host_Board_IsVerbose (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Host_Board_IsVerbose (void) {
+    if (g_is_verbose < 0) {
+        const char *verbose = getenv("HOST_VERBOSE");
+        g_is_verbose = ((verbose != NULL) && (strcmp(verbose, "0") != 0)) ? 1 : 0;
+    }
+
+    return (g_is_verbose == 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void Host_Board_OnModemOutput (void) {
+    if (g_rx_callback[eUartDriver_2] == NULL) {
+        return;
+    }
+
+    Host_EnterIsr();
+    g_rx_callback[eUartDriver_2](eUartDriver_2);
+    Host_ExitIsr();
+}
+
+const sHostBoardStats_t *Host_Board_GetStats (void) {
+    return &g_stats;
+}
+
+void Host_Board_SetVerbose (bool is_verbose) {
+    g_is_verbose = (is_verbose == true) ? 1 : 0;
+}
+
+char *itoa (int value, char *str, int base) {
+    char digits[sizeof(int) * 8 + 1];
+    size_t count = 0;
+    unsigned int magnitude = (value < 0) && (base == 10) ? (0U - (unsigned int) value) : (unsigned int) value;
+    char *out = str;
+
+    if ((base < 2) || (base > 36)) {
+        *str = '\0';
+        return str;
+    }
+
+    do {
+        unsigned int digit = magnitude % (unsigned int) base;
+        digits[count++] = (char) ((digit < 10) ? ('0' + digit) : ('a' + digit - 10));
+        magnitude /= (unsigned int) base;
+    } while (magnitude > 0);
+
+    if ((value < 0) && (base == 10)) {
+        *out++ = '-';
+    }
+
+    while (count > 0) {
+        *out++ = digits[--count];
+    }
+
+    *out = '\0';
+
+    return str;
+}
+
+bool Debug_API_Init (void) {
+    return true;
+}
+
+bool Debug_API_PrintMessage (const char *module_tag, const char *file, int line, eDebugLevel_t debug_level, const char *format, ...) {
+    if ((Host_Board_IsVerbose() == false) && (g_mirror == NULL)) {
+        return true;
+    }
+
+    char message[512] = {0};
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (g_mirror != NULL) {
+        g_mirror(osKernelGetTickCount(), message, strlen(message));
+    }
+
+    if (Host_Board_IsVerbose() == false) {
+        return true;
+    }
+
+    printf("%8llu %s [%s] %s", (unsigned long long) Host_GetTime(), (debug_level < eDebugLevel_Last) ? g_level_name[debug_level] : "?",
+           module_tag, message);
+
+    if ((strlen(message) == 0) || (message[strlen(message) - 1] != '\n')) {
+        printf("\n");
+    }
+
+    return true;
+}
+
+void Debug_API_SetMirror (debug_mirror_callback_t mirror) {
+    g_mirror = mirror;
+}
+
+bool Debug_API_GetStats (sLogRingStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    return true;
+}
+
+bool GPIO_Driver_Init (void) {
+    return true;
+}
+
+bool GPIO_Driver_Toggle (eGPIODriver_t pin_name) {
+    if (pin_name >= eGPIODriver_Last) {
+        return false;
+    }
+
+    return GPIO_Driver_Write(pin_name, (g_pin_state[pin_name] == eGPIO_PinState_High) ? eGPIO_PinState_Low : eGPIO_PinState_High);
+}
+
+bool GPIO_Driver_Write (eGPIODriver_t pin_name, eGPIO_PinState_t pin_state) {
+    if ((pin_name >= eGPIODriver_Last) || (pin_state >= eGPIO_PinState_Last)) {
+        return false;
+    }
+
+    if ((pin_name == eGPIODriver_ModemUartDtrPin) && (g_pin_state[pin_name] == eGPIO_PinState_High) && (pin_state == eGPIO_PinState_Low)) {
+        g_stats.dtr_pulses++;
+    }
+
+    g_pin_state[pin_name] = pin_state;
+
+    if (pin_name == eGPIODriver_ModemOnPin) {
+        Modem_Sim_OnPowerKey(pin_state == eGPIO_PinState_High);
+    }
+
+    return true;
+}
+
+bool GPIO_Driver_Read (eGPIODriver_t pin_name, eGPIO_PinState_t *pin_state) {
+    if ((pin_name >= eGPIODriver_Last) || (pin_state == NULL)) {
+        return false;
+    }
+
+    *pin_state = g_pin_state[pin_name];
+
+    return true;
+}
+
+bool Power_API_Init (void) {
+    return true;
+}
+
+void Power_API_Lock (void) {
+    g_stats.power_locks++;
+    g_stats.power_lock_depth++;
+
+    if ((uint32_t) g_stats.power_lock_depth > g_stats.max_power_lock_depth) {
+        g_stats.max_power_lock_depth = (uint32_t) g_stats.power_lock_depth;
+    }
+}
+
+void Power_API_Unlock (void) {
+    if (g_stats.power_lock_depth == 0) {
+        fprintf(stderr, "host: power unlock without a lock\n");
+        abort();
+    }
+
+    g_stats.power_lock_depth--;
+}
+
+void Power_API_MarkActivity (void) {
+}
+
+uint32_t Power_API_GetStopTime (void) {
+    return 0;
+}
+
+bool Power_API_GetStats (sPowerStats_t *stats) {
+    if (stats == NULL) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->locks = (uint32_t) g_stats.power_lock_depth;
+
+    return true;
+}
+
+bool UART_Driver_Init (eUartDriver_t uart, uint32_t baudrate) {
+    return (uart < eUartDriver_Last) && (baudrate > 0);
+}
+
+bool UART_Driver_SendByte (eUartDriver_t uart, uint8_t data) {
+    return UART_Driver_SendBytes(uart, &data, 1);
+}
+
+bool UART_Driver_SendBytes (eUartDriver_t uart, uint8_t *data, size_t length) {
+    if ((uart >= eUartDriver_Last) || (data == NULL)) {
+        return false;
+    }
+
+    if (uart == eUartDriver_2) {
+        Modem_Sim_OnMcuBytes(data, length);
+    } else if (Host_Board_IsVerbose() == true) {
+        fwrite(data, 1, length, stdout);
+    }
+
+    return true;
+}
+
+bool UART_Driver_GetByte (eUartDriver_t uart, uint8_t *data) {
+    if ((uart != eUartDriver_2) || (data == NULL)) {
+        return false;
+    }
+
+    return Modem_Sim_GetByte(data);
+}
+
+bool UART_Driver_SetRxCallback (eUartDriver_t uart, uart_rx_callback_t callback) {
+    if (uart >= eUartDriver_Last) {
+        return false;
+    }
+
+    g_rx_callback[uart] = callback;
+
+    return true;
+}
+
+bool UART_Driver_IsTxIdle (eUartDriver_t uart) {
+    return (uart < eUartDriver_Last);
+}
@@ -0,0 +1,26 @@
+#ifndef TESTS_HOST_HOST_BOARD_H_
+#define TESTS_HOST_HOST_BOARD_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef struct sHostBoardStats {
+    uint32_t power_locks;
+    /* Deepest the lock count got and the current count, Stop is only entered at 0 */
+    uint32_t max_power_lock_depth;
+    int32_t power_lock_depth;
+    uint32_t dtr_pulses;
+} sHostBoardStats_t;
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* The modem stand-in has bytes for the MCU, runs the receive interrupt of the modem UART */
+void Host_Board_OnModemOutput (void);
+const sHostBoardStats_t *Host_Board_GetStats (void);
+/* Log lines go to stdout when set, HOST_VERBOSE=1 in the environment sets it too */
+void Host_Board_SetVerbose (bool is_verbose);
+#endif /* TESTS_HOST_HOST_BOARD_H_ */
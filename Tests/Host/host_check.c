@@ -0,0 +1,45 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "host.h"
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static int g_failures = 0;
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+bool Host_Check (bool condition, const char *expression, const char *file, int line) {
+    if (condition == false) {
+        g_failures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+
+    return condition;
+}
+
+int Host_GetFailures (void) {
+    return g_failures;
+}
+
+uint64_t Host_ReadCycles (void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+uint64_t Host_ReadNanoseconds (void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+}
@@ -0,0 +1,12 @@
+#ifndef TESTS_HOST_HOST_COMPAT_H_
+#define TESTS_HOST_HOST_COMPAT_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdlib.h>
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* newlib has it and the firmware uses it, glibc does not. Force included into every host build. */
+char *itoa (int value, char *str, int base);
+#endif /* TESTS_HOST_HOST_COMPAT_H_ */
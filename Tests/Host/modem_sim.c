@@ -0,0 +1,834 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "cmux_frame.h"
+#include "host_board.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SIM_OUTPUT_SIZE (256U * 1024U)
+#define SIM_LINE_SIZE 256
+#define SIM_EVENT_COUNT 64
+#define SIM_EVENT_TEXT_SIZE 160
+#define SIM_CHANNEL_COUNT 4
+#define SIM_CHANNEL_AT 1
+#define SIM_CHANNEL_DATA 2
+#define SIM_CHANNEL_GNSS 3
+#define SIM_WAKE_FLAG 0x01U
+#define SIM_POWER_KEY_MIN_MS 500
+#define SIM_ESCAPE_GUARD_MS 1000
+#define SIM_NO_SOCKET (-1)
+#define SIM_CONNECT_FAILED 566
+#define SIM_CONTEXT_FAILED 561
+#define SIM_SOCKET_USED 563
+#define SIM_NO_FIX 516
+#define SIM_CONTROL_CLD 0xC3
+#define SIM_CONTROL_CR 0x02
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eSimEvent {
+    eSimEvent_First = 0,
+    eSimEvent_Text = eSimEvent_First,
+    eSimEvent_Boot,
+    eSimEvent_OpenResult,
+    eSimEvent_EscapeCheck,
+    eSimEvent_Prompt,
+    eSimEvent_Last
+} eSimEvent_t;
+
+typedef struct sSimEvent {
+    bool is_used;
+    eSimEvent_t type;
+    uint32_t due_tick;
+    uint32_t generation;
+    int channel;
+    int socket;
+    int mode;
+    char text[SIM_EVENT_TEXT_SIZE];
+} sSimEvent_t;
+
+typedef struct sSimChannel {
+    char line[SIM_LINE_SIZE];
+    size_t line_size;
+    int send_socket;
+    /* The payload only counts once the prompt is out, the rest of the command write is thrown away like on the
+     * module */
+    size_t prompt_size;
+    size_t send_left;
+    int transparent_socket;
+    uint32_t last_rx_tick;
+    size_t escape_count;
+} sSimChannel_t;
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sModemSimConfig_t g_config = {0};
+static sModemSimStats_t g_stats = {0};
+static sModemSimSocket_t g_socket[MODEM_SIM_SOCKET_COUNT];
+static sSimChannel_t g_channel[SIM_CHANNEL_COUNT];
+static sSimEvent_t g_event[SIM_EVENT_COUNT];
+static uint8_t g_output[SIM_OUTPUT_SIZE];
+static size_t g_output_head = 0;
+static size_t g_output_count = 0;
+static osThreadId_t g_thread_id = NULL;
+static sCmuxDeframer_t g_deframer = {0};
+static bool g_is_booted = false;
+static bool g_is_echo = true;
+static bool g_is_cmux = false;
+static bool g_is_network_up = true;
+static bool g_is_context_active = false;
+static bool g_has_fix = false;
+static char g_location[SIM_EVENT_TEXT_SIZE] = {0};
+static bool g_is_power_key_high = false;
+static uint32_t g_power_key_tick = 0;
+/* Events of an earlier boot are dropped when they come due */
+static uint32_t g_generation = 0;
+static uint32_t g_second_tick = 0;
+static uint32_t g_second_commands = 0;
+static uint32_t g_open_attempt[MODEM_SIM_SOCKET_COUNT];
+static uint32_t g_prompt_delay_ms = 0;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Modem_Sim_Thread (void *argument);
+static void Modem_Sim_Schedule (eSimEvent_t type, uint32_t delay_ms, int channel, int socket, int mode, const char *text);
+static void Modem_Sim_RunEvent (sSimEvent_t *event);
+static void Modem_Sim_Output (const uint8_t *data, size_t size);
+static void Modem_Sim_Emit (int channel, const void *data, size_t size);
+static void Modem_Sim_EmitLine (int channel, const char *line);
+static void Modem_Sim_Reset (void);
+static void Modem_Sim_OnChannelByte (int channel, uint8_t byte);
+static void Modem_Sim_OnTransparentBytes (int channel, const uint8_t *data, size_t size);
+static void Modem_Sim_OnFrame (const sCmuxFrame_t *frame);
+static void Modem_Sim_SendFrame (uint8_t dlci, uint8_t control, const uint8_t *info, size_t info_size);
+static void Modem_Sim_HandleCommand (int channel, char *command);
+static void Modem_Sim_ServerReceive (int connect_id, const uint8_t *data, size_t size);
+static void Modem_Sim_CloseAll (bool is_reported);
+static bool Modem_Sim_IsSocketValid (int connect_id);
+static void Modem_Sim_ArmPrompts (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static void Modem_Sim_Thread (void *argument) {
+    while (1) {
+        uint32_t now = osKernelGetTickCount();
+        uint32_t timeout = osWaitForever;
+        sSimEvent_t *due = NULL;
+
+        for (size_t i = 0; i < SIM_EVENT_COUNT; i++) {
+            if (g_event[i].is_used == false) {
+                continue;
+            }
+
+            int32_t remaining = (int32_t) (g_event[i].due_tick - now);
+
+            if (remaining <= 0) {
+                if ((due == NULL) || ((int32_t) (g_event[i].due_tick - due->due_tick) < 0)) {
+                    due = &g_event[i];
+                }
+            } else if ((uint32_t) remaining < timeout) {
+                timeout = (uint32_t) remaining;
+            }
+        }
+
+        if (due != NULL) {
+            sSimEvent_t event = *due;
+            due->is_used = false;
+
+            if (event.generation == g_generation) {
+                Modem_Sim_RunEvent(&event);
+            }
+
+            continue;
+        }
+
+        osThreadFlagsWait(SIM_WAKE_FLAG, osFlagsWaitAny, timeout);
+    }
+}
+
+static void Modem_Sim_Schedule (eSimEvent_t type, uint32_t delay_ms, int channel, int socket, int mode, const char *text) {
+    for (size_t i = 0; i < SIM_EVENT_COUNT; i++) {
+        if (g_event[i].is_used == true) {
+            continue;
+        }
+
+        g_event[i].is_used = true;
+        g_event[i].type = type;
+        g_event[i].due_tick = osKernelGetTickCount() + delay_ms;
+        g_event[i].generation = g_generation;
+        g_event[i].channel = channel;
+        g_event[i].socket = socket;
+        g_event[i].mode = mode;
+        snprintf(g_event[i].text, sizeof(g_event[i].text), "%s", (text != NULL) ? text : "");
+        osThreadFlagsSet(g_thread_id, SIM_WAKE_FLAG);
+        return;
+    }
+
+    fprintf(stderr, "modem sim: out of events\n");
+    abort();
+}
+
+static void Modem_Sim_RunEvent (sSimEvent_t *event) {
+    switch (event->type) {
+        case eSimEvent_Text: {
+            Modem_Sim_EmitLine(event->channel, event->text);
+            break;
+        }
+        case eSimEvent_Boot: {
+            static const char *boot_lines[] = {"RDY", "+CFUN: 1", "+CPIN: READY", "+QUSIM: 1", "+QIND: SMS DONE", "+QIND: PB DONE"};
+
+            g_is_booted = true;
+            g_stats.boots++;
+
+            for (size_t i = 0; i < (sizeof(boot_lines) / sizeof(boot_lines[0])); i++) {
+                Modem_Sim_EmitLine(SIM_CHANNEL_AT, boot_lines[i]);
+            }
+            break;
+        }
+        case eSimEvent_OpenResult: {
+            sModemSimSocket_t *socket = &g_socket[event->socket];
+            int result = SIM_CONNECT_FAILED;
+
+            if (g_is_context_active == false) {
+                result = SIM_CONTEXT_FAILED;
+            } else if (g_is_network_up == true) {
+                result = (g_config.open_handler != NULL) ? g_config.open_handler(event->socket, g_open_attempt[event->socket]) : 0;
+            }
+
+            if (result != 0) {
+                socket->open_failures++;
+            } else {
+                socket->is_open = true;
+            }
+
+            char line[SIM_EVENT_TEXT_SIZE];
+
+            if (event->mode == 2) {
+                if (result == 0) {
+                    socket->is_transparent = true;
+                    g_channel[event->channel].transparent_socket = event->socket;
+                    Modem_Sim_EmitLine(event->channel, "CONNECT");
+                } else {
+                    Modem_Sim_EmitLine(event->channel, "ERROR");
+                }
+                break;
+            }
+
+            snprintf(line, sizeof(line), "+QIOPEN: %d,%d", event->socket, result);
+            Modem_Sim_EmitLine(SIM_CHANNEL_AT, line);
+            break;
+        }
+        case eSimEvent_EscapeCheck: {
+            sSimChannel_t *channel = &g_channel[event->channel];
+
+            if ((channel->escape_count != 3) || ((osKernelGetTickCount() - channel->last_rx_tick) < SIM_ESCAPE_GUARD_MS)) {
+                break;
+            }
+
+            g_stats.escapes++;
+            g_socket[channel->transparent_socket].is_transparent = false;
+            channel->transparent_socket = SIM_NO_SOCKET;
+            channel->escape_count = 0;
+            Modem_Sim_EmitLine(event->channel, "OK");
+            break;
+        }
+        case eSimEvent_Prompt: {
+            /* The length of the send rides in the mode field, whatever came before the prompt went to the parser */
+            g_channel[event->channel].send_socket = event->socket;
+            g_channel[event->channel].send_left = (size_t) event->mode;
+            Modem_Sim_Emit(event->channel, "\r\n> ", 4);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void Modem_Sim_Output (const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (g_output_count == SIM_OUTPUT_SIZE) {
+            fprintf(stderr, "modem sim: output overflow\n");
+            abort();
+        }
+
+        g_output[(g_output_head + g_output_count) % SIM_OUTPUT_SIZE] = data[i];
+        g_output_count++;
+    }
+
+    Host_Board_OnModemOutput();
+}
+
+static void Modem_Sim_SendFrame (uint8_t dlci, uint8_t control, const uint8_t *info, size_t info_size) {
+    uint8_t frame_buffer[CMUX_FRAME_MAX_SIZE];
+    sCmuxFrame_t frame = {.dlci = dlci, .control = control, .is_command = false, .poll_final = (control != CMUX_FRAME_UIH),
+                          .info = info, .info_size = info_size};
+    size_t frame_size = CmuxFrame_Encode(&frame, frame_buffer, sizeof(frame_buffer));
+
+    Modem_Sim_Output(frame_buffer, frame_size);
+}
+
+static void Modem_Sim_Emit (int channel, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *) data;
+
+    if (g_is_cmux == false) {
+        Modem_Sim_Output(bytes, size);
+        return;
+    }
+
+    while (size > 0) {
+        size_t chunk_size = (size > CMUX_FRAME_MAX_INFO_SIZE) ? CMUX_FRAME_MAX_INFO_SIZE : size;
+
+        Modem_Sim_SendFrame((uint8_t) channel, CMUX_FRAME_UIH, bytes, chunk_size);
+        bytes += chunk_size;
+        size -= chunk_size;
+    }
+}
+
+static void Modem_Sim_EmitLine (int channel, const char *line) {
+    char buffer[SIM_LINE_SIZE + 8];
+    int size = snprintf(buffer, sizeof(buffer), "\r\n%s\r\n", line);
+
+    Modem_Sim_Emit(channel, buffer, (size_t) size);
+}
+
+static void Modem_Sim_Reset (void) {
+    g_generation++;
+    g_is_booted = false;
+    g_is_echo = true;
+    g_is_cmux = false;
+    g_is_context_active = false;
+    g_output_count = 0;
+    CmuxFrame_ResetDeframer(&g_deframer);
+
+    for (int connect_id = 0; connect_id < MODEM_SIM_SOCKET_COUNT; connect_id++) {
+        g_socket[connect_id].is_open = false;
+        g_socket[connect_id].is_transparent = false;
+        g_socket[connect_id].downlink_count = 0;
+    }
+
+    for (int channel = 0; channel < SIM_CHANNEL_COUNT; channel++) {
+        memset(&g_channel[channel], 0, sizeof(g_channel[channel]));
+        g_channel[channel].send_socket = SIM_NO_SOCKET;
+        g_channel[channel].transparent_socket = SIM_NO_SOCKET;
+    }
+}
+
+static void Modem_Sim_ArmPrompts (void) {
+    for (int channel = 0; channel < SIM_CHANNEL_COUNT; channel++) {
+        if (g_channel[channel].prompt_size > 0) {
+            g_channel[channel].send_left = g_channel[channel].prompt_size;
+            g_channel[channel].prompt_size = 0;
+        }
+    }
+}
+
+static bool Modem_Sim_IsSocketValid (int connect_id) {
+    return (connect_id >= 0) && (connect_id < MODEM_SIM_SOCKET_COUNT);
+}
+
+static void Modem_Sim_ServerReceive (int connect_id, const uint8_t *data, size_t size) {
+    sModemSimSocket_t *socket = &g_socket[connect_id];
+    size_t stored = size;
+
+    if (stored > (MODEM_SIM_SERVER_BUFFER_SIZE - socket->server_rx_count)) {
+        stored = MODEM_SIM_SERVER_BUFFER_SIZE - socket->server_rx_count;
+    }
+
+    memcpy(&socket->server_rx[socket->server_rx_count], data, stored);
+    socket->server_rx_count += stored;
+    socket->received += size;
+
+    if (g_config.server_handler != NULL) {
+        g_config.server_handler(connect_id, data, size);
+    }
+}
+
+static void Modem_Sim_CloseAll (bool is_reported) {
+    for (int connect_id = 0; connect_id < MODEM_SIM_SOCKET_COUNT; connect_id++) {
+        if (g_socket[connect_id].is_open == false) {
+            continue;
+        }
+
+        g_socket[connect_id].is_open = false;
+
+        if (is_reported == true) {
+            char line[SIM_EVENT_TEXT_SIZE];
+            snprintf(line, sizeof(line), "+QIURC: \"closed\",%d", connect_id);
+            Modem_Sim_EmitLine(SIM_CHANNEL_AT, line);
+        }
+    }
+}
+
+static void Modem_Sim_OnTransparentBytes (int channel, const uint8_t *data, size_t size) {
+    sSimChannel_t *sim_channel = &g_channel[channel];
+    uint32_t now = osKernelGetTickCount();
+
+    for (size_t i = 0; i < size; i++) {
+        bool is_guarded = (sim_channel->escape_count > 0) || ((now - sim_channel->last_rx_tick) >= SIM_ESCAPE_GUARD_MS);
+
+        if ((data[i] == '+') && (is_guarded == true) && (sim_channel->escape_count < 3)) {
+            sim_channel->escape_count++;
+
+            if (sim_channel->escape_count == 3) {
+                Modem_Sim_Schedule(eSimEvent_EscapeCheck, SIM_ESCAPE_GUARD_MS, channel, SIM_NO_SOCKET, 0, NULL);
+            }
+
+            sim_channel->last_rx_tick = now;
+            continue;
+        }
+
+        /* Pluses that turned out to be data go to the server after all */
+        while (sim_channel->escape_count > 0) {
+            uint8_t plus = '+';
+            Modem_Sim_ServerReceive(sim_channel->transparent_socket, &plus, 1);
+            sim_channel->escape_count--;
+        }
+
+        Modem_Sim_ServerReceive(sim_channel->transparent_socket, &data[i], 1);
+        sim_channel->last_rx_tick = now;
+    }
+}
+
+static void Modem_Sim_OnChannelByte (int channel, uint8_t byte) {
+    sSimChannel_t *sim_channel = &g_channel[channel];
+
+    if (sim_channel->transparent_socket != SIM_NO_SOCKET) {
+        Modem_Sim_OnTransparentBytes(channel, &byte, 1);
+        return;
+    }
+
+    sim_channel->last_rx_tick = osKernelGetTickCount();
+
+    if (sim_channel->prompt_size > 0) {
+        return;
+    }
+
+    if (sim_channel->send_left > 0) {
+        int connect_id = sim_channel->send_socket;
+
+        Modem_Sim_ServerReceive(connect_id, &byte, 1);
+
+        if (--sim_channel->send_left == 0) {
+            sim_channel->send_socket = SIM_NO_SOCKET;
+
+            if ((g_is_network_up == true) && (g_socket[connect_id].is_open == true)) {
+                g_socket[connect_id].sends++;
+                Modem_Sim_EmitLine(channel, "SEND OK");
+            } else {
+                g_socket[connect_id].send_failures++;
+                Modem_Sim_EmitLine(channel, "SEND FAIL");
+            }
+        }
+        return;
+    }
+
+    /* The firmware terminates its commands with a NUL after the line end */
+    if ((byte == '\0') || (byte == '\n')) {
+        return;
+    }
+
+    if (byte != '\r') {
+        if (sim_channel->line_size < (SIM_LINE_SIZE - 1)) {
+            sim_channel->line[sim_channel->line_size++] = (char) byte;
+        }
+        return;
+    }
+
+    sim_channel->line[sim_channel->line_size] = '\0';
+    sim_channel->line_size = 0;
+
+    if (sim_channel->line[0] == '\0') {
+        return;
+    }
+
+    if (g_is_echo == true) {
+        char echo[SIM_LINE_SIZE + 4];
+        int size = snprintf(echo, sizeof(echo), "%s\r\n", sim_channel->line);
+        Modem_Sim_Emit(channel, echo, (size_t) size);
+    }
+
+    Modem_Sim_HandleCommand(channel, sim_channel->line);
+}
+
+static void Modem_Sim_OnFrame (const sCmuxFrame_t *frame) {
+    switch (frame->control) {
+        case CMUX_FRAME_SABM:
+        case CMUX_FRAME_DISC: {
+            if (g_config.is_cmux_broken == false) {
+                Modem_Sim_SendFrame(frame->dlci, CMUX_FRAME_UA, NULL, 0);
+            }
+            break;
+        }
+        case CMUX_FRAME_UIH:
+        case CMUX_FRAME_UI: {
+            if (frame->dlci != 0) {
+                if (frame->dlci < SIM_CHANNEL_COUNT) {
+                    for (size_t i = 0; i < frame->info_size; i++) {
+                        Modem_Sim_OnChannelByte(frame->dlci, frame->info[i]);
+                    }
+                }
+                break;
+            }
+
+            if ((frame->info_size > 0) && ((frame->info[0] & ~SIM_CONTROL_CR) == (SIM_CONTROL_CLD & ~SIM_CONTROL_CR))) {
+                uint8_t response[CMUX_FRAME_MAX_INFO_SIZE];
+                memcpy(response, frame->info, frame->info_size);
+                response[0] &= ~SIM_CONTROL_CR;
+
+                if (g_config.is_cmux_broken == false) {
+                    Modem_Sim_SendFrame(0, CMUX_FRAME_UIH, response, frame->info_size);
+                }
+
+                g_is_cmux = false;
+                CmuxFrame_ResetDeframer(&g_deframer);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+static void Modem_Sim_HandleCommand (int channel, char *command) {
+    char line[SIM_LINE_SIZE];
+    uint32_t now = osKernelGetTickCount();
+
+    g_stats.commands++;
+
+    if ((now - g_second_tick) >= 1000) {
+        g_second_tick = now;
+        g_second_commands = 0;
+    }
+
+    if (++g_second_commands > g_stats.max_commands_per_second) {
+        g_stats.max_commands_per_second = g_second_commands;
+    }
+
+    if ((g_is_booted == false) || (strncmp(command, "AT", 2) != 0)) {
+        return;
+    }
+
+    char *body = &command[2];
+
+    if ((strcmp(body, "") == 0) || (strcmp(body, "E0") == 0)) {
+        g_is_echo = (strcmp(body, "E0") == 0) ? false : g_is_echo;
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+CMUX=", 6) == 0) {
+        if ((g_config.is_cmux_supported == false) || (g_is_cmux == true)) {
+            g_stats.errors++;
+            Modem_Sim_EmitLine(channel, "ERROR");
+            return;
+        }
+
+        Modem_Sim_EmitLine(channel, "OK");
+        g_is_cmux = true;
+        g_stats.cmux_sessions++;
+        CmuxFrame_ResetDeframer(&g_deframer);
+    } else if (strncmp(body, "+IFC=", 5) == 0) {
+        if (g_config.is_flow_control_refused == true) {
+            g_stats.errors++;
+            Modem_Sim_EmitLine(channel, "ERROR");
+            return;
+        }
+
+        g_stats.is_flow_control = (strcmp(body, "+IFC=2,2") == 0);
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if ((strncmp(body, "+QICSGP=", 8) == 0) || (strncmp(body, "+QICFG=", 7) == 0) || (strncmp(body, "&D", 2) == 0)) {
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+QIACT=", 7) == 0) {
+        g_is_context_active = g_is_network_up;
+        Modem_Sim_EmitLine(channel, (g_is_context_active == true) ? "OK" : "ERROR");
+    } else if (strncmp(body, "+QIDEACT=", 9) == 0) {
+        g_is_context_active = false;
+        Modem_Sim_CloseAll(false);
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strcmp(body, "+CEREG?") == 0) {
+        Modem_Sim_EmitLine(channel, (g_is_network_up == true) ? "+CEREG: 0,1" : "+CEREG: 0,2");
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+CGPADDR=", 9) == 0) {
+        Modem_Sim_EmitLine(channel, "+CGPADDR: 1,10.20.30.40");
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+QIOPEN=", 8) == 0) {
+        int context_id = 0;
+        int connect_id = 0;
+        int mode = 0;
+        char *mode_str = strrchr(body, ',');
+
+        if ((sscanf(&body[8], "%d,%d", &context_id, &connect_id) != 2) || (Modem_Sim_IsSocketValid(connect_id) == false) ||
+            (mode_str == NULL)) {
+            Modem_Sim_EmitLine(channel, "ERROR");
+            return;
+        }
+
+        mode = atoi(&mode_str[1]);
+        g_socket[connect_id].opens++;
+        g_open_attempt[connect_id]++;
+
+        if (g_stats.open_count < MODEM_SIM_MAX_OPENS) {
+            g_stats.open_tick[g_stats.open_count] = now;
+            g_stats.open_socket[g_stats.open_count] = (uint8_t) connect_id;
+        }
+        g_stats.open_count++;
+
+        if (g_socket[connect_id].is_open == true) {
+            Modem_Sim_EmitLine(channel, "OK");
+            snprintf(line, sizeof(line), "+QIOPEN: %d,%d", connect_id, SIM_SOCKET_USED);
+            Modem_Sim_Schedule(eSimEvent_Text, 10, SIM_CHANNEL_AT, connect_id, 0, line);
+            return;
+        }
+
+        if (mode != 2) {
+            Modem_Sim_EmitLine(channel, "OK");
+        }
+
+        Modem_Sim_Schedule(eSimEvent_OpenResult, g_config.open_delay_ms, channel, connect_id, mode, NULL);
+    } else if (strncmp(body, "+QISEND=", 8) == 0) {
+        int connect_id = 0;
+        int length = 0;
+
+        if ((sscanf(&body[8], "%d,%d", &connect_id, &length) != 2) || (Modem_Sim_IsSocketValid(connect_id) == false) ||
+            (g_socket[connect_id].is_open == false) || (length <= 0)) {
+            g_stats.errors++;
+            Modem_Sim_EmitLine(channel, "ERROR");
+            return;
+        }
+
+        if ((g_prompt_delay_ms > 0) && (g_prompt_delay_ms != MODEM_SIM_PROMPT_LOST)) {
+            Modem_Sim_Schedule(eSimEvent_Prompt, g_prompt_delay_ms, channel, connect_id, length, NULL);
+            return;
+        }
+
+        g_channel[channel].send_socket = connect_id;
+        g_channel[channel].prompt_size = (size_t) length;
+
+        if (g_prompt_delay_ms != MODEM_SIM_PROMPT_LOST) {
+            Modem_Sim_Emit(channel, "\r\n> ", 4);
+        }
+    } else if (strncmp(body, "+QIRD=", 6) == 0) {
+        int connect_id = 0;
+        int length = 0;
+
+        if ((sscanf(&body[6], "%d,%d", &connect_id, &length) != 2) || (Modem_Sim_IsSocketValid(connect_id) == false)) {
+            Modem_Sim_EmitLine(channel, "ERROR");
+            return;
+        }
+
+        sModemSimSocket_t *socket = &g_socket[connect_id];
+        size_t read_size = (socket->downlink_count < (size_t) length) ? socket->downlink_count : (size_t) length;
+
+        snprintf(line, sizeof(line), "+QIRD: %u", (unsigned) read_size);
+        Modem_Sim_EmitLine(channel, line);
+
+        if (read_size > 0) {
+            Modem_Sim_Emit(channel, socket->downlink, read_size);
+            memmove(socket->downlink, &socket->downlink[read_size], socket->downlink_count - read_size);
+            socket->downlink_count -= read_size;
+        }
+
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+QICLOSE=", 9) == 0) {
+        int connect_id = atoi(&body[9]);
+
+        if (Modem_Sim_IsSocketValid(connect_id) == true) {
+            g_socket[connect_id].closes++;
+            g_socket[connect_id].is_open = false;
+        }
+
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strncmp(body, "+QIGETERROR", 11) == 0) {
+        Modem_Sim_EmitLine(channel, "+QIGETERROR: 0,operation successful");
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if ((strncmp(body, "+QGPS", 5) == 0)) {
+        if (channel == SIM_CHANNEL_GNSS) {
+            g_stats.gnss_commands_on_gnss_channel++;
+        } else {
+            g_stats.gnss_commands_on_at_channel++;
+        }
+
+        if (strncmp(body, "+QGPSLOC=", 9) == 0) {
+            if (g_has_fix == false) {
+                snprintf(line, sizeof(line), "+CME ERROR: %d", SIM_NO_FIX);
+                Modem_Sim_EmitLine(channel, line);
+                return;
+            }
+
+            snprintf(line, sizeof(line), "+QGPSLOC: %s", g_location);
+            Modem_Sim_EmitLine(channel, line);
+        }
+
+        Modem_Sim_EmitLine(channel, "OK");
+    } else if (strcmp(body, "+CSQ") == 0) {
+        Modem_Sim_EmitLine(channel, "+CSQ: 20,99");
+        Modem_Sim_EmitLine(channel, "OK");
+    } else {
+        g_stats.errors++;
+        Modem_Sim_EmitLine(channel, "ERROR");
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+void Modem_Sim_Init (const sModemSimConfig_t *config) {
+    g_config = *config;
+
+    if (g_config.boot_ms == 0) {
+        g_config.boot_ms = 10000;
+    }
+
+    memset(&g_stats, 0, sizeof(g_stats));
+    memset(g_socket, 0, sizeof(g_socket));
+    memset(g_event, 0, sizeof(g_event));
+    memset(g_open_attempt, 0, sizeof(g_open_attempt));
+    Modem_Sim_Reset();
+
+    if (g_thread_id == NULL) {
+        osThreadAttr_t attr = {.name = "ModemSim"};
+        g_thread_id = osThreadNew(&Modem_Sim_Thread, NULL, &attr);
+    }
+}
+
+void Modem_Sim_OnMcuBytes (const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (g_is_booted == false) {
+            continue;
+        }
+
+        if (g_is_cmux == false) {
+            Modem_Sim_OnChannelByte(SIM_CHANNEL_AT, data[i]);
+            continue;
+        }
+
+        sCmuxFrame_t frame;
+
+        if (CmuxFrame_Decode(&g_deframer, data[i], &frame)) {
+            Modem_Sim_OnFrame(&frame);
+            Modem_Sim_ArmPrompts();
+        }
+    }
+
+    Modem_Sim_ArmPrompts();
+}
+
+bool Modem_Sim_GetByte (uint8_t *byte) {
+    if (g_output_count == 0) {
+        return false;
+    }
+
+    *byte = g_output[g_output_head];
+    g_output_head = (g_output_head + 1) % SIM_OUTPUT_SIZE;
+    g_output_count--;
+
+    return true;
+}
+
+/* PWRKEY: a pulse of at least half a second starts the module, a running one restarts from scratch */
+void Modem_Sim_OnPowerKey (bool is_high) {
+    uint32_t now = osKernelGetTickCount();
+
+    if (is_high == g_is_power_key_high) {
+        return;
+    }
+
+    g_is_power_key_high = is_high;
+
+    if (is_high == true) {
+        g_power_key_tick = now;
+        return;
+    }
+
+    if ((now - g_power_key_tick) < SIM_POWER_KEY_MIN_MS) {
+        return;
+    }
+
+    Modem_Sim_Reset();
+    Modem_Sim_Schedule(eSimEvent_Boot, g_config.boot_ms, SIM_CHANNEL_AT, SIM_NO_SOCKET, 0, NULL);
+}
+
+bool Modem_Sim_IsBooted (void) {
+    return g_is_booted;
+}
+
+bool Modem_Sim_IsMultiplexed (void) {
+    return g_is_cmux;
+}
+
+void Modem_Sim_SetNetwork (bool is_up) {
+    g_is_network_up = is_up;
+
+    if (is_up == false) {
+        Modem_Sim_CloseAll(true);
+    }
+}
+
+void Modem_Sim_CloseSocket (int connect_id) {
+    if ((Modem_Sim_IsSocketValid(connect_id) == false) || (g_socket[connect_id].is_open == false)) {
+        return;
+    }
+
+    char line[SIM_EVENT_TEXT_SIZE];
+
+    g_socket[connect_id].is_open = false;
+    snprintf(line, sizeof(line), "+QIURC: \"closed\",%d", connect_id);
+    Modem_Sim_EmitLine(SIM_CHANNEL_AT, line);
+}
+
+void Modem_Sim_DeactivateContext (void) {
+    g_is_context_active = false;
+    Modem_Sim_CloseAll(false);
+    Modem_Sim_EmitLine(SIM_CHANNEL_AT, "+QIURC: \"pdpdeact\",1");
+}
+
+void Modem_Sim_PushDownlink (int connect_id, const void *data, size_t size) {
+    if ((Modem_Sim_IsSocketValid(connect_id) == false) || (g_socket[connect_id].is_open == false)) {
+        return;
+    }
+
+    sModemSimSocket_t *socket = &g_socket[connect_id];
+
+    if (socket->is_transparent == true) {
+        for (int channel = 0; channel < SIM_CHANNEL_COUNT; channel++) {
+            if (g_channel[channel].transparent_socket == connect_id) {
+                Modem_Sim_Emit(channel, data, size);
+            }
+        }
+        return;
+    }
+
+    if (size > (MODEM_SIM_SERVER_BUFFER_SIZE - socket->downlink_count)) {
+        size = MODEM_SIM_SERVER_BUFFER_SIZE - socket->downlink_count;
+    }
+
+    memcpy(&socket->downlink[socket->downlink_count], data, size);
+    socket->downlink_count += size;
+
+    char line[SIM_EVENT_TEXT_SIZE];
+    snprintf(line, sizeof(line), "+QIURC: \"recv\",%d", connect_id);
+    Modem_Sim_EmitLine(SIM_CHANNEL_AT, line);
+}
+
+void Modem_Sim_SetPromptDelay (uint32_t delay_ms) {
+    g_prompt_delay_ms = delay_ms;
+}
+
+void Modem_Sim_SetFix (bool has_fix, const char *location) {
+    g_has_fix = has_fix;
+    snprintf(g_location, sizeof(g_location), "%s", (location != NULL) ? location : "");
+}
+
+const sModemSimSocket_t *Modem_Sim_GetSocket (int connect_id) {
+    return (Modem_Sim_IsSocketValid(connect_id) == true) ? &g_socket[connect_id] : NULL;
+}
+
+const sModemSimStats_t *Modem_Sim_GetStats (void) {
+    return &g_stats;
+}
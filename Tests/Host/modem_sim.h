@@ -0,0 +1,91 @@
+#ifndef TESTS_HOST_MODEM_SIM_H_
+#define TESTS_HOST_MODEM_SIM_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+#define MODEM_SIM_SOCKET_COUNT 12
+#define MODEM_SIM_SERVER_BUFFER_SIZE 8192
+#define MODEM_SIM_MAX_OPENS 256
+/* The modem waits for the payload of AT+QISEND but its > prompt never reaches the tracker */
+#define MODEM_SIM_PROMPT_LOST UINT32_MAX
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+/* Decides how an AT+QIOPEN ends, 0 opens the socket and anything else is the +QIOPEN error code */
+typedef int (*modem_sim_open_handler_t) (int connect_id, uint32_t attempt);
+/* Sees every byte the tracker sends on an open socket, the stand-in for the server */
+typedef void (*modem_sim_server_handler_t) (int connect_id, const uint8_t *data, size_t size);
+
+typedef struct sModemSimSocket {
+    bool is_open;
+    bool is_transparent;
+    uint32_t opens;
+    uint32_t open_failures;
+    uint32_t closes;
+    uint32_t sends;
+    uint32_t send_failures;
+    size_t received;
+    uint8_t server_rx[MODEM_SIM_SERVER_BUFFER_SIZE];
+    size_t server_rx_count;
+    uint8_t downlink[MODEM_SIM_SERVER_BUFFER_SIZE];
+    size_t downlink_count;
+} sModemSimSocket_t;
+
+typedef struct sModemSimStats {
+    uint32_t boots;
+    uint32_t commands;
+    uint32_t errors;
+    uint32_t max_commands_per_second;
+    uint32_t cmux_sessions;
+    /* AT+IFC=2,2 taken, the modem would hold its bytes while RTS is up */
+    bool is_flow_control;
+    uint32_t escapes;
+    uint32_t gnss_commands_on_at_channel;
+    uint32_t gnss_commands_on_gnss_channel;
+    uint32_t open_count;
+    uint32_t open_tick[MODEM_SIM_MAX_OPENS];
+    uint8_t open_socket[MODEM_SIM_MAX_OPENS];
+} sModemSimStats_t;
+
+typedef struct sModemSimConfig {
+    bool is_cmux_supported;
+    /* Answers AT+CMUX with OK but never acknowledges the SABM frames */
+    bool is_cmux_broken;
+    /* Answers AT+IFC with ERROR, like a modem without the RTS/CTS lines */
+    bool is_flow_control_refused;
+    uint32_t boot_ms;
+    uint32_t open_delay_ms;
+    modem_sim_open_handler_t open_handler;
+    modem_sim_server_handler_t server_handler;
+} sModemSimConfig_t;
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+void Modem_Sim_Init (const sModemSimConfig_t *config);
+/* UART side, wired up by the host board */
+void Modem_Sim_OnMcuBytes (const uint8_t *data, size_t length);
+bool Modem_Sim_GetByte (uint8_t *byte);
+void Modem_Sim_OnPowerKey (bool is_high);
+/* Network side */
+bool Modem_Sim_IsBooted (void);
+bool Modem_Sim_IsMultiplexed (void);
+void Modem_Sim_SetNetwork (bool is_up);
+void Modem_Sim_CloseSocket (int connect_id);
+void Modem_Sim_DeactivateContext (void);
+void Modem_Sim_PushDownlink (int connect_id, const void *data, size_t size);
+void Modem_Sim_SetFix (bool has_fix, const char *location);
+/* Holds the > prompt of AT+QISEND back, 0 answers straight away */
+void Modem_Sim_SetPromptDelay (uint32_t delay_ms);
+const sModemSimSocket_t *Modem_Sim_GetSocket (int connect_id);
+const sModemSimStats_t *Modem_Sim_GetStats (void);
+#endif /* TESTS_HOST_MODEM_SIM_H_ */
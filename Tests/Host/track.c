@@ -0,0 +1,403 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "nmea_parser.h"
+#include "track.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+/* Vilnius, 2026-02-19 08:11:22 UTC */
+#define START_LATITUDE 54.68916
+#define START_LONGITUDE 25.27980
+#define START_ALTITUDE_M 120.0
+#define START_TIME 1771488682U
+#define METERS_PER_DEGREE 111320.0
+#define DEGREES_TO_RADIANS (M_PI / 180.0)
+#define MPS_TO_KNOTS 1.943844
+#define MPS_TO_KMH 3.6
+/* First order Gauss-Markov position error, about 1.5 m with a 60 s correlation time */
+#define NOISE_SIGMA_M 1.5
+#define NOISE_TAU_S 60.0
+#define SATELLITES_IN_VIEW 12
+#define LOAD_LINE_SIZE 128
+#define SECONDS_PER_DAY 86400U
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sTrackState {
+    uint32_t seed;
+    double latitude;
+    double longitude;
+    double altitude;
+    double speed;
+    double heading;
+    double target_speed;
+    double target_heading;
+    uint32_t phase_left_s;
+    double noise_north;
+    double noise_east;
+} sTrackState_t;
+
+typedef struct sTrackLeg {
+    eTrackProfile_t profile;
+    uint32_t duration_s;
+} sTrackLeg_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const char *g_profile_name[eTrackProfile_Last] = {
+    [eTrackProfile_Parked] = "parked",
+    [eTrackProfile_City] = "city",
+    [eTrackProfile_Highway] = "highway",
+    [eTrackProfile_Mixed] = "mixed"
+};
+
+static const sTrackLeg_t g_mixed_legs[] = {
+    {.profile = eTrackProfile_Parked, .duration_s = 600},
+    {.profile = eTrackProfile_City, .duration_s = 1200},
+    {.profile = eTrackProfile_Highway, .duration_s = 3600},
+    {.profile = eTrackProfile_City, .duration_s = 900},
+    {.profile = eTrackProfile_Parked, .duration_s = 1800}
+};
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static double Track_Random (sTrackState_t *state);
+static double Track_Gaussian (sTrackState_t *state);
+static void Track_Steer (sTrackState_t *state, eTrackProfile_t profile);
+static void Track_Step (sTrackState_t *state, eTrackProfile_t profile);
+static void Track_Sample (sTrackState_t *state, uint32_t timestamp, sTrackFix_t *point);
+static eTrackProfile_t Track_GetLeg (eTrackProfile_t profile, uint32_t elapsed_s);
+static size_t Track_FormatSentence (char *buffer, size_t size, const char *body);
+static void Track_FormatCoordinate (char *buffer, size_t size, int32_t value, bool is_latitude);
+static uint32_t Track_DaysFromCivil (int32_t year, uint32_t month, uint32_t day);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* xorshift32, the C library generator differs between hosts */
+static double Track_Random (sTrackState_t *state) {
+    state->seed ^= state->seed << 13;
+    state->seed ^= state->seed >> 17;
+    state->seed ^= state->seed << 5;
+
+    return (double) state->seed / 4294967296.0;
+}
+
+static double Track_Gaussian (sTrackState_t *state) {
+    double sum = 0.0;
+
+    for (int i = 0; i < 12; i++) {
+        sum += Track_Random(state);
+    }
+
+    return sum - 6.0;
+}
+
+/* Picks the next speed and heading to go for once the current phase runs out */
+static void Track_Steer (sTrackState_t *state, eTrackProfile_t profile) {
+    if (state->phase_left_s > 0) {
+        state->phase_left_s--;
+        return;
+    }
+
+    switch (profile) {
+        case eTrackProfile_City: {
+            /* Stop at a light, or drive a block and maybe turn at the next crossing */
+            if ((state->target_speed > 0.0) && (Track_Random(state) < 0.3)) {
+                state->target_speed = 0.0;
+                state->phase_left_s = 10 + (uint32_t) (Track_Random(state) * 40.0);
+            } else {
+                state->target_speed = 8.0 + (Track_Random(state) * 6.0);
+                state->phase_left_s = 20 + (uint32_t) (Track_Random(state) * 70.0);
+
+                double turn = Track_Random(state);
+                if (turn < 0.25) {
+                    state->target_heading -= 90.0;
+                } else if (turn < 0.5) {
+                    state->target_heading += 90.0;
+                }
+            }
+            break;
+        }
+        case eTrackProfile_Highway: {
+            state->target_speed = 25.0 + (Track_Random(state) * 8.0);
+            state->target_heading += (Track_Random(state) - 0.5) * 20.0;
+            state->phase_left_s = 60 + (uint32_t) (Track_Random(state) * 240.0);
+            break;
+        }
+        default: {
+            state->target_speed = 0.0;
+            state->phase_left_s = 60;
+            break;
+        }
+    }
+
+    state->target_heading = fmod(state->target_heading + 360.0, 360.0);
+}
+
+/* One second of driving: accelerate or brake at about 2 m/s2, turn at up to 15 deg/s while moving */
+static void Track_Step (sTrackState_t *state, eTrackProfile_t profile) {
+    Track_Steer(state, profile);
+
+    double speed_error = state->target_speed - state->speed;
+    state->speed += (speed_error > 2.0) ? 2.0 : ((speed_error < -2.5) ? -2.5 : speed_error);
+
+    if (state->speed > 0.5) {
+        double heading_error = fmod(state->target_heading - state->heading + 540.0, 360.0) - 180.0;
+        double max_turn = (profile == eTrackProfile_Highway) ? 1.0 : 15.0;
+
+        state->heading += (heading_error > max_turn) ? max_turn : ((heading_error < -max_turn) ? -max_turn : heading_error);
+        state->heading = fmod(state->heading + 360.0, 360.0);
+    }
+
+    double north = state->speed * cos(state->heading * DEGREES_TO_RADIANS);
+    double east = state->speed * sin(state->heading * DEGREES_TO_RADIANS);
+
+    state->latitude += north / METERS_PER_DEGREE;
+    state->longitude += east / (METERS_PER_DEGREE * cos(state->latitude * DEGREES_TO_RADIANS));
+    state->altitude += (Track_Random(state) - 0.5) * 0.2 * state->speed / 10.0;
+
+    double decay = exp(-1.0 / NOISE_TAU_S);
+    double drive = NOISE_SIGMA_M * sqrt(1.0 - (decay * decay));
+
+    state->noise_north = (state->noise_north * decay) + (drive * Track_Gaussian(state));
+    state->noise_east = (state->noise_east * decay) + (drive * Track_Gaussian(state));
+}
+
+static void Track_Sample (sTrackState_t *state, uint32_t timestamp, sTrackFix_t *point) {
+    double latitude = state->latitude + (state->noise_north / METERS_PER_DEGREE);
+    double longitude = state->longitude + (state->noise_east / (METERS_PER_DEGREE * cos(state->latitude * DEGREES_TO_RADIANS)));
+    double speed = state->speed + ((state->speed > 0.0) ? (Track_Gaussian(state) * 0.1) : 0.0);
+
+    point->timestamp = timestamp;
+    point->latitude = (int32_t) lround(latitude * 1e7);
+    point->longitude = (int32_t) lround(longitude * 1e7);
+    point->altitude = (int32_t) lround(state->altitude * 100.0);
+    point->speed = (uint16_t) lround(((speed < 0.0) ? 0.0 : speed) * 100.0);
+    point->course = (uint16_t) (lround(state->heading * 100.0) % 36000);
+    point->satellites = (uint8_t) (8 + (uint32_t) (Track_Random(state) * 4.0));
+    point->hdop = (uint16_t) (80 + (uint32_t) (Track_Random(state) * 40.0));
+}
+
+static eTrackProfile_t Track_GetLeg (eTrackProfile_t profile, uint32_t elapsed_s) {
+    if (profile != eTrackProfile_Mixed) {
+        return profile;
+    }
+
+    uint32_t cycle_s = 0;
+
+    for (size_t i = 0; i < (sizeof(g_mixed_legs) / sizeof(g_mixed_legs[0])); i++) {
+        cycle_s += g_mixed_legs[i].duration_s;
+    }
+
+    elapsed_s %= cycle_s;
+
+    for (size_t i = 0; i < (sizeof(g_mixed_legs) / sizeof(g_mixed_legs[0])); i++) {
+        if (elapsed_s < g_mixed_legs[i].duration_s) {
+            return g_mixed_legs[i].profile;
+        }
+
+        elapsed_s -= g_mixed_legs[i].duration_s;
+    }
+
+    return eTrackProfile_Parked;
+}
+
+/* "$" body "*" checksum CRLF */
+static size_t Track_FormatSentence (char *buffer, size_t size, const char *body) {
+    uint8_t checksum = 0;
+
+    for (const char *c = body; *c != '\0'; c++) {
+        checksum ^= (uint8_t) *c;
+    }
+
+    int length = snprintf(buffer, size, "$%s*%02X\r\n", body, checksum);
+
+    return ((length < 0) || ((size_t) length >= size)) ? 0 : (size_t) length;
+}
+
+/* 1e-7 degrees to "ddmm.mmmmm,N" or "dddmm.mmmmm,E" */
+static void Track_FormatCoordinate (char *buffer, size_t size, int32_t value, bool is_latitude) {
+    char hemisphere = is_latitude ? ((value < 0) ? 'S' : 'N') : ((value < 0) ? 'W' : 'E');
+    int64_t magnitude = (value < 0) ? -(int64_t) value : value;
+    int64_t degrees = magnitude / 10000000;
+    int64_t minutes_e5 = ((magnitude % 10000000) * 6 + 5) / 10;
+
+    if (minutes_e5 >= 6000000) {
+        degrees++;
+        minutes_e5 -= 6000000;
+    }
+
+    snprintf(buffer, size, is_latitude ? "%02lld%02lld.%05lld,%c" : "%03lld%02lld.%05lld,%c", (long long) degrees,
+             (long long) (minutes_e5 / 100000), (long long) (minutes_e5 % 100000), hemisphere);
+}
+
+static uint32_t Track_DaysFromCivil (int32_t year, uint32_t month, uint32_t day) {
+    year -= (month <= 2) ? 1 : 0;
+
+    int32_t era = year / 400;
+    uint32_t year_of_era = (uint32_t) (year - (era * 400));
+    uint32_t day_of_year = ((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5 + day - 1;
+    uint32_t day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+
+    return (uint32_t) ((era * 146097) + (int32_t) day_of_era - 719468);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+size_t Track_Generate (eTrackProfile_t profile, uint32_t period_s, uint32_t duration_s, uint32_t seed,
+                       sTrackFix_t *points, size_t max_points) {
+    if ((profile >= eTrackProfile_Last) || (period_s == 0) || (points == NULL)) {
+        return 0;
+    }
+
+    sTrackState_t state = {
+        .seed = (seed == 0) ? 1 : seed,
+        .latitude = START_LATITUDE,
+        .longitude = START_LONGITUDE,
+        .altitude = START_ALTITUDE_M
+    };
+    size_t count = 0;
+
+    for (uint32_t second = 0; (second < duration_s) && (count < max_points); second++) {
+        Track_Step(&state, Track_GetLeg(profile, second));
+
+        if ((second % period_s) == 0) {
+            Track_Sample(&state, START_TIME + second, &points[count++]);
+        }
+    }
+
+    return count;
+}
+
+size_t Track_LoadNmea (const char *path, sTrackFix_t *points, size_t max_points) {
+    FILE *file = fopen(path, "rb");
+
+    if ((file == NULL) || (points == NULL)) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        return 0;
+    }
+
+    static sNmeaParser_t parser;
+    char line[LOAD_LINE_SIZE];
+    size_t count = 0;
+
+    NmeaParser_Init(&parser);
+
+    /* Line by line, so every RMC is seen on its own */
+    while ((fgets(line, sizeof(line), file) != NULL) && (count < max_points)) {
+        if ((NmeaParser_Feed(&parser, line, strlen(line)) & (1U << eNmeaSentence_RMC)) == 0) {
+            continue;
+        }
+
+        sNmeaFix_t fix;
+
+        if ((NmeaParser_GetFix(&parser, &fix) == false) || (fix.is_valid == false)) {
+            continue;
+        }
+
+        /* ddmmyy and the time of day */
+        uint32_t days = Track_DaysFromCivil(2000 + (int32_t) (fix.date % 100), (fix.date / 100) % 100, fix.date / 10000);
+        sTrackFix_t *point = &points[count++];
+
+        point->timestamp = (days * SECONDS_PER_DAY) + (fix.time_ms / 1000);
+        point->latitude = fix.latitude;
+        point->longitude = fix.longitude;
+        point->altitude = fix.altitude;
+        point->speed = fix.speed;
+        point->course = fix.course;
+        point->satellites = fix.satellites_used;
+        point->hdop = fix.hdop;
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+size_t Track_FormatNmea (const sTrackFix_t *point, char *buffer, size_t size) {
+    static const uint8_t svs[SATELLITES_IN_VIEW] = {2, 5, 7, 9, 13, 15, 18, 20, 23, 26, 29, 30};
+    char body[NMEA_MAX_SENTENCE_SIZE];
+    char latitude[16];
+    char longitude[16];
+    char time[16];
+    char date[8];
+    size_t length = 0;
+    size_t written = 0;
+
+    uint32_t seconds = point->timestamp % SECONDS_PER_DAY;
+    uint32_t days = point->timestamp / SECONDS_PER_DAY;
+
+    /* civil_from_days */
+    uint32_t z = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t day_of_era = z - (era * 146097);
+    uint32_t year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+    uint32_t day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+    uint32_t mp = ((5 * day_of_year) + 2) / 153;
+    uint32_t day = day_of_year - (((153 * mp) + 2) / 5) + 1;
+    uint32_t month = (mp < 10) ? (mp + 3) : (mp - 9);
+    uint32_t year = year_of_era + (era * 400) + ((month <= 2) ? 1 : 0);
+
+    snprintf(time, sizeof(time), "%02u%02u%02u.000", seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    snprintf(date, sizeof(date), "%02u%02u%02u", day % 100, month % 100, year % 100);
+    Track_FormatCoordinate(latitude, sizeof(latitude), point->latitude, true);
+    Track_FormatCoordinate(longitude, sizeof(longitude), point->longitude, false);
+
+    double speed = point->speed / 100.0;
+    double course = point->course / 100.0;
+    double altitude = point->altitude / 100.0;
+    double hdop = point->hdop / 100.0;
+
+    snprintf(body, sizeof(body), "GPGGA,%s,%s,%s,1,%02u,%.2f,%.2f,M,29.00,M,,", time, latitude, longitude,
+             point->satellites, hdop, altitude);
+    length = Track_FormatSentence(&buffer[written], size - written, body);
+    written += length;
+
+    snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%s,%.3f,%.2f,%s,,,A", time, latitude, longitude, speed * MPS_TO_KNOTS,
+             course, date);
+    length = (length == 0) ? 0 : Track_FormatSentence(&buffer[written], size - written, body);
+    written += length;
+
+    int used = snprintf(body, sizeof(body), "GPGSA,A,3");
+    for (size_t i = 0; i < 12; i++) {
+        if (i < point->satellites) {
+            used += snprintf(&body[used], sizeof(body) - used, ",%02u", svs[i]);
+        } else {
+            used += snprintf(&body[used], sizeof(body) - used, ",");
+        }
+    }
+    snprintf(&body[used], sizeof(body) - used, ",%.2f,%.2f,%.2f", hdop * 1.4, hdop, hdop * 1.1);
+    length = (length == 0) ? 0 : Track_FormatSentence(&buffer[written], size - written, body);
+    written += length;
+
+    for (uint32_t message = 0; message < (SATELLITES_IN_VIEW / 4); message++) {
+        used = snprintf(body, sizeof(body), "GPGSV,%u,%u,%02u", SATELLITES_IN_VIEW / 4, message + 1, SATELLITES_IN_VIEW);
+
+        for (uint32_t i = message * 4; i < ((message + 1) * 4); i++) {
+            used += snprintf(&body[used], sizeof(body) - used, ",%02u,%02u,%03u,%02u", svs[i], 10 + ((i * 7) % 80),
+                             (i * 29) % 360, 25 + ((point->timestamp + i) % 24));
+        }
+
+        length = (length == 0) ? 0 : Track_FormatSentence(&buffer[written], size - written, body);
+        written += length;
+    }
+
+    snprintf(body, sizeof(body), "GPVTG,%.2f,T,,M,%.3f,N,%.3f,K,A", course, speed * MPS_TO_KNOTS, speed * MPS_TO_KMH);
+    length = (length == 0) ? 0 : Track_FormatSentence(&buffer[written], size - written, body);
+    written += length;
+
+    return (length == 0) ? 0 : written;
+}
+
+const char *Track_GetProfileName (eTrackProfile_t profile) {
+    return (profile < eTrackProfile_Last) ? g_profile_name[profile] : "file";
+}
@@ -0,0 +1,45 @@
+#ifndef TESTS_HOST_TRACK_H_
+#define TESTS_HOST_TRACK_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+typedef enum eTrackProfile {
+    eTrackProfile_First = 0,
+    eTrackProfile_Parked = eTrackProfile_First,
+    eTrackProfile_City,
+    eTrackProfile_Highway,
+    /* Parked, city, highway, city and parked again, repeated for the duration */
+    eTrackProfile_Mixed,
+    eTrackProfile_Last
+} eTrackProfile_t;
+
+/* Units of the NMEA parser: coordinates 1e-7 deg, altitude cm, speed 0.01 m/s, course 0.01 deg, HDOP 0.01 */
+typedef struct sTrackFix {
+    uint32_t timestamp;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    uint16_t speed;
+    uint16_t course;
+    uint8_t satellites;
+    uint16_t hdop;
+} sTrackFix_t;
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+/* A drive as a receiver reports it, with correlated position noise of about 1.5 m. The same seed gives the same
+ * track on every host. Returns the number of points. */
+size_t Track_Generate (eTrackProfile_t profile, uint32_t period_s, uint32_t duration_s, uint32_t seed,
+                       sTrackFix_t *points, size_t max_points);
+/* A recorded NMEA log, one point per valid RMC, through the firmware parser. Returns 0 if the file cannot be read. */
+size_t Track_LoadNmea (const char *path, sTrackFix_t *points, size_t max_points);
+/* The GGA, RMC, GSA, three GSV and VTG sentences of one receiver epoch */
+size_t Track_FormatNmea (const sTrackFix_t *point, char *buffer, size_t size);
+const char *Track_GetProfileName (eTrackProfile_t profile);
+#endif /* TESTS_HOST_TRACK_H_ */
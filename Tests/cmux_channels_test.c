@@ -0,0 +1,147 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "gnss_api.h"
+#include "tcp_api.h"
+#include "tcp_app.h"
+#include "host.h"
+#include "host_board.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define STREAM_SOCKET 3
+/* The server refuses streams on this socket */
+#define REFUSED_SOCKET 4
+#define REFUSED_ERROR 566
+#define STREAM_PAYLOAD "GET /fences.bin HTTP/1.1\r\n\r\n"
+#define SEND_PAYLOAD "hello"
+#define FIX_LOCATION "081122.000,54.6891600,25.2798000,1.2,120.0,3,90.00,36.0,19.4,190226,08"
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define POLL_MS 50
+/* A refused stream must not sit out the 30 s connect timeout */
+#define REFUSED_TIMEOUT_MS 1000
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Test_Main (void *argument);
+static int Test_Open (int connect_id, uint32_t attempt);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static int Test_Open (int connect_id, uint32_t attempt) {
+    return (connect_id == REFUSED_SOCKET) ? REFUSED_ERROR : 0;
+}
+
+/* A transparent stream on the data channel leaves GNSS polls and socket sends running on the others */
+static void Test_Main (void *argument) {
+    sModemSimConfig_t config = {
+        .is_cmux_supported = true,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+        .open_handler = &Test_Open,
+    };
+
+    Modem_Sim_Init(&config);
+    Modem_Sim_SetFix(true, FIX_LOCATION);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(GNSS_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    HOST_CHECK(Modem_API_IsMultiplexed() == true);
+    HOST_CHECK(GNSS_API_Start() == eModemError_ATSuccess);
+
+    start = osKernelGetTickCount();
+    HOST_CHECK(TCP_API_OpenStream(REFUSED_SOCKET, SERVER_ADDRESS, SERVER_PORT) == eModemError_InvalidResponse);
+    HOST_CHECK((osKernelGetTickCount() - start) < REFUSED_TIMEOUT_MS);
+    HOST_CHECK(TCP_API_IsStreaming() == false);
+
+    HOST_CHECK(TCP_API_OpenStream(STREAM_SOCKET, SERVER_ADDRESS, SERVER_PORT) == eModemError_ATSuccess);
+    HOST_CHECK(TCP_API_StreamWrite(STREAM_PAYLOAD, sizeof(STREAM_PAYLOAD) - 1) == eModemError_ATSuccess);
+    HOST_CHECK(Host_Board_GetStats()->power_lock_depth > 0);
+
+    /* The AT channel is free while the stream runs */
+    sNmeaFix_t fix = {0};
+    HOST_CHECK(GNSS_API_PollLocation() == eModemError_ATSuccess);
+    HOST_CHECK(GNSS_API_GetFix(&fix) && (fix.is_valid == true) && (fix.latitude == 546891600));
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+    tcp_job.data.connect.connect_id = eServerId_First;
+    tcp_job.data.connect.service = eSocketService_Tcp;
+    tcp_job.data.connect.port = SERVER_PORT;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", SERVER_ADDRESS);
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+
+    start = osKernelGetTickCount();
+
+    while ((TCP_APP_GetSocketState(eServerId_First) != eSocketState_Connected) &&
+           ((osKernelGetTickCount() - start) < CONNECT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    HOST_CHECK(TCP_APP_GetSocketState(eServerId_First) == eSocketState_Connected);
+
+    char *payload = TCP_APP_AllocPayload(sizeof(SEND_PAYLOAD) - 1);
+    HOST_CHECK(payload != NULL);
+    memcpy(payload, SEND_PAYLOAD, sizeof(SEND_PAYLOAD) - 1);
+    tcp_job = (sTcpJobMessage_t) {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = eServerId_First;
+    tcp_job.data.send.data_str = payload;
+    tcp_job.data.send.data_size = sizeof(SEND_PAYLOAD) - 1;
+    tcp_job.data.send.urgent = true;
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+    osDelay(CONNECT_TIMEOUT_MS);
+
+    HOST_CHECK(TCP_API_IsStreaming() == true);
+    /* DTR is not seen through the multiplexer, the stream has to leave by escape sequence anyway */
+    HOST_CHECK(TCP_API_CloseStream(eStreamExit_Dtr) == eModemError_ATSuccess);
+    HOST_CHECK(TCP_API_IsStreaming() == false);
+    /* The modem holds its bytes on RTS, neither the multiplexer nor the connected socket keep the core out of Stop */
+    HOST_CHECK(TCP_APP_GetSocketState(eServerId_First) == eSocketState_Connected);
+    HOST_CHECK(Modem_Sim_GetStats()->is_flow_control == true);
+    HOST_CHECK(Host_Board_GetStats()->power_lock_depth == 0);
+
+    const sModemSimStats_t *stats = Modem_Sim_GetStats();
+    const sModemSimSocket_t *stream_server = Modem_Sim_GetSocket(STREAM_SOCKET);
+    const sModemSimSocket_t *send_server = Modem_Sim_GetSocket(eServerId_First);
+
+    HOST_CHECK((stream_server->server_rx_count == (sizeof(STREAM_PAYLOAD) - 1)) &&
+               (memcmp(stream_server->server_rx, STREAM_PAYLOAD, sizeof(STREAM_PAYLOAD) - 1) == 0));
+    HOST_CHECK((send_server->server_rx_count == (sizeof(SEND_PAYLOAD) - 1)) &&
+               (memcmp(send_server->server_rx, SEND_PAYLOAD, sizeof(SEND_PAYLOAD) - 1) == 0));
+    HOST_CHECK(stats->escapes == 1);
+    HOST_CHECK(Host_Board_GetStats()->dtr_pulses == 0);
+    HOST_CHECK(stats->gnss_commands_on_at_channel == 0);
+    HOST_CHECK(stats->gnss_commands_on_gnss_channel == 2);
+
+    printf("cmux channels: %u GNSS command(s) on the GNSS channel, %u on the AT channel, %d failure(s)\n",
+           stats->gnss_commands_on_gnss_channel, stats->gnss_commands_on_at_channel, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    return Host_Run(&Test_Main, NULL);
+}
@@ -0,0 +1,143 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "cmsis_os2.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "tcp_app.h"
+#include "host.h"
+#include "host_board.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define POLL_MS 50
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sScenario {
+    const char *name;
+    bool is_cmux_supported;
+    bool is_cmux_broken;
+    bool is_flow_control_refused;
+} sScenario_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+/* A modem without the multiplexer, one that takes AT+CMUX but never opens a channel, and one without either of them
+ * or the flow control */
+static const sScenario_t g_scenarios[] = {
+    {.name = "cmux refused", .is_cmux_supported = false, .is_cmux_broken = false},
+    {.name = "cmux channels dead", .is_cmux_supported = true, .is_cmux_broken = true},
+    {.name = "flow control refused", .is_cmux_supported = false, .is_flow_control_refused = true}
+};
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Test_Main (void *argument);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static void Test_Main (void *argument) {
+    const sScenario_t *scenario = (const sScenario_t *) argument;
+    sModemSimConfig_t config = {
+        .is_cmux_supported = scenario->is_cmux_supported,
+        .is_cmux_broken = scenario->is_cmux_broken,
+        .is_flow_control_refused = scenario->is_flow_control_refused,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+    };
+
+    Modem_Sim_Init(&config);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    /* The modem comes up once and stays on AT commands */
+    HOST_CHECK(Modem_Sim_GetStats()->boots == 1);
+    HOST_CHECK(Modem_API_IsMultiplexed() == false);
+    HOST_CHECK(Modem_Sim_IsMultiplexed() == false);
+    /* Only a modem that would send while RTS is up keeps the core out of Stop */
+    HOST_CHECK(Host_Board_GetStats()->power_lock_depth == ((scenario->is_flow_control_refused == true) ? 1 : 0));
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+    tcp_job.data.connect.connect_id = eServerId_First;
+    tcp_job.data.connect.service = eSocketService_Tcp;
+    tcp_job.data.connect.port = SERVER_PORT;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", SERVER_ADDRESS);
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+
+    start = osKernelGetTickCount();
+
+    while ((TCP_APP_GetSocketState(eServerId_First) != eSocketState_Connected) &&
+           ((osKernelGetTickCount() - start) < CONNECT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    HOST_CHECK(TCP_APP_GetSocketState(eServerId_First) == eSocketState_Connected);
+
+    char *payload = TCP_APP_AllocPayload(5);
+    HOST_CHECK(payload != NULL);
+    memcpy(payload, "hello", 5);
+    tcp_job = (sTcpJobMessage_t) {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = eServerId_First;
+    tcp_job.data.send.data_str = payload;
+    tcp_job.data.send.data_size = 5;
+    tcp_job.data.send.urgent = true;
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+    osDelay(CONNECT_TIMEOUT_MS);
+
+    const sModemSimSocket_t *server = Modem_Sim_GetSocket(eServerId_First);
+    HOST_CHECK((server->server_rx_count == 5) && (memcmp(server->server_rx, "hello", 5) == 0));
+    HOST_CHECK(Modem_Sim_GetStats()->boots == 1);
+
+    printf("%s: %u boot(s), %u modem commands, %d failure(s)\n", scenario->name, Modem_Sim_GetStats()->boots,
+           Modem_Sim_GetStats()->commands, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* Every scenario gets a process of its own, the virtual RTOS and the modem stand-in only start once */
+int main (void) {
+    int failed = 0;
+
+    for (size_t i = 0; i < (sizeof(g_scenarios) / sizeof(g_scenarios[0])); i++) {
+        fflush(stdout);
+        pid_t child = fork();
+
+        if (child == 0) {
+            return Host_Run(&Test_Main, (void *) &g_scenarios[i]);
+        }
+
+        int status = 0;
+
+        if ((child < 0) || (waitpid(child, &status, 0) != child) || (WIFEXITED(status) == false) ||
+            (WEXITSTATUS(status) != 0)) {
+            fprintf(stderr, "%s: failed\n", g_scenarios[i].name);
+            failed++;
+        }
+    }
+
+    return (failed == 0) ? 0 : 1;
+}
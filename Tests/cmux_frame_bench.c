@@ -0,0 +1,120 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmux_frame.h"
+#include "host.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define FRAME_COUNT 20000
+#define STREAM_SIZE (FRAME_COUNT * CMUX_FRAME_MAX_SIZE)
+#define ROUNDS 20
+/* The modem UART at 115200 baud, 8N1 */
+#define UART_BYTES_PER_SECOND 11520
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static uint8_t g_stream[STREAM_SIZE];
+static uint8_t g_payload[CMUX_FRAME_MAX_INFO_SIZE];
+static sCmuxDeframer_t g_deframer;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static size_t Bench_Encode (size_t info_size);
+static uint32_t Bench_Decode (size_t stream_size, size_t info_size);
+static void Bench_Report (const char *name, size_t info_size, size_t bytes, uint64_t ns, uint64_t cycles);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static size_t Bench_Encode (size_t info_size) {
+    size_t stream_size = 0;
+
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        sCmuxFrame_t frame = {.dlci = 1 + (i % 3), .control = CMUX_FRAME_UIH, .is_command = true, .poll_final = false,
+                              .info = g_payload, .info_size = info_size};
+
+        stream_size += CmuxFrame_Encode(&frame, &g_stream[stream_size], STREAM_SIZE - stream_size);
+    }
+
+    return stream_size;
+}
+
+/* Byte by byte, the way the UART receive path feeds it */
+static uint32_t Bench_Decode (size_t stream_size, size_t info_size) {
+    uint32_t frames = 0;
+    sCmuxFrame_t frame;
+
+    CmuxFrame_ResetDeframer(&g_deframer);
+
+    for (size_t i = 0; i < stream_size; i++) {
+        if (CmuxFrame_Decode(&g_deframer, g_stream[i], &frame) == false) {
+            continue;
+        }
+
+        if ((frame.info_size == info_size) && (memcmp(frame.info, g_payload, info_size) == 0)) {
+            frames++;
+        }
+    }
+
+    return frames;
+}
+
+static void Bench_Report (const char *name, size_t info_size, size_t bytes, uint64_t ns, uint64_t cycles) {
+    double seconds = (double) ns / 1e9;
+
+    printf("%-6s %3zu B info: %8.1f MB/s, %6.2f ns/B, %6.2f host cycles/B, %7.0fx the UART\n", name, info_size,
+           ((double) bytes / seconds) / 1e6, (double) ns / (double) bytes, (double) cycles / (double) bytes,
+           ((double) bytes / seconds) / UART_BYTES_PER_SECOND);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    static const size_t info_sizes[] = {1, 16, 64, CMUX_FRAME_MAX_INFO_SIZE};
+    int failures = 0;
+
+    for (size_t i = 0; i < CMUX_FRAME_MAX_INFO_SIZE; i++) {
+        g_payload[i] = (uint8_t) ((i * 37U) + 11U);
+    }
+
+    /* The flag byte in the payload too, basic option framing does not escape it */
+    g_payload[0] = CMUX_FRAME_FLAG;
+
+    for (size_t s = 0; s < (sizeof(info_sizes) / sizeof(info_sizes[0])); s++) {
+        size_t info_size = info_sizes[s];
+        size_t stream_size = 0;
+        uint32_t frames = 0;
+
+        uint64_t start_ns = Host_ReadNanoseconds();
+        uint64_t start_cycles = Host_ReadCycles();
+
+        for (int round = 0; round < ROUNDS; round++) {
+            stream_size = Bench_Encode(info_size);
+        }
+
+        Bench_Report("encode", info_size, stream_size * ROUNDS, Host_ReadNanoseconds() - start_ns,
+                     Host_ReadCycles() - start_cycles);
+
+        start_ns = Host_ReadNanoseconds();
+        start_cycles = Host_ReadCycles();
+
+        for (int round = 0; round < ROUNDS; round++) {
+            frames = Bench_Decode(stream_size, info_size);
+        }
+
+        Bench_Report("decode", info_size, stream_size * ROUNDS, Host_ReadNanoseconds() - start_ns,
+                     Host_ReadCycles() - start_cycles);
+
+        if ((frames != FRAME_COUNT) || (g_deframer.fcs_errors != 0)) {
+            fprintf(stderr, "%zu B info: %u of %u frames decoded, %u FCS errors\n", info_size, frames, FRAME_COUNT,
+                    g_deframer.fcs_errors);
+            failures++;
+        }
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "geodesy.h"
+#include "host.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define INPUT_COUNT 4096U
+#define INPUT_MASK (INPUT_COUNT - 1U)
+#define CALLS 4000000U
+/* Hops between fixes a second apart up to the span of one report period */
+#define HOP_RANGE_DEGREES_E7 100000
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eBenchFunction {
+    eBenchFunction_First = 0,
+    eBenchFunction_Sin = eBenchFunction_First,
+    eBenchFunction_Cos,
+    eBenchFunction_Atan2,
+    eBenchFunction_Sqrt,
+    eBenchFunction_Haversine,
+    eBenchFunction_Equirectangular,
+    eBenchFunction_Bearing,
+    eBenchFunction_Speed,
+    eBenchFunction_ToEnu,
+    eBenchFunction_Last
+} eBenchFunction_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const char *g_function_names[eBenchFunction_Last] = {
+    [eBenchFunction_Sin] = "Geodesy_Sin",
+    [eBenchFunction_Cos] = "Geodesy_Cos",
+    [eBenchFunction_Atan2] = "Geodesy_Atan2",
+    [eBenchFunction_Sqrt] = "Geodesy_Sqrt",
+    [eBenchFunction_Haversine] = "Geodesy_HaversineDistance",
+    [eBenchFunction_Equirectangular] = "Geodesy_Equirectangular",
+    [eBenchFunction_Bearing] = "Geodesy_Bearing",
+    [eBenchFunction_Speed] = "Geodesy_Speed",
+    [eBenchFunction_ToEnu] = "Geodesy_ToEnu"
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static uint32_t g_seed = 0x5EED;
+static uint32_t g_values[INPUT_COUNT];
+static sGeodesyPoint_t g_from[INPUT_COUNT];
+static sGeodesyPoint_t g_to[INPUT_COUNT];
+static sGeodesyReference_t g_reference;
+/* Keeps the calls from being optimised out */
+static volatile uint64_t g_sink;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static uint32_t Bench_Random (void);
+static void Bench_Prepare (void);
+static uint64_t Bench_Call (eBenchFunction_t function, uint32_t index);
+static void Bench_Run (eBenchFunction_t function);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static uint32_t Bench_Random (void) {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+
+    return g_seed;
+}
+
+static void Bench_Prepare (void) {
+    for (uint32_t i = 0; i < INPUT_COUNT; i++) {
+        g_values[i] = Bench_Random();
+        g_from[i] = (sGeodesyPoint_t) {.latitude = (int32_t) (Bench_Random() % 1700000001U) - 850000000,
+                                       .longitude = (int32_t) (Bench_Random() % 3600000000U) - 1800000000};
+        g_to[i] = (sGeodesyPoint_t) {
+            .latitude = g_from[i].latitude + (int32_t) (Bench_Random() % (2U * HOP_RANGE_DEGREES_E7)) - HOP_RANGE_DEGREES_E7,
+            .longitude = g_from[i].longitude + (int32_t) (Bench_Random() % (2U * HOP_RANGE_DEGREES_E7)) - HOP_RANGE_DEGREES_E7
+        };
+    }
+
+    Geodesy_SetReference(&g_reference, &g_from[0], 0);
+}
+
+static uint64_t Bench_Call (eBenchFunction_t function, uint32_t index) {
+    const sGeodesyPoint_t *from = &g_from[index];
+    const sGeodesyPoint_t *to = &g_to[index];
+    uint32_t value = g_values[index];
+    sGeodesyEnu_t enu;
+
+    switch (function) {
+        case eBenchFunction_Sin: {
+            return (uint64_t) Geodesy_Sin(value);
+        }
+        case eBenchFunction_Cos: {
+            return (uint64_t) Geodesy_Cos(value);
+        }
+        case eBenchFunction_Atan2: {
+            return Geodesy_Atan2((int32_t) value, (int32_t) g_values[(index + 1) & INPUT_MASK]);
+        }
+        case eBenchFunction_Sqrt: {
+            return Geodesy_Sqrt(((uint64_t) value << 32) | g_values[(index + 1) & INPUT_MASK]);
+        }
+        case eBenchFunction_Haversine: {
+            return Geodesy_HaversineDistance(from, to);
+        }
+        case eBenchFunction_Equirectangular: {
+            return Geodesy_EquirectangularDistance(from, to);
+        }
+        case eBenchFunction_Bearing: {
+            return Geodesy_Bearing(from, to);
+        }
+        case eBenchFunction_Speed: {
+            return Geodesy_Speed(value >> 12, (value & 0xFFFU) + 1U);
+        }
+        case eBenchFunction_ToEnu: {
+            Geodesy_ToEnu(&g_reference, to, 0, &enu);
+            return (uint64_t) (uint32_t) (enu.east ^ enu.north);
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
+/* The call through the switch and the table load are in the figure too, a few cycles on top of each function */
+static void Bench_Run (eBenchFunction_t function) {
+    uint64_t sink = 0;
+
+    uint64_t start_ns = Host_ReadNanoseconds();
+    uint64_t start_cycles = Host_ReadCycles();
+
+    for (uint32_t i = 0; i < CALLS; i++) {
+        sink += Bench_Call(function, i & INPUT_MASK);
+    }
+
+    uint64_t ns = Host_ReadNanoseconds() - start_ns;
+    uint64_t cycles = Host_ReadCycles() - start_cycles;
+
+    g_sink = sink;
+
+    printf("%-26s %6.1f ns %6.1f host cycles/call\n", g_function_names[function], (double) ns / CALLS,
+           (double) cycles / CALLS);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    Bench_Prepare();
+
+    for (eBenchFunction_t function = eBenchFunction_First; function < eBenchFunction_Last; function++) {
+        Bench_Run(function);
+    }
+
+    return 0;
+}
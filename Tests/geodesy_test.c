@@ -0,0 +1,271 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "geodesy.h"
+#include "host.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SAMPLES 200000
+#define EARTH_RADIUS_CM 637100880.0
+#define TURN 4294967296.0
+#define DEGREES_TO_RADIANS (M_PI / 180.0)
+#define Q31_ONE 2147483648.0
+/* Bounds in the unit of each function, about twice the worst error measured on these samples */
+#define SINE_MAX_ERROR_LSB 8.0
+#define ATAN2_MAX_ERROR_UNITS 32.0
+#define HAVERSINE_ABSOLUTE_RANGE_CM 2e6
+#define HAVERSINE_MAX_ERROR_CM 10.0
+/* CORDIC rounding beyond about 100 km, tens of cm there */
+#define HAVERSINE_MAX_RELATIVE_ERROR 5e-6
+#define EQUIRECTANGULAR_RANGE_DEGREES_E7 5000000
+#define EQUIRECTANGULAR_MAX_RELATIVE_ERROR 1e-3
+#define BEARING_MIN_DISTANCE_CM 1000.0
+#define BEARING_MAX_ERROR_CENTIDEGREES 2.0
+#define ENU_RANGE_DEGREES_E7 500000
+#define ENU_MAX_ERROR_CM 4.0
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sErrorStats {
+    const char *name;
+    const char *unit;
+    double max_error;
+    double sum_error;
+    uint32_t samples;
+} sErrorStats_t;
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static uint32_t g_seed = 0x5EED;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static uint32_t Test_Random (void);
+static int32_t Test_RandomRange (int32_t low, int32_t high);
+static sGeodesyPoint_t Test_RandomPoint (void);
+static sGeodesyPoint_t Test_NearbyPoint (const sGeodesyPoint_t *from, int32_t range);
+static double Test_Haversine (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+static double Test_Bearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to);
+static void Test_Add (sErrorStats_t *stats, double error);
+static void Test_Report (const sErrorStats_t *stats, double bound);
+static void Test_Trigonometry (void);
+static void Test_Sqrt (void);
+static void Test_Distances (void);
+static void Test_Bearings (void);
+static void Test_Enu (void);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static uint32_t Test_Random (void) {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+
+    return g_seed;
+}
+
+static int32_t Test_RandomRange (int32_t low, int32_t high) {
+    return low + (int32_t) (Test_Random() % (uint32_t) (high - low + 1));
+}
+
+/* Up to 85 deg, the range a vehicle tracker sees */
+static sGeodesyPoint_t Test_RandomPoint (void) {
+    return (sGeodesyPoint_t) {.latitude = Test_RandomRange(-850000000, 850000000),
+                              .longitude = Test_RandomRange(-1800000000, 1799999999)};
+}
+
+static sGeodesyPoint_t Test_NearbyPoint (const sGeodesyPoint_t *from, int32_t range) {
+    sGeodesyPoint_t to = {.latitude = from->latitude + Test_RandomRange(-range, range),
+                          .longitude = from->longitude + Test_RandomRange(-range, range)};
+
+    to.latitude = (to.latitude > 900000000) ? 900000000 : ((to.latitude < -900000000) ? -900000000 : to.latitude);
+
+    return to;
+}
+
+static double Test_Haversine (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    double from_latitude = (from->latitude / 1e7) * DEGREES_TO_RADIANS;
+    double to_latitude = (to->latitude / 1e7) * DEGREES_TO_RADIANS;
+    double delta_latitude = to_latitude - from_latitude;
+    double delta_longitude = ((double) to->longitude - from->longitude) / 1e7 * DEGREES_TO_RADIANS;
+    double a = pow(sin(delta_latitude / 2.0), 2) + (cos(from_latitude) * cos(to_latitude) * pow(sin(delta_longitude / 2.0), 2));
+
+    return 2.0 * EARTH_RADIUS_CM * asin(sqrt((a > 1.0) ? 1.0 : a));
+}
+
+static double Test_Bearing (const sGeodesyPoint_t *from, const sGeodesyPoint_t *to) {
+    double from_latitude = (from->latitude / 1e7) * DEGREES_TO_RADIANS;
+    double to_latitude = (to->latitude / 1e7) * DEGREES_TO_RADIANS;
+    double delta_longitude = ((double) to->longitude - from->longitude) / 1e7 * DEGREES_TO_RADIANS;
+    double y = sin(delta_longitude) * cos(to_latitude);
+    double x = (cos(from_latitude) * sin(to_latitude)) - (sin(from_latitude) * cos(to_latitude) * cos(delta_longitude));
+
+    return fmod((atan2(y, x) / DEGREES_TO_RADIANS) + 360.0, 360.0) * 100.0;
+}
+
+static void Test_Add (sErrorStats_t *stats, double error) {
+    error = fabs(error);
+    stats->max_error = (error > stats->max_error) ? error : stats->max_error;
+    stats->sum_error += error;
+    stats->samples++;
+}
+
+static void Test_Report (const sErrorStats_t *stats, double bound) {
+    printf("%-26s max %10.3g mean %10.3g %-10s (bound %g) over %u samples\n", stats->name, stats->max_error,
+           stats->sum_error / stats->samples, stats->unit, bound, stats->samples);
+
+    if (stats->max_error > bound) {
+        Host_Check(false, stats->name, __FILE__, __LINE__);
+    }
+}
+
+static void Test_Trigonometry (void) {
+    sErrorStats_t sine = {.name = "Geodesy_Sin", .unit = "Q31 LSB"};
+    sErrorStats_t cosine = {.name = "Geodesy_Cos", .unit = "Q31 LSB"};
+    sErrorStats_t atan = {.name = "Geodesy_Atan2", .unit = "2^-32 turn"};
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint32_t angle = Test_Random();
+        double radians = (angle / TURN) * 2.0 * M_PI;
+
+        Test_Add(&sine, Geodesy_Sin(angle) - (sin(radians) * Q31_ONE));
+        Test_Add(&cosine, Geodesy_Cos(angle) - (cos(radians) * Q31_ONE));
+
+        int32_t y = (int32_t) Test_Random();
+        int32_t x = (int32_t) Test_Random();
+
+        if ((x == 0) && (y == 0)) {
+            continue;
+        }
+
+        double expected = fmod((atan2(y, x) / (2.0 * M_PI)) * TURN + TURN, TURN);
+        double error = fmod(((double) Geodesy_Atan2(y, x) - expected) + TURN + (TURN / 2.0), TURN) - (TURN / 2.0);
+
+        Test_Add(&atan, error);
+    }
+
+    Test_Report(&sine, SINE_MAX_ERROR_LSB);
+    Test_Report(&cosine, SINE_MAX_ERROR_LSB);
+    Test_Report(&atan, ATAN2_MAX_ERROR_UNITS);
+}
+
+/* Floor of the root, the same as the integer square root everywhere */
+static void Test_Sqrt (void) {
+    uint32_t wrong = 0;
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint64_t value = ((uint64_t) Test_Random() << 32) | Test_Random();
+
+        value >>= Test_Random() % 64;
+
+        uint64_t root = Geodesy_Sqrt(value);
+
+        if (((root * root) > value) || (((root + 1) * (root + 1)) <= value)) {
+            wrong++;
+        }
+    }
+
+    printf("%-26s %u of %u roots off\n", "Geodesy_Sqrt", wrong, SAMPLES);
+    HOST_CHECK(wrong == 0);
+}
+
+static void Test_Distances (void) {
+    sErrorStats_t haversine = {.name = "Geodesy_HaversineDistance", .unit = "cm"};
+    sErrorStats_t haversine_relative = {.name = "Geodesy_HaversineDistance", .unit = "relative"};
+    sErrorStats_t equirectangular = {.name = "Geodesy_Equirectangular", .unit = "relative"};
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        sGeodesyPoint_t from = Test_RandomPoint();
+        /* Every range from a metre to across the globe */
+        int32_t range = (int32_t) (100U << (Test_Random() % 24));
+        sGeodesyPoint_t to = Test_NearbyPoint(&from, (range > 900000000) ? 900000000 : range);
+        double expected = Test_Haversine(&from, &to);
+        double error = Geodesy_HaversineDistance(&from, &to) - expected;
+
+        /* Absolute below about 20 km, relative beyond */
+        if (expected < HAVERSINE_ABSOLUTE_RANGE_CM) {
+            Test_Add(&haversine, error);
+        } else {
+            Test_Add(&haversine_relative, error / expected);
+        }
+
+        to = Test_NearbyPoint(&from, EQUIRECTANGULAR_RANGE_DEGREES_E7);
+        expected = Test_Haversine(&from, &to);
+
+        if (expected > 100.0) {
+            Test_Add(&equirectangular, (Geodesy_EquirectangularDistance(&from, &to) - expected) / expected);
+        }
+    }
+
+    Test_Report(&haversine, HAVERSINE_MAX_ERROR_CM);
+    Test_Report(&haversine_relative, HAVERSINE_MAX_RELATIVE_ERROR);
+    Test_Report(&equirectangular, EQUIRECTANGULAR_MAX_RELATIVE_ERROR);
+}
+
+static void Test_Bearings (void) {
+    sErrorStats_t bearing = {.name = "Geodesy_Bearing", .unit = "0.01 deg"};
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        sGeodesyPoint_t from = Test_RandomPoint();
+        int32_t range = (int32_t) (1000U << (Test_Random() % 20));
+        sGeodesyPoint_t to = Test_NearbyPoint(&from, range);
+
+        if (Test_Haversine(&from, &to) < BEARING_MIN_DISTANCE_CM) {
+            continue;
+        }
+
+        double error = fmod((Geodesy_Bearing(&from, &to) - Test_Bearing(&from, &to)) + 54000.0, 36000.0) - 18000.0;
+
+        Test_Add(&bearing, error);
+    }
+
+    Test_Report(&bearing, BEARING_MAX_ERROR_CENTIDEGREES);
+}
+
+/* Against the same local plane in doubles, the plane itself is the caller's choice of model */
+static void Test_Enu (void) {
+    sErrorStats_t enu = {.name = "Geodesy_ToEnu", .unit = "cm"};
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        sGeodesyPoint_t origin = Test_RandomPoint();
+        sGeodesyPoint_t point = Test_NearbyPoint(&origin, ENU_RANGE_DEGREES_E7);
+        sGeodesyReference_t reference;
+        sGeodesyEnu_t result;
+        int32_t altitude = Test_RandomRange(-100000, 100000);
+
+        Geodesy_SetReference(&reference, &origin, 12000);
+        Geodesy_ToEnu(&reference, &point, altitude, &result);
+
+        double cm_per_degree_e7 = EARTH_RADIUS_CM * DEGREES_TO_RADIANS / 1e7;
+        double east = ((double) point.longitude - origin.longitude) * cos((origin.latitude / 1e7) * DEGREES_TO_RADIANS) * cm_per_degree_e7;
+        double north = ((double) point.latitude - origin.latitude) * cm_per_degree_e7;
+
+        Test_Add(&enu, hypot(result.east - east, result.north - north));
+        HOST_CHECK(result.up == (altitude - 12000));
+    }
+
+    Test_Report(&enu, ENU_MAX_ERROR_CM);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    Test_Trigonometry();
+    Test_Sqrt();
+    Test_Distances();
+    Test_Bearings();
+    Test_Enu();
+
+    HOST_CHECK(Geodesy_Speed(2778, 1000) == 2778);
+    HOST_CHECK(Geodesy_Speed(UINT32_MAX, 1) == UINT16_MAX);
+    HOST_CHECK(Geodesy_Speed(100, 0) == 0);
+
+    printf("geodesy: %d failure(s)\n", Host_GetFailures());
+
+    return (Host_GetFailures() == 0) ? 0 : 1;
+}
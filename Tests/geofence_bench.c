@@ -0,0 +1,263 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "geofence.h"
+#include "host.h"
+#include "track.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define FENCE_COUNT 1000U
+#define MIN_FENCE_VERTICES 4U
+#define MAX_FENCE_VERTICES 12U
+/* Depots and yards, 50 to 400 m across the middle */
+#define MIN_FENCE_RADIUS_M 25U
+#define MAX_FENCE_RADIUS_M 200U
+#define METERS_PER_DEGREE 111320.0
+#define DEGREES_TO_RADIANS (M_PI / 180.0)
+#define TRACK_HOURS 8U
+#define MAX_FIXES (TRACK_HOURS * 3600U)
+#define TRACK_SEED 0x5EEDU
+#define FENCE_SEED 0xF3ACEU
+#define ROUNDS 5
+#define IMAGE_SIZE (sizeof(sGeofenceSetHeader_t) + (FENCE_COUNT * sizeof(sGeofenceRecord_t)) + \
+                    (FENCE_COUNT * MAX_FENCE_VERTICES * sizeof(sGeodesyPoint_t)))
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sTrackFix_t g_track[MAX_FIXES];
+static uint32_t g_image[(IMAGE_SIZE + sizeof(uint32_t) - 1) / sizeof(uint32_t)];
+static sGeofence_t g_geofence;
+static bool g_is_inside[FENCE_COUNT];
+static uint32_t g_seed = FENCE_SEED;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static uint32_t Bench_Random (void);
+static size_t Bench_BuildFences (size_t fix_count);
+static bool Bench_Check (size_t fix_count);
+static double Bench_RunEngine (size_t fix_count, uint32_t *alerts);
+static double Bench_RunBruteForce (size_t fix_count);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static uint32_t Bench_Random (void) {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 17;
+    g_seed ^= g_seed << 5;
+
+    return g_seed;
+}
+
+/* Half of the fences are centred on the track so it runs through them, the rest are scattered over its area.
+ * Returns the image size. */
+static size_t Bench_BuildFences (size_t fix_count) {
+    sGeofenceSetHeader_t *header = (sGeofenceSetHeader_t *) g_image;
+    sGeofenceRecord_t *records = (sGeofenceRecord_t *) (header + 1);
+    sGeodesyPoint_t *vertices = (sGeodesyPoint_t *) (records + FENCE_COUNT);
+    sGeofenceBox_t area = {.min_latitude = INT32_MAX, .min_longitude = INT32_MAX, .max_latitude = INT32_MIN,
+                           .max_longitude = INT32_MIN};
+    uint32_t vertex_count = 0;
+
+    for (size_t i = 0; i < fix_count; i++) {
+        area.min_latitude = (g_track[i].latitude < area.min_latitude) ? g_track[i].latitude : area.min_latitude;
+        area.max_latitude = (g_track[i].latitude > area.max_latitude) ? g_track[i].latitude : area.max_latitude;
+        area.min_longitude = (g_track[i].longitude < area.min_longitude) ? g_track[i].longitude : area.min_longitude;
+        area.max_longitude = (g_track[i].longitude > area.max_longitude) ? g_track[i].longitude : area.max_longitude;
+    }
+
+    for (uint32_t fence = 0; fence < FENCE_COUNT; fence++) {
+        sGeodesyPoint_t centre;
+
+        if ((fence % 2) == 0) {
+            const sTrackFix_t *fix = &g_track[Bench_Random() % fix_count];
+            centre = (sGeodesyPoint_t) {.latitude = fix->latitude, .longitude = fix->longitude};
+        } else {
+            centre.latitude = area.min_latitude + (int32_t) (Bench_Random() % (uint32_t) (area.max_latitude - area.min_latitude + 1));
+            centre.longitude = area.min_longitude + (int32_t) (Bench_Random() % (uint32_t) (area.max_longitude - area.min_longitude + 1));
+        }
+
+        double scale = 1.0 / cos((centre.latitude / 1e7) * DEGREES_TO_RADIANS);
+        uint32_t count = MIN_FENCE_VERTICES + (Bench_Random() % (MAX_FENCE_VERTICES - MIN_FENCE_VERTICES + 1));
+        uint32_t radius_m = MIN_FENCE_RADIUS_M + (Bench_Random() % (MAX_FENCE_RADIUS_M - MIN_FENCE_RADIUS_M + 1));
+        sGeofenceRecord_t *record = &records[fence];
+
+        *record = (sGeofenceRecord_t) {.id = (uint16_t) fence, .flags = GEOFENCE_FLAG_ENTRY | GEOFENCE_FLAG_EXIT,
+                                       .vertex_count = (uint8_t) count, .first_vertex = vertex_count,
+                                       .box = {INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN}};
+
+        /* Star shaped, the vertices go round once so the polygon never crosses itself */
+        for (uint32_t v = 0; v < count; v++) {
+            double angle = (2.0 * M_PI * v) / count;
+            double distance = radius_m * (0.5 + ((Bench_Random() % 1000U) / 2000.0));
+            sGeodesyPoint_t *vertex = &vertices[vertex_count++];
+
+            vertex->latitude = centre.latitude + (int32_t) lround((distance * cos(angle) / METERS_PER_DEGREE) * 1e7);
+            vertex->longitude = centre.longitude + (int32_t) lround((distance * sin(angle) * scale / METERS_PER_DEGREE) * 1e7);
+
+            record->box.min_latitude = (vertex->latitude < record->box.min_latitude) ? vertex->latitude : record->box.min_latitude;
+            record->box.max_latitude = (vertex->latitude > record->box.max_latitude) ? vertex->latitude : record->box.max_latitude;
+            record->box.min_longitude = (vertex->longitude < record->box.min_longitude) ? vertex->longitude : record->box.min_longitude;
+            record->box.max_longitude = (vertex->longitude > record->box.max_longitude) ? vertex->longitude : record->box.max_longitude;
+        }
+    }
+
+    *header = (sGeofenceSetHeader_t) {.magic = GEOFENCE_SET_MAGIC, .version = GEOFENCE_SET_VERSION,
+                                      .fence_count = FENCE_COUNT, .vertex_count = vertex_count};
+
+    return sizeof(*header) + (FENCE_COUNT * sizeof(sGeofenceRecord_t)) + (vertex_count * sizeof(sGeodesyPoint_t));
+}
+
+/* Without hysteresis the engine has to agree with testing every polygon on every fix. Transitions past the alert
+ * array are held back to the next fix, the same fix is evaluated again until they are all out. */
+static bool Bench_Check (size_t fix_count) {
+    const sGeofenceSetHeader_t *header = (const sGeofenceSetHeader_t *) g_image;
+    const sGeofenceRecord_t *records = (const sGeofenceRecord_t *) (header + 1);
+    const sGeodesyPoint_t *vertices = (const sGeodesyPoint_t *) (records + FENCE_COUNT);
+    sGeofenceAlert_t alerts[GEOFENCE_MAX_EVENTS];
+    size_t mismatches = 0;
+    size_t repeats = 0;
+
+    memset(g_is_inside, 0, sizeof(g_is_inside));
+    Geofence_Init(&g_geofence, 1);
+
+    if (Geofence_Load(&g_geofence, g_image, sizeof(g_image)) == false) {
+        fprintf(stderr, "fence set does not load\n");
+        return false;
+    }
+
+    for (size_t i = 0; i < fix_count; i++) {
+        sGeodesyPoint_t position = {.latitude = g_track[i].latitude, .longitude = g_track[i].longitude};
+        size_t transitions = 0;
+        size_t inside = 0;
+
+        for (uint32_t fence = 0; fence < FENCE_COUNT; fence++) {
+            bool is_inside = Geofence_IsInside(&position, &vertices[records[fence].first_vertex], records[fence].vertex_count);
+
+            transitions += (is_inside != g_is_inside[fence]) ? 1 : 0;
+            inside += is_inside ? 1 : 0;
+            g_is_inside[fence] = is_inside;
+        }
+
+        size_t alert_total = 0;
+        size_t alert_count = 0;
+
+        do {
+            alert_count = Geofence_Evaluate(&g_geofence, &position, g_track[i].timestamp, alerts);
+            alert_total += alert_count;
+            repeats += (alert_count == GEOFENCE_MAX_EVENTS) ? 1 : 0;
+
+            for (size_t a = 0; a < alert_count; a++) {
+                uint16_t id = alerts[a].fence_id;
+
+                if ((id >= FENCE_COUNT) || (g_is_inside[id] != (alerts[a].event == eGeofenceEvent_Enter))) {
+                    mismatches++;
+                }
+            }
+        } while (alert_count == GEOFENCE_MAX_EVENTS);
+
+        if ((alert_total != transitions) || (Geofence_GetInsideCount(&g_geofence) != inside)) {
+            mismatches++;
+        }
+    }
+
+    sGeofenceStats_t stats;
+    Geofence_GetStats(&g_geofence, &stats);
+
+    if ((mismatches != 0) || (stats.untracked != 0)) {
+        fprintf(stderr, "%zu fixes disagree with the brute force, %u untracked\n", mismatches, stats.untracked);
+        return false;
+    }
+
+    printf("agrees with the brute force on every fix, %u alerts held back over %zu repeated fixes\n",
+           stats.deferred, repeats);
+
+    return true;
+}
+
+/* Returns host cycles per fix */
+static double Bench_RunEngine (size_t fix_count, uint32_t *alerts) {
+    sGeofenceAlert_t output[GEOFENCE_MAX_EVENTS];
+
+    *alerts = 0;
+
+    uint64_t start_ns = Host_ReadNanoseconds();
+    uint64_t start_cycles = Host_ReadCycles();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        Geofence_Init(&g_geofence, GEOFENCE_DEFAULT_HYSTERESIS);
+        Geofence_Load(&g_geofence, g_image, sizeof(g_image));
+
+        for (size_t i = 0; i < fix_count; i++) {
+            sGeodesyPoint_t position = {.latitude = g_track[i].latitude, .longitude = g_track[i].longitude};
+            *alerts += (uint32_t) Geofence_Evaluate(&g_geofence, &position, g_track[i].timestamp, output);
+        }
+    }
+
+    uint64_t ns = Host_ReadNanoseconds() - start_ns;
+    uint64_t cycles = Host_ReadCycles() - start_cycles;
+    double fixes = (double) fix_count * ROUNDS;
+    sGeofenceStats_t stats;
+
+    Geofence_GetStats(&g_geofence, &stats);
+    *alerts /= ROUNDS;
+
+    printf("%-12s %6.1f ns %8.1f host cycles/fix, %5.2f candidates %5.2f polygon tests/fix, %u alerts\n", "grid index",
+           (double) ns / fixes, (double) cycles / fixes, (double) stats.candidates / stats.fixes,
+           (double) stats.polygon_tests / stats.fixes, *alerts);
+
+    return (double) cycles / fixes;
+}
+
+static double Bench_RunBruteForce (size_t fix_count) {
+    const sGeofenceSetHeader_t *header = (const sGeofenceSetHeader_t *) g_image;
+    const sGeofenceRecord_t *records = (const sGeofenceRecord_t *) (header + 1);
+    const sGeodesyPoint_t *vertices = (const sGeodesyPoint_t *) (records + FENCE_COUNT);
+    uint32_t inside = 0;
+
+    uint64_t start_ns = Host_ReadNanoseconds();
+    uint64_t start_cycles = Host_ReadCycles();
+
+    for (size_t i = 0; i < fix_count; i++) {
+        sGeodesyPoint_t position = {.latitude = g_track[i].latitude, .longitude = g_track[i].longitude};
+
+        for (uint32_t fence = 0; fence < FENCE_COUNT; fence++) {
+            inside += Geofence_IsInside(&position, &vertices[records[fence].first_vertex], records[fence].vertex_count) ? 1 : 0;
+        }
+    }
+
+    uint64_t ns = Host_ReadNanoseconds() - start_ns;
+    uint64_t cycles = Host_ReadCycles() - start_cycles;
+
+    printf("%-12s %6.1f ns %8.1f host cycles/fix, %u fence fixes inside\n", "every fence", (double) ns / fix_count,
+           (double) cycles / fix_count, inside);
+
+    return (double) cycles / fix_count;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* What the 100 MHz target spends per fix scales with the host cycles, the ratio between the two is the point */
+int main (void) {
+    size_t fix_count = Track_Generate(eTrackProfile_Mixed, 1, TRACK_HOURS * 3600U, TRACK_SEED, g_track, MAX_FIXES);
+    size_t image_size = Bench_BuildFences(fix_count);
+    uint32_t alerts = 0;
+
+    printf("%u fences, %zu B image, %zu fixes over %u h\n", FENCE_COUNT, image_size, fix_count, TRACK_HOURS);
+
+    if (Bench_Check(fix_count) == false) {
+        return 1;
+    }
+
+    double engine_cycles = Bench_RunEngine(fix_count, &alerts);
+    double brute_force_cycles = Bench_RunBruteForce(fix_count);
+
+    printf("grid index is %.0fx cheaper than testing every fence\n", brute_force_cycles / engine_cycles);
+
+    return (alerts > 0) ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "tcp_app.h"
+#include "report_app.h"
+#include "metrics_api.h"
+#include "log_sink_app.h"
+#include "host.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define SINK_RATE 4096
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define POLL_MS 50
+/* The connect is logged too, its lines go out first, once the sink retries the link */
+#define SETTLE_MS 8000
+/* Past the flush latency of the sink and the coalescing delay of the TCP task */
+#define FLUSH_WAIT_MS 3000
+/* Many flush latencies, still short of the first metrics snapshot */
+#define QUIET_WAIT_MS 20000
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+CREATE_MODULE_TAG(LOG_SINK_TEST);
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Test_Main (void *argument);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Sending a block makes the modem layers log, those lines must not be sent again and again */
+static void Test_Main (void *argument) {
+    sModemSimConfig_t config = {
+        .is_cmux_supported = true,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+    };
+
+    Modem_Sim_Init(&config);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+    HOST_CHECK(LOG_SINK_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    HOST_CHECK(LOG_SINK_APP_Start(eServerId_First, SERVER_ADDRESS, SERVER_PORT, SINK_RATE));
+
+    start = osKernelGetTickCount();
+
+    while ((TCP_APP_GetSocketState(eServerId_First) != eSocketState_Connected) &&
+           ((osKernelGetTickCount() - start) < CONNECT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(TCP_APP_GetSocketState(eServerId_First) == eSocketState_Connected) == false) {
+        Host_Exit(1);
+    }
+
+    osDelay(SETTLE_MS);
+
+    const sModemSimSocket_t *server = Modem_Sim_GetSocket(eServerId_First);
+    sLogSinkAppStats_t stats = {0};
+
+    HOST_CHECK(LOG_SINK_APP_GetStats(&stats));
+
+    uint32_t blocks_sent = stats.blocks_sent;
+    uint32_t sends = server->sends;
+    size_t rx_count = server->server_rx_count;
+
+    /* One line is flushed once */
+    DEBUG_INFO("Log sink test line\r\n");
+    osDelay(FLUSH_WAIT_MS);
+
+    HOST_CHECK(LOG_SINK_APP_GetStats(&stats));
+    HOST_CHECK(stats.blocks_sent == (blocks_sent + 1));
+    HOST_CHECK(server->sends == (sends + 1));
+    HOST_CHECK(server->server_rx_count > rx_count);
+
+    /* And the lines its send caused do not follow */
+    rx_count = server->server_rx_count;
+    osDelay(QUIET_WAIT_MS);
+
+    HOST_CHECK(LOG_SINK_APP_GetStats(&stats));
+    HOST_CHECK(stats.blocks_sent == (blocks_sent + 1));
+    HOST_CHECK(server->sends == (sends + 1));
+    HOST_CHECK(server->server_rx_count == rx_count);
+    HOST_CHECK(LOG_SINK_APP_Stop());
+
+    printf("log sink: %u block(s), %u send(s), %u byte(s) at the server, %d failure(s)\n", (unsigned) stats.blocks_sent,
+           server->sends, (unsigned) server->server_rx_count, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* The sink reads their counters into the metrics snapshot, none is due within the test */
+bool REPORT_APP_GetStats (sReportAppStats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    return true;
+}
+
+bool Metrics_API_GetCpuLoad (uint16_t *load_permille) {
+    *load_permille = 0;
+
+    return true;
+}
+
+bool Metrics_API_GetSleep (uint16_t *sleep_permille) {
+    *sleep_permille = 0;
+
+    return true;
+}
+
+int main (void) {
+    return Host_Run(&Test_Main, NULL);
+}
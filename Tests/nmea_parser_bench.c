@@ -0,0 +1,186 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nmea_parser.h"
+#include "host.h"
+#include "track.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define LOG_HOURS 8U
+#define MAX_EPOCHS (LOG_HOURS * 3600U)
+#define EPOCH_MAX_SIZE 1024
+#define SENTENCES_PER_EPOCH 7U
+#define ROUNDS 5
+#define TRACK_SEED 0x5EEDU
+/* The UART layer hands over whatever arrived since the last idle line interrupt */
+#define MAX_CHUNK_SIZE 64U
+/* The fix comes back through decimal minutes with 5 decimals and speeds through knots */
+#define COORDINATE_TOLERANCE 2
+#define SPEED_TOLERANCE 1
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sTrackFix_t g_track[MAX_EPOCHS];
+static sNmeaParser_t g_parser;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Bench_IsClose (int32_t a, int32_t b, int32_t tolerance);
+static char *Bench_BuildLog (size_t epochs, size_t *size);
+static char *Bench_ReadFile (const char *path, size_t *size);
+static int Bench_Run (const char *name, const char *log, size_t size, uint32_t expected_sentences);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Bench_IsClose (int32_t a, int32_t b, int32_t tolerance) {
+    return ((a - b) <= tolerance) && ((b - a) <= tolerance);
+}
+
+/* Formats the generated track and checks every epoch comes back out of the parser */
+static char *Bench_BuildLog (size_t epochs, size_t *size) {
+    char *log = malloc(epochs * EPOCH_MAX_SIZE);
+    size_t mismatches = 0;
+
+    *size = 0;
+
+    if (log == NULL) {
+        return NULL;
+    }
+
+    NmeaParser_Init(&g_parser);
+
+    for (size_t i = 0; i < epochs; i++) {
+        size_t length = Track_FormatNmea(&g_track[i], &log[*size], EPOCH_MAX_SIZE);
+        sNmeaFix_t fix;
+
+        NmeaParser_Feed(&g_parser, &log[*size], length);
+        *size += length;
+
+        if ((length == 0) || (NmeaParser_GetFix(&g_parser, &fix) == false) || (fix.is_valid == false) ||
+            (Bench_IsClose(fix.latitude, g_track[i].latitude, COORDINATE_TOLERANCE) == false) ||
+            (Bench_IsClose(fix.longitude, g_track[i].longitude, COORDINATE_TOLERANCE) == false) ||
+            (Bench_IsClose(fix.speed, g_track[i].speed, SPEED_TOLERANCE) == false) ||
+            (fix.course != g_track[i].course) || (fix.altitude != g_track[i].altitude) ||
+            (fix.satellites_used != g_track[i].satellites) || (fix.hdop != g_track[i].hdop) ||
+            (fix.time_ms != ((g_track[i].timestamp % 86400U) * 1000U))) {
+            mismatches++;
+        }
+    }
+
+    if (mismatches > 0) {
+        fprintf(stderr, "%zu of %zu epochs parsed back wrong\n", mismatches, epochs);
+        free(log);
+        return NULL;
+    }
+
+    return log;
+}
+
+static char *Bench_ReadFile (const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *data = (length > 0) ? malloc((size_t) length) : NULL;
+
+    if ((data == NULL) || (fread(data, 1, (size_t) length, file) != (size_t) length)) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+    *size = (size_t) length;
+
+    return data;
+}
+
+/* Sentences per second per MHz is a million over the cycles per sentence, what the 100 MHz target gets from it
+ * depends on its flash wait states, the host figure is the upper bound. */
+static int Bench_Run (const char *name, const char *log, size_t size, uint32_t expected_sentences) {
+    sNmeaStats_t stats = {0};
+    uint32_t seed = 1;
+
+    uint64_t start_ns = Host_ReadNanoseconds();
+    uint64_t start_cycles = Host_ReadCycles();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        NmeaParser_Init(&g_parser);
+
+        for (size_t position = 0; position < size; ) {
+            seed = (seed * 1103515245U) + 12345U;
+
+            size_t chunk = 1 + ((seed >> 16) % MAX_CHUNK_SIZE);
+            chunk = ((size - position) < chunk) ? (size - position) : chunk;
+
+            NmeaParser_Feed(&g_parser, &log[position], chunk);
+            position += chunk;
+        }
+    }
+
+    uint64_t ns = Host_ReadNanoseconds() - start_ns;
+    uint64_t cycles = Host_ReadCycles() - start_cycles;
+
+    NmeaParser_GetStats(&g_parser, &stats);
+
+    double sentences = (double) stats.sentences * ROUNDS;
+    double cycles_per_sentence = (double) cycles / sentences;
+
+    printf("%-20s %8u sentences, %6.1f MB: %6.1f ns %6.1f host cycles/sentence, %6.0f sentences/s/MHz, "
+           "%5.1f MB/s, %u checksum errors\n", name, stats.sentences, (double) size / 1e6, (double) ns / sentences,
+           cycles_per_sentence, (cycles_per_sentence > 0.0) ? (1e6 / cycles_per_sentence) : 0.0,
+           ((double) size * ROUNDS) / ((double) ns / 1e9) / 1e6, stats.checksum_errors);
+
+    if ((expected_sentences != 0) && ((stats.sentences != expected_sentences) || (stats.checksum_errors != 0))) {
+        fprintf(stderr, "%s: %u of %u sentences parsed\n", name, stats.sentences, expected_sentences);
+        return 1;
+    }
+
+    return 0;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* Recorded NMEA logs given on the command line run after the generated one */
+int main (int argc, char **argv) {
+    int failures = 0;
+    size_t size = 0;
+    size_t epochs = Track_Generate(eTrackProfile_Mixed, 1, LOG_HOURS * 3600U, TRACK_SEED, g_track, MAX_EPOCHS);
+    char *log = Bench_BuildLog(epochs, &size);
+    char name[32];
+
+    if (log == NULL) {
+        return 1;
+    }
+
+    snprintf(name, sizeof(name), "generated %u h", LOG_HOURS);
+    failures += Bench_Run(name, log, size, (uint32_t) (epochs * SENTENCES_PER_EPOCH));
+    free(log);
+
+    for (int i = 1; i < argc; i++) {
+        log = Bench_ReadFile(argv[i], &size);
+
+        if (log == NULL) {
+            fprintf(stderr, "%s: cannot read\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        failures += Bench_Run(argv[i], log, size, 0);
+        free(log);
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "tcp_app.h"
+#include "host.h"
+#include "host_board.h"
+#include "flash_ram.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define DOWN_SOCKET eServerId_First
+#define UP_SOCKET (eServerId_First + 1)
+#define FRAME_COUNT 3
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define DRAIN_MS 5000
+#define POLL_MS 50
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Test_Connect (eServerId_t connect_id);
+static void Test_Send (eServerId_t connect_id, const char *data, bool is_urgent);
+static uint32_t Test_GetPending (void);
+static uint32_t Test_GetAppended (void);
+static void Test_Main (void *argument);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static void Test_Connect (eServerId_t connect_id) {
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+    tcp_job.data.connect.connect_id = connect_id;
+    tcp_job.data.connect.service = eSocketService_Tcp;
+    tcp_job.data.connect.port = SERVER_PORT;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", SERVER_ADDRESS);
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((TCP_APP_GetSocketState(connect_id) != eSocketState_Connected) &&
+           ((osKernelGetTickCount() - start) < CONNECT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    HOST_CHECK(TCP_APP_GetSocketState(connect_id) == eSocketState_Connected);
+}
+
+static void Test_Send (eServerId_t connect_id, const char *data, bool is_urgent) {
+    size_t size = strlen(data);
+    char *payload = TCP_APP_AllocPayload(size);
+
+    if (HOST_CHECK(payload != NULL) == false) {
+        return;
+    }
+
+    memcpy(payload, data, size);
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = connect_id;
+    tcp_job.data.send.data_str = payload;
+    tcp_job.data.send.data_size = size;
+    tcp_job.data.send.persistent = true;
+    tcp_job.data.send.urgent = is_urgent;
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+}
+
+static uint32_t Test_GetPending (void) {
+    sOutboxStats_t stats;
+    uint32_t pending = 0;
+
+    HOST_CHECK(TCP_APP_GetOutboxStats(&stats, &pending));
+
+    return pending;
+}
+
+static uint32_t Test_GetAppended (void) {
+    sOutboxStats_t stats;
+    uint32_t pending = 0;
+
+    HOST_CHECK(TCP_APP_GetOutboxStats(&stats, &pending));
+
+    return stats.appended;
+}
+
+/* Records of a socket that is down must not hold back the ones of a connected socket queued behind them */
+static void Test_Main (void *argument) {
+    sModemSimConfig_t config = {
+        .is_cmux_supported = false,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+    };
+
+    Modem_Sim_Init(&config);
+    Flash_Ram_Reset(0);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    Test_Connect(UP_SOCKET);
+
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        Test_Send(DOWN_SOCKET, "down;", false);
+    }
+
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        Test_Send(UP_SOCKET, "up;", false);
+    }
+
+    osDelay(DRAIN_MS);
+
+    const sModemSimSocket_t *down_server = Modem_Sim_GetSocket(DOWN_SOCKET);
+    const sModemSimSocket_t *up_server = Modem_Sim_GetSocket(UP_SOCKET);
+
+    HOST_CHECK((up_server->server_rx_count == 9) && (memcmp(up_server->server_rx, "up;up;up;", 9) == 0));
+    /* The delivered records stay behind the commit until the ones in front of them go */
+    HOST_CHECK(Test_GetPending() == (2 * FRAME_COUNT));
+
+    /* A flash that takes no more writes: the connected socket gets the frame live, the other one counts it lost */
+    sTcpSendStats_t send_stats;
+    Flash_Ram_CutPowerAfter(0);
+    Test_Send(UP_SOCKET, "live;", false);
+    Test_Send(DOWN_SOCKET, "lost;", false);
+    osDelay(DRAIN_MS);
+    Flash_Ram_RestorePower();
+
+    HOST_CHECK((up_server->server_rx_count == 14) && (memcmp(&up_server->server_rx[9], "live;", 5) == 0));
+    HOST_CHECK(TCP_APP_GetSendStats(DOWN_SOCKET, &send_stats) && (send_stats.lost == 1));
+
+    /* The outbox keeps working once the flash is back, and the held back records go out on connect */
+    Test_Send(UP_SOCKET, "up;", false);
+    osDelay(DRAIN_MS);
+    HOST_CHECK((up_server->server_rx_count == 17) && (memcmp(&up_server->server_rx[14], "up;", 3) == 0));
+
+    Test_Connect(DOWN_SOCKET);
+    osDelay(DRAIN_MS);
+
+    HOST_CHECK((down_server->server_rx_count == 15) && (memcmp(down_server->server_rx, "down;down;down;", 15) == 0));
+    HOST_CHECK(Test_GetPending() == 0);
+    /* A batch counts every record packed into it */
+    HOST_CHECK(TCP_APP_GetSendStats(DOWN_SOCKET, &send_stats) && (send_stats.frames == FRAME_COUNT));
+
+    /* An alert to a connected socket goes out live and never touches the flash */
+    uint32_t appended = Test_GetAppended();
+    Test_Send(UP_SOCKET, "alert;", true);
+    osDelay(DRAIN_MS);
+    HOST_CHECK((up_server->server_rx_count == 23) && (memcmp(&up_server->server_rx[17], "alert;", 6) == 0));
+    HOST_CHECK(Test_GetAppended() == appended);
+
+    /* One stored while the socket is down goes out ahead of the backlog stored before it */
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Disconnect};
+    tcp_job.data.disconnect.connect_id = DOWN_SOCKET;
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+    osDelay(DRAIN_MS);
+    HOST_CHECK(TCP_APP_GetSocketState(DOWN_SOCKET) == eSocketState_Closed);
+    /* Nothing holds the core out of Stop between sends, connected sockets or not */
+    HOST_CHECK(Host_Board_GetStats()->power_lock_depth == 0);
+
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        Test_Send(DOWN_SOCKET, "down;", false);
+    }
+
+    Test_Send(DOWN_SOCKET, "alert;", true);
+    osDelay(DRAIN_MS);
+    HOST_CHECK(Test_GetPending() == (FRAME_COUNT + 1));
+
+    Test_Connect(DOWN_SOCKET);
+    osDelay(DRAIN_MS);
+
+    HOST_CHECK((down_server->server_rx_count == 36) &&
+               (memcmp(&down_server->server_rx[15], "alert;down;down;down;", 21) == 0));
+    HOST_CHECK(Test_GetPending() == 0);
+    HOST_CHECK(TCP_APP_GetSendStats(DOWN_SOCKET, &send_stats) && (send_stats.frames == ((2 * FRAME_COUNT) + 1)));
+    HOST_CHECK(Host_Board_GetStats()->power_lock_depth == 0);
+
+    printf("outbox drain: %u bytes to the connected socket, %u after the reconnect, %d failure(s)\n",
+           (unsigned) up_server->server_rx_count, (unsigned) down_server->server_rx_count, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    return Host_Run(&Test_Main, NULL);
+}
@@ -0,0 +1,302 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "flash_driver.h"
+#include "outbox.h"
+#include "host.h"
+#include "flash_ram.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SECTOR_SIZE 1024
+#define SECTOR_COUNT 3
+#define RECORD_COUNT 240
+/* Delivery keeps up closely enough that a recycled sector never holds a pending record */
+#define MAX_PENDING 6
+#define MAX_RECORD_SIZE 44
+#define CUT_STEP 3
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef enum eRecordState {
+    eRecordState_First = 0,
+    eRecordState_None = eRecordState_First,
+    eRecordState_Pending,
+    eRecordState_Delivered,
+    /* The operation the power cut hit, either outcome is fine */
+    eRecordState_Torn,
+    eRecordState_Last
+} eRecordState_t;
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sOutbox_t g_outbox;
+static eRecordState_t g_record_state[RECORD_COUNT + 1];
+static uint32_t g_records_seen[RECORD_COUNT + 1];
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static bool Test_Read (size_t sector, size_t offset, void *data, size_t size);
+static bool Test_Program (size_t sector, size_t offset, const void *data, size_t size);
+static bool Test_Erase (size_t sector);
+static size_t Test_MakeRecord (uint32_t id, uint8_t *record);
+static uint32_t Test_CheckRecord (const uint8_t *record, size_t size);
+static bool Test_ReadPending (sOutboxCursor_t *cursors, uint32_t *ids, size_t count);
+static bool Test_RunWorkload (void);
+static void Test_Delivery (void);
+static void Test_PowerCut (size_t budget);
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const sOutboxFlash_t g_flash = {
+    .sector_count = SECTOR_COUNT,
+    .sector_size = SECTOR_SIZE,
+    .read = &Test_Read,
+    .program = &Test_Program,
+    .erase = &Test_Erase
+};
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static bool Test_Read (size_t sector, size_t offset, void *data, size_t size) {
+    return Flash_Driver_Read(eFlashDriverSector_Outbox0 + sector, offset, data, size);
+}
+
+static bool Test_Program (size_t sector, size_t offset, const void *data, size_t size) {
+    return Flash_Driver_Program(eFlashDriverSector_Outbox0 + sector, offset, data, size);
+}
+
+static bool Test_Erase (size_t sector) {
+    return Flash_Driver_Erase(eFlashDriverSector_Outbox0 + sector);
+}
+
+/* [id, id derived bytes...], sized so records land at every alignment */
+static size_t Test_MakeRecord (uint32_t id, uint8_t *record) {
+    size_t size = sizeof(id) + 1 + (id % (MAX_RECORD_SIZE - sizeof(id)));
+
+    memcpy(record, &id, sizeof(id));
+
+    for (size_t i = sizeof(id); i < size; i++) {
+        record[i] = (uint8_t) ((id * 31U) + i);
+    }
+
+    return size;
+}
+
+/* The id of an intact record, 0 otherwise */
+static uint32_t Test_CheckRecord (const uint8_t *record, size_t size) {
+    uint8_t expected[MAX_RECORD_SIZE];
+    uint32_t id;
+
+    if (size < sizeof(id)) {
+        return 0;
+    }
+
+    memcpy(&id, record, sizeof(id));
+
+    if ((id == 0) || (id > RECORD_COUNT) || (Test_MakeRecord(id, expected) != size) || (memcmp(expected, record, size) != 0)) {
+        return 0;
+    }
+
+    return id;
+}
+
+/* The oldest pending records, each cursor is left right after its record */
+static bool Test_ReadPending (sOutboxCursor_t *cursors, uint32_t *ids, size_t count) {
+    sOutboxCursor_t cursor;
+    uint8_t record[MAX_RECORD_SIZE];
+
+    if (Outbox_GetReadCursor(&g_outbox, &cursor) == false) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        size_t size = Outbox_Read(&g_outbox, &cursor, record, sizeof(record));
+
+        ids[i] = Test_CheckRecord(record, size);
+
+        if (ids[i] == 0) {
+            return false;
+        }
+
+        cursors[i] = cursor;
+    }
+
+    return true;
+}
+
+/* Appends every record and delivers the oldest ones, in order and out of order, until a write fails */
+static bool Test_RunWorkload (void) {
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t pending = 0;
+
+    for (uint32_t id = 1; id <= RECORD_COUNT; id++) {
+        g_record_state[id] = eRecordState_Torn;
+
+        if (Outbox_Append(&g_outbox, record, Test_MakeRecord(id, record), NULL) == false) {
+            return false;
+        }
+
+        g_record_state[id] = eRecordState_Pending;
+        pending++;
+
+        if (pending <= MAX_PENDING) {
+            continue;
+        }
+
+        sOutboxCursor_t cursors[2];
+        uint32_t ids[2];
+
+        if (HOST_CHECK(Test_ReadPending(cursors, ids, 2)) == false) {
+            return false;
+        }
+
+        if ((id % 2) == 0) {
+            g_record_state[ids[0]] = eRecordState_Torn;
+
+            if (Outbox_Commit(&g_outbox, &cursors[0]) == false) {
+                return false;
+            }
+
+            g_record_state[ids[0]] = eRecordState_Delivered;
+            pending--;
+            continue;
+        }
+
+        /* The second one first, the commit cannot move until the oldest one is marked too */
+        for (int i = 1; i >= 0; i--) {
+            g_record_state[ids[i]] = eRecordState_Torn;
+
+            if (Outbox_MarkDelivered(&g_outbox, &cursors[i]) == false) {
+                return false;
+            }
+
+            g_record_state[ids[i]] = eRecordState_Delivered;
+            pending--;
+
+            if (Outbox_CommitDelivered(&g_outbox) == false) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void Test_Delivery (void) {
+    Flash_Ram_Reset(SECTOR_SIZE);
+    memset(g_record_state, 0, sizeof(g_record_state));
+    HOST_CHECK(Outbox_Mount(&g_outbox, &g_flash));
+    HOST_CHECK(Test_RunWorkload());
+
+    sOutboxStats_t stats;
+    HOST_CHECK(Outbox_GetStats(&g_outbox, &stats));
+    HOST_CHECK(stats.lost == 0);
+    HOST_CHECK(stats.erases > SECTOR_COUNT);
+    HOST_CHECK(Outbox_GetPending(&g_outbox) == MAX_PENDING);
+
+    /* Delivered records stay skipped after a remount */
+    HOST_CHECK(Outbox_Mount(&g_outbox, &g_flash));
+    HOST_CHECK(Outbox_GetPending(&g_outbox) == MAX_PENDING);
+
+    sOutboxCursor_t cursors[MAX_PENDING];
+    uint32_t ids[MAX_PENDING];
+    HOST_CHECK(Test_ReadPending(cursors, ids, MAX_PENDING));
+
+    for (size_t i = 0; i < MAX_PENDING; i++) {
+        HOST_CHECK(ids[i] == (RECORD_COUNT - MAX_PENDING + 1 + i));
+    }
+
+    printf("outbox: %u records, %u erases, %u flash bytes programmed\n", RECORD_COUNT, stats.erases,
+           (unsigned) Flash_Ram_GetStats()->bytes_programmed);
+}
+
+/* Every record acknowledged as appended and not as delivered has to come back once, the torn one at most once */
+static void Test_PowerCut (size_t budget) {
+    Flash_Ram_Reset(SECTOR_SIZE);
+    memset(g_record_state, 0, sizeof(g_record_state));
+    memset(g_records_seen, 0, sizeof(g_records_seen));
+
+    if (HOST_CHECK(Outbox_Mount(&g_outbox, &g_flash)) == false) {
+        return;
+    }
+
+    Flash_Ram_CutPowerAfter(budget);
+
+    bool is_done = Test_RunWorkload();
+
+    if ((is_done == false) && (HOST_CHECK(Flash_Ram_IsPowerCut()) == false)) {
+        return;
+    }
+
+    Flash_Ram_RestorePower();
+
+    if (HOST_CHECK(Outbox_Mount(&g_outbox, &g_flash)) == false) {
+        fprintf(stderr, "power cut after %zu bytes: mount failed\n", budget);
+        return;
+    }
+
+    sOutboxCursor_t cursor;
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t size;
+    int failures = Host_GetFailures();
+
+    HOST_CHECK(Outbox_GetReadCursor(&g_outbox, &cursor));
+
+    while ((size = Outbox_Read(&g_outbox, &cursor, record, sizeof(record))) > 0) {
+        uint32_t id = Test_CheckRecord(record, size);
+
+        if (HOST_CHECK(id != 0) == false) {
+            continue;
+        }
+
+        g_records_seen[id]++;
+        HOST_CHECK(g_records_seen[id] == 1);
+        HOST_CHECK((g_record_state[id] == eRecordState_Pending) || (g_record_state[id] == eRecordState_Torn));
+    }
+
+    for (uint32_t id = 1; id <= RECORD_COUNT; id++) {
+        if (g_record_state[id] == eRecordState_Pending) {
+            HOST_CHECK(g_records_seen[id] == 1);
+        }
+    }
+
+    /* And the outbox takes new records after it */
+    uint8_t expected[MAX_RECORD_SIZE];
+    size_t expected_size = Test_MakeRecord(RECORD_COUNT, expected);
+    sOutboxCursor_t appended;
+    HOST_CHECK(Outbox_Append(&g_outbox, expected, expected_size, &appended));
+    HOST_CHECK((Outbox_Read(&g_outbox, &cursor, record, sizeof(record)) == expected_size) &&
+               (memcmp(record, expected, expected_size) == 0));
+    /* The cursor handed back by the append reads the same record */
+    HOST_CHECK((Outbox_Read(&g_outbox, &appended, record, sizeof(record)) == expected_size) &&
+               (appended.sequence == cursor.sequence) && (appended.record_offset == cursor.record_offset));
+
+    if (Host_GetFailures() != failures) {
+        fprintf(stderr, "power cut after %zu bytes\n", budget);
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    Test_Delivery();
+
+    /* Erases count as their sector size, the budget runs over every byte the workload writes */
+    const sFlashRamStats_t *flash_stats = Flash_Ram_GetStats();
+    size_t total = flash_stats->bytes_programmed + (flash_stats->erases * SECTOR_SIZE);
+    uint32_t cuts = 0;
+
+    for (size_t budget = 0; budget < total; budget += CUT_STEP) {
+        Test_PowerCut(budget);
+        cuts++;
+    }
+
+    printf("outbox power cuts: %u, %d failure(s)\n", cuts, Host_GetFailures());
+
+    return (Host_GetFailures() == 0) ? 0 : 1;
+}
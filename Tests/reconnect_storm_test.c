@@ -0,0 +1,227 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "tcp_app.h"
+#include "host.h"
+#include "host_board.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+/* Keep in step with tcp_app.c */
+#define RECONNECT_MIN_DELAY_MS 1000
+#define RECONNECT_MAX_DELAY_MS 60000
+#define RECONNECT_JITTER_DIVIDER 4
+#define SOCKET_COUNT 6
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define OUTAGE_MS 300000
+/* Last backoff plus its jitter, the release of the socket and the open itself */
+#define RECOVERY_TIMEOUT_MS (RECONNECT_MAX_DELAY_MS + (RECONNECT_MAX_DELAY_MS / RECONNECT_JITTER_DIVIDER) + 5000)
+#define POLL_MS 50
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static bool g_is_server_slow = false;
+static uint32_t g_refused_opens = 0;
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static int Test_OnOpen (int connect_id, uint32_t attempt);
+static bool Test_WaitForSockets (size_t count, eSocketState_t state, uint32_t timeout);
+static void Test_Connect (eServerId_t connect_id);
+static void Test_CheckBackoff (uint32_t first_open, uint32_t last_open, uint32_t outage_tick);
+static void Test_Main (void *argument);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* The last socket is refused twice after the outage, a server that comes back slowly */
+static int Test_OnOpen (int connect_id, uint32_t attempt) {
+    if ((g_is_server_slow == true) && (connect_id == (SOCKET_COUNT - 1)) && (g_refused_opens < 2)) {
+        g_refused_opens++;
+        return 566;
+    }
+
+    return 0;
+}
+
+static bool Test_WaitForSockets (size_t count, eSocketState_t state, uint32_t timeout) {
+    uint32_t start = osKernelGetTickCount();
+
+    while ((osKernelGetTickCount() - start) < timeout) {
+        bool is_done = true;
+
+        for (eServerId_t connect_id = eServerId_First; connect_id < count; connect_id++) {
+            is_done = is_done && (TCP_APP_GetSocketState(connect_id) == state);
+        }
+
+        if (is_done == true) {
+            return true;
+        }
+
+        osDelay(POLL_MS);
+    }
+
+    return false;
+}
+
+static void Test_Connect (eServerId_t connect_id) {
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+
+    tcp_job.data.connect.connect_id = connect_id;
+    tcp_job.data.connect.service = eSocketService_Tcp;
+    tcp_job.data.connect.port = SERVER_PORT;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", SERVER_ADDRESS);
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+}
+
+/* Opens from one outage: capped exponential backoff per socket, and the sockets spread out instead of reconnecting
+ * together */
+static void Test_CheckBackoff (uint32_t first_open, uint32_t last_open, uint32_t outage_tick) {
+    const sModemSimStats_t *stats = Modem_Sim_GetStats();
+    uint32_t same_tick_opens = 0;
+    uint32_t storm_opens = 0;
+
+    HOST_CHECK(last_open <= MODEM_SIM_MAX_OPENS);
+
+    for (int connect_id = 0; connect_id < SOCKET_COUNT; connect_id++) {
+        uint32_t previous_tick = outage_tick;
+        uint32_t opens = 0;
+
+        for (uint32_t open = first_open; open < last_open; open++) {
+            if (stats->open_socket[open] != connect_id) {
+                continue;
+            }
+
+            uint32_t gap = stats->open_tick[open] - previous_tick;
+
+            if (opens > 0) {
+                uint32_t backoff = RECONNECT_MIN_DELAY_MS << ((opens > 6) ? 6 : opens);
+                backoff = (backoff > RECONNECT_MAX_DELAY_MS) ? RECONNECT_MAX_DELAY_MS : backoff;
+
+                /* The delay runs from the release of the socket, the open itself adds a little */
+                HOST_CHECK(gap >= backoff);
+                HOST_CHECK(gap <= (backoff + (backoff / RECONNECT_JITTER_DIVIDER) + 2000));
+            }
+
+            previous_tick = stats->open_tick[open];
+            opens++;
+        }
+
+        /* 1 + 2 + 4 + 8 + 16 + 32 s and then once a minute over the five minutes */
+        HOST_CHECK(opens >= 6);
+        HOST_CHECK(opens <= 12);
+        storm_opens += opens;
+    }
+
+    for (uint32_t open = first_open + 1; open < last_open; open++) {
+        if (stats->open_tick[open] == stats->open_tick[open - 1]) {
+            same_tick_opens++;
+        }
+    }
+
+    printf("outage: %u opens, %u in the same tick as the one before\n", storm_opens, same_tick_opens);
+    HOST_CHECK(same_tick_opens == 0);
+}
+
+static void Test_Main (void *argument) {
+    sModemSimConfig_t config = {
+        .is_cmux_supported = true,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+        .open_handler = &Test_OnOpen,
+    };
+
+    Modem_Sim_Init(&config);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    for (eServerId_t connect_id = eServerId_First; connect_id < SOCKET_COUNT; connect_id++) {
+        Test_Connect(connect_id);
+    }
+
+    HOST_CHECK(Test_WaitForSockets(SOCKET_COUNT, eSocketState_Connected, CONNECT_TIMEOUT_MS));
+
+    /* Coverage drops for five minutes, every socket is closed by the network at once */
+    uint32_t first_open = Modem_Sim_GetStats()->open_count;
+    uint32_t outage_tick = osKernelGetTickCount();
+
+    Modem_Sim_SetNetwork(false);
+    osDelay(OUTAGE_MS);
+
+    for (eServerId_t connect_id = eServerId_First; connect_id < SOCKET_COUNT; connect_id++) {
+        HOST_CHECK(TCP_APP_GetSocketState(connect_id) != eSocketState_Connected);
+    }
+
+    uint32_t last_open = Modem_Sim_GetStats()->open_count;
+    Test_CheckBackoff(first_open, last_open, outage_tick);
+
+    /* Every socket is back within one capped delay, the slow server only costs its own socket */
+    g_is_server_slow = true;
+    Modem_Sim_SetNetwork(true);
+    HOST_CHECK(Test_WaitForSockets(SOCKET_COUNT - 1, eSocketState_Connected, RECOVERY_TIMEOUT_MS));
+    HOST_CHECK(Test_WaitForSockets(SOCKET_COUNT, eSocketState_Connected, 2 * RECOVERY_TIMEOUT_MS));
+    HOST_CHECK(g_refused_opens == 2);
+
+    /* A lost PDP context is reactivated once and every socket reconnects after the first short delay */
+    uint32_t boots = Modem_Sim_GetStats()->boots;
+    first_open = Modem_Sim_GetStats()->open_count;
+    Modem_Sim_DeactivateContext();
+    osDelay(RECONNECT_MIN_DELAY_MS);
+    HOST_CHECK(Test_WaitForSockets(SOCKET_COUNT, eSocketState_Connected, 2 * CONNECT_TIMEOUT_MS));
+    HOST_CHECK((Modem_Sim_GetStats()->open_count - first_open) == SOCKET_COUNT);
+    HOST_CHECK(Modem_Sim_GetStats()->boots == boots);
+
+    /* The server closing one socket leaves the others alone */
+    first_open = Modem_Sim_GetStats()->open_count;
+    Modem_Sim_CloseSocket(2);
+    osDelay(RECONNECT_MIN_DELAY_MS);
+    HOST_CHECK(Test_WaitForSockets(SOCKET_COUNT, eSocketState_Connected, CONNECT_TIMEOUT_MS));
+    HOST_CHECK((Modem_Sim_GetStats()->open_count - first_open) == 1);
+    HOST_CHECK(Modem_Sim_GetStats()->open_socket[first_open] == 2);
+
+    /* A send right after the storm reaches the server */
+    char *payload = TCP_APP_AllocPayload(5);
+    HOST_CHECK(payload != NULL);
+    memcpy(payload, "hello", 5);
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Send};
+    tcp_job.data.send.connect_id = eServerId_First;
+    tcp_job.data.send.data_str = payload;
+    tcp_job.data.send.data_size = 5;
+    tcp_job.data.send.urgent = true;
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+    osDelay(CONNECT_TIMEOUT_MS);
+
+    const sModemSimSocket_t *server = Modem_Sim_GetSocket(eServerId_First);
+    HOST_CHECK((server->server_rx_count == 5) && (memcmp(server->server_rx, "hello", 5) == 0));
+
+    printf("reconnect storm: %u modem commands, at most %u in one second, %d failure(s)\n", Modem_Sim_GetStats()->commands,
+           Modem_Sim_GetStats()->max_commands_per_second, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    return Host_Run(&Test_Main, NULL);
+}
@@ -0,0 +1,113 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "heap_api.h"
+#include "modem_api.h"
+#include "tcp_api.h"
+#include "tcp_app.h"
+#include "host.h"
+#include "modem_sim.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define SERVER_ADDRESS "192.0.2.10"
+#define SERVER_PORT 5000
+#define MODEM_BOOT_TIMEOUT_MS 60000
+#define CONNECT_TIMEOUT_MS 10000
+#define POLL_MS 50
+/* Past the command timeout of AT+QISEND but inside the extra wait for a late prompt */
+#define LATE_PROMPT_MS 1200
+#define LATE_PAYLOAD "late"
+#define LOST_PAYLOAD "lost"
+#define NEXT_PAYLOAD "next"
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static void Test_Main (void *argument);
+static eModemError_t Test_Send (const char *payload);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+static eModemError_t Test_Send (const char *payload) {
+    char buffer[16];
+    size_t size = strlen(payload);
+
+    memcpy(buffer, payload, size);
+
+    return TCP_API_Send(eServerId_First, buffer, size);
+}
+
+/* A slow or lost > prompt must not leave the modem counting the next command as socket data */
+static void Test_Main (void *argument) {
+    sModemSimConfig_t config = {
+        .is_cmux_supported = true,
+        .boot_ms = 10000,
+        .open_delay_ms = 150,
+    };
+
+    Modem_Sim_Init(&config);
+    HOST_CHECK(Heap_API_Init());
+    HOST_CHECK(Modem_API_Init());
+    HOST_CHECK(TCP_APP_Init());
+
+    uint32_t start = osKernelGetTickCount();
+
+    while ((Modem_API_GetState() != eModemState_Initialized) && ((osKernelGetTickCount() - start) < MODEM_BOOT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(Modem_API_GetState() == eModemState_Initialized) == false) {
+        Host_Exit(1);
+    }
+
+    sTcpJobMessage_t tcp_job = {.type = eTcpJob_Connect};
+    tcp_job.data.connect.connect_id = eServerId_First;
+    tcp_job.data.connect.service = eSocketService_Tcp;
+    tcp_job.data.connect.port = SERVER_PORT;
+    snprintf(tcp_job.data.connect.ip_address, sizeof(tcp_job.data.connect.ip_address), "%s", SERVER_ADDRESS);
+    HOST_CHECK(TCP_APP_AddTask(&tcp_job));
+
+    start = osKernelGetTickCount();
+
+    while ((TCP_APP_GetSocketState(eServerId_First) != eSocketState_Connected) &&
+           ((osKernelGetTickCount() - start) < CONNECT_TIMEOUT_MS)) {
+        osDelay(POLL_MS);
+    }
+
+    if (HOST_CHECK(TCP_APP_GetSocketState(eServerId_First) == eSocketState_Connected) == false) {
+        Host_Exit(1);
+    }
+
+    const sModemSimSocket_t *server = Modem_Sim_GetSocket(eServerId_First);
+
+    /* The late prompt still gets its payload */
+    Modem_Sim_SetPromptDelay(LATE_PROMPT_MS);
+    HOST_CHECK(Test_Send(LATE_PAYLOAD) == eModemError_ATSuccess);
+    HOST_CHECK((server->server_rx_count == 4) && (memcmp(server->server_rx, LATE_PAYLOAD, 4) == 0));
+
+    /* The lost prompt is padded out and the send reported as failed */
+    Modem_Sim_SetPromptDelay(MODEM_SIM_PROMPT_LOST);
+    HOST_CHECK(Test_Send(LOST_PAYLOAD) == eModemError_NoResponse);
+    HOST_CHECK((server->server_rx_count == 8) && (memcmp(&server->server_rx[4], "\0\0\0\0", 4) == 0));
+
+    /* Either way the next command is taken as a command again */
+    Modem_Sim_SetPromptDelay(0);
+    HOST_CHECK(Test_Send(NEXT_PAYLOAD) == eModemError_ATSuccess);
+    HOST_CHECK((server->server_rx_count == 12) && (memcmp(&server->server_rx[8], NEXT_PAYLOAD, 4) == 0));
+    HOST_CHECK(server->sends == 3);
+
+    printf("send prompt: %u send(s), %u byte(s) at the server, %d failure(s)\n", server->sends,
+           (unsigned) server->server_rx_count, Host_GetFailures());
+    Host_Exit((Host_GetFailures() == 0) ? 0 : 1);
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+int main (void) {
+    return Host_Run(&Test_Main, NULL);
+}
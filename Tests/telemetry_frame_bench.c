@@ -0,0 +1,189 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "buffer.h"
+#include "message.h"
+#include "telemetry_frame.h"
+#include "host.h"
+#include "track.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define MAX_POINTS (24U * 3600U)
+/* One payload block per frame, as REPORT_APP_Upload sends them */
+#define FRAME_SIZE 256
+#define MAX_FRAMES (MAX_POINTS / 4U)
+#define MIN_BENCH_POINTS 2000000U
+#define TRACK_SEED 0x5EEDU
+/* "1771488682,546891600,252798000,1234\n", what a text report of the same fields takes */
+#define CSV_LINE_SIZE 64
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sTrackSpec {
+    eTrackProfile_t profile;
+    uint32_t period_s;
+    uint32_t duration_s;
+} sTrackSpec_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const sTrackSpec_t g_tracks[] = {
+    {.profile = eTrackProfile_City, .period_s = 1, .duration_s = 2 * 3600},
+    {.profile = eTrackProfile_Highway, .period_s = 1, .duration_s = 2 * 3600},
+    {.profile = eTrackProfile_Mixed, .period_s = 1, .duration_s = 8 * 3600},
+    {.profile = eTrackProfile_Mixed, .period_s = 5, .duration_s = 24 * 3600}
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sTrackFix_t g_track[MAX_POINTS];
+static sTelemetryPoint_t g_points[MAX_POINTS];
+static sTelemetryPoint_t g_decoded[MAX_POINTS];
+static char g_frames[MAX_FRAMES][FRAME_SIZE];
+static size_t g_frame_size[MAX_FRAMES];
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static size_t Bench_Encode (size_t point_count, size_t *frame_count);
+static bool Bench_Decode (size_t point_count, size_t frame_count);
+static size_t Bench_GetCsvSize (size_t point_count);
+static int Bench_Run (const char *name, size_t point_count);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* Returns the bytes on the wire */
+static size_t Bench_Encode (size_t point_count, size_t *frame_count) {
+    sTelemetryHeader_t header = {.fix_type = 3, .satellites = 9, .hdop = 95};
+    size_t bytes = 0;
+    size_t sent = 0;
+
+    *frame_count = 0;
+
+    while ((sent < point_count) && (*frame_count < MAX_FRAMES)) {
+        sBuffer_t buffer = {.str = g_frames[*frame_count], .size = FRAME_SIZE, .count = 0};
+        sTelemetryEncoder_t encoder;
+
+        TelemetryFrame_Begin(&encoder, &buffer, &header, true);
+
+        while ((sent < point_count) && TelemetryFrame_AddPoint(&encoder, &g_points[sent])) {
+            sent++;
+        }
+
+        g_frame_size[*frame_count] = TelemetryFrame_Finish(&encoder);
+        bytes += g_frame_size[(*frame_count)++];
+    }
+
+    return bytes;
+}
+
+static bool Bench_Decode (size_t point_count, size_t frame_count) {
+    size_t decoded = 0;
+
+    for (size_t i = 0; i < frame_count; i++) {
+        sString_t frame = {.str = g_frames[i], .size = g_frame_size[i]};
+        sTelemetryHeader_t header;
+        size_t count = 0;
+
+        if (TelemetryFrame_Decode(frame, &header, &g_decoded[decoded], MAX_POINTS - decoded, &count) == false) {
+            return false;
+        }
+
+        decoded += count;
+    }
+
+    return (decoded == point_count) && (memcmp(g_decoded, g_points, point_count * sizeof(g_points[0])) == 0);
+}
+
+static size_t Bench_GetCsvSize (size_t point_count) {
+    size_t bytes = 0;
+    char line[CSV_LINE_SIZE];
+
+    for (size_t i = 0; i < point_count; i++) {
+        bytes += (size_t) snprintf(line, sizeof(line), "%u,%d,%d,%u\n", g_points[i].timestamp, g_points[i].latitude,
+                                   g_points[i].longitude, g_points[i].speed);
+    }
+
+    return bytes;
+}
+
+static int Bench_Run (const char *name, size_t point_count) {
+    memset(g_points, 0, sizeof(g_points));
+
+    for (size_t i = 0; i < point_count; i++) {
+        g_points[i].timestamp = g_track[i].timestamp;
+        g_points[i].latitude = g_track[i].latitude;
+        g_points[i].longitude = g_track[i].longitude;
+        g_points[i].speed = g_track[i].speed;
+    }
+
+    size_t rounds = (MIN_BENCH_POINTS / point_count) + 1;
+    size_t frame_count = 0;
+    size_t bytes = 0;
+
+    uint64_t start_ns = Host_ReadNanoseconds();
+    uint64_t start_cycles = Host_ReadCycles();
+
+    for (size_t round = 0; round < rounds; round++) {
+        bytes = Bench_Encode(point_count, &frame_count);
+    }
+
+    uint64_t encode_ns = Host_ReadNanoseconds() - start_ns;
+    uint64_t encode_cycles = Host_ReadCycles() - start_cycles;
+
+    start_ns = Host_ReadNanoseconds();
+    bool is_decoded = Bench_Decode(point_count, frame_count);
+    uint64_t decode_ns = Host_ReadNanoseconds() - start_ns;
+
+    /* Packed fields, what a hand-rolled fixed layout would send */
+    size_t packed = point_count * (sizeof(uint32_t) + sizeof(int32_t) + sizeof(int32_t) + sizeof(uint16_t));
+    size_t csv = Bench_GetCsvSize(point_count);
+    double points = (double) point_count * (double) rounds;
+
+    printf("%-22s %6zu points %5zu frames %7zu B %5.2f B/point, %4.1fx packed %4.1fx CSV, encode %5.1f ns %6.1f host "
+           "cycles/point, decode %5.1f ns/point\n", name, point_count, frame_count, bytes, (double) bytes / point_count,
+           (double) packed / bytes, (double) csv / bytes, (double) encode_ns / points, (double) encode_cycles / points,
+           (double) decode_ns / point_count);
+
+    if (is_decoded == false) {
+        fprintf(stderr, "%s: decoded points differ from the encoded ones\n", name);
+        return 1;
+    }
+
+    return 0;
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* Recorded NMEA logs given on the command line run after the generated tracks */
+int main (int argc, char **argv) {
+    int failures = 0;
+
+    for (size_t i = 0; i < (sizeof(g_tracks) / sizeof(g_tracks[0])); i++) {
+        const sTrackSpec_t *spec = &g_tracks[i];
+        size_t count = Track_Generate(spec->profile, spec->period_s, spec->duration_s, TRACK_SEED, g_track, MAX_POINTS);
+        char name[32];
+
+        snprintf(name, sizeof(name), "%s %u h, %u s", Track_GetProfileName(spec->profile), spec->duration_s / 3600,
+                 spec->period_s);
+        failures += Bench_Run(name, count);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        size_t count = Track_LoadNmea(argv[i], g_track, MAX_POINTS);
+
+        if (count == 0) {
+            fprintf(stderr, "%s: no fixes\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        failures += Bench_Run(argv[i], count);
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
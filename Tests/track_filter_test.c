@@ -0,0 +1,185 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "track_filter.h"
+#include "host.h"
+#include "track.h"
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+#define MAX_POINTS (8U * 3600U)
+#define TRACK_SEED 0x5EEDU
+#define METERS_PER_DEGREE 111320.0
+#define DEGREES_TO_RADIANS (M_PI / 180.0)
+/* The filter works on an integer plane, a few cm of rounding on top of the bound are fine */
+#define DEVIATION_SLACK_CM 5.0
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+typedef struct sTrackSpec {
+    eTrackProfile_t profile;
+    uint32_t duration_s;
+    /* Kept points may be at most one in this many, 0 for no limit */
+    uint32_t min_reduction;
+} sTrackSpec_t;
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+static const sTrackSpec_t g_tracks[] = {
+    {.profile = eTrackProfile_Highway, .duration_s = 3600, .min_reduction = 10},
+    {.profile = eTrackProfile_Parked, .duration_s = 3600, .min_reduction = 100},
+    {.profile = eTrackProfile_City, .duration_s = 3600, .min_reduction = 0},
+    {.profile = eTrackProfile_Mixed, .duration_s = 8 * 3600, .min_reduction = 0}
+};
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+static sTrackFix_t g_track[MAX_POINTS];
+static sTrackPoint_t g_points[MAX_POINTS];
+static sTrackPoint_t g_kept[MAX_POINTS];
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+static double Test_SegmentDistance (const sTrackPoint_t *start, const sTrackPoint_t *end, const sTrackPoint_t *point);
+static size_t Test_Filter (size_t count, sTrackFilterStats_t *stats);
+static void Test_Track (const char *name, size_t count, uint32_t min_reduction);
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+/* In cm on a flat plane around the segment start, in doubles */
+static double Test_SegmentDistance (const sTrackPoint_t *start, const sTrackPoint_t *end, const sTrackPoint_t *point) {
+    double scale = cos((start->latitude / 1e7) * DEGREES_TO_RADIANS);
+    double end_x = ((end->longitude - start->longitude) / 1e7) * METERS_PER_DEGREE * scale * 100.0;
+    double end_y = ((end->latitude - start->latitude) / 1e7) * METERS_PER_DEGREE * 100.0;
+    double x = ((point->longitude - start->longitude) / 1e7) * METERS_PER_DEGREE * scale * 100.0;
+    double y = ((point->latitude - start->latitude) / 1e7) * METERS_PER_DEGREE * 100.0;
+    double length_squared = (end_x * end_x) + (end_y * end_y);
+    double t = (length_squared > 0.0) ? (((x * end_x) + (y * end_y)) / length_squared) : 0.0;
+
+    t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+
+    return hypot(x - (t * end_x), y - (t * end_y));
+}
+
+/* Every point through the filter and a flush at the end, as before the device sleeps */
+static size_t Test_Filter (size_t count, sTrackFilterStats_t *stats) {
+    static sTrackFilter_t filter;
+    sTrackPoint_t output[TRACK_FILTER_MAX_OUTPUT];
+    size_t kept = 0;
+
+    TrackFilter_Init(&filter, NULL);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t output_count = TrackFilter_Push(&filter, &g_points[i], output);
+
+        for (size_t j = 0; j < output_count; j++) {
+            g_kept[kept++] = output[j];
+        }
+    }
+
+    if (TrackFilter_Flush(&filter, &output[0])) {
+        g_kept[kept++] = output[0];
+    }
+
+    TrackFilter_GetStats(&filter, stats);
+
+    return kept;
+}
+
+static void Test_Track (const char *name, size_t count, uint32_t min_reduction) {
+    sTrackFilterStats_t stats;
+    int failures = Host_GetFailures();
+
+    for (size_t i = 0; i < count; i++) {
+        g_points[i] = (sTrackPoint_t) {.timestamp = g_track[i].timestamp, .latitude = g_track[i].latitude,
+                                       .longitude = g_track[i].longitude, .speed = g_track[i].speed,
+                                       .course = g_track[i].course};
+    }
+
+    size_t kept = Test_Filter(count, &stats);
+
+    HOST_CHECK(kept > 0);
+    HOST_CHECK(stats.points_in == count);
+    HOST_CHECK(stats.kept == kept);
+    HOST_CHECK((stats.kept + stats.dropped) == count);
+    HOST_CHECK((stats.kept_deviation + stats.kept_heading + stats.kept_speed + stats.kept_interval + 1) <= kept);
+
+    /* The kept points are input points in track order, the first and the last one among them */
+    size_t input = 0;
+    double max_deviation = 0.0;
+    uint32_t max_interval = 0;
+
+    HOST_CHECK(memcmp(&g_kept[0], &g_points[0], sizeof(sTrackPoint_t)) == 0);
+    HOST_CHECK(memcmp(&g_kept[kept - 1], &g_points[count - 1], sizeof(sTrackPoint_t)) == 0);
+
+    for (size_t k = 1; k < kept; k++) {
+        const sTrackPoint_t *start = &g_kept[k - 1];
+        const sTrackPoint_t *end = &g_kept[k];
+
+        if (HOST_CHECK(end->timestamp > start->timestamp) == false) {
+            break;
+        }
+
+        while ((input < count) && (g_points[input].timestamp < end->timestamp)) {
+            if (g_points[input].timestamp > start->timestamp) {
+                double deviation = Test_SegmentDistance(start, end, &g_points[input]);
+                max_deviation = (deviation > max_deviation) ? deviation : max_deviation;
+            }
+
+            input++;
+        }
+
+        HOST_CHECK((input < count) && (memcmp(&g_points[input], end, sizeof(sTrackPoint_t)) == 0));
+
+        if ((end->timestamp - start->timestamp) > max_interval) {
+            max_interval = end->timestamp - start->timestamp;
+        }
+    }
+
+    /* Points dropped by thinning the window on long runs were only checked against a coarser sample */
+    HOST_CHECK(max_deviation <= ((2.0 * TRACK_FILTER_DEFAULT_MAX_DEVIATION_CM) + DEVIATION_SLACK_CM));
+    HOST_CHECK(max_interval <= TRACK_FILTER_DEFAULT_MAX_INTERVAL_S);
+
+    if (min_reduction != 0) {
+        HOST_CHECK((kept * min_reduction) <= count);
+    }
+
+    printf("%-20s %6zu fixes, %5zu kept (1 in %5.1f): %u deviation, %u heading, %u speed, %u interval, max %.0f cm off "
+           "the kept line, max %u s between points\n", name, count, kept, (double) count / kept, stats.kept_deviation,
+           stats.kept_heading, stats.kept_speed, stats.kept_interval, max_deviation, max_interval);
+
+    if (Host_GetFailures() != failures) {
+        fprintf(stderr, "%s: failed\n", name);
+    }
+}
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+/* Recorded NMEA logs given on the command line are checked after the generated tracks */
+int main (int argc, char **argv) {
+    for (size_t i = 0; i < (sizeof(g_tracks) / sizeof(g_tracks[0])); i++) {
+        const sTrackSpec_t *spec = &g_tracks[i];
+        size_t count = Track_Generate(spec->profile, 1, spec->duration_s, TRACK_SEED, g_track, MAX_POINTS);
+        char name[32];
+
+        snprintf(name, sizeof(name), "%s %u h", Track_GetProfileName(spec->profile), spec->duration_s / 3600);
+        Test_Track(name, count, spec->min_reduction);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        size_t count = Track_LoadNmea(argv[i], g_track, MAX_POINTS);
+
+        if (HOST_CHECK(count > 0) == false) {
+            continue;
+        }
+
+        Test_Track(argv[i], count, 0);
+    }
+
+    return (Host_GetFailures() == 0) ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""Decodes the binary debug log of the firmware back into text.
+
+The firmware is built with DEBUG_API_BINARY_LOG set to 1. Every DEBUG_INFO/WARN/ERROR call then sends a COBS frame
+ending with a zero byte instead of a formatted line:
+
+    timestamp (u32), format descriptor address, module tag address, packed arguments
+
+The descriptor sits in the .log_formats section and points at the format string and the file name, all of it is read
+back from the ELF the capture was made with. Integers are stored in their own size, strings as a length byte and the
+characters.
+
+    python3 Tools/log_decode.py firmware.elf capture.bin
+    cat /dev/ttyUSB0 | python3 Tools/log_decode.py firmware.elf -
+"""
+import argparse
+import re
+import struct
+import sys
+
+FORMAT_SECTION = ".log_formats"
+LEVEL_NAMES = ("INF", "WRN", "ERR")
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diuoxXcpfFeEgGs%])")
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+class Elf:
+    def __init__(self, path):
+        with open(path, "rb") as file:
+            self.data = file.read()
+
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+
+        self.is_64 = self.data[4] == 2
+        self.pointer_size = 8 if self.is_64 else 4
+        self.pointer = "<Q" if self.is_64 else "<I"
+
+        if self.is_64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3A)
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+
+        headers = [self._section_header(shoff + index * shentsize) for index in range(shnum)]
+        names = headers[shstrndx]
+        self.sections = {}
+
+        for header in headers:
+            name_end = self.data.index(b"\0", names["offset"] + header["name"])
+            header["name"] = self.data[names["offset"] + header["name"]:name_end].decode()
+            self.sections[header["name"]] = header
+
+        self.loaded = [header for header in headers
+                       if (header["type"] == SHT_PROGBITS) and (header["flags"] & SHF_ALLOC)]
+
+    def _section_header(self, offset):
+        if self.is_64:
+            name, kind, flags, addr, data_offset, size = struct.unpack_from("<IIQQQQ", self.data, offset)
+        else:
+            name, kind, flags, addr, data_offset, size = struct.unpack_from("<IIIIII", self.data, offset)
+
+        return {"name": name, "type": kind, "flags": flags, "addr": addr, "offset": data_offset, "size": size}
+
+    def read(self, address, size):
+        for section in self.loaded:
+            if section["addr"] <= address and (address + size) <= (section["addr"] + section["size"]):
+                start = section["offset"] + address - section["addr"]
+                return self.data[start:start + size]
+
+        raise KeyError("0x%x is not in a loaded section" % address)
+
+    def read_string(self, address):
+        if address == 0:
+            return None
+
+        for section in self.loaded:
+            if section["addr"] <= address < (section["addr"] + section["size"]):
+                start = section["offset"] + address - section["addr"]
+                return self.data[start:self.data.index(b"\0", start)].decode(errors="replace")
+
+        raise KeyError("0x%x is not in a loaded section" % address)
+
+    def read_pointer(self, address):
+        return struct.unpack(self.pointer, self.read(address, self.pointer_size))[0]
+
+    def is_descriptor(self, address):
+        section = self.sections.get(FORMAT_SECTION)
+
+        return (section is not None) and (section["addr"] <= address < (section["addr"] + section["size"]))
+
+
+def cobs_decode(frame):
+    data = bytearray()
+    index = 0
+
+    while index < len(frame):
+        code = frame[index]
+
+        if (code == 0) or ((index + code) > len(frame)):
+            raise ValueError("broken COBS frame")
+
+        data += frame[index + 1:index + code]
+        index += code
+
+        if (code < 0xFF) and (index < len(frame)):
+            data.append(0)
+
+    return bytes(data)
+
+
+class Arguments:
+    def __init__(self, data, elf):
+        self.data = data
+        self.offset = 0
+        self.elf = elf
+
+    def take(self, fmt):
+        size = struct.calcsize(fmt)
+
+        if (self.offset + size) > len(self.data):
+            raise EOFError
+
+        value, = struct.unpack_from(fmt, self.data, self.offset)
+        self.offset += size
+
+        return value
+
+    def take_string(self):
+        length = self.take("<B")
+
+        if (self.offset + length) > len(self.data):
+            raise EOFError
+
+        value = self.data[self.offset:self.offset + length].decode(errors="replace")
+        self.offset += length
+
+        return value
+
+
+def integer_format(length, conversion, elf):
+    signed = conversion in "dic"
+
+    if length == "ll":
+        code = "q"
+    elif length in ("l", "z", "j", "t"):
+        code = "q" if elf.is_64 else "i"
+    else:
+        code = "i"
+
+    return "<" + (code if signed else code.upper())
+
+
+def render(format_string, arguments, elf):
+    """Rebuilds the text the way printf would have, stops where the packed arguments ran out."""
+    output = []
+    position = 0
+
+    try:
+        for match in CONVERSION.finditer(format_string):
+            output.append(format_string[position:match.start()])
+            position = match.end()
+            flags, width, precision, length, conversion = match.groups()
+
+            if conversion == "%":
+                output.append("%")
+                continue
+
+            if width == "*":
+                width = str(arguments.take("<i"))
+
+            if precision == "*":
+                star = arguments.take("<i")
+                precision = str(star) if star >= 0 else None
+
+            spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+
+            if conversion in "diuoxXc":
+                value = arguments.take(integer_format(length or "", conversion, elf))
+                output.append((spec + "c") % (value & 0xFF) if conversion == "c" else
+                              (spec + ("d" if conversion in "iu" else conversion)) % value)
+            elif conversion == "p":
+                output.append((spec + "s") % ("0x%x" % arguments.take(elf.pointer)))
+            elif conversion == "s":
+                output.append((spec + "s") % arguments.take_string())
+            else:
+                output.append((spec + conversion) % arguments.take("<d"))
+    except EOFError:
+        output.append("<cut short>")
+        return "".join(output)
+
+    output.append(format_string[position:])
+
+    return "".join(output)
+
+
+def decode_frame(record, elf):
+    # The pointers are naturally aligned behind the timestamp
+    header = "<I" + ("4x" if elf.is_64 else "") + elf.pointer[1:] * 2
+    timestamp, descriptor, module_tag = struct.unpack_from(header, record)
+
+    if not elf.is_descriptor(descriptor):
+        raise ValueError("0x%x is not a format descriptor" % descriptor)
+
+    format_address = elf.read_pointer(descriptor)
+    file_address = elf.read_pointer(descriptor + elf.pointer_size)
+    line, level = struct.unpack("<HB", elf.read(descriptor + 2 * elf.pointer_size, 3))
+    format_string = elf.read_string(format_address)
+    tag = elf.read_string(module_tag)
+    text = render(format_string, Arguments(record[struct.calcsize(header):], elf), elf).rstrip("\r\n")
+    level_name = LEVEL_NAMES[level] if level < len(LEVEL_NAMES) else "???"
+
+    if level_name == "INF":
+        prefix = "[%s.%s]: \t" % (tag, level_name)
+    else:
+        file_name = elf.read_string(file_address) or "?"
+        prefix = "[%s.%s] (%s @%u line): \t" % (tag, level_name, file_name, line)
+
+    return "%10u %s%s" % (timestamp, prefix, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the binary debug log of the firmware")
+    parser.add_argument("elf", help="firmware ELF the capture was made with")
+    parser.add_argument("capture", help="raw capture of the debug UART, - reads stdin")
+    options = parser.parse_args()
+    elf = Elf(options.elf)
+    stream = sys.stdin.buffer if options.capture == "-" else open(options.capture, "rb")
+    pending = b""
+    broken = 0
+
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+
+        if not chunk:
+            break
+
+        frames = (pending + chunk).split(b"\0")
+        pending = frames.pop()
+
+        for frame in frames:
+            if not frame:
+                continue
+
+            try:
+                print(decode_frame(cobs_decode(frame), elf), flush=True)
+            except (ValueError, KeyError, struct.error) as error:
+                broken += 1
+                print("<broken frame: %s>" % error, file=sys.stderr)
+
+    if broken > 0:
+        print("%u broken frames" % broken, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Turns a sampling profile of the firmware into a flat profile per function.
+
+The profile is printed by the "profdump" CLI command. Every line of it starts with PROFILE, anything else in the
+capture, log prefixes included, is skipped:
+
+    PROFILE BEGIN <version> <rate hz> <samples> <dropped> <slots used>
+    PROFILE TASK <number> <name>
+    PROFILE SAMPLES <pc>:<task>:<count> ...
+    PROFILE END
+
+Task 0 stands for samples taken while an interrupt was running. The program counters are resolved against the symbol
+table of the ELF the firmware was built from, the last complete profile in the capture is used.
+
+    python3 Tools/profile_report.py firmware.elf console.log
+    python3 Tools/profile_report.py firmware.elf console.log --tasks
+"""
+import argparse
+import bisect
+import struct
+import sys
+
+from log_decode import Elf
+
+FORMAT_VERSION = 1
+ISR_TASK = 0
+STT_FUNC = 2
+THUMB_BIT = 1
+
+
+class Profile:
+    def __init__(self, rate, samples, dropped):
+        self.rate = rate
+        self.samples = samples
+        self.dropped = dropped
+        self.tasks = {ISR_TASK: "(interrupt)"}
+        self.slots = []
+
+
+class Symbols:
+    def __init__(self, elf):
+        symtab = elf.sections.get(".symtab")
+        strtab = elf.sections.get(".strtab")
+
+        if (symtab is None) or (strtab is None):
+            raise ValueError("the ELF has no symbol table, was it stripped?")
+
+        entry_format = "<IBBHQQ" if elf.is_64 else "<IIIBBH"
+        entry_size = struct.calcsize(entry_format)
+        functions = {}
+
+        for offset in range(symtab["offset"], symtab["offset"] + symtab["size"], entry_size):
+            if elf.is_64:
+                name, info, _, _, value, size = struct.unpack_from(entry_format, elf.data, offset)
+            else:
+                name, value, size, info, _, _ = struct.unpack_from(entry_format, elf.data, offset)
+
+            if ((info & 0xF) != STT_FUNC) or (value == 0):
+                continue
+
+            start = strtab["offset"] + name
+            text = elf.data[start:elf.data.index(b"\0", start)].decode(errors="replace")
+            functions[value & ~THUMB_BIT] = (text, size)
+
+        self.starts = sorted(functions)
+        self.functions = [functions[start] for start in self.starts]
+
+    def resolve(self, address):
+        index = bisect.bisect_right(self.starts, address) - 1
+
+        if index >= 0:
+            name, size = self.functions[index]
+
+            # A symbol without a size still gets the addresses up to the next one
+            if (size == 0) or (address < (self.starts[index] + size)):
+                return name
+
+        return "0x%08x" % address
+
+
+def parse(lines):
+    """The last profile that got as far as its END line."""
+    profile = None
+    complete = None
+
+    for line in lines:
+        position = line.find("PROFILE ")
+
+        if position < 0:
+            continue
+
+        fields = line[position:].rstrip("\r\n").split(" ")
+        kind = fields[1] if len(fields) > 1 else ""
+
+        if kind == "BEGIN" and len(fields) >= 7:
+            if int(fields[2]) != FORMAT_VERSION:
+                raise ValueError("profile format %s is not supported" % fields[2])
+
+            profile = Profile(int(fields[3]), int(fields[4]), int(fields[5]))
+        elif profile is None:
+            continue
+        elif kind == "TASK" and len(fields) >= 4:
+            profile.tasks[int(fields[2])] = " ".join(fields[3:])
+        elif kind == "SAMPLES":
+            for slot in fields[2:]:
+                pc, task, count = slot.split(":")
+                profile.slots.append((int(pc, 16), int(task), int(count)))
+        elif kind == "END":
+            complete = profile
+            profile = None
+
+    return complete
+
+
+def report(profile, symbols, by_task, limit):
+    total = sum(count for _, _, count in profile.slots)
+    functions = {}
+
+    for pc, task, count in profile.slots:
+        key = (symbols.resolve(pc & ~THUMB_BIT), task if by_task else None)
+        functions[key] = functions.get(key, 0) + count
+
+    print("%u samples at %u Hz, %.1f s sampled, %u dropped" % (total, profile.rate,
+                                                                 total / profile.rate if profile.rate else 0.0,
+                                                                 profile.dropped))
+
+    if by_task:
+        print("%8s %7s  %-16s %s" % ("samples", "share", "task", "function"))
+    else:
+        print("%8s %7s  %s" % ("samples", "share", "function"))
+
+    ranked = sorted(functions.items(), key=lambda item: -item[1])
+
+    for (name, task), count in ranked[:limit] if limit > 0 else ranked:
+        share = (100.0 * count / total) if total > 0 else 0.0
+
+        if by_task:
+            print("%8u %6.2f%%  %-16s %s" % (count, share, profile.tasks.get(task, "task %u" % task), name))
+        else:
+            print("%8u %6.2f%%  %s" % (count, share, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flat profile per function from a sampling profile of the firmware")
+    parser.add_argument("elf", help="firmware ELF the profile was taken with")
+    parser.add_argument("capture", help="console log holding the profile, - reads stdin")
+    parser.add_argument("--tasks", action="store_true", help="split every function by the task it ran in")
+    parser.add_argument("--limit", type=int, default=40, help="lines to print, 0 prints all of them")
+    options = parser.parse_args()
+
+    stream = sys.stdin if options.capture == "-" else open(options.capture, "r", errors="replace")
+    profile = parse(stream)
+
+    if profile is None:
+        print("no complete profile found", file=sys.stderr)
+        sys.exit(1)
+
+    report(profile, Symbols(Elf(options.elf)), options.tasks, options.limit)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Decodes the binary telemetry frames the tracker uploads into CSV.
+
+Frames are built by Utility/telemetry_frame.c:
+
+    version << 4 | flags, header field count << 4 | point field count, header fields, points, CRC-16 if flagged
+
+Every field is a zigzag varint, the first point is absolute and every later one a delta to the one before. The field
+lists are read from the X-macro schema in telemetry_frame.h, so the decoder follows the firmware it is pointed at.
+
+    python3 Tools/telemetry_decode.py frame0.bin frame1.bin > track.csv
+    python3 Tools/telemetry_decode.py --hex server.log
+"""
+import argparse
+import os
+import re
+import sys
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Source", "Utility", "telemetry_frame.h")
+FIELD = re.compile(r"X\(\s*(\w+)\s*,\s*(\w+)\s*,")
+FLAG_CRC = 0x01
+CRC16_INIT = 0xFFFF
+CRC16_POLY = 0x1021
+TYPE_BITS = {"uint8_t": 8, "int8_t": 8, "uint16_t": 16, "int16_t": 16, "uint32_t": 32, "int32_t": 32}
+
+
+class Schema:
+    def __init__(self, path):
+        with open(path) as file:
+            text = file.read().replace("\\\n", " ")
+
+        self.version = int(re.search(r"#define TELEMETRY_FRAME_VERSION (\d+)", text).group(1))
+        self.header = self._fields(text, "TELEMETRY_HEADER_FIELDS")
+        self.point = self._fields(text, "TELEMETRY_POINT_FIELDS")
+
+    @staticmethod
+    def _fields(text, macro):
+        body = re.search(r"#define %s\(X\)(.*)" % macro, text).group(1)
+        return FIELD.findall(body)
+
+
+def crc16(data):
+    crc = CRC16_INIT
+
+    for byte in data:
+        crc ^= byte << 8
+
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC16_POLY) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+
+    return crc
+
+
+def read_varint(data, position):
+    value = 0
+    shift = 0
+
+    while True:
+        if position >= len(data):
+            raise ValueError("varint runs past the end of the frame")
+
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+
+        if (byte & 0x80) == 0:
+            return (value >> 1) ^ -(value & 1), position
+
+
+def wrap(value, kind):
+    """The firmware adds deltas in 64 bits and truncates to the field type."""
+    bits = TYPE_BITS[kind]
+    value &= (1 << bits) - 1
+
+    if not kind.startswith("u") and value >= (1 << (bits - 1)):
+        value -= 1 << bits
+
+    return value
+
+
+def decode_frame(frame, schema):
+    if len(frame) < 2 or (frame[0] >> 4) != schema.version:
+        raise ValueError("not a version %u frame" % schema.version)
+
+    if frame[1] != ((len(schema.header) << 4) | len(schema.point)):
+        raise ValueError("field counts do not match the schema")
+
+    end = len(frame)
+
+    if frame[0] & FLAG_CRC:
+        end -= 2
+
+        if end < 2 or crc16(frame[:end]) != ((frame[end] << 8) | frame[end + 1]):
+            raise ValueError("CRC mismatch")
+
+    position = 2
+    header = {}
+
+    for name, kind in schema.header:
+        value, position = read_varint(frame, position)
+        header[name] = wrap(value, kind)
+
+    points = []
+    previous = {name: 0 for name, _ in schema.point}
+
+    while position < end:
+        point = {}
+
+        for name, kind in schema.point:
+            value, position = read_varint(frame, position)
+            point[name] = wrap(previous[name] + value, kind)
+
+        points.append(point)
+        previous = point
+
+    return header, points
+
+
+def read_frames(options):
+    if options.hex:
+        for path in options.frames:
+            stream = sys.stdin if path == "-" else open(path)
+
+            for line in stream:
+                line = line.strip()
+
+                if line:
+                    yield path, bytes.fromhex(line)
+    else:
+        for path in options.frames:
+            with open(path, "rb") as file:
+                yield path, file.read()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode tracker telemetry frames into CSV")
+    parser.add_argument("frames", nargs="+", help="one frame per file, or hex lines with --hex, - reads stdin")
+    parser.add_argument("--hex", action="store_true", help="inputs hold one hex encoded frame per line")
+    parser.add_argument("--schema", default=DEFAULT_HEADER, help="telemetry_frame.h of the firmware")
+    options = parser.parse_args()
+    schema = Schema(options.schema)
+    columns = [name for name, _ in schema.header] + [name for name, _ in schema.point]
+    broken = 0
+
+    print(",".join(["frame"] + columns))
+
+    for index, (path, frame) in enumerate(read_frames(options)):
+        try:
+            header, points = decode_frame(frame, schema)
+        except ValueError as error:
+            broken += 1
+            print("%s: broken frame %u: %s" % (path, index, error), file=sys.stderr)
+            continue
+
+        for point in points:
+            row = dict(header, **point)
+            print(",".join([str(index)] + [str(row[name]) for name in columns]))
+
+    if broken > 0:
+        print("%u broken frames" % broken, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
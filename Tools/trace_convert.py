@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Turns a kernel trace dump of the firmware into a Chrome trace JSON file, which Perfetto and chrome://tracing open.
+
+The dump is printed by the "tracedump" CLI command, or sent over a socket by "tracedump:<socket>". Every line of it
+starts with TRACE, anything else in the capture, log prefixes included, is skipped:
+
+    TRACE BEGIN <version> <cpu hz> <events> <overwritten>
+    TRACE TASK <number> <priority> <name>
+    TRACE OBJECT <number> <queue type> <name>
+    TRACE EVENTS <event> ...
+    TRACE END
+
+An event is 16 hex digits: the DWT cycle count (8), the event (2), the exception it was recorded in (2, 0 is a task)
+and the task or queue number (4). The last complete dump in the capture is converted.
+
+    python3 Tools/trace_convert.py console.log trace.json
+"""
+import argparse
+import json
+import sys
+
+FORMAT_VERSION = 1
+CYCLE_WRAP = 1 << 32
+PROCESS_ID = 1
+ISR_THREAD_BASE = 1000
+PENDSV_EXCEPTION = 14
+
+# Same order as eTraceEvent_t in API/trace_api.h
+(TASK_SWITCH, TASK_CREATE, TASK_DELETE, NOTIFY, NOTIFY_BLOCK, QUEUE_SEND, QUEUE_SEND_FAILED, QUEUE_RECEIVE,
+ QUEUE_RECEIVE_FAILED, QUEUE_BLOCK_SEND, QUEUE_BLOCK_RECEIVE) = range(11)
+
+# ucQueueType of the kernel
+QUEUE_TYPES = {0: "queue", 1: "mutex", 2: "semaphore", 3: "semaphore", 4: "mutex", 5: "queue set"}
+EXCEPTION_NAMES = {2: "NMI", 3: "HardFault", 11: "SVCall", 14: "PendSV", 15: "SysTick"}
+# Queue events read as a give and a take on a mutex or a semaphore
+QUEUE_VERBS = {
+    QUEUE_SEND: ("send", "give"),
+    QUEUE_SEND_FAILED: ("send failed", "give failed"),
+    QUEUE_RECEIVE: ("receive", "take"),
+    QUEUE_RECEIVE_FAILED: ("receive failed", "take failed"),
+    QUEUE_BLOCK_SEND: ("block on send", "block on give"),
+    QUEUE_BLOCK_RECEIVE: ("block on receive", "block on take"),
+}
+
+
+class Dump:
+    def __init__(self, hz, count, overwritten):
+        self.hz = hz
+        self.count = count
+        self.overwritten = overwritten
+        self.tasks = {}
+        self.objects = {}
+        self.events = []
+
+
+def parse(lines):
+    """The last dump that got as far as its END line."""
+    dump = None
+    complete = None
+
+    for line in lines:
+        position = line.find("TRACE ")
+
+        if position < 0:
+            continue
+
+        fields = line[position:].rstrip("\r\n").split(" ")
+        kind = fields[1] if len(fields) > 1 else ""
+
+        if kind == "BEGIN" and len(fields) >= 6:
+            if int(fields[2]) != FORMAT_VERSION:
+                raise ValueError("trace format %s is not supported" % fields[2])
+
+            dump = Dump(int(fields[3]), int(fields[4]), int(fields[5]))
+        elif dump is None:
+            continue
+        elif kind == "TASK" and len(fields) >= 5:
+            dump.tasks[int(fields[2])] = {"priority": int(fields[3]), "name": " ".join(fields[4:])}
+        elif kind == "OBJECT" and len(fields) >= 5:
+            dump.objects[int(fields[2])] = {"type": int(fields[3]), "name": " ".join(fields[4:])}
+        elif kind == "EVENTS":
+            for event in fields[2:]:
+                if len(event) != 16:
+                    raise ValueError("broken event %r" % event)
+
+                dump.events.append((int(event[0:8], 16), int(event[8:10], 16), int(event[10:12], 16),
+                                    int(event[12:16], 16)))
+        elif kind == "END":
+            complete = dump
+            dump = None
+
+    return complete
+
+
+def task_name(dump, number):
+    task = dump.tasks.get(number)
+
+    return task["name"] if task is not None else "task %u" % number
+
+
+def object_name(dump, number):
+    item = dump.objects.get(number)
+
+    if item is None:
+        return "queue %u" % number
+
+    kind = QUEUE_TYPES.get(item["type"], "queue")
+
+    return "%s %s" % (kind, item["name"] if item["name"] != "-" else number)
+
+
+def exception_name(exception):
+    if exception >= 16:
+        return "IRQ %u" % (exception - 16)
+
+    return EXCEPTION_NAMES.get(exception, "exception %u" % exception)
+
+
+def convert(dump):
+    """Chrome trace events and the time each task ran, in microseconds."""
+    output = []
+    run_time = {}
+    threads = {}
+    cycles_per_us = dump.hz / 1e6
+    base = None
+    previous = None
+    offset = 0
+    current = None
+    current_start = 0.0
+    now = 0.0
+
+    def thread(tid, name):
+        threads.setdefault(tid, name)
+        return tid
+
+    for raw, event, exception, number in dump.events:
+        # The cycle counter wraps every few tens of seconds
+        if (previous is not None) and (raw < previous):
+            offset += CYCLE_WRAP
+
+        previous = raw
+
+        if base is None:
+            base = raw
+
+        now = (raw + offset - base) / cycles_per_us
+
+        if event == TASK_SWITCH:
+            if (current is not None) and (current != number):
+                output.append({"name": task_name(dump, current), "ph": "X", "ts": current_start,
+                               "dur": now - current_start, "pid": PROCESS_ID,
+                               "tid": thread(current, task_name(dump, current))})
+                run_time[current] = run_time.get(current, 0.0) + now - current_start
+
+            if current != number:
+                current = number
+                current_start = now
+
+            continue
+
+        if (exception != 0) and (exception != PENDSV_EXCEPTION):
+            tid = thread(ISR_THREAD_BASE + exception, exception_name(exception))
+        elif current is not None:
+            tid = thread(current, task_name(dump, current))
+        else:
+            continue
+
+        if event in QUEUE_VERBS:
+            item = dump.objects.get(number)
+            is_lock = (item is not None) and (QUEUE_TYPES.get(item["type"]) in ("mutex", "semaphore"))
+            name = "%s %s" % (QUEUE_VERBS[event][1 if is_lock else 0], object_name(dump, number))
+        elif event == NOTIFY:
+            name = "notify %s" % task_name(dump, number)
+        elif event == NOTIFY_BLOCK:
+            name = "wait for notification"
+        elif event == TASK_CREATE:
+            name = "create %s" % task_name(dump, number)
+        elif event == TASK_DELETE:
+            name = "delete %s" % task_name(dump, number)
+        else:
+            name = "event %u" % event
+
+        output.append({"name": name, "ph": "i", "s": "t", "ts": now, "pid": PROCESS_ID, "tid": tid})
+
+    if current is not None:
+        output.append({"name": task_name(dump, current), "ph": "X", "ts": current_start, "dur": now - current_start,
+                       "pid": PROCESS_ID, "tid": thread(current, task_name(dump, current))})
+        run_time[current] = run_time.get(current, 0.0) + now - current_start
+
+    metadata = [{"name": "process_name", "ph": "M", "pid": PROCESS_ID, "args": {"name": "FreeRTOS"}}]
+
+    for tid, name in sorted(threads.items()):
+        metadata.append({"name": "thread_name", "ph": "M", "pid": PROCESS_ID, "tid": tid, "args": {"name": name}})
+        metadata.append({"name": "thread_sort_index", "ph": "M", "pid": PROCESS_ID, "tid": tid,
+                         "args": {"sort_index": tid}})
+
+    return metadata + output, run_time, now
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a kernel trace dump of the firmware to Chrome trace JSON")
+    parser.add_argument("capture", help="console log or socket capture holding the dump, - reads stdin")
+    parser.add_argument("output", help="JSON file to write, - writes stdout")
+    options = parser.parse_args()
+
+    stream = sys.stdin if options.capture == "-" else open(options.capture, "r", errors="replace")
+    dump = parse(stream)
+
+    if dump is None:
+        print("no complete trace dump found", file=sys.stderr)
+        sys.exit(1)
+
+    if len(dump.events) != dump.count:
+        print("dump announced %u events, %u found" % (dump.count, len(dump.events)), file=sys.stderr)
+
+    events, run_time, span = convert(dump)
+    document = {"traceEvents": events, "displayTimeUnit": "ns"}
+
+    if options.output == "-":
+        json.dump(document, sys.stdout)
+    else:
+        with open(options.output, "w") as file:
+            json.dump(document, file)
+
+    print("%u events over %.3f ms, %u lost to overwriting" % (len(dump.events), span / 1000.0, dump.overwritten),
+          file=sys.stderr)
+
+    for number, used in sorted(run_time.items(), key=lambda item: -item[1]):
+        share = (100.0 * used / span) if span > 0 else 0.0
+        print("  %-16s %6.2f %%" % (task_name(dump, number), share), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()